@@ -669,6 +669,53 @@ public:
     MI_TRAVERSE_CB(Object, m_size)
 };
 
+/**
+ * \brief Writes an OpenEXR file incrementally, one band of rows at a time
+ *
+ * This is useful for images that are too large to be held in memory as a
+ * whole: the producer hands over bands of rows (top to bottom) as soon as they
+ * are final, and only the current band needs to be resident. The bands must
+ * match the width, pixel format, component format, and channels of the
+ * \c layout bitmap given to the constructor, whose metadata is also stored in
+ * the file. The file is finished once all rows have been written, or when
+ * \ref close() is called or the writer is destroyed.
+ */
+class MI_EXPORT_LIB BitmapStreamWriter : public Object {
+public:
+    /**
+     * \brief Create an OpenEXR file with the given height, taking all
+     * other properties of the image from \c layout
+     */
+    BitmapStreamWriter(const fs::path &filename, const Bitmap *layout,
+                       uint32_t height);
+
+    /// Finish the file (see \ref close())
+    ~BitmapStreamWriter();
+
+    /// Append the rows of \c band to the file
+    void write(const Bitmap *band);
+
+    /// Finish the file. Rows that have not been written are left empty.
+    void close();
+
+    /// Return the number of rows written so far
+    uint32_t rows_written() const;
+
+    /// Return the height of the image
+    uint32_t height() const;
+
+    /// Return the name of the file being written
+    const fs::path &filename() const;
+
+    /// Return a human-readable summary
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS(BitmapStreamWriter)
+private:
+    struct BitmapStreamWriterPrivate;
+    std::unique_ptr<BitmapStreamWriterPrivate> d;
+};
+
 
 /**
  * \brief Accumulate the contents of a source bitmap into a
@@ -15,6 +15,7 @@
  */
 
 #include <mitsuba/core/fwd.h>
+#include <cstdint>
 #include <iosfwd>
 #include <string>
 #include <string_view>
@@ -223,6 +224,11 @@ extern MI_EXPORT_LIB bool exists(const path& p) noexcept;
  */
 extern MI_EXPORT_LIB size_t file_size(const path& p);
 
+/** \brief Returns the time of the last modification of the file at <tt>p</tt>
+ * (in seconds since the epoch). Symlinks are followed.
+ */
+extern MI_EXPORT_LIB int64_t last_write_time(const path& p);
+
 /** \brief Checks whether two paths refer to the same file system object.
  * Both must refer to an existing file or directory.
  * Symlinks are followed to determine equivalence.
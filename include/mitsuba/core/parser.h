@@ -20,7 +20,7 @@
  *
  * 2. Transformations: \ref transform_upgrade(), \ref
  *    transform_resolve(), \ref transform_merge_equivalent(),
- *    \ref transform_merge_meshes()
+ *    \ref transform_dedup_geometry(), \ref transform_merge_meshes()
  *
  *    - ``upgrade``: adapts old scene formats to the latest version
  *      (variant-independent).
@@ -31,6 +31,9 @@
  *    - ``merge_equivalent``, ``merge_meshes``: merge equivalent/compatible
  *      plugin instantiations.
  *
+ *    - ``dedup_geometry``: replaces shapes that load identical mesh files by
+ *      instances of a shared shape group (optional).
+ *
  *    The convenience function \ref transform_all() applies the standard
  *    transformation pipeline in the correct order.
  *
@@ -86,6 +89,10 @@ struct ParserConfig {
     /// Merge compatible meshes (same material) into single larger mesh
     bool merge_meshes = true;
 
+    /// Replace shapes that load identical mesh files by instances of a
+    /// shared shape group (disabled by default)
+    bool dedup_geometry = false;
+
     /// Constructor that takes variant name
     ParserConfig(std::string_view variant) : variant(variant) {}
 };
@@ -284,6 +291,33 @@ extern MI_EXPORT_LIB void transform_resolve(const ParserConfig &config,
 extern MI_EXPORT_LIB void transform_merge_equivalent(const ParserConfig &config,
                                                      ParserState &state);
 
+/**
+ * \brief Share the geometry of shapes that load identical mesh files
+ *
+ * Scenes assembled from asset libraries often load the same mesh many times,
+ * either from one file referenced under different IDs or from byte-identical
+ * copies of a file. This transformation detects such duplicates among the
+ * top-level ``ply``, ``obj``, and ``serialized`` shapes by hashing the
+ * contents of their files (matches are confirmed byte by byte) and comparing
+ * their remaining properties, except for ``to_world``.
+ *
+ * Each set of duplicates is replaced by a single ``shapegroup`` holding one
+ * copy of the shape, and every original shape turns into an ``instance`` of
+ * that group with the original transform and ID. The mesh is thus loaded and
+ * stored once, and the acceleration data structure is built once per group.
+ * The amount of mesh file data that no longer needs to be loaded is logged.
+ *
+ * Shapes that are emitters or sensors, or that are referenced more than once,
+ * cannot be instanced and are left unchanged. Since instanced geometry cannot
+ * be differentiated, this transformation is disabled by default (see \ref
+ * ParserConfig::dedup_geometry).
+ *
+ * \param config Parser configuration (currently unused)
+ * \param state Parser state to modify in-place
+ */
+extern MI_EXPORT_LIB void transform_dedup_geometry(const ParserConfig &config,
+                                                   ParserState &state);
+
 /**
  * \brief Adapt the scene description to merge geometry whenever possible
  *
@@ -364,7 +398,8 @@ extern MI_EXPORT_LIB void transform_relocate(const ParserConfig &config,
  * 1. \ref transform_upgrade()
  * 2. \ref transform_resolve()
  * 3. \ref transform_merge_equivalent() (if config.merge_equivalent is enabled)
- * 4. \ref transform_merge_meshes() (if config.merge_meshes is enabled)
+ * 4. \ref transform_dedup_geometry() (if config.dedup_geometry is enabled)
+ * 5. \ref transform_merge_meshes() (if config.merge_meshes is enabled)
  *
  * \param config Parser configuration containing variant and other settings
  * \param state Parser state to transform (modified in-place)
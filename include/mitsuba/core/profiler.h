@@ -1,6 +1,11 @@
 #pragma once
 
 #include <mitsuba/core/object.h>
+#include <cstdint>
+
+#if defined(MI_ENABLE_PROFILER)
+#  include <atomic>
+#endif
 
 #if defined(MI_ENABLE_ITTNOTIFY)
 #  include <ittnotify.h>
@@ -48,6 +53,9 @@ enum class ProfilerPhase : int {
     ProfilerPhaseCount
 };
 
+static_assert(int(ProfilerPhase::ProfilerPhaseCount) <= 64,
+              "The profiler tracks the phases of a thread in a 64-bit mask!");
+
 constexpr const char
     *profiler_phase_id[int(ProfilerPhase::ProfilerPhaseCount)] = {
         "Scene initialization",
@@ -84,8 +92,40 @@ extern MI_EXPORT_LIB __itt_string_handle *
     mitsuba_itt_phase[int(ProfilerPhase::ProfilerPhaseCount)];
 #endif
 
+#if defined(MI_ENABLE_PROFILER)
+/// Is the builtin sampling profiler running? (see \ref Profiler::start())
+extern MI_EXPORT_LIB std::atomic<bool> profiler_enabled;
+
+/**
+ * Slot holding the phases that the current thread is in, with bit \c i
+ * referring to <tt>ProfilerPhase(i)</tt>. Thanks to the partial order of the
+ * phases, the highest set bit always identifies the innermost phase, hence
+ * this mask encodes the thread's phase stack. Only the owning thread writes
+ * it, while the signal handler of the profiler reads it.
+ */
+extern MI_EXPORT_LIB thread_local std::atomic<uint64_t> *profiler_slot;
+
+/// Assign a profiler slot to the current thread and return it
+extern MI_EXPORT_LIB std::atomic<uint64_t> *profiler_register_thread();
+#endif
+
 struct ScopedPhase {
     ScopedPhase(ProfilerPhase phase) {
+#if defined(MI_ENABLE_PROFILER)
+        m_slot = nullptr;
+        if (profiler_enabled.load(std::memory_order_relaxed)) {
+            m_slot = profiler_slot ? profiler_slot : profiler_register_thread();
+
+            /* Only the outermost scope of a given phase clears its bit again */
+            m_flag = 1ull << int(phase);
+            uint64_t flags = m_slot->load(std::memory_order_relaxed);
+            if (flags & m_flag)
+                m_slot = nullptr;
+            else
+                m_slot->store(flags | m_flag, std::memory_order_relaxed);
+        }
+#endif
+
         /// Interface with various external visual profilers
 #if defined(MI_ENABLE_ITTNOTIFY)
         __itt_task_begin(mitsuba_itt_domain, __itt_null, __itt_null,
@@ -99,6 +139,12 @@ struct ScopedPhase {
     }
 
     ~ScopedPhase() {
+#if defined(MI_ENABLE_PROFILER)
+        if (m_slot)
+            m_slot->store(m_slot->load(std::memory_order_relaxed) & ~m_flag,
+                          std::memory_order_relaxed);
+#endif
+
 #if defined(MI_ENABLE_ITTNOTIFY)
         __itt_task_end(mitsuba_itt_domain);
 #endif
@@ -110,12 +156,46 @@ struct ScopedPhase {
 
     ScopedPhase(const ScopedPhase &) = delete;
     ScopedPhase &operator=(const ScopedPhase &) = delete;
+
+#if defined(MI_ENABLE_PROFILER)
+private:
+    std::atomic<uint64_t> *m_slot;
+    uint64_t m_flag;
+#endif
 };
 
+/**
+ * \brief Builtin sampling profiler
+ *
+ * When compiled with the \c MI_PROFILER_SAMPLING CMake option (the default on
+ * Linux and macOS), the profiler is disabled until \ref start() is called,
+ * e.g. by <tt>mitsuba --profile</tt>. While it runs, every thread tracks the
+ * phases it is in (see \ref ScopedPhase), and a timer signal interrupts the
+ * process after every millisecond of CPU time and records the phases of the
+ * interrupted thread in a fixed-size histogram. \ref print_report() then
+ * summarizes the time spent per phase. When the profiler is disabled, a phase
+ * scope only tests a global flag, which makes this usable on production
+ * machines where no external profiler is available.
+ *
+ * The phases are only meaningful in scalar variants: JIT variants execute
+ * them while tracing rather than while rendering.
+ */
 class MI_EXPORT_LIB Profiler {
 public:
     static void static_initialization();
     static void static_shutdown();
+
+    /// Is the builtin sampling profiler available in this build?
+    static bool available();
+
+    /// Clear the histogram and start sampling
+    static void start();
+
+    /// Stop sampling (the histogram is kept)
+    static void stop();
+
+    /// Log the per-phase time breakdown of the samples taken so far
+    static void print_report();
 };
 
 NAMESPACE_END(mitsuba)
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/vector.h>
+#include <memory>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Rectangular block of texels of a \ref TiledImage
+struct TextureTile {
+    using Vector2u = Vector<uint32_t, 2>;
+
+    /// Resolution of the tile (tiles at the right/bottom edge may be smaller)
+    Vector2u size;
+
+    /// Number of interleaved channels
+    uint32_t channel_count;
+
+    /// Float32 texels in scanline order, with interleaved channels
+    std::unique_ptr<float[]> data;
+
+    /// Number of bytes occupied by the tile
+    size_t memory() const;
+};
+
+/**
+ * \brief OpenEXR image whose texels are read on demand, one tile at a time
+ *
+ * Tiled OpenEXR files are read tile by tile. If the file stores a MIP map
+ * (or RIP map, of which only the isotropic levels are used), its levels are
+ * exposed as well. Scanline files consist of a single level and are split
+ * into strips of \ref scanline_tile_height rows.
+ *
+ * Only luminance (\c Y) and RGB images are supported; other channels such as
+ * alpha are ignored. Texels are converted to single precision on load.
+ *
+ * Instances should be obtained from \ref TextureCache::open(), which shares
+ * them between all users of the same file. Tiles returned by \ref tile() are
+ * then held by the process-wide \ref TextureCache.
+ */
+class MI_EXPORT_LIB TiledImage : public Object {
+public:
+    using Vector2u = Vector<uint32_t, 2>;
+
+    /// Height of the strips that scanline files are split into
+    static constexpr uint32_t scanline_tile_height = 64;
+
+    /// Open the given OpenEXR file and read its header
+    TiledImage(const fs::path &filename);
+
+    /// Release all resources
+    virtual ~TiledImage();
+
+    /// Return the name of the underlying file
+    const fs::path &filename() const;
+
+    /// Return the number of MIP map levels (1 if the file has none)
+    uint32_t level_count() const;
+
+    /// Return the resolution of the given level
+    Vector2u size(uint32_t level = 0) const;
+
+    /// Return the (maximum) resolution of a tile
+    Vector2u tile_size() const;
+
+    /// Return the number of tiles along each axis of the given level
+    Vector2u tile_count(uint32_t level = 0) const;
+
+    /// Return the number of channels (1 or 3)
+    uint32_t channel_count() const;
+
+    /// Identifier of this image within the texture cache
+    uint32_t id() const { return m_id; }
+
+    /**
+     * \brief Return the given tile, reading it from disk if it is not
+     * resident in the \ref TextureCache
+     *
+     * The returned pointer remains valid even if the cache evicts the tile in
+     * the meantime. This function can safely be called from multiple threads.
+     */
+    std::shared_ptr<const TextureTile> tile(uint32_t level, uint32_t x,
+                                            uint32_t y) const;
+
+    /// Read the given tile from disk, bypassing the cache
+    std::shared_ptr<TextureTile> read_tile(uint32_t level, uint32_t x,
+                                           uint32_t y) const;
+
+    /// Return a human-readable summary
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS(TiledImage)
+private:
+    struct TiledImagePrivate;
+    std::unique_ptr<TiledImagePrivate> d;
+    uint32_t m_id;
+};
+
+/**
+ * \brief Process-wide cache of \ref TiledImage tiles with a memory budget
+ *
+ * Textures that reference images which do not fit into memory load tiles
+ * lazily through this cache. It is shared by all such textures and evicts
+ * the least recently used tiles once their total size exceeds the budget.
+ * To keep contention low when many threads render concurrently, the cache is
+ * split into independently locked shards that each receive an equal share of
+ * the budget.
+ */
+class MI_EXPORT_LIB TextureCache {
+public:
+    /// Counters describing the effectiveness of the cache
+    struct Statistics {
+        /// Number of tile requests served from memory
+        size_t hits = 0;
+        /// Number of tile requests that had to read from disk
+        size_t misses = 0;
+        /// Number of tiles released to stay within the budget
+        size_t evictions = 0;
+        /// Number of tiles currently held by the cache
+        size_t tile_count = 0;
+        /// Memory currently held by the cache (in bytes)
+        size_t memory = 0;
+        /// Largest amount of memory held by the cache so far (in bytes)
+        size_t peak_memory = 0;
+
+        /// Return a human-readable summary
+        std::string to_string() const;
+    };
+
+    static void static_initialization();
+    static void static_shutdown();
+
+    /**
+     * \brief Return a handle to the given OpenEXR file
+     *
+     * Repeated calls with the same file return the same instance, so that
+     * all textures referencing it share its tiles. Files are identified by
+     * their path, modification time, and size, hence a file that changed on
+     * disk is opened again. Every call must be paired with \ref close().
+     */
+    static ref<TiledImage> open(const fs::path &filename);
+
+    /**
+     * \brief Release a handle obtained from \ref open()
+     *
+     * Once all handles of an image are released, the cache forgets the image
+     * and drops its tiles.
+     */
+    static void close(const TiledImage *image);
+
+    /// Set the memory budget (in bytes, default: 2 GiB)
+    static void set_budget(size_t bytes);
+
+    /// Return the memory budget (in bytes)
+    static size_t budget();
+
+    /// Return the current statistics
+    static Statistics statistics();
+
+    /// Reset the hit, miss, and eviction counters and the peak memory
+    static void reset_statistics();
+
+    /// Release all tiles (open files are kept)
+    static void clear();
+
+    /// Return the given tile of an image (see \ref TiledImage::tile())
+    static std::shared_ptr<const TextureTile> tile(const TiledImage *image,
+                                                   uint32_t level, uint32_t x,
+                                                   uint32_t y);
+};
+
+NAMESPACE_END(mitsuba)
@@ -8,9 +8,14 @@
 #  pragma clang diagnostic ignored "-Wdouble-promotion"
 #endif
 
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/logger.h>
 #include <mitsuba/core/ray.h>
+#include <mitsuba/core/string.h>
+#include <drjit/quaternion.h>
 #include <drjit/transform.h>
 #include <drjit/sphere.h>
+#include <vector>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -495,6 +500,274 @@ std::ostream &operator<<(std::ostream &os, const Transform<Point, Affine> &t) {
     return os;
 }
 
+// -----------------------------------------------------------------------
+
+/**
+ * \brief Affine transformation that is keyframed over an interval of time
+ *
+ * The keyframes are spaced uniformly over <tt>[time_start, time_end]</tt>,
+ * and the transformation remains constant before the first and after the
+ * last one. Each keyframe is decomposed into a translation, a rotation, and
+ * an upper triangular scale/shear matrix. In between keyframes, the rotation
+ * is interpolated spherically and the other parts linearly. This matches the
+ * quaternion motion blur of Embree, so that all CPU acceleration data
+ * structures agree on the motion.
+ *
+ * The keyframes are stored in scalar precision, while \ref eval() can be
+ * vectorized over the time argument.
+ */
+template <typename Float_> struct AnimatedTransform {
+    using Float                   = Float_;
+    using ScalarFloat             = dr::scalar_t<Float>;
+    using ScalarVector3f          = Vector<ScalarFloat, 3>;
+    using ScalarPoint3f           = Point<ScalarFloat, 3>;
+    using ScalarMatrix3f          = dr::Matrix<ScalarFloat, 3>;
+    using ScalarQuaternion4f      = dr::Quaternion<ScalarFloat>;
+    using ScalarAffineTransform4f = AffineTransform<Point<ScalarFloat, 4>>;
+    using ScalarBoundingBox3f     = BoundingBox<ScalarPoint3f>;
+
+    /// Keyframe decomposed as <tt>translate(trans) * rotate(quat) * scale</tt>
+    struct Keyframe {
+        /// Upper triangular scale/shear matrix
+        ScalarMatrix3f scale;
+        /// Rotation quaternion
+        ScalarQuaternion4f quat;
+        /// Translation
+        ScalarVector3f trans;
+    };
+
+    /// Create a static transformation
+    AnimatedTransform(const ScalarAffineTransform4f &transform = ScalarAffineTransform4f())
+        : AnimatedTransform(std::vector<ScalarAffineTransform4f>{ transform }) { }
+
+    /// Create a transformation from keyframes spaced uniformly over the given interval
+    AnimatedTransform(const std::vector<ScalarAffineTransform4f> &transforms,
+                      ScalarFloat time_start = 0.f, ScalarFloat time_end = 1.f)
+        : m_transforms(transforms), m_time_start(time_start), m_time_end(time_end) {
+        if (transforms.empty())
+            Throw("AnimatedTransform: at least one keyframe must be specified!");
+        if (transforms.size() > 1 && !(time_end > time_start))
+            Throw("AnimatedTransform: the end of the time interval (%f) must "
+                  "lie after its start (%f)!", time_end, time_start);
+
+        for (const ScalarAffineTransform4f &transform : transforms) {
+            Keyframe key = decompose(transform);
+            /* Interpolate along the shorter arc, which is also what Embree
+               does with quaternion motion blur */
+            if (!m_keyframes.empty() &&
+                dr::dot(m_keyframes.back().quat, key.quat) < 0.f)
+                key.quat = -key.quat;
+            m_keyframes.push_back(key);
+        }
+    }
+
+    /// Return the number of keyframes
+    size_t size() const { return m_keyframes.size(); }
+
+    /// Does the transformation change over time?
+    bool is_animated() const { return m_keyframes.size() > 1; }
+
+    /// Return the number of motion segments between keyframes (0 if static)
+    uint32_t segment_count() const { return (uint32_t) m_keyframes.size() - 1; }
+
+    /// Return the time of the first keyframe
+    ScalarFloat time_start() const { return m_time_start; }
+
+    /// Return the time of the last keyframe
+    ScalarFloat time_end() const { return m_time_end; }
+
+    /// Return the i-th keyframe in decomposed form
+    const Keyframe &keyframe(size_t i) const { return m_keyframes[i]; }
+
+    /// Return the i-th keyframe as specified
+    const ScalarAffineTransform4f &transform(size_t i) const { return m_transforms[i]; }
+
+    /**
+     * \brief Return the index of the motion segment containing \c time and
+     * the relative position within it
+     *
+     * Times before the first or after the last keyframe map to the start of
+     * the first or the end of the last segment. Must only be called on
+     * animated transformations.
+     */
+    template <typename Value>
+    std::pair<dr::uint32_array_t<Value>, Value> segment(const Value &time) const {
+        using UInt32 = dr::uint32_array_t<Value>;
+        uint32_t segments = segment_count();
+
+        Value x = (time - m_time_start) / (m_time_end - m_time_start) *
+                  ScalarFloat(segments);
+        x = dr::clip(x, 0.f, ScalarFloat(segments));
+
+        UInt32 index = dr::minimum(UInt32(x), segments - 1);
+        return { index, x - Value(index) };
+    }
+
+    /// Evaluate the transformation at the given time
+    template <typename Value>
+    AffineTransform<Point<Value, 4>> eval(const Value &time) const {
+        using Matrix3   = dr::Matrix<Value, 3>;
+        using Quat      = dr::Quaternion<Value>;
+        using Vector3   = Vector<Value, 3>;
+        using Transform = AffineTransform<Point<Value, 4>>;
+
+        if (!is_animated())
+            return Transform(m_transforms[0]);
+
+        auto [index, alpha] = segment(time);
+
+        // Fetch the keyframes surrounding each time
+        Matrix3 s0(m_keyframes[0].scale), s1(m_keyframes[1].scale);
+        Quat q0(m_keyframes[0].quat), q1(m_keyframes[1].quat);
+        Vector3 t0(m_keyframes[0].trans), t1(m_keyframes[1].trans);
+
+        for (uint32_t i = 1; i < segment_count(); ++i) {
+            dr::mask_t<Value> sel = index == i;
+            const Keyframe &k0 = m_keyframes[i], &k1 = m_keyframes[i + 1];
+            s0 = dr::select(sel, Matrix3(k0.scale), s0);
+            s1 = dr::select(sel, Matrix3(k1.scale), s1);
+            q0 = dr::select(sel, Quat(k0.quat), q0);
+            q1 = dr::select(sel, Quat(k1.quat), q1);
+            t0 = dr::select(sel, Vector3(k0.trans), t0);
+            t1 = dr::select(sel, Vector3(k1.trans), t1);
+        }
+
+        return compose(dr::lerp(s0, s1, alpha), dr::slerp(q0, q1, alpha),
+                       dr::lerp(t0, t1, alpha));
+    }
+
+    /**
+     * \brief Return bounds of \c bbox as it moves during the given segment
+     *
+     * The corners are transformed at several times within the segment. When
+     * the rotation changes, each one is padded by the largest distance that
+     * a point can move between two of these times, which keeps the bounds
+     * conservative. Otherwise, the corners move along straight lines and the
+     * keyframes at the ends of the segment suffice.
+     */
+    ScalarBoundingBox3f segment_bbox(uint32_t index,
+                                     const ScalarBoundingBox3f &bbox) const {
+        if (!is_animated()) {
+            ScalarBoundingBox3f result;
+            for (int i = 0; i < 8; ++i)
+                result.expand(m_transforms[0] * bbox.corner(i));
+            return result;
+        }
+
+        const Keyframe &k0 = m_keyframes[index], &k1 = m_keyframes[index + 1];
+        ScalarFloat angle = 2.f * dr::safe_acos(dr::dot(k0.quat, k1.quat));
+        uint32_t steps = angle > 1e-6f ? 32 : 1;
+
+        ScalarBoundingBox3f result;
+        for (int i = 0; i < 8; ++i) {
+            ScalarVector3f v0 = k0.scale * ScalarVector3f(bbox.corner(i)),
+                           v1 = k1.scale * ScalarVector3f(bbox.corner(i));
+
+            ScalarFloat pad = 0.f;
+            if (steps > 1)
+                pad = (dr::norm(k1.trans - k0.trans) + dr::norm(v1 - v0)) / steps +
+                      2.f * dr::sin(.5f * angle / steps) *
+                          dr::maximum(dr::norm(v0), dr::norm(v1));
+
+            for (uint32_t k = 0; k <= steps; ++k) {
+                ScalarFloat alpha = k / (ScalarFloat) steps;
+                ScalarMatrix3f rot = dr::quat_to_matrix<ScalarMatrix3f>(
+                    dr::slerp(k0.quat, k1.quat, alpha));
+                ScalarPoint3f p(dr::lerp(k0.trans, k1.trans, alpha) +
+                                rot * dr::lerp(v0, v1, alpha));
+                result.expand(ScalarBoundingBox3f(p - pad, p + pad));
+            }
+        }
+        return result;
+    }
+
+    /// Return bounds of \c bbox over all times
+    ScalarBoundingBox3f bbox(const ScalarBoundingBox3f &bbox) const {
+        ScalarBoundingBox3f result = segment_bbox(0, bbox);
+        for (uint32_t i = 1; i < segment_count(); ++i)
+            result.expand(segment_bbox(i, bbox));
+        return result;
+    }
+
+    /**
+     * \brief Decompose an affine transformation into a translation, a
+     * rotation, and an upper triangular scale/shear matrix
+     *
+     * This is a QR decomposition of the linear part. Reflections are
+     * represented by a negative scale along the Z axis.
+     */
+    static Keyframe decompose(const ScalarAffineTransform4f &transform) {
+        const auto &m = transform.matrix;
+        ScalarMatrix3f scale = dr::zeros<ScalarMatrix3f>();
+        ScalarVector3f q[3];
+
+        // Gram-Schmidt orthogonalization of the columns
+        for (size_t i = 0; i < 3; ++i) {
+            ScalarVector3f c(m(0, i), m(1, i), m(2, i)), v = c;
+            for (size_t j = 0; j < i; ++j) {
+                scale(j, i) = dr::dot(q[j], c);
+                v -= scale(j, i) * q[j];
+            }
+            scale(i, i) = dr::norm(v);
+            if (!(scale(i, i) > 0.f))
+                Throw("AnimatedTransform: cannot decompose a singular "
+                      "transformation!");
+            q[i] = v / scale(i, i);
+        }
+
+        if (dr::dot(dr::cross(q[0], q[1]), q[2]) < 0.f) {
+            q[2] = -q[2];
+            scale(2, 2) = -scale(2, 2);
+        }
+
+        ScalarMatrix3f rot;
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t j = 0; j < 3; ++j)
+                rot(j, i) = q[i][j];
+
+        return { scale, dr::matrix_to_quat(rot),
+                 ScalarVector3f(m(0, 3), m(1, 3), m(2, 3)) };
+    }
+
+    /// Inverse of \ref decompose()
+    template <typename Value>
+    static AffineTransform<Point<Value, 4>>
+    compose(const dr::Matrix<Value, 3> &scale, const dr::Quaternion<Value> &quat,
+            const Vector<Value, 3> &trans) {
+        using Matrix3 = dr::Matrix<Value, 3>;
+        using Matrix4 = dr::Matrix<Value, 4>;
+
+        Matrix3 m3 = dr::quat_to_matrix<Matrix3>(quat) * scale;
+        Matrix4 m  = dr::identity<Matrix4>();
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j)
+                m(i, j) = m3(i, j);
+            m(i, 3) = trans[i];
+        }
+        return AffineTransform<Point<Value, 4>>(m);
+    }
+
+private:
+    std::vector<ScalarAffineTransform4f> m_transforms;
+    std::vector<Keyframe> m_keyframes;
+    ScalarFloat m_time_start, m_time_end;
+};
+
+template <typename Float>
+std::ostream &operator<<(std::ostream &os, const AnimatedTransform<Float> &t) {
+    if (!t.is_animated())
+        return os << t.transform(0);
+    os << "AnimatedTransform[" << std::endl
+       << "  time_start = " << t.time_start() << "," << std::endl
+       << "  time_end = " << t.time_end() << "," << std::endl
+       << "  keyframes = [" << std::endl;
+    for (size_t i = 0; i < t.size(); ++i)
+        os << "    " << string::indent(t.transform(i), 4)
+           << (i + 1 < t.size() ? "," : "") << std::endl;
+    os << "  ]" << std::endl << "]";
+    return os;
+}
+
 
 #if defined(__GNUG__)
 #  pragma GCC diagnostic pop
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mitsuba/core/stream.h>
+#include <vector>
 
 extern "C" {
     struct z_stream_s;
@@ -68,6 +69,32 @@ public:
     //! @}
     // =========================================================================
 
+    // =========================================================================
+    //! @{ \name Block compression
+    // =========================================================================
+
+    /**
+     * \brief Compress a buffer into a self-contained ZLib block
+     *
+     * Unlike the streaming interface, this function keeps no state and may be
+     * called from several threads at once, e.g. to compress the independent
+     * blocks of a large array in parallel.
+     */
+    static std::vector<uint8_t> compress_block(const void *ptr, size_t size,
+                                               int level = -1);
+
+    /**
+     * \brief Decompress a block created by \ref compress_block()
+     *
+     * Throws an exception unless the block expands to exactly \c size bytes.
+     * Like \ref compress_block(), this function is thread-safe.
+     */
+    static void decompress_block(const void *src, size_t src_size, void *dst,
+                                 size_t size);
+
+    //! @}
+    // =========================================================================
+
     // =========================================================================
     //! @{ \name Implementation of the Stream interface
     // =========================================================================
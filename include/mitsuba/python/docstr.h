@@ -531,6 +531,14 @@ static const char *__doc_mi_float4_y = R"doc()doc";
 
 static const char *__doc_mi_float4_z = R"doc()doc";
 
+static const char *__doc_mitsuba_AccelQuality = R"doc(Build quality of the CPU ray tracing acceleration data structures)doc";
+
+static const char *__doc_mitsuba_AccelQuality_High = R"doc(Slowest build and fastest ray tracing)doc";
+
+static const char *__doc_mitsuba_AccelQuality_Low = R"doc(Fastest build at the cost of slower ray tracing (interactive use))doc";
+
+static const char *__doc_mitsuba_AccelQuality_Medium = R"doc(Compromise between build and ray tracing performance)doc";
+
 static const char *__doc_mitsuba_AdjointIntegrator = R"doc()doc";
 
 static const char *__doc_mitsuba_AdjointIntegrator_2 =
@@ -598,6 +606,14 @@ static const char *__doc_mitsuba_AdjointIntegrator_traverse_1_cb_ro = R"doc()doc
 
 static const char *__doc_mitsuba_AdjointIntegrator_traverse_1_cb_rw = R"doc()doc";
 
+static const char *__doc_mitsuba_AnimatedTransform =
+R"doc(Keyframed affine transformation for motion blur
+
+Each keyframe is decomposed into an upper triangular scale/shear
+matrix, a rotation quaternion, and a translation. These components are
+interpolated independently (the rotation spherically) for times
+between uniformly spaced keyframes.)doc";
+
 static const char *__doc_mitsuba_Any =
 R"doc(Type-erased storage for arbitrary objects
 
@@ -1247,6 +1263,26 @@ static const char *__doc_mitsuba_BaseSunskyEmitter = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_BaseSunskyEmitter = R"doc()doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_bake_sky =
+R"doc(Tabulates the sky radiance and builds a sampling warp proportional to
+it
+
+The sky is stored in an equirectangular map over the upper hemisphere,
+which eval() and the sky sampling routines then use instead of the
+analytic model. The sun is unaffected. Time-dependent skies are
+averaged over the given time interval. Subclasses must call this
+function whenever their sky datasets change. It does nothing unless
+the ``bake_sky`` parameter was set.
+
+Parameter ``time_start``:
+    Start of the time interval to average over
+
+Parameter ``time_end``:
+    End of the time interval to average over
+
+Parameter ``time_samples``:
+    Number of instants to average)doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_bbox =
 R"doc(This emitter does not occupy any particular region of space, return an
 invalid bounding box)doc";
@@ -1364,6 +1400,21 @@ Parameter ``sky_radiance``:
 Returns:
     Indirect sun illumination)doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_eval_sky_map =
+R"doc(Bilinearly interpolates the baked sky radiance
+
+Parameter ``local_wo``:
+    Direction in local space
+
+Parameter ``channel_idx``:
+    Indices of the queried channels
+
+Parameter ``active``:
+    Indicates which channels are valid indices
+
+Returns:
+    The sky radiance (not scaled by the sky scale))doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_eval_sky_pdf = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_eval_sun =
@@ -1519,20 +1570,32 @@ static const char *__doc_mitsuba_BaseSunskyEmitter_m_albedo = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_albedo_tex = R"doc()doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_m_bake_sky = R"doc(Indicates if the sky radiance is tabulated in m_sky_map)doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_bsphere = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_complex_sun = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_sampling_params = R"doc()doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_bake_error = R"doc(Relative L1 error of the baked sky with respect to the analytic model)doc";
+
+static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_bake_res = R"doc(Number of cells of the baked sky map along the elevation)doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_irrad_dataset = R"doc()doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_map =
+R"doc(Sky radiance at the vertices of the baked map, with interleaved
+channels)doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_params_dataset = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_rad_dataset = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_scale = R"doc()doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_m_sky_warp = R"doc(Sampling warp proportional to the luminance of the baked sky)doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_sun_half_aperture = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_m_sun_irrad_dataset = R"doc()doc";
@@ -1587,6 +1650,30 @@ Returns:
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_set_scene = R"doc()doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_sky_bake_outdated =
+R"doc(Indicates whether a parameter update invalidates the baked sky
+
+The sky and sun scales as well as the transform are applied on lookup,
+so that updating them does not require a new bake.)doc";
+
+static const char *__doc_mitsuba_BaseSunskyEmitter_sky_map_cells =
+R"doc(Number of cells of the baked sky map along the azimuth and the
+elevation)doc";
+
+static const char *__doc_mitsuba_BaseSunskyEmitter_sky_map_dir = R"doc(Inverse of sky_map_uv())doc";
+
+static const char *__doc_mitsuba_BaseSunskyEmitter_sky_map_uv =
+R"doc(Maps a local direction of the upper hemisphere to the unit square of
+the baked sky map)doc";
+
+static const char *__doc_mitsuba_BaseSunskyEmitter_sky_or_sun_up =
+R"doc(Indicates lanes where the emitter is visible, i.e. where the sun is up
+or the sky is baked)doc";
+
+static const char *__doc_mitsuba_BaseSunskyEmitter_sky_sampling_weight =
+R"doc(Probability of sampling the sky, which is the only choice for a baked
+sky at night)doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_sun_coordinates =
 R"doc(Compute the elevation and azimuth of the sun as seen by an observer at
 ``location`` at the date and time specified in ``dateTime``.
@@ -1609,6 +1696,31 @@ Returns:
     The cosine of the angle between the sun's radius and the viewing
     direction)doc";
 
+static const char *__doc_mitsuba_BaseSunskyEmitter_tabulate_sky =
+R"doc(Evaluates the analytic sky model on a regular grid over the
+coordinates of the baked sky map
+
+Parameter ``size``:
+    Number of grid points along each axis
+
+Parameter ``stride``:
+    Spacing of the grid points, in units of map cells
+
+Parameter ``offset``:
+    Offset of the grid points, in units of map cells
+
+Parameter ``time_start``:
+    Start of the time interval to average over
+
+Parameter ``time_end``:
+    End of the time interval to average over
+
+Parameter ``time_samples``:
+    Number of instants to average
+
+Returns:
+    The sky radiance of all channels, interleaved per grid point)doc";
+
 static const char *__doc_mitsuba_BaseSunskyEmitter_to_string = R"doc()doc";
 
 static const char *__doc_mitsuba_BaseSunskyEmitter_traverse = R"doc()doc";
@@ -1624,6 +1736,34 @@ PNG and OpenEXR files are optionally annotated with string-valued
 metadata, and the gamma setting can be stored as well. Please see the
 class methods and enumerations for further detail.)doc";
 
+static const char *__doc_mitsuba_BitmapStreamWriter =
+R"doc(Writes an OpenEXR file incrementally, one band of rows at a time
+
+This is useful for images that are too large to be held in memory as a
+whole: the producer hands over bands of rows (top to bottom) as soon as
+they are final, and only the current band needs to be resident. The
+bands must match the width, pixel format, component format, and
+channels of the ``layout`` bitmap given to the constructor, whose
+metadata is also stored in the file. The file is finished once all
+rows have been written, or when close() is called or the writer is
+destroyed.)doc";
+
+static const char *__doc_mitsuba_BitmapStreamWriter_BitmapStreamWriter =
+R"doc(Create an OpenEXR file with the given height, taking all other
+properties of the image from ``layout``)doc";
+
+static const char *__doc_mitsuba_BitmapStreamWriter_close = R"doc(Finish the file. Rows that have not been written are left empty.)doc";
+
+static const char *__doc_mitsuba_BitmapStreamWriter_filename = R"doc(Return the name of the file being written)doc";
+
+static const char *__doc_mitsuba_BitmapStreamWriter_height = R"doc(Return the height of the image)doc";
+
+static const char *__doc_mitsuba_BitmapStreamWriter_rows_written = R"doc(Return the number of rows written so far)doc";
+
+static const char *__doc_mitsuba_BitmapStreamWriter_to_string = R"doc(Return a human-readable summary)doc";
+
+static const char *__doc_mitsuba_BitmapStreamWriter_write = R"doc(Append the rows of ``band`` to the file)doc";
+
 static const char *__doc_mitsuba_Bitmap_AlphaTransform = R"doc(Type of alpha transformation)doc";
 
 static const char *__doc_mitsuba_Bitmap_AlphaTransform_Empty = R"doc(No transformation (default))doc";
@@ -4296,6 +4436,12 @@ the Image Block.)doc";
 
 static const char *__doc_mitsuba_FilmFlags_Spectral = R"doc(The film stores a spectral representation of the image)doc";
 
+static const char *__doc_mitsuba_FilmFlags_Streaming =
+R"doc(The film writes finished rows of the image to disk while rendering and
+only keeps the rows in flight in memory. It requires image blocks to be
+submitted in scanline order in a single pass, and the developed image
+is not available in memory.)doc";
+
 static const char *__doc_mitsuba_Film_Film = R"doc(Create a film)doc";
 
 static const char *__doc_mitsuba_Film_base_channels_count = R"doc(Return the number of channels for the developed image (excluding AOVs))doc";
@@ -4917,6 +5063,16 @@ Parameter ``values``:
 
 static const char *__doc_mitsuba_ImageBlock_put_block = R"doc(Accumulate another image block into this one)doc";
 
+static const char *__doc_mitsuba_ImageBlock_put_block_2 =
+R"doc(Accumulate a rectangular region of another image block into this one
+
+The region is specified in image-space pixel coordinates, i.e. in the
+same coordinate system as the block offsets, and parts of it that lie
+outside of either block (including borders) are ignored. Accumulating
+disjoint regions from several threads at the same time is safe in
+scalar variants, which allows a film to merge blocks without
+serializing on a single lock.)doc";
+
 static const char *__doc_mitsuba_ImageBlock_read =
 R"doc(Fetch a single sample or a wavefront of samples from the image block.
 
@@ -5461,6 +5617,75 @@ static const char *__doc_mitsuba_JitObject_m_id = R"doc(Stores the identifier of
 
 static const char *__doc_mitsuba_JitObject_set_id = R"doc(Set the identifier of this instance)doc";
 
+static const char *__doc_mitsuba_KDTreeBuildReport =
+R"doc(Summary of a kd-tree construction
+
+This record is filled in by every call to TShapeKDTree::build(),
+independently of the log level, and can be queried afterwards via
+TShapeKDTree::build_report(). Times are given in milliseconds. Wall-
+clock times refer to the thread calling ``build()``, while the binning
+and event sorting times are summed over all threads participating in
+the build.)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_bad_refines = R"doc(Number of splits whose cost exceeded that of a leaf node)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_binning_time = R"doc(Time spent in min-max binning and partitioning (summed over threads))doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_cached =
+R"doc(Whether the tree was loaded from an acceleration cache instead of
+being built
+
+Only the timings, primitive/index/node counts, and the duplication
+factor are available in this case.)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_compaction_time = R"doc(Wall-clock time needed to copy nodes and indices into compact arrays)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_construction_time = R"doc(Wall-clock time of the recursive top-down construction)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_cost = R"doc(Cost of the tree according to the construction heuristic)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_duplication_factor = R"doc(Average number of references per primitive (``index_count / primitive_count``))doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_event_sort_time = R"doc(Time spent creating and sorting edge event lists (summed over threads))doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_expected_leaf_visits = R"doc(Expected number of leaf node visits per query)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_expected_primitive_visits = R"doc(Expected number of primitive visits per query)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_expected_traversals = R"doc(Expected number of traversal steps per query)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_index_count = R"doc(Number of primitive references stored in the leaf nodes)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_leaf_count = R"doc(Number of leaf nodes)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_leaf_histogram = R"doc(Entry i counts the leaf nodes referencing i primitives)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_max_depth = R"doc(Maximum depth of a node)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_max_leaf_size = R"doc(Largest number of primitives referenced by a leaf node)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_node_count = R"doc(Total number of nodes)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_nonempty_leaf_count = R"doc(Number of leaf nodes that reference at least one primitive)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_primitive_count = R"doc(Number of primitives the tree was built from)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_pruned = R"doc(Number of primitives removed by clipping)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_retracted_splits = R"doc(Number of splits that were replaced by a leaf node again)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_statistics_time = R"doc(Wall-clock time needed to compute the statistics in this record)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_subtree_tasks = R"doc(Number of subtrees of the O(N log N) builder handed to separate tasks)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_temp_storage = R"doc(Temporary storage used by the build (in bytes))doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_to_string = R"doc(Return a human-readable summary)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_total_time = R"doc(Wall-clock time of the entire build)doc";
+
+static const char *__doc_mitsuba_KDTreeBuildReport_work_units = R"doc(Number of min-max binning steps)doc";
+
 static const char *__doc_mitsuba_Layout = R"doc(Content of the packed records of a Mesh)doc";
 
 static const char *__doc_mitsuba_Layout_FaceBSDFs = R"doc(< The face records carry per-face BSDF indices)doc";
@@ -5749,7 +5974,11 @@ static const char *__doc_mitsuba_MediumInteraction_labels = R"doc(//! @})doc";
 
 static const char *__doc_mitsuba_MediumInteraction_medium = R"doc(Pointer to the associated medium)doc";
 
-static const char *__doc_mitsuba_MediumInteraction_mint = R"doc(mint used when sampling the given distance ``t``)doc";
+static const char *__doc_mitsuba_MediumInteraction_mint =
+R"doc(Start of the free-flight segment used when sampling the given distance
+``t``, i.e., ``(t - mint) * combined_extinction`` is the sampled optical
+depth. Media with spatially varying majorants shift this value
+accordingly.)doc";
 
 static const char *__doc_mitsuba_MediumInteraction_name = R"doc(//! @})doc";
 
@@ -5828,7 +6057,11 @@ Parameter ``channel``:
 Returns:
     This method returns a MediumInteraction. The MediumInteraction
     will always be valid, except if the ray missed the Medium's
-    bounding box.)doc";
+    bounding box.
+
+The default implementation samples the distance using the single
+majorant returned by get_majorant(). Media with spatially varying
+majorants override this function.)doc";
 
 static const char *__doc_mitsuba_Medium_to_string = R"doc(Return a human-readable representation of the Medium)doc";
 
@@ -6330,6 +6563,8 @@ static const char *__doc_mitsuba_Mesh_face_normal = R"doc(Returns the normal dir
 
 static const char *__doc_mitsuba_Mesh_face_normal_2 = R"doc(Returns the normal direction of the face with index ``index``)doc";
 
+static const char *__doc_mitsuba_Mesh_face_records = R"doc(Return the packed face records, decoding them if they are quantized)doc";
+
 static const char *__doc_mitsuba_Mesh_faces = R"doc(Return the vertex index triplets as an ``(F, 3)`` tensor)doc";
 
 static const char *__doc_mitsuba_Mesh_find_attribute = R"doc(Return the mesh attribute ``name`` or NULL)doc";
@@ -6495,6 +6730,12 @@ conversions (e.g., spectral upsampling))doc";
 
 static const char *__doc_mitsuba_Mesh_invert_silhouette_sample = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_is_quantized =
+R"doc(Are the vertex records quantized?
+
+This is the case for meshes constructed with the ``quantize``
+property, see QuantizedMesh for the encoding.)doc";
+
 static const char *__doc_mitsuba_Mesh_is_vertex_attribute =
 R"doc(Does the attribute ``name`` live on the vertices rather than the
 faces?)doc";
@@ -6555,6 +6796,22 @@ representative vertex)doc";
 
 static const char *__doc_mitsuba_Mesh_m_positions = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_m_quantization_error = R"doc(See quantization_error())doc";
+
+static const char *__doc_mitsuba_Mesh_m_quantize = R"doc(Store the records in quantized form? (see quantize()))doc";
+
+static const char *__doc_mitsuba_Mesh_m_quantized_clusters = R"doc(Position offset and scale of each quantized vertex cluster)doc";
+
+static const char *__doc_mitsuba_Mesh_m_quantized_face_base = R"doc(Smallest vertex index of each quantized face cluster)doc";
+
+static const char *__doc_mitsuba_Mesh_m_quantized_faces =
+R"doc(Quantized face records (2 x UInt32 per face). Replaces m_packed_faces
+unless some face cluster overflowed.)doc";
+
+static const char *__doc_mitsuba_Mesh_m_quantized_vertices =
+R"doc(Quantized vertex records (4 x UInt32 per vertex). Replaces
+m_packed_vertices when the mesh is_quantized().)doc";
+
 static const char *__doc_mitsuba_Mesh_m_scene = R"doc(Pointer to the scene that owns this mesh)doc";
 
 static const char *__doc_mitsuba_Mesh_m_sil_dedge_pmf = R"doc(Sampling density of silhouette edges, null until sil_dedge_pmf())doc";
@@ -6639,7 +6896,9 @@ R"doc(Returns the packed vertex data for vertex index ``index``
 
 When ``detach`` is ``True``, the read is detached from the AD graph.)doc";
 
-static const char *__doc_mitsuba_Mesh_packed_vertices = R"doc(Return the packed per-vertex buffer)doc";
+static const char *__doc_mitsuba_Mesh_packed_vertices =
+R"doc(Return the packed per-vertex buffer, which is empty when the mesh
+is_quantized())doc";
 
 static const char *__doc_mitsuba_Mesh_packed_vertices_2 = R"doc(Const variant of packed_vertices.)doc";
 
@@ -6665,6 +6924,30 @@ static const char *__doc_mitsuba_Mesh_primitive_count = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_primitive_silhouette_projection = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_quantization_error =
+R"doc(Largest distance between a decoded position of a quantized mesh and
+its full-precision value)doc";
+
+static const char *__doc_mitsuba_Mesh_quantize =
+R"doc(Replace the packed records by their quantized encoding
+
+Called by refresh() when the mesh was constructed with the
+``quantize`` property. Each nonempty packed buffer is quantized and
+released, which also updates the bounding box when the vertex records
+change. Face records whose offsets exceed 16 bits stay unquantized.)doc";
+
+static const char *__doc_mitsuba_Mesh_quantized_cluster =
+R"doc(Gather the position offset and scale of the quantized vertex cluster
+containing the vertex ``index``)doc";
+
+static const char *__doc_mitsuba_Mesh_ray_intersect_preliminary = R"doc()doc";
+
+static const char *__doc_mitsuba_Mesh_ray_intersect_preliminary_packet = R"doc()doc";
+
+static const char *__doc_mitsuba_Mesh_ray_intersect_preliminary_packet_2 = R"doc()doc";
+
+static const char *__doc_mitsuba_Mesh_ray_intersect_preliminary_packet_3 = R"doc()doc";
+
 static const char *__doc_mitsuba_Mesh_ray_intersect_triangle = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_ray_intersect_triangle_impl =
@@ -6735,6 +7018,10 @@ The distribution excludes concave edges and flat surfaces. It depends
 on the vertex positions, so refresh() discards it and this accessor
 rebuilds it on the next use.)doc";
 
+static const char *__doc_mitsuba_Mesh_storage_size =
+R"doc(Number of bytes occupied by the vertex and face records, whether
+packed or quantized)doc";
+
 static const char *__doc_mitsuba_Mesh_surface_area = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_tangents = R"doc(Return the shading tangents as a ``(V, 3)`` tensor)doc";
@@ -6797,6 +7084,8 @@ The index type is generic because the host-side kd-tree paths
 one at a time with a plain ``uint32_t``, while the packet variants of
 ray_intersect_triangle() pass a ``dr::Packet``.)doc";
 
+static const char *__doc_mitsuba_Mesh_vertex_records = R"doc(Return the packed vertex records, decoding them if they are quantized)doc";
+
 static const char *__doc_mitsuba_Mesh_vertex_texcoord = R"doc(Returns the UV texture coordinates of the vertex with index ``index``)doc";
 
 static const char *__doc_mitsuba_Mesh_write_ply =
@@ -8678,6 +8967,46 @@ Mitsuba assigns a queried bit with every parameter. Unqueried
 parameters are detected to issue warnings, since this is usually
 indicative of typos.)doc";
 
+static const char *__doc_mitsuba_QuantizedMesh =
+R"doc(Quantized storage of the packed records of a Mesh
+
+Meshes constructed with the ``quantize`` property replace their packed
+records (MeshVertexStride floats per vertex and MeshFaceStride words
+per face) with the more compact encoding below, which Mesh decodes on
+the fly when it intersects rays or evaluates surface interactions.
+
+Vertices form clusters of QuantizedVertexCluster consecutive records.
+The positions of a cluster are stored as 16-bit fixed point values
+relative to its bounding box, the normal or shading frame as 16-bit
+signed normalized values, and the texture coordinates as half
+precision floats. Faces form clusters of QuantizedFaceCluster records,
+which store 16-bit offsets relative to the smallest vertex index of
+the cluster, along with the BSDF index and UV orientation bit.
+
+A quantized vertex record consists of the words ``(x | y << 16, z | f0
+<< 16, f1 | f2 << 16, u | v << 16)``, where ``f0..f2`` refer to the
+lanes at PackedFrameOffset, and a quantized face record of ``(d0 | d1
+<< 16, d2 | flags << 16)``.)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_bbox = R"doc(Bounding box of the decoded positions)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_clusters = R"doc(Offset and scale of the positions of each vertex cluster)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_face_base = R"doc(Smallest vertex index referenced by each face cluster)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_faces =
+R"doc(Quantized face records (QuantizedFaceStride words each). Empty when
+some face cluster spans more than 65536 vertices or a BSDF index does
+not fit into 15 bits.)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_memory = R"doc(Number of bytes occupied by the buffers above)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_position_error = R"doc(Largest distance between a decoded and the original position)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_texcoord_error = R"doc(Largest deviation of a decoded texture coordinate)doc";
+
+static const char *__doc_mitsuba_QuantizedMesh_vertices = R"doc(Quantized vertex records (QuantizedVertexStride words each))doc";
+
 static const char *__doc_mitsuba_RadicalInverse =
 R"doc(Efficient implementation of a radical inverse function with prime
 bases including scrambled versions.
@@ -9401,6 +9730,16 @@ static const char *__doc_mitsuba_SceneIR_top_blases = R"doc(Indices in blases th
 
 static const char *__doc_mitsuba_Scene_Scene = R"doc(Instantiate a scene from a Properties object)doc";
 
+static const char *__doc_mitsuba_Scene_accel_build_time =
+R"doc(Return the time spent on the most recent build or update of the
+acceleration data structure (in milliseconds))doc";
+
+static const char *__doc_mitsuba_Scene_accel_quality =
+R"doc(Return the build quality of the acceleration data structure
+
+This is the ``accel_quality`` scene parameter, with ``auto`` resolved
+based on the primitive and sample counts.)doc";
+
 static const char *__doc_mitsuba_Scene_bbox = R"doc(Return a bounding box surrounding the scene)doc";
 
 static const char *__doc_mitsuba_Scene_class_name = R"doc()doc";
@@ -9461,8 +9800,18 @@ Parameter ``ss``:
 Returns:
     The corresponding boundary sample space point)doc";
 
+static const char *__doc_mitsuba_Scene_kdtree_build_report =
+R"doc(Return statistics about the construction of the scene's kd-tree
+
+Returns ``nullptr`` unless the scene uses Mitsuba's builtin kd-tree
+(i.e. when Embree, OptiX, Metal, or the BVH are used instead).)doc";
+
 static const char *__doc_mitsuba_Scene_m_accel = R"doc(Backend-specific acceleration data structure state)doc";
 
+static const char *__doc_mitsuba_Scene_m_accel_build_time = R"doc()doc";
+
+static const char *__doc_mitsuba_Scene_m_accel_quality = R"doc()doc";
+
 static const char *__doc_mitsuba_Scene_m_bbox = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_children = R"doc()doc";
@@ -9483,6 +9832,8 @@ static const char *__doc_mitsuba_Scene_m_environment = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_integrator = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_m_needs_uv_partials = R"doc()doc";
+
 static const char *__doc_mitsuba_Scene_m_sensors = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_sensors_dr = R"doc()doc";
@@ -9503,6 +9854,11 @@ static const char *__doc_mitsuba_Scene_m_silhouette_shapes_dr = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_thread_reordering = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_needs_uv_partials =
+R"doc(Does any texture of the scene filter over the footprint given by the
+UV partials of a surface interaction? (see
+Texture::needs_uv_partials()))doc";
+
 static const char *__doc_mitsuba_Scene_parameters_changed = R"doc(Update internal state following a parameter update)doc";
 
 static const char *__doc_mitsuba_Scene_pdf_emitter =
@@ -10219,6 +10575,25 @@ static const char *__doc_mitsuba_SerializedFlags_SinglePrecision = R"doc()doc";
 
 static const char *__doc_mitsuba_Shape = R"doc()doc";
 
+static const char *__doc_mitsuba_ShapeDirtyFlags =
+R"doc(Describes how the geometry of a dirty shape changed
+
+The scene uses this information to update its acceleration data
+structure incrementally where possible (see Scene::parameters_changed()).)doc";
+
+static const char *__doc_mitsuba_ShapeDirtyFlags_Clean = R"doc(The geometry is unchanged)doc";
+
+static const char *__doc_mitsuba_ShapeDirtyFlags_Topology = R"doc(Any other change, which requires a full rebuild)doc";
+
+static const char *__doc_mitsuba_ShapeDirtyFlags_Transform =
+R"doc(Only the transformation of an instance changed. The top level of the
+acceleration data structure must be rebuilt.)doc";
+
+static const char *__doc_mitsuba_ShapeDirtyFlags_Vertices =
+R"doc(Vertex positions moved, while the number of primitives and their
+connectivity stayed the same. The bounds of the acceleration data
+structure can be refit.)doc";
+
 static const char *__doc_mitsuba_Shape_2 = R"doc(Forward declaration for `SilhouetteSample`)doc";
 
 static const char *__doc_mitsuba_Shape_3 = R"doc(Forward declaration for `SilhouetteSample`)doc";
@@ -10391,7 +10766,12 @@ static const char *__doc_mitsuba_ShapeKDTree_6 = R"doc()doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_ShapeKDTree =
 R"doc(Create an empty kd-tree and take build-related parameters from
-``props``.)doc";
+``props``.
+
+The ``quality`` selects defaults for these parameters: ``High`` runs
+the full SAH optimization with primitive clipping, ``Medium`` only
+uses the exact O(n log n) method for smaller nodes, and ``Low`` only
+uses Min-Max binning without clipping.)doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_add_shape = R"doc(Register a new shape with the kd-tree (to be called before build()))doc";
 
@@ -10399,12 +10779,26 @@ static const char *__doc_mitsuba_ShapeKDTree_bbox = R"doc(Return the bounding bo
 
 static const char *__doc_mitsuba_ShapeKDTree_bbox_2 = R"doc(Return the (clipped) bounding box of the i-th primitive)doc";
 
-static const char *__doc_mitsuba_ShapeKDTree_build = R"doc(Build the kd-tree)doc";
+static const char *__doc_mitsuba_ShapeKDTree_build =
+R"doc(Build the kd-tree
+
+When a cache directory was specified, a tree built earlier from the
+same geometry and parameters is memory-mapped from the cache instead.
+Otherwise, the newly built tree is added to the cache.)doc";
+
+static const char *__doc_mitsuba_ShapeKDTree_cache_dir = R"doc(Return the directory of the acceleration cache (empty if disabled))doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_class_name = R"doc()doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_clear = R"doc(Clear the kd-tree (build-related parameters remain))doc";
 
+static const char *__doc_mitsuba_ShapeKDTree_content_hash =
+R"doc(Compute a hash of everything the tree structure depends on
+
+This includes the build parameters and the bounds of all primitives.
+For meshes, the world-space positions of the triangle vertices are
+hashed instead, since primitive clipping depends on them.)doc";
+
 static const char *__doc_mitsuba_ShapeKDTree_find_shape =
 R"doc(Map an abstract TShapeKDTree primitive index to a specific shape
 managed by the ShapeKDTree.
@@ -10418,6 +10812,10 @@ R"doc(Check whether a primitive is intersected by the given ray.
 Some temporary space is supplied to store data that can later be used
 to create a detailed intersection record.)doc";
 
+static const char *__doc_mitsuba_ShapeKDTree_load_cache = R"doc(Try to memory-map a tree with the given hash from the cache directory)doc";
+
+static const char *__doc_mitsuba_ShapeKDTree_m_cache_dir = R"doc()doc";
+
 static const char *__doc_mitsuba_ShapeKDTree_m_primitive_map = R"doc()doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_m_shapes = R"doc()doc";
@@ -10438,6 +10836,8 @@ static const char *__doc_mitsuba_ShapeKDTree_shape_count = R"doc(Return the numb
 
 static const char *__doc_mitsuba_ShapeKDTree_to_string = R"doc(Return a human-readable string representation of the scene contents.)doc";
 
+static const char *__doc_mitsuba_ShapeKDTree_write_cache = R"doc(Write the tree to the cache directory)doc";
+
 static const char *__doc_mitsuba_ShapeType = R"doc(Shape type bit flags driving GPU intersection-function dispatch.)doc";
 
 static const char *__doc_mitsuba_ShapeType_BSplineCurve = R"doc(B-Spline curves (`bsplinecurve`))doc";
@@ -10594,6 +10994,8 @@ Returns:
 
 static const char *__doc_mitsuba_Shape_dirty = R"doc(Return whether the shape's geometry has changed)doc";
 
+static const char *__doc_mitsuba_Shape_dirty_flags = R"doc(Return how the shape's geometry has changed (see ShapeDirtyFlags))doc";
+
 static const char *__doc_mitsuba_Shape_effective_primitive_count =
 R"doc(Return the number of primitives (triangles, hairs, ..) contributed to
 the scene by this shape
@@ -10728,6 +11130,8 @@ static const char *__doc_mitsuba_Shape_m_bsdf = R"doc()doc";
 
 static const char *__doc_mitsuba_Shape_m_dirty = R"doc(True if the shape's geometry has changed)doc";
 
+static const char *__doc_mitsuba_Shape_m_dirty_flags = R"doc(How the shape's geometry has changed (see ShapeDirtyFlags))doc";
+
 static const char *__doc_mitsuba_Shape_m_discontinuity_types = R"doc()doc";
 
 static const char *__doc_mitsuba_Shape_m_emitter = R"doc()doc";
@@ -10752,7 +11156,11 @@ static const char *__doc_mitsuba_Shape_m_to_world = R"doc()doc";
 
 static const char *__doc_mitsuba_Shape_mark_as_instance = R"doc()doc";
 
-static const char *__doc_mitsuba_Shape_mark_dirty = R"doc(Mark that the shape's geometry has changed)doc";
+static const char *__doc_mitsuba_Shape_mark_dirty =
+R"doc(Mark that the shape's geometry has changed
+
+Changes accumulate until the scene updates its acceleration data
+structure. The default conservatively requests a full rebuild.)doc";
 
 static const char *__doc_mitsuba_Shape_parameters_changed = R"doc()doc";
 
@@ -10897,6 +11305,9 @@ This operation is used by the KDTree acceleration structure.
 Parameter ``ray``:
     The ray to be tested for an intersection
 
+Parameter ``prim_index``:
+    Index of the primitive to be intersected
+
 Returns:
     A tuple containing the following field: ``valid``, ``t``, ``uv``,
     ``shape_index``, ``prim_index``. The ``shape_index`` should be
@@ -11164,7 +11575,11 @@ static const char *__doc_mitsuba_Spiral_Direction_Up = R"doc()doc";
 
 static const char *__doc_mitsuba_Spiral_Spiral =
 R"doc(Create a new spiral generator for the given size, offset into a larger
-frame, and block size)doc";
+frame, and block size
+
+When ``scanline`` is set, the blocks are instead generated row by row
+from the top left, which streaming films rely on to write finished
+rows of the image to disk while rendering.)doc";
 
 static const char *__doc_mitsuba_Spiral_block_count = R"doc(Return the total number of blocks)doc";
 
@@ -11188,6 +11603,8 @@ static const char *__doc_mitsuba_Spiral_m_passes_left = R"doc()doc";
 
 static const char *__doc_mitsuba_Spiral_m_position = R"doc()doc";
 
+static const char *__doc_mitsuba_Spiral_m_scanline = R"doc()doc";
+
 static const char *__doc_mitsuba_Spiral_m_size = R"doc()doc";
 
 static const char *__doc_mitsuba_Spiral_m_spiral_size = R"doc()doc";
@@ -11948,6 +12365,8 @@ static const char *__doc_mitsuba_TShapeKDTree_bbox = R"doc(Return the bounding b
 
 static const char *__doc_mitsuba_TShapeKDTree_build = R"doc()doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_build_report = R"doc(Return statistics about the most recent call to build())doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_class_name = R"doc()doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_clip_primitives = R"doc(Return whether primitive clipping is used during tree construction)doc";
@@ -12012,7 +12431,7 @@ static const char *__doc_mitsuba_TShapeKDTree_set_clip_primitives = R"doc(Set wh
 static const char *__doc_mitsuba_TShapeKDTree_set_exact_primitive_threshold =
 R"doc(Specify the number of primitives, at which the builder will switch
 from (approximate) Min-Max binning to the accurate O(n log n)
-optimization method.)doc";
+optimization method. A value of zero disables the latter.)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_set_log_level = R"doc(Return the log level of kd-tree status messages)doc";
 
@@ -12079,6 +12498,70 @@ static const char *__doc_mitsuba_TensorFile_to_string = R"doc(Return a human-rea
 
 static const char *__doc_mitsuba_Texture = R"doc()doc";
 
+static const char *__doc_mitsuba_TextureCache = R"doc(Process-wide cache of TiledImage tiles with a memory budget
+
+Textures that reference images which do not fit into memory load tiles
+lazily through this cache. It is shared by all such textures and evicts
+the least recently used tiles once their total size exceeds the budget.
+To keep contention low when many threads render concurrently, the cache is
+split into independently locked shards that each receive an equal share of
+the budget.)doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics = R"doc(Counters describing the effectiveness of the cache)doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics_evictions = R"doc(Number of tiles released to stay within the budget)doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics_hits = R"doc(Number of tile requests served from memory)doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics_misses = R"doc(Number of tile requests that had to read from disk)doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics_memory = R"doc(Memory currently held by the cache (in bytes))doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics_peak_memory = R"doc(Largest amount of memory held by the cache so far (in bytes))doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics_tile_count = R"doc(Number of tiles currently held by the cache)doc";
+
+static const char *__doc_mitsuba_TextureCache_Statistics_to_string = R"doc(Return a human-readable summary)doc";
+
+static const char *__doc_mitsuba_TextureCache_budget = R"doc(Return the memory budget (in bytes))doc";
+
+static const char *__doc_mitsuba_TextureCache_clear = R"doc(Release all tiles (open files are kept))doc";
+
+static const char *__doc_mitsuba_TextureCache_close =
+R"doc(Release a handle obtained from open()
+
+Once all handles of an image are released, the cache forgets the image
+and drops its tiles.)doc";
+
+static const char *__doc_mitsuba_TextureCache_open = R"doc(Return a handle to the given OpenEXR file
+
+Repeated calls with the same file return the same instance, so that
+all textures referencing it share its tiles. Files are identified by
+their path, modification time, and size, hence a file that changed on
+disk is opened again. Every call must be paired with close().)doc";
+
+static const char *__doc_mitsuba_TextureCache_reset_statistics = R"doc(Reset the hit, miss, and eviction counters and the peak memory)doc";
+
+static const char *__doc_mitsuba_TextureCache_set_budget = R"doc(Set the memory budget (in bytes, default: 2 GiB))doc";
+
+static const char *__doc_mitsuba_TextureCache_static_initialization = R"doc()doc";
+
+static const char *__doc_mitsuba_TextureCache_static_shutdown = R"doc()doc";
+
+static const char *__doc_mitsuba_TextureCache_statistics = R"doc(Return the current statistics)doc";
+
+static const char *__doc_mitsuba_TextureCache_tile = R"doc(Return the given tile of an image (see TiledImage::tile()))doc";
+
+static const char *__doc_mitsuba_TextureTile = R"doc(Rectangular block of texels of a TiledImage)doc";
+
+static const char *__doc_mitsuba_TextureTile_channel_count = R"doc(Number of interleaved channels)doc";
+
+static const char *__doc_mitsuba_TextureTile_data = R"doc(Float32 texels in scanline order, with interleaved channels)doc";
+
+static const char *__doc_mitsuba_TextureTile_memory = R"doc(Number of bytes occupied by the tile)doc";
+
+static const char *__doc_mitsuba_TextureTile_size = R"doc(Resolution of the tile (tiles at the right/bottom edge may be smaller))doc";
+
 static const char *__doc_mitsuba_Texture_2 =
 R"doc(Base class of all surface texture implementations
 
@@ -12181,6 +12664,11 @@ default implementation throws an exception.
 Even if the operation is provided, it may only return an
 approximation.)doc";
 
+static const char *__doc_mitsuba_Texture_needs_uv_partials =
+R"doc(Does this texture filter over the footprint given by the UV partials of
+the surface interaction? Integrators only compute these partials when
+some texture of the scene requests them.)doc";
+
 static const char *__doc_mitsuba_Texture_pdf_position = R"doc(Returns the probability per unit area of sample_position())doc";
 
 static const char *__doc_mitsuba_Texture_pdf_spectrum =
@@ -12292,6 +12780,52 @@ static const char *__doc_mitsuba_Thread_thread = R"doc(Return the current thread
 
 static const char *__doc_mitsuba_Thread_wait_for_tasks = R"doc(Wait for previously registered nanothread tasks to complete)doc";
 
+static const char *__doc_mitsuba_TiledImage = R"doc(OpenEXR image whose texels are read on demand, one tile at a time
+
+Tiled OpenEXR files are read tile by tile. If the file stores a MIP map
+(or RIP map, of which only the isotropic levels are used), its levels are
+exposed as well. Scanline files consist of a single level and are split
+into strips of scanline_tile_height rows.
+
+Only luminance (``Y``) and RGB images are supported; other channels such as
+alpha are ignored. Texels are converted to single precision on load.
+
+Instances should be obtained from TextureCache::open(), which shares
+them between all users of the same file. Tiles returned by tile() are
+then held by the process-wide TextureCache.)doc";
+
+static const char *__doc_mitsuba_TiledImage_TiledImage = R"doc(Open the given OpenEXR file and read its header)doc";
+
+static const char *__doc_mitsuba_TiledImage_channel_count = R"doc(Return the number of channels (1 or 3))doc";
+
+static const char *__doc_mitsuba_TiledImage_class_name = R"doc()doc";
+
+static const char *__doc_mitsuba_TiledImage_d = R"doc()doc";
+
+static const char *__doc_mitsuba_TiledImage_filename = R"doc(Return the name of the underlying file)doc";
+
+static const char *__doc_mitsuba_TiledImage_id = R"doc(Identifier of this image within the texture cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_level_count = R"doc(Return the number of MIP map levels (1 if the file has none))doc";
+
+static const char *__doc_mitsuba_TiledImage_m_id = R"doc()doc";
+
+static const char *__doc_mitsuba_TiledImage_read_tile = R"doc(Read the given tile from disk, bypassing the cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_size = R"doc(Return the resolution of the given level)doc";
+
+static const char *__doc_mitsuba_TiledImage_tile = R"doc(Return the given tile, reading it from disk if it is not
+resident in the TextureCache
+
+The returned pointer remains valid even if the cache evicts the tile in
+the meantime. This function can safely be called from multiple threads.)doc";
+
+static const char *__doc_mitsuba_TiledImage_tile_count = R"doc(Return the number of tiles along each axis of the given level)doc";
+
+static const char *__doc_mitsuba_TiledImage_tile_size = R"doc(Return the (maximum) resolution of a tile)doc";
+
+static const char *__doc_mitsuba_TiledImage_to_string = R"doc(Return a human-readable summary)doc";
+
 static const char *__doc_mitsuba_Timer = R"doc()doc";
 
 static const char *__doc_mitsuba_Timer_Timer = R"doc()doc";
@@ -12646,6 +13180,23 @@ R"doc(Write an encoded form of the volume grid to a stream
 Parameter ``stream``:
     Target stream that will receive the encoded output)doc";
 
+static const char *__doc_mitsuba_VolumeGrid_write_sparse =
+R"doc(Write the volume grid to a bricked sparse volume file
+
+The grid is split into dense bricks of ``brick_size^3`` voxels (8 or
+16), and bricks whose voxels are all zero are omitted. Such files are
+read by the ``sparsegridvolume`` plugin, whose documentation specifies
+the format.
+
+Parameter ``path``:
+    Target file name
+
+Parameter ``brick_size``:
+    Number of voxels along each side of a brick)doc";
+
+static const char *__doc_mitsuba_VolumeGrid_write_sparse_2 =
+R"doc(Write the volume grid to a stream using the bricked sparse format)doc";
+
 static const char *__doc_mitsuba_Volume_Volume = R"doc()doc";
 
 static const char *__doc_mitsuba_Volume_bbox = R"doc(Returns the bounding box of the volume)doc";
@@ -12692,6 +13243,17 @@ static const char *__doc_mitsuba_Volume_m_to_local = R"doc(Used to bring points
 
 static const char *__doc_mitsuba_Volume_max = R"doc(Returns the maximum value of the volume over all dimensions.)doc";
 
+static const char *__doc_mitsuba_Volume_max_grid =
+R"doc(Compute upper bounds of the volume over the cells of a coarse grid
+
+The grid of resolution ``res`` subdivides the unit cube of the volume's
+local coordinate system. Entry ``(z * res.y() + y) * res.x() + x`` of
+``out`` receives an upper bound of the values returned by eval() and
+eval_1() anywhere within cell ``(x, y, z)``, accounting for
+interpolation. The default implementation fills the grid with max().
+
+Pointer allocation/deallocation must be performed by the caller.)doc";
+
 static const char *__doc_mitsuba_Volume_max_per_channel =
 R"doc(In the case of a multi-channel volume, this function returns the
 maximum value for each channel.
@@ -12704,6 +13266,8 @@ discrete representation.
 
 The default implementation returns ``(1, 1, 1)``)doc";
 
+static const char *__doc_mitsuba_Volume_to_local = R"doc(Returns the transformation from world space into the volume's unit cube)doc";
+
 static const char *__doc_mitsuba_Volume_to_string = R"doc(Returns a human-reable summary)doc";
 
 static const char *__doc_mitsuba_Volume_traverse_1_cb_ro = R"doc()doc";
@@ -12926,6 +13490,16 @@ static const char *__doc_mitsuba_detail_ConcurrentVector_reserve = R"doc()doc";
 
 static const char *__doc_mitsuba_detail_ConcurrentVector_size = R"doc()doc";
 
+static const char *__doc_mitsuba_detail_KDStorageDeleter =
+R"doc(Deleter for the node and index arrays of a kd-tree
+
+The arrays are either allocated by the tree itself or reside within a
+memory-mapped cache file, which is then kept alive by ``mapping``.)doc";
+
+static const char *__doc_mitsuba_detail_KDStorageDeleter_mapping = R"doc()doc";
+
+static const char *__doc_mitsuba_detail_KDStorageDeleter_operator_call = R"doc()doc";
+
 static const char *__doc_mitsuba_detail_Log = R"doc()doc";
 
 static const char *__doc_mitsuba_detail_OrderedChunkAllocator =
@@ -13158,6 +13732,10 @@ static const char *__doc_mitsuba_filesystem_is_regular_file =
 R"doc(Checks if ``p`` points to a regular file, as opposed to a directory or
 symlink.)doc";
 
+static const char *__doc_mitsuba_filesystem_last_write_time =
+R"doc(Returns the time of the last modification of the file at ``p`` (in
+seconds since the epoch). Symlinks are followed.)doc";
+
 static const char *__doc_mitsuba_filesystem_path =
 R"doc(Represents a path to a filesystem resource. On construction, the path
 is parsed and stored in a system-agnostic representation. The path can
@@ -14185,6 +14763,10 @@ such as how to handle unused parameters and other validation settings.)doc";
 
 static const char *__doc_mitsuba_parser_ParserConfig_ParserConfig = R"doc(Constructor that takes variant name)doc";
 
+static const char *__doc_mitsuba_parser_ParserConfig_dedup_geometry =
+R"doc(Replace shapes that load identical mesh files by instances of a
+shared shape group (disabled by default))doc";
+
 static const char *__doc_mitsuba_parser_ParserConfig_max_include_depth = R"doc(Maximum include depth to prevent infinite recursion)doc";
 
 static const char *__doc_mitsuba_parser_ParserConfig_merge_equivalent = R"doc(Enable merging of identical plugin instances (e.g., materials))doc";
@@ -14372,7 +14954,8 @@ R"doc(Apply all transformations in sequence
 This convenience function applies all parser transformations to the
 scene graph in the following order: 1. transform_upgrade() 2.
 transform_resolve() 3. transform_merge_equivalent() (if
-config.merge_equivalent is enabled) 4. transform_merge_meshes() (if
+config.merge_equivalent is enabled) 4. transform_dedup_geometry() (if
+config.dedup_geometry is enabled) 5. transform_merge_meshes() (if
 config.merge_meshes is enabled)
 
 Parameter ``config``:
@@ -14381,6 +14964,35 @@ Parameter ``config``:
 Parameter ``state``:
     Parser state to transform (modified in-place))doc";
 
+static const char *__doc_mitsuba_parser_transform_dedup_geometry =
+R"doc(Share the geometry of shapes that load identical mesh files
+
+Scenes assembled from asset libraries often load the same mesh many
+times, either from one file referenced under different IDs or from
+byte-identical copies of a file. This transformation detects such
+duplicates among the top-level ``ply``, ``obj``, and ``serialized``
+shapes by hashing the contents of their files (matches are confirmed
+byte by byte) and comparing their remaining properties, except for
+``to_world``.
+
+Each set of duplicates is replaced by a single ``shapegroup`` holding
+one copy of the shape, and every original shape turns into an
+``instance`` of that group with the original transform and ID. The
+mesh is thus loaded and stored once, and the acceleration data
+structure is built once per group. The amount of mesh file data that
+no longer needs to be loaded is logged.
+
+Shapes that are emitters or sensors, or that are referenced more than
+once, cannot be instanced and are left unchanged. Since instanced
+geometry cannot be differentiated, this transformation is disabled by
+default (see ParserConfig::dedup_geometry).
+
+Parameter ``config``:
+    Parser configuration (currently unused)
+
+Parameter ``state``:
+    Parser state to modify in-place)doc";
+
 static const char *__doc_mitsuba_parser_transform_merge_equivalent =
 R"doc(Merge equivalent nodes to reduce memory usage and instantiation time
 
@@ -14688,6 +15300,32 @@ Returns:
     A tuple (nodes, weights) storing the nodes and weights of the
     quadrature rule.)doc";
 
+static const char *__doc_mitsuba_quantize_packed_mesh =
+R"doc(Quantize the packed vertex and face records of a mesh
+
+Either record array may be null, in which case the corresponding
+fields of the result stay empty. See QuantizedMesh for the encoding,
+which the decoding helpers quantized_position(), quantized_snorm(),
+quantized_half(), and quantized_face() invert.)doc";
+
+static const char *__doc_mitsuba_quantized_face =
+R"doc(Decode a quantized face record into the words of a packed face record,
+given the smallest vertex index ``base`` of its cluster)doc";
+
+static const char *__doc_mitsuba_quantized_half = R"doc(Decode the half precision float stored in the lower half of ``w``)doc";
+
+static const char *__doc_mitsuba_quantized_position =
+R"doc(Decode a position from the first two words of a quantized vertex
+record, given the ``offset`` and ``scale`` of its cluster)doc";
+
+static const char *__doc_mitsuba_quantized_snorm =
+R"doc(Decode a 16-bit signed normalized value stored in the upper half of
+``w``)doc";
+
+static const char *__doc_mitsuba_quantized_vertex =
+R"doc(Decode the words ``w`` of a quantized vertex record into a packed
+vertex record, given the ``offset`` and ``scale`` of its cluster)doc";
+
 static const char *__doc_mitsuba_radical_inverse_2 = R"doc(Van der Corput radical inverse in base 2)doc";
 
 static const char *__doc_mitsuba_reduce_bbox =
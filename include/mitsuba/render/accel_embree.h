@@ -29,6 +29,8 @@ struct EmbreeAccel {
     // --- Lifecycle (bodies in scene_embree.inl) ---
     void init(Scene<Float, Spectrum> *scene, const Properties &props);
     void rebuild(Scene<Float, Spectrum> *scene);
+    /// Refit moved meshes and re-place moved instances (see ShapeDirtyFlags)
+    void update(Scene<Float, Spectrum> *scene);
     void release();
 
     static void static_initialization() { }
@@ -54,6 +56,12 @@ struct EmbreeAccel {
     RTCSceneTy *accel = nullptr;
     std::vector<int> geometries;
     bool is_nested_scene = false;
+    /// Scenes were switched to Embree's two-level mode by \ref update()
+    bool is_dynamic = false;
+    /// Whether any instance is motion-blurred, and the time range shared by
+    /// all such instances (ray times are clamped to it)
+    bool has_motion = false;
+    float motion_range[2] = { 0.f, 1.f };
     /// One nested Embree scene per ShapeGroup, shared by its Instances.
     tsl::robin_map<const void *, RTCSceneTy *, PointerHasher> group_scenes;
     /// Width-specialized Embree entry points.
@@ -1,5 +1,5 @@
 /*
-   accel_native.h -- Builtin kd-tree acceleration backend declarations.
+   accel_native.h -- Builtin kd-tree/BVH acceleration backend declarations.
 */
 
 #pragma once
@@ -12,8 +12,9 @@
 NAMESPACE_BEGIN(mitsuba)
 
 template <typename Float, typename Spectrum> class ShapeKDTree;
+template <typename Float, typename Spectrum> class ShapeBVH;
 
-/// Vectorized CPU ray tracing acceleration via Mitsuba's builtin kd-tree.
+/// Vectorized CPU ray tracing acceleration via Mitsuba's builtin kd-tree or BVH.
 template <typename Float, typename Spectrum>
 struct NativeAccel {
     MI_IMPORT_TYPES(Shape, ShapePtr)
@@ -25,6 +26,8 @@ struct NativeAccel {
     // --- Lifecycle (bodies in scene_native.inl) ---
     void init(Scene<Float, Spectrum> *scene, const Properties &props);
     void rebuild(Scene<Float, Spectrum> *scene);
+    /// Refit the BVH to moved geometry (the kd-tree is rebuilt instead)
+    void update(Scene<Float, Spectrum> *scene);
     void release();
 
     static void static_initialization() { }
@@ -37,18 +40,25 @@ struct NativeAccel {
         Mask active) const;
     Mask ray_test(const Scene<Float, Spectrum> *scene, const Ray3f &ray,
                   Mask coherent, Mask active) const;
-    /// The kd-tree supports a genuine brute-force traversal (used by tests).
+    /// The native structures support a genuine brute-force traversal (used by tests).
     SurfaceInteraction3f ray_intersect_naive(
         const Scene<Float, Spectrum> *scene, const Ray3f &ray,
         Mask active) const;
 
+    /// Invoke ``func`` with whichever native acceleration structure is active
+    template <typename Func> auto visit_tree(Func &&func) const {
+        return bvh ? func(bvh) : func(accel);
+    }
+
     // --- Declarative traversal ---
     DRJIT_TRAVERSE(NativeAccel, accel_handle, func_handle,
                    occlude_handle, shapes_registry_ids)
 
     /// Native kd-tree, lifetime tied to ``accel_handle`` in JIT variants.
     ShapeKDTree<Float, Spectrum> *accel = nullptr;
-    /// Width-specialized kd-tree entry points.
+    /// Native BVH (``accel="bvh"``), used instead of the kd-tree when set.
+    ShapeBVH<Float, Spectrum> *bvh = nullptr;
+    /// Width-specialized kd-tree/BVH entry points.
     void *func_ptr = nullptr;
     void *occlude_func_ptr = nullptr;
 
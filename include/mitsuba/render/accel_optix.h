@@ -26,6 +26,8 @@ struct OptixAccel {
     // --- Lifecycle (bodies in scene_optix.inl) ---
     void init(Scene<Float, Spectrum> *scene, const Properties &props);
     void rebuild(Scene<Float, Spectrum> *scene);
+    /// No incremental path: dirty geometry is rebuilt by \ref rebuild()
+    void update(Scene<Float, Spectrum> *scene) { rebuild(scene); }
     void release();
 
     static void static_initialization() { }
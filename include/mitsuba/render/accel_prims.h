@@ -0,0 +1,270 @@
+/*
+    accel_prims.h -- Shape and primitive bookkeeping shared by the builtin
+    CPU acceleration data structures (kd-tree and BVH).
+*/
+
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/mesh.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Result of a packet traversal through a builtin acceleration data structure
+template <typename FloatP> struct PacketIntersection {
+    using MaskP   = dr::mask_t<FloatP>;
+    using UInt32P = dr::uint32_array_t<FloatP>;
+
+    /// Lanes that found an intersection
+    MaskP valid = false;
+    /// Distance to the intersection (infinity for lanes without a hit)
+    FloatP t = dr::Infinity<FloatP>;
+    /// Barycentric coordinates of the intersection
+    Point<FloatP, 2> prim_uv = 0.f;
+    /// Primitive index within the intersected shape
+    UInt32P prim_index = 0;
+    /// Index of the intersected shape (within the instanced group for
+    /// instance hits)
+    UInt32P shape_index = 0;
+    /// Shape index of the intersected instance, or \c (uint32_t) -1
+    UInt32P instance_index = (uint32_t) -1;
+};
+
+/**
+ * \brief Flat list of shapes and primitives traced by the builtin CPU
+ * acceleration data structures
+ *
+ * The primitives of all registered shapes are numbered consecutively, so that
+ * an acceleration data structure only needs to store a single 32-bit index
+ * per primitive reference. \ref find_shape() maps such an index back to the
+ * shape and its local primitive index, and \ref intersect_prim() and \ref
+ * intersect_prim_packet() implement the corresponding ray-primitive tests.
+ */
+template <typename Float, typename Spectrum> class AccelPrimitives {
+public:
+    MI_IMPORT_TYPES(Shape, Mesh)
+
+    using ScalarRay3f = Ray<ScalarPoint3f, Spectrum>;
+    using Size        = uint32_t;
+    using Index       = uint32_t;
+
+    AccelPrimitives() { m_primitive_map.push_back(0); }
+
+    /// Return the number of registered shapes
+    Size shape_count() const { return Size(m_shapes.size()); }
+
+    /// Return the number of registered primitives
+    Size primitive_count() const { return m_primitive_map.back(); }
+
+    /// Return the i-th shape (const version)
+    const Shape *shape(size_t i) const { Assert(i < m_shapes.size()); return m_shapes[i]; }
+
+    /// Return the i-th shape
+    Shape *shape(size_t i) { Assert(i < m_shapes.size()); return m_shapes[i]; }
+
+    /// Return the bounding box of the i-th primitive
+    MI_INLINE ScalarBoundingBox3f bbox(Index i) const {
+        Index shape_index = find_shape(i);
+        return m_shapes[shape_index]->bbox(i);
+    }
+
+    /// Return the (clipped) bounding box of the i-th primitive
+    MI_INLINE ScalarBoundingBox3f bbox(Index i, const ScalarBoundingBox3f &clip) const {
+        Index shape_index = find_shape(i);
+        return m_shapes[shape_index]->bbox(i, clip);
+    }
+
+    /**
+     * \brief Check whether a packet of rays is coherent enough for packet
+     * traversal
+     *
+     * This requires at least two active lanes, whose directions must all lie
+     * in the same octant so that they agree on the near/far order at every
+     * inner node.
+     */
+    template <typename Vector3fP, typename MaskP>
+    static bool is_coherent(const Vector3fP &d, const MaskP &active) {
+        if (dr::count(active) < 2)
+            return false;
+        for (size_t i = 0; i < 3; ++i) {
+            MaskP negative = d[i] < 0.f;
+            if (dr::any(active && negative) && dr::any(active && !negative))
+                return false;
+        }
+        return true;
+    }
+
+    /// Brute force intersection routine for debugging purposes
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection3f
+    ray_intersect_naive(Ray3f ray, Mask active) const {
+        if constexpr (!dr::is_array_v<Float>) {
+            PreliminaryIntersection3f pi = dr::zeros<PreliminaryIntersection3f>();
+
+            for (Size i = 0; i < primitive_count(); ++i) {
+                PreliminaryIntersection3f prim_pi = intersect_prim<ShadowRay>(i, ray);
+
+                if constexpr (dr::is_array_v<Float>) {
+                    dr::masked(pi, prim_pi.is_valid()) = prim_pi;
+                } else if (prim_pi.is_valid()) {
+                    pi = prim_pi;
+                    ray.maxt = prim_pi.t;
+                }
+
+                if (ShadowRay && dr::all(pi.is_valid() || !active))
+                    break;
+            }
+
+            return pi;
+        } else {
+            Throw("ray_intersect_naive(): only supported in scalar variants");
+        }
+    }
+
+protected:
+    /// Append the primitives of \c shape to the list
+    void add_primitives(Shape *shape) {
+        m_primitive_map.push_back(m_primitive_map.back() +
+                                  shape->primitive_count());
+        m_shapes.push_back(shape);
+    }
+
+    /// Remove all shapes
+    void clear_primitives() {
+        m_shapes.clear();
+        m_primitive_map.clear();
+        m_primitive_map.push_back(0);
+    }
+
+    /**
+     * \brief Map an abstract primitive index to a specific registered shape
+     *
+     * The function returns the shape index and updates the \a idx parameter to
+     * point to the primitive index (e.g. triangle ID) within the shape.
+     */
+    MI_INLINE Index find_shape(Index &i) const {
+        Assert(i < primitive_count());
+
+        Index shape_index = math::find_interval<Index>(
+            Size(m_primitive_map.size()),
+            [&](Index k) DRJIT_INLINE_LAMBDA {
+                return m_primitive_map[k] <= i;
+            }
+        );
+
+        Assert(shape_index < shape_count() &&
+               m_primitive_map.size() == shape_count() + 1);
+
+        Assert(i >= m_primitive_map[shape_index]);
+        Assert(i <  m_primitive_map[shape_index + 1]);
+        i -= m_primitive_map[shape_index];
+
+        return shape_index;
+    }
+
+    /**
+     * \brief Check whether a primitive is intersected by the given ray.
+     *
+     * Some temporary space is supplied to store data that can later be used to
+     * create a detailed intersection record.
+     */
+    template <bool ShadowRay = false>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
+    intersect_prim(Index prim_index, const ScalarRay3f &ray) const {
+        Index shape_index  = find_shape(prim_index);
+        const Shape *shape = this->shape(shape_index);
+        const Mesh *mesh = (const Mesh *) shape;
+
+        PreliminaryIntersection<ScalarFloat, Shape> pi;
+
+        if constexpr (ShadowRay) {
+            bool hit;
+            if (shape->is_mesh()) {
+                hit = std::get<0>(
+                    mesh->ray_intersect_triangle_scalar(prim_index, ray));
+            } else {
+                hit = shape->ray_test_scalar(ray, prim_index);
+            }
+            pi.valid = hit;
+            pi.t = dr::select(hit, ScalarFloat(0), dr::Infinity<ScalarFloat>);
+        } else {
+            uint32_t inst_index = (uint32_t) -1;
+            if (shape->is_mesh()) {
+                std::tie(pi.valid, pi.t, pi.prim_uv) =
+                    mesh->ray_intersect_triangle_scalar(prim_index, ray);
+            } else {
+                std::tie(pi.valid, pi.t, pi.prim_uv, inst_index, prim_index) =
+                    shape->ray_intersect_preliminary_scalar(ray, prim_index);
+            }
+            pi.prim_index = prim_index;
+
+            bool hit_inst  = (inst_index != (uint32_t) -1);
+            pi.shape       = hit_inst ? (const Shape *) (size_t) shape_index : shape; // shape_index for LLVM + kdtree
+            pi.instance    = hit_inst ? shape : nullptr;
+            pi.shape_index = hit_inst ? inst_index : shape_index;
+        }
+
+        return pi;
+    }
+
+    /**
+     * \brief Packet version of \ref intersect_prim()
+     *
+     * Tests the primitive against all active lanes of \c ray and merges
+     * closer hits into \c pi, shortening \c ray.maxt accordingly.
+     */
+    template <bool ShadowRay, typename FloatP>
+    MI_INLINE void
+    intersect_prim_packet(Index prim_index, Ray<Point<FloatP, 3>, Spectrum> &ray,
+                          const dr::mask_t<FloatP> &active,
+                          PacketIntersection<FloatP> &pi) const {
+        using MaskP   = dr::mask_t<FloatP>;
+        using UInt32P = dr::uint32_array_t<FloatP>;
+
+        Index shape_index  = find_shape(prim_index);
+        const Shape *shape = this->shape(shape_index);
+
+        MaskP hit;
+        FloatP t;
+        Point<FloatP, 2> prim_uv;
+        UInt32P inst_index = (uint32_t) -1,
+                hit_prim   = prim_index;
+
+        if (shape->is_mesh()) {
+            std::tie(hit, t, prim_uv) =
+                ((const Mesh *) shape)
+                    ->template ray_intersect_triangle_broadcast<FloatP>(
+                        prim_index, ray, active);
+        } else if constexpr (ShadowRay) {
+            hit = shape->ray_test_packet(ray, prim_index, active);
+        } else {
+            std::tie(hit, t, prim_uv, inst_index, hit_prim) =
+                shape->ray_intersect_preliminary_packet(ray, prim_index, active);
+        }
+        hit &= active;
+
+        if constexpr (ShadowRay) {
+            pi.valid |= hit;
+        } else {
+            MaskP hit_inst = inst_index != (uint32_t) -1;
+            pi.valid |= hit;
+            dr::masked(pi.t, hit)          = t;
+            dr::masked(pi.prim_uv, hit)    = prim_uv;
+            dr::masked(pi.prim_index, hit) = hit_prim;
+            dr::masked(pi.shape_index, hit) =
+                dr::select(hit_inst, inst_index, UInt32P(shape_index));
+            dr::masked(pi.instance_index, hit) =
+                dr::select(hit_inst, UInt32P(shape_index), UInt32P((uint32_t) -1));
+            dr::masked(ray.maxt, hit) = t;
+        }
+    }
+
+protected:
+    std::vector<ref<Shape>> m_shapes;
+    std::vector<Size> m_primitive_map;
+};
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/render/accel_prims.h>
+
+/// Compile-time BVH depth limit to enable traversal with stack memory
+#define MI_BVH_MAXDEPTH 64u
+
+/**
+ * Beyond this depth, the BVH builder switches from SAH to object-median
+ * splits, which bounds the depth of the remaining subtree by log2(N)
+ */
+#define MI_BVH_MEDIAN_DEPTH 32u
+
+/// Subtrees with more primitives than this are built in parallel
+#define MI_BVH_GRAIN_SIZE 10240u
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Bounding volume hierarchy over the shapes of a scene
+ *
+ * This class is an alternative to \ref ShapeKDTree that can be selected via
+ * the ``accel`` scene property. It is built top-down using the surface area
+ * heuristic evaluated over a small number of centroid bins, which runs in
+ * linear time per tree level and, unlike the kd-tree, never duplicates
+ * primitive references. This makes it considerably faster to build and
+ * smaller in memory on large triangle meshes, at a somewhat higher tracing
+ * cost.
+ *
+ * The tree is binary and each node fits into 32 bytes: a single precision
+ * bounding box (rounded outward in double precision variants), together with
+ * either the index of the node's first child or the primitive range of a
+ * leaf. Ray-primitive tests are shared with the kd-tree (see \ref
+ * AccelPrimitives).
+ */
+template <typename Float, typename Spectrum>
+class MI_EXPORT_LIB ShapeBVH : public Object, public AccelPrimitives<Float, Spectrum> {
+public:
+    MI_IMPORT_TYPES(Shape, Mesh)
+
+    using ScalarRay3f = Ray<ScalarPoint3f, Spectrum>;
+    using Prims       = AccelPrimitives<Float, Spectrum>;
+    using Size        = uint32_t;
+    using Index       = uint32_t;
+
+    using Prims::bbox;
+    using Prims::shape;
+    using Prims::shape_count;
+    using Prims::primitive_count;
+    using Prims::is_coherent;
+    using Prims::ray_intersect_naive;
+
+    /**
+     * \brief Create an empty BVH and take build-related parameters from
+     * \c props.
+     *
+     * Lower \c quality settings evaluate the SAH over fewer bins.
+     */
+    ShapeBVH(const Properties &props,
+             AccelQuality quality = AccelQuality::High);
+
+    /// Clear the BVH (build-related parameters remain)
+    void clear();
+
+    /// Register a new shape with the BVH (to be called before \ref build())
+    void add_shape(Shape *shape);
+
+    /// Build the BVH
+    void build();
+
+    /**
+     * \brief Recompute the node bounds after the registered shapes moved
+     *
+     * The topology of the tree is kept, which is valid as long as the shapes'
+     * primitive counts did not change. This is much faster than a full
+     * rebuild, though the tree quality degrades if the geometry moves far.
+     */
+    void refit();
+
+    /// Has the BVH been built?
+    bool ready() const { return (bool) m_nodes; }
+
+    /// Return the bounding box of the entire BVH
+    const ScalarBoundingBox3f &bbox() const { return m_bbox; }
+
+    /// Return the number of nodes
+    Size node_count() const { return m_node_count; }
+
+    /// Does the BVH trace coherent packets with \ref ray_intersect_packet()?
+    bool packet_traversal() const { return m_packet_traversal; }
+
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection3f ray_intersect_preliminary(const Ray3f &ray,
+                                                                   Mask active) const {
+        DRJIT_MARK_USED(active);
+        if constexpr (!dr::is_array_v<Float>)
+            return ray_intersect_scalar<ShadowRay>(ray);
+        else
+            Throw("The BVH should only be used in scalar mode");
+    }
+
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
+    ray_intersect_scalar(ScalarRay3f ray) const {
+        PreliminaryIntersection<ScalarFloat, Shape> pi;
+        if (unlikely(!m_nodes))
+            return pi;
+
+        // Allocate the node stack
+        const BVHNode *stack[MI_BVH_MAXDEPTH];
+        int32_t stack_index = 0;
+
+        ScalarVector3f d_rcp = safe_rcp(ray.d);
+        const BVHNode *node = m_nodes.get();
+
+        while (true) {
+            if (node->ray_intersect(ray.o, d_rcp, ray.maxt)) {
+                if (likely(!node->leaf())) { // Inner node
+                    /* Visit the child on the ray's side of the split axis first */
+                    const BVHNode *left = m_nodes.get() + node->offset;
+                    bool right_first = ray.d[node->axis()] < 0.f;
+                    stack[stack_index++] = right_first ? left : left + 1;
+                    node = right_first ? left + 1 : left;
+                    continue;
+                }
+
+                // Arrived at a leaf node
+                Index prim_start = node->offset;
+                Index prim_end = prim_start + node->primitive_count();
+                for (Index i = prim_start; i < prim_end; i++) {
+                    PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
+                        intersect_prim<ShadowRay>(m_indices[i], ray);
+
+                    if (unlikely(prim_pi.is_valid())) {
+                        if constexpr (ShadowRay)
+                            return prim_pi;
+
+                        Assert(prim_pi.t >= 0.f && prim_pi.t <= ray.maxt);
+                        pi = prim_pi;
+                        ray.maxt = pi.t;
+                    }
+                }
+            }
+
+            if (likely(stack_index > 0))
+                node = stack[--stack_index];
+            else
+                break;
+        }
+
+        return pi;
+    }
+
+    /**
+     * \brief Trace a packet of rays through the BVH
+     *
+     * All lanes walk the tree together, and a node is entered as long as at
+     * least one active lane overlaps its bounding box. Leaves test each
+     * primitive against all such lanes at once. This pays off when the rays
+     * are coherent (see \ref is_coherent()).
+     *
+     * The packet width must be one of the widths supported by \ref
+     * Shape::ray_intersect_preliminary_packet() (4, 8 or 16).
+     */
+    template <bool ShadowRay, typename FloatP>
+    PacketIntersection<FloatP>
+    ray_intersect_packet(Ray<Point<FloatP, 3>, Spectrum> ray,
+                         dr::mask_t<FloatP> active) const {
+        using MaskP = dr::mask_t<FloatP>;
+
+        PacketIntersection<FloatP> pi;
+        if (unlikely(!m_nodes))
+            return pi;
+
+        // Allocate the node stack
+        const BVHNode *stack[MI_BVH_MAXDEPTH];
+        int32_t stack_index = 0;
+
+        Vector<FloatP, 3> d_rcp = safe_rcp(ray.d);
+        const BVHNode *node = m_nodes.get();
+
+        /* The packet is coherent, hence any active lane can decide the order */
+        size_t lead = 0;
+        for (size_t i = 0; i < dr::size_v<FloatP>; ++i) {
+            if (active[i]) {
+                lead = i;
+                break;
+            }
+        }
+
+        while (true) {
+            if constexpr (ShadowRay)
+                active &= !pi.valid;
+
+            MaskP node_active =
+                active && node->ray_intersect(ray.o, d_rcp, ray.maxt);
+
+            if (dr::any(node_active)) {
+                if (likely(!node->leaf())) { // Inner node
+                    const BVHNode *left = m_nodes.get() + node->offset;
+                    bool right_first = ray.d[node->axis()][lead] < 0.f;
+                    stack[stack_index++] = right_first ? left : left + 1;
+                    node = right_first ? left + 1 : left;
+                    continue;
+                }
+
+                // Arrived at a leaf node
+                Index prim_start = node->offset;
+                Index prim_end = prim_start + node->primitive_count();
+                for (Index i = prim_start; i < prim_end; i++) {
+                    intersect_prim_packet<ShadowRay>(m_indices[i], ray,
+                                                     node_active, pi);
+
+                    if constexpr (ShadowRay) {
+                        if (dr::all(pi.valid || !node_active))
+                            break;
+                    }
+                }
+            }
+
+            if (likely(stack_index > 0))
+                node = stack[--stack_index];
+            else
+                break;
+        }
+
+        return pi;
+    }
+
+    /// Return a human-readable string representation of the scene contents.
+    virtual std::string to_string() const override;
+
+    MI_DECLARE_CLASS(ShapeBVH)
+protected:
+    using Prims::find_shape;
+    using Prims::intersect_prim;
+    using Prims::intersect_prim_packet;
+    using Prims::m_shapes;
+
+    /// BVH node in 32 bytes
+    struct BVHNode {
+        /// Lower corner of the node's bounding box
+        float bbox_min[3];
+
+        /**
+         * Leaf node: start offset of the primitive list. Inner node: index of
+         * the first child node, which is immediately followed by the second.
+         */
+        uint32_t offset;
+
+        /// Upper corner of the node's bounding box
+        float bbox_max[3];
+
+        /// Number of primitives in the lower 30 bits (0 for inner nodes),
+        /// split axis in the upper 2 bits
+        uint32_t data;
+
+        /// Is this a leaf node?
+        bool leaf() const { return (data & 0x3FFFFFFFu) != 0; }
+
+        /// Assuming this is a leaf node, return the number of primitives
+        Index primitive_count() const { return data & 0x3FFFFFFFu; }
+
+        /// Assuming that this is an inner node, return the split axis
+        Index axis() const { return data >> 30; }
+
+        /// Store the given bounding box in single precision, rounded outward
+        void set_bbox(const ScalarBoundingBox3f &bounds) {
+            for (size_t i = 0; i < 3; ++i) {
+                float lo = (float) bounds.min[i], hi = (float) bounds.max[i];
+                if ((ScalarFloat) lo > bounds.min[i])
+                    lo = std::nextafter(lo, -dr::Infinity<float>);
+                if ((ScalarFloat) hi < bounds.max[i])
+                    hi = std::nextafter(hi, dr::Infinity<float>);
+                bbox_min[i] = lo;
+                bbox_max[i] = hi;
+            }
+        }
+
+        /// Slab test against the node's bounding box
+        template <typename Point3, typename Vector3, typename Value>
+        MI_INLINE dr::mask_t<Value> ray_intersect(const Point3 &o,
+                                                  const Vector3 &d_rcp,
+                                                  const Value &maxt) const {
+            Value t_min = 0.f, t_max = maxt;
+            for (size_t i = 0; i < 3; ++i) {
+                Value t0 = (Value(bbox_min[i]) - o[i]) * d_rcp[i],
+                      t1 = (Value(bbox_max[i]) - o[i]) * d_rcp[i];
+                t_min = dr::maximum(t_min, dr::minimum(t0, t1));
+                t_max = dr::minimum(t_max, dr::maximum(t0, t1));
+            }
+            return t_min <= t_max;
+        }
+    };
+
+    static_assert(sizeof(BVHNode) == 32,
+                  "BVH node has unexpected size. Padding issue?");
+
+    /**
+     * \brief Reciprocal direction for the slab test, where zero components
+     * are replaced by the smallest positive value. This avoids the \c NaN
+     * produced by <tt>0 * inf</tt> for rays lying in a slab plane.
+     */
+    template <typename Vector3>
+    static MI_INLINE Vector3 safe_rcp(const Vector3 &d) {
+        using Value = dr::value_t<Vector3>;
+        return dr::rcp(dr::select(d == 0.f, dr::Smallest<Value>, d));
+    }
+
+    /// Per-primitive data used during construction
+    struct BuildPrimitive {
+        ScalarBoundingBox3f bbox;
+        ScalarPoint3f centroid;
+    };
+
+    /// Build-related state shared by all threads
+    struct BuildContext;
+
+    /// Recursively build the subtree of \c node over <tt>m_indices[begin, end)</tt>
+    void build_node(BuildContext &ctx, Index node, Index begin, Index end,
+                    Size depth);
+
+protected:
+    std::unique_ptr<BVHNode[]> m_nodes;
+    std::unique_ptr<Index[]> m_indices;
+    Size m_node_count = 0;
+    Size m_index_count = 0;
+    ScalarBoundingBox3f m_bbox;
+
+    /// Number of centroid bins per axis used to evaluate the SAH
+    Size m_bins = 16;
+    /// Leaves with up to this many primitives are created when splitting
+    /// does not reduce the SAH cost
+    Size m_max_leaf_size = 8;
+    bool m_packet_traversal = true;
+};
+
+MI_EXTERN_CLASS(ShapeBVH)
+NAMESPACE_END(mitsuba)
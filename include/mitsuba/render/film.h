@@ -33,6 +33,14 @@ enum class FilmFlags : uint32_t {
      * a special treatment of the samples before storing them in the Image Block.
      */
     Special              = 0x4,
+
+    /**
+     * The film writes finished rows of the image to disk while rendering and
+     * only keeps the rows in flight in memory. It requires image blocks to be
+     * submitted in scanline order in a single pass, and the developed image
+     * is not available in memory.
+     */
+    Streaming            = 0x8,
 };
 
 MI_DECLARE_ENUM_OPERATORS(FilmFlags)
@@ -8,6 +8,7 @@ NAMESPACE_BEGIN(mitsuba)
 
 struct BSDFContext;
 struct ShapeIR;
+struct KDTreeBuildReport;
 template <typename Float, typename Spectrum> class BSDF;
 template <typename Float, typename Spectrum> class DirectedEdge;
 template <typename Float, typename Spectrum> class OptixDenoiser;
@@ -31,6 +32,7 @@ template <typename Float, typename Spectrum> class ProjectiveCamera;
 template <typename Float, typename Spectrum> class Shape;
 template <typename Float, typename Spectrum> class ShapeGroup;
 template <typename Float, typename Spectrum> class ShapeKDTree;
+template <typename Float, typename Spectrum> class ShapeBVH;
 template <typename Float, typename Spectrum> class Texture;
 template <typename Float, typename Spectrum> class Volume;
 template <typename Float, typename Spectrum> class VolumeGrid;
@@ -90,6 +92,18 @@ enum class ShapeType : uint32_t {
 
 MI_DECLARE_ENUM_OPERATORS(ShapeType)
 
+/// Build quality of the CPU ray tracing acceleration data structures
+enum class AccelQuality : uint32_t {
+    /// Fastest build at the cost of slower ray tracing (interactive use)
+    Low,
+
+    /// Compromise between build and ray tracing performance
+    Medium,
+
+    /// Slowest build and fastest ray tracing
+    High
+};
+
 template <typename Float_, typename Spectrum_> struct RenderAliases {
     using Float                     = Float_;
     using Spectrum                  = Spectrum_;
@@ -119,6 +133,7 @@ template <typename Float_, typename Spectrum_> struct RenderAliases {
     using Shape                  = mitsuba::Shape<Float, Spectrum>;
     using ShapeGroup             = mitsuba::ShapeGroup<Float, Spectrum>;
     using ShapeKDTree            = mitsuba::ShapeKDTree<Float, Spectrum>;
+    using ShapeBVH               = mitsuba::ShapeBVH<Float, Spectrum>;
     using Mesh                   = mitsuba::Mesh<Float, Spectrum>;
     using DirectedEdge           = mitsuba::DirectedEdge<Float, Spectrum>;
     using Integrator             = mitsuba::Integrator<Float, Spectrum>;
@@ -207,6 +222,7 @@ template <typename Float_, typename Spectrum_> struct RenderAliases {
     using MicrofacetDistribution = typename RenderAliases::MicrofacetDistribution;                 \
     using Shape                  = typename RenderAliases::Shape;                                  \
     using ShapeKDTree            = typename RenderAliases::ShapeKDTree;                            \
+    using ShapeBVH               = typename RenderAliases::ShapeBVH;                               \
     using Mesh                   = typename RenderAliases::Mesh;                                   \
     using Integrator             = typename RenderAliases::Integrator;                             \
     using SamplingIntegrator     = typename RenderAliases::SamplingIntegrator;                     \
@@ -151,6 +151,20 @@ public:
     /// Accumulate another image block into this one
     void put_block(const ImageBlock *block);
 
+    /**
+     * \brief Accumulate a rectangular region of another image block into
+     * this one
+     *
+     * The region is specified in image-space pixel coordinates, i.e. in the
+     * same coordinate system as the block offsets, and parts of it that lie
+     * outside of either block (including borders) are ignored. Accumulating
+     * disjoint regions from several threads at the same time is safe in scalar
+     * variants, which allows a film to merge blocks without serializing on a
+     * single lock.
+     */
+    void put_block(const ImageBlock *block, const ScalarPoint2i &region_offset,
+                   const ScalarVector2i &region_size);
+
     /**
      * \brief Accumulate a single sample or a wavefront of samples into the
      * image block.
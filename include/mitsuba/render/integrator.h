@@ -486,6 +486,28 @@ protected:
      */
     uint32_t m_samples_per_pass;
 
+    /**
+     * \brief Relative error at which progressive rendering stops refining
+     * an image block (scalar variants) or pixel (JIT variants).
+     *
+     * The error is the standard error of the pixel luminance estimated from
+     * the variation between passes, relative to the luminance itself. A value
+     * of zero disables this criterion (default).
+     */
+    ScalarFloat m_error_threshold;
+
+    /**
+     * \brief Wall-clock budget of progressive rendering (in seconds).
+     *
+     * Unlike \ref m_timeout, the budget is only checked between passes, and
+     * the first pass always completes, so that the film always holds a
+     * complete image. A negative value disables the budget (default).
+     */
+    float m_time_budget;
+
+    /// Number of samples per pixel and pass in progressive rendering
+    uint32_t m_pass_samples;
+
     MI_TRAVERSE_CB(Base)
 };
 
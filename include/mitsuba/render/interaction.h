@@ -652,7 +652,12 @@ struct MediumInteraction : Interaction<Float_, Spectrum_> {
 
     UnpolarizedSpectrum sigma_s, sigma_n, sigma_t, combined_extinction;
 
-    /// mint used when sampling the given distance ``t``
+    /**
+     * Start of the free-flight segment used when sampling the given distance
+     * ``t``, i.e., ``(t - mint) * combined_extinction`` is the sampled optical
+     * depth. Media with spatially varying majorants shift this value
+     * accordingly.
+     */
     Float mint;
 
     //! @}
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <unordered_set>
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 
 #include <nanothread/nanothread.h>
 #include <mitsuba/core/bbox.h>
+#include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fwd.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
@@ -13,6 +17,7 @@
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
+#include <mitsuba/render/accel_prims.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/mesh.h>
 
@@ -22,9 +27,18 @@
 /// OrderedChunkAllocator: don't create chunks smaller than 5MiB
 #define MI_KD_MIN_ALLOC 5*1024u*1024u
 
-/// Grain size for parallelization
+/// Maximum grain size for parallelization
 #define MI_KD_GRAIN_SIZE 10240u
 
+/// Minimum grain size for parallelization
+#define MI_KD_MIN_GRAIN_SIZE 1024u
+
+/// O(N log N) builder: split subtrees into separate tasks above this many primitives
+#define MI_KD_TASK_THRESHOLD 8192u
+
+/// Edge event lists longer than this are sorted in parallel
+#define MI_KD_SORT_THRESHOLD 65536u
+
 /**
  * Temporary scratch space that is used to cache intersection information
  * (# of floats)
@@ -305,8 +319,134 @@ private:
     std::atomic<uint64_t> m_size_and_capacity;
     std::atomic<Value *> m_slices[32] { };
 };
+
+/**
+ * \brief Deleter for the node and index arrays of a kd-tree
+ *
+ * The arrays are either allocated by the tree itself or reside within a
+ * memory-mapped cache file, which is then kept alive by \c mapping.
+ */
+template <typename T> struct KDStorageDeleter {
+    ref<Object> mapping;
+
+    void operator()(T *ptr) const {
+        if (!mapping)
+            delete[] ptr;
+    }
+};
 NAMESPACE_END(detail)
 
+/**
+ * \brief Summary of a kd-tree construction
+ *
+ * This record is filled in by every call to \ref TShapeKDTree::build(),
+ * independently of the log level, and can be queried afterwards via \ref
+ * TShapeKDTree::build_report(). Times are given in milliseconds. Wall-clock
+ * times refer to the thread calling \c build(), while the binning and event
+ * sorting times are summed over all threads participating in the build.
+ */
+struct KDTreeBuildReport {
+    /// Wall-clock time of the entire build
+    double total_time = 0;
+    /// Wall-clock time of the recursive top-down construction
+    double construction_time = 0;
+    /// Time spent in min-max binning and partitioning (summed over threads)
+    double binning_time = 0;
+    /// Time spent creating and sorting edge event lists (summed over threads)
+    double event_sort_time = 0;
+    /// Wall-clock time needed to copy nodes and indices into compact arrays
+    double compaction_time = 0;
+    /// Wall-clock time needed to compute the statistics in this record
+    double statistics_time = 0;
+
+    /// Cost of the tree according to the construction heuristic
+    double cost = 0;
+    /// Expected number of traversal steps per query
+    double expected_traversals = 0;
+    /// Expected number of leaf node visits per query
+    double expected_leaf_visits = 0;
+    /// Expected number of primitive visits per query
+    double expected_primitive_visits = 0;
+
+    /// Number of primitives the tree was built from
+    size_t primitive_count = 0;
+    /// Number of primitive references stored in the leaf nodes
+    size_t index_count = 0;
+    /// Average number of references per primitive (<tt>index_count / primitive_count</tt>)
+    double duplication_factor = 0;
+    /// Total number of nodes
+    size_t node_count = 0;
+    /// Number of leaf nodes
+    size_t leaf_count = 0;
+    /// Number of leaf nodes that reference at least one primitive
+    size_t nonempty_leaf_count = 0;
+    /// Maximum depth of a node
+    size_t max_depth = 0;
+    /// Largest number of primitives referenced by a leaf node
+    size_t max_leaf_size = 0;
+    /// Entry \c i counts the leaf nodes referencing \c i primitives
+    std::array<size_t, 16> leaf_histogram { };
+
+    /// Number of splits that were replaced by a leaf node again
+    size_t retracted_splits = 0;
+    /// Number of splits whose cost exceeded that of a leaf node
+    size_t bad_refines = 0;
+    /// Number of primitives removed by clipping
+    size_t pruned = 0;
+    /// Number of min-max binning steps
+    size_t work_units = 0;
+    /// Number of subtrees of the O(N log N) builder handed to separate tasks
+    size_t subtree_tasks = 0;
+    /// Temporary storage used by the build (in bytes)
+    size_t temp_storage = 0;
+
+    /**
+     * \brief Whether the tree was loaded from an acceleration cache instead
+     * of being built
+     *
+     * Only the timings, primitive/index/node counts, and the duplication
+     * factor are available in this case.
+     */
+    bool cached = false;
+
+    /// Return a human-readable summary
+    std::string to_string() const {
+        std::ostringstream oss;
+        oss << "KDTreeBuildReport[" << std::endl
+            << "  total_time = " << util::time_string((float) total_time, true) << "," << std::endl
+            << "  construction_time = " << util::time_string((float) construction_time, true) << "," << std::endl
+            << "  binning_time = " << util::time_string((float) binning_time, true) << "," << std::endl
+            << "  event_sort_time = " << util::time_string((float) event_sort_time, true) << "," << std::endl
+            << "  compaction_time = " << util::time_string((float) compaction_time, true) << "," << std::endl
+            << "  statistics_time = " << util::time_string((float) statistics_time, true) << "," << std::endl
+            << "  cost = " << cost << "," << std::endl
+            << "  expected_traversals = " << expected_traversals << "," << std::endl
+            << "  expected_leaf_visits = " << expected_leaf_visits << "," << std::endl
+            << "  expected_primitive_visits = " << expected_primitive_visits << "," << std::endl
+            << "  primitive_count = " << primitive_count << "," << std::endl
+            << "  index_count = " << index_count << "," << std::endl
+            << "  duplication_factor = " << duplication_factor << "," << std::endl
+            << "  node_count = " << node_count << "," << std::endl
+            << "  leaf_count = " << leaf_count << "," << std::endl
+            << "  nonempty_leaf_count = " << nonempty_leaf_count << "," << std::endl
+            << "  max_depth = " << max_depth << "," << std::endl
+            << "  max_leaf_size = " << max_leaf_size << "," << std::endl
+            << "  leaf_histogram = [";
+        for (size_t i = 0; i < leaf_histogram.size(); ++i)
+            oss << (i > 0 ? ", " : "") << leaf_histogram[i];
+        oss << "]," << std::endl
+            << "  retracted_splits = " << retracted_splits << "," << std::endl
+            << "  bad_refines = " << bad_refines << "," << std::endl
+            << "  pruned = " << pruned << "," << std::endl
+            << "  work_units = " << work_units << "," << std::endl
+            << "  subtree_tasks = " << subtree_tasks << "," << std::endl
+            << "  temp_storage = " << util::mem_string(temp_storage) << "," << std::endl
+            << "  cached = " << (cached ? "true" : "false") << std::endl
+            << "]";
+        return oss.str();
+    }
+};
+
 
 /**
  * \brief Optimized KD-tree acceleration data structure for n-dimensional
@@ -454,7 +594,7 @@ public:
     /**
      * \brief Specify the number of primitives, at which the builder will
      * switch from (approximate) Min-Max binning to the accurate O(n log n)
-     * optimization method.
+     * optimization method. A value of zero disables the latter.
      */
     void set_exact_primitive_threshold(Size value) {
         m_exact_prim_threshold = value;
@@ -468,6 +608,9 @@ public:
 
     bool ready() const { return (bool) m_nodes; }
 
+    /// Return statistics about the most recent call to \ref build()
+    const KDTreeBuildReport &build_report() const { return m_build_report; }
+
     /// Return the bounding box of the entire kd-tree
     const BoundingBox bbox() const { return m_bbox; }
 
@@ -608,6 +751,26 @@ protected:
                   "kd-tree node has unexpected size. Padding issue?");
 
 protected:
+    using Clock = std::chrono::steady_clock;
+
+    /// Return the time elapsed since \c start in nanoseconds
+    static uint64_t elapsed_ns(Clock::time_point start) {
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count();
+    }
+
+    /**
+     * \brief Return the grain size for a parallel loop over \c count elements
+     *
+     * Creates several work items per thread so that nodes with moderately
+     * large primitive lists still occupy all cores.
+     */
+    static Size grain_size(Size count) {
+        Size grain = count / (Size) (4 * (pool_size() + 1));
+        return std::min(std::max(grain, (Size) MI_KD_MIN_GRAIN_SIZE),
+                        (Size) MI_KD_GRAIN_SIZE);
+    }
+
     /// Enumeration representing the state of a classified primitive in the O(N log N) builder
     enum class PrimClassification : uint8_t {
         Ignore = 0, /// Primitive was handled already, ignore from now on
@@ -692,10 +855,14 @@ protected:
         std::atomic<size_t> pruned {0};
         std::atomic<size_t> temp_storage {0};
         std::atomic<size_t> work_units {0};
+        std::atomic<size_t> subtree_tasks {0};
+        std::atomic<uint64_t> binning_time {0};    /* nanoseconds */
+        std::atomic<uint64_t> event_sort_time {0}; /* nanoseconds */
         double exp_traversal_steps = 0;
         double exp_leaves_visited = 0;
         double exp_primitives_queried = 0;
         Size max_prims_in_leaf = 0;
+        Size leaf_count = 0;
         Size nonempty_leaf_count = 0;
         Size max_depth = 0;
         Size prim_buckets[16] { };
@@ -990,7 +1157,8 @@ protected:
             BoundingBox left_bounds, right_bounds;
 
             dr::parallel_for(
-                dr::blocked_range<Size>(0u, Size(indices.size()), MI_KD_GRAIN_SIZE),
+                dr::blocked_range<Size>(0u, Size(indices.size()),
+                                        grain_size(Size(indices.size()))),
                 [&](const dr::blocked_range<Index> &range) {
                     IndexVector left_indices_local, right_indices_local;
                     BoundingBox left_bounds_local, right_bounds_local;
@@ -1077,8 +1245,9 @@ protected:
      * At the top of the tree, it uses min-max-binning and parallel reductions
      * to create sufficient parallelism. When the number of elements is
      * sufficiently small, it switches to a more accurate O(N log N) builder
-     * which uses normal recursion on the stack (i.e. it does not spawn further
-     * parallel pieces of work).
+     * which uses normal recursion on the stack. This builder only spawns
+     * further tasks when both children of a node contain more than
+     * \ref MI_KD_TASK_THRESHOLD primitives.
      */
     class BuildTask {
     public:
@@ -1161,11 +1330,13 @@ protected:
             /*                              Binning                                 */
             /* ==================================================================== */
 
+            auto binning_start = Clock::now();
+
             /* Accumulate all shapes into bins */
             MinMaxBins bins(derived.min_max_bins(), m_tight_bbox);
             std::mutex bins_mutex;
             dr::parallel_for(
-                dr::blocked_range<Size>(0u, prim_count, MI_KD_GRAIN_SIZE),
+                dr::blocked_range<Size>(0u, prim_count, grain_size(prim_count)),
                 [&](const dr::blocked_range<Index> &range) {
                     MinMaxBins bins_local(derived.min_max_bins(), m_tight_bbox);
                     for (Index i = range.begin(); i != range.end(); ++i)
@@ -1192,6 +1363,7 @@ protected:
             if (best.cost >= leaf_cost) {
                 if ((best.cost > 4 * leaf_cost && prim_count < 16)
                     || m_bad_refines >= derived.max_bad_refines()) {
+                    m_ctx.binning_time += elapsed_ns(binning_start);
                     make_leaf(std::move(m_indices));
                     return;
                 }
@@ -1208,6 +1380,8 @@ protected:
             /* Release index list */
             IndexVector().swap(m_indices);
 
+            m_ctx.binning_time += elapsed_ns(binning_start);
+
             /* ==================================================================== */
             /*                              Recursion                               */
             /* ==================================================================== */
@@ -1653,15 +1827,33 @@ protected:
                       "to store overly large offset to left child node (%i)",
                       left_offset);
 
-            Scalar left_cost =
-                build_nlogn(children, best.left_count - pruned_left,
-                            left_events_start, left_events_end, left_bbox,
-                            depth + 1, bad_refines, true);
+            Size left_prims  = best.left_count - pruned_left,
+                 right_prims = best.right_count - pruned_right;
 
-            Scalar right_cost =
-                build_nlogn(children + 1, best.right_count - pruned_right,
-                            right_events_start, right_events_end, right_bbox,
-                            depth + 1, bad_refines, false);
+            Scalar left_cost = 0, right_cost = 0;
+            Task *left_task = nullptr;
+
+            if (left_prims > MI_KD_TASK_THRESHOLD &&
+                right_prims > MI_KD_TASK_THRESHOLD) {
+                /* Both subtrees are large: build the left one concurrently */
+                m_ctx.subtree_tasks++;
+                left_task = dr::do_async([&]() {
+                    left_cost = build_nlogn_task(
+                        children, left_prims, left_events_start,
+                        left_events_end, left_bbox, depth + 1, bad_refines);
+                });
+            } else {
+                left_cost = build_nlogn(children, left_prims, left_events_start,
+                                        left_events_end, left_bbox, depth + 1,
+                                        bad_refines, true);
+            }
+
+            right_cost = build_nlogn(children + 1, right_prims,
+                                     right_events_start, right_events_end,
+                                     right_bbox, depth + 1, bad_refines, false);
+
+            if (left_task)
+                task_wait_and_release(left_task);
 
             /* Release the index lists not needed by the children anymore */
             if (left_child)
@@ -1697,55 +1889,149 @@ protected:
             return final_cost;
         }
 
+        /**
+         * \brief Run the O(N log N) builder on a subtree within a separate task
+         *
+         * The event lists of the O(N log N) builder live in thread-local
+         * allocators that release memory in stack order. The events of the
+         * subtree are therefore first copied into the allocator of the thread
+         * executing this task.
+         */
+        Scalar build_nlogn_task(Index node, Size prim_count,
+                                const EdgeEvent *events_start,
+                                const EdgeEvent *events_end,
+                                const BoundingBox &bbox, Size depth,
+                                Size bad_refines) {
+            FTZGuard g;
+            size_t event_count = (size_t) (events_end - events_start);
+
+            EdgeEvent *events =
+                m_local.left_alloc.template allocate<EdgeEvent>(event_count);
+            std::copy(events_start, events_end, events);
+
+            m_local.classification_storage.resize(m_ctx.derived.primitive_count());
+            m_local.ctx = &m_ctx;
+
+            Scalar cost = build_nlogn(node, prim_count, events,
+                                      events + event_count, bbox, depth,
+                                      bad_refines, true);
+
+            m_local.left_alloc.release(events);
+
+            return cost;
+        }
+
+        /**
+         * \brief Sort an edge event list
+         *
+         * Long lists are split in half; the halves are sorted concurrently
+         * and then merged.
+         */
+        static void sort_events(EdgeEvent *start, EdgeEvent *end) {
+            size_t size = (size_t) (end - start);
+            if (size <= MI_KD_SORT_THRESHOLD) {
+                std::sort(start, end);
+                return;
+            }
+
+            EdgeEvent *middle = start + size / 2;
+            Task *task = dr::do_async([start, middle]() { sort_events(start, middle); });
+            sort_events(middle, end);
+            task_wait_and_release(task);
+            std::inplace_merge(start, middle, end);
+        }
+
         /// Create an initial sorted edge event list and start the O(N log N) builder
         Scalar transition_to_nlogn() {
             const auto &derived = m_ctx.derived;
-            // m_local = &m_ctx.local; // TODO remove this
+            auto sort_start = Clock::now();
 
-            Size prim_count = Size(m_indices.size()), final_prim_count = prim_count;
+            Size prim_count = Size(m_indices.size());
 
             /* We don't yet know how many edge events there will be. Allocate a
                conservative amount and shrink the buffer later on. */
-            Size initial_size = prim_count * 2 * Dimension;
+            Size segment_size = prim_count * 2,
+                 initial_size = segment_size * Dimension;
 
             EdgeEvent *events_start =
                 m_local.left_alloc.template allocate<EdgeEvent>(initial_size),
                 *events_end = events_start + initial_size;
 
-            for (Size i = 0; i<prim_count; ++i) {
-                Index prim_index = m_indices[i];
-                BoundingBox prim_bbox = derived.bbox(prim_index, m_bbox);
-                bool valid = prim_bbox.valid() && prim_bbox.surface_area() > 0;
-
-                if (unlikely(!valid)) {
-                    --final_prim_count;
-                    m_ctx.pruned++;
-                }
+            std::atomic<Size> invalid_count { 0 };
+            dr::parallel_for(
+                dr::blocked_range<Size>(0u, prim_count, grain_size(prim_count)),
+                [&](const dr::blocked_range<Size> &range) {
+                    FTZGuard g;
+                    Size invalid_count_local = 0;
 
-                for (Index axis = 0; axis < Dimension; ++axis) {
-                    Scalar min = prim_bbox.min[axis], max = prim_bbox.max[axis];
-                    Index offset = (Index) (axis * prim_count + i) * 2;
-
-                    if (unlikely(!valid)) {
-                        events_start[offset  ].set_invalid();
-                        events_start[offset+1].set_invalid();
-                    } else if (min == max) {
-                        events_start[offset  ] = EdgeEvent(EdgeEvent::Type::EdgePlanar, axis, min, prim_index);
-                        events_start[offset+1].set_invalid();
-                    } else {
-                        events_start[offset  ] = EdgeEvent(EdgeEvent::Type::EdgeStart, axis, min, prim_index);
-                        events_start[offset+1] = EdgeEvent(EdgeEvent::Type::EdgeEnd,   axis, max, prim_index);
+                    for (Size i = range.begin(); i != range.end(); ++i) {
+                        Index prim_index = m_indices[i];
+                        BoundingBox prim_bbox = derived.bbox(prim_index, m_bbox);
+                        bool valid = prim_bbox.valid() && prim_bbox.surface_area() > 0;
+
+                        if (unlikely(!valid))
+                            invalid_count_local++;
+
+                        for (Index axis = 0; axis < Dimension; ++axis) {
+                            Scalar min = prim_bbox.min[axis], max = prim_bbox.max[axis];
+                            Index offset = (Index) (axis * prim_count + i) * 2;
+
+                            if (unlikely(!valid)) {
+                                events_start[offset  ].set_invalid();
+                                events_start[offset+1].set_invalid();
+                            } else if (min == max) {
+                                events_start[offset  ] = EdgeEvent(EdgeEvent::Type::EdgePlanar, axis, min, prim_index);
+                                events_start[offset+1].set_invalid();
+                            } else {
+                                events_start[offset  ] = EdgeEvent(EdgeEvent::Type::EdgeStart, axis, min, prim_index);
+                                events_start[offset+1] = EdgeEvent(EdgeEvent::Type::EdgeEnd,   axis, max, prim_index);
+                            }
+                        }
                     }
+
+                    invalid_count += invalid_count_local;
                 }
-            }
+            );
+
+            Size final_prim_count = prim_count - invalid_count.load();
+            m_ctx.pruned += invalid_count.load();
 
             /* Release index list */
             IndexVector().swap(m_indices);
 
-            /* Sort the events list and remove invalid ones from the end */
-            std::sort(events_start, events_end);
-            while (events_start != events_end && !(events_end-1)->valid())
-                --events_end;
+            /* Each axis occupies its own segment of the event list, so the
+               segments can be sorted independently. Invalid events end up at
+               the end of each segment, and concatenating the valid prefixes
+               yields the same list as sorting the entire list at once. */
+            Task *sort_tasks[Dimension] { };
+            for (size_t axis = 0; axis < Dimension; ++axis) {
+                EdgeEvent *start = events_start + axis * segment_size,
+                          *end   = start + segment_size;
+                if (axis + 1 < Dimension && segment_size > MI_KD_SORT_THRESHOLD)
+                    sort_tasks[axis] = dr::do_async([start, end]() { sort_events(start, end); });
+                else
+                    sort_events(start, end);
+            }
+
+            for (Task *task : sort_tasks) {
+                if (task)
+                    task_wait_and_release(task);
+            }
+
+            EdgeEvent *target = events_start;
+            for (size_t axis = 0; axis < Dimension; ++axis) {
+                EdgeEvent *start = events_start + axis * segment_size,
+                          *end = std::partition_point(
+                              start, start + segment_size,
+                              [](const EdgeEvent &e) { return e.valid(); });
+                if (target == start)
+                    target = end;
+                else
+                    target = std::move(start, end, target);
+            }
+            events_end = target;
+
+            m_ctx.event_sort_time += elapsed_ns(sort_start);
 
             m_local.left_alloc.template shrink_allocation<EdgeEvent>(
                 events_start, events_end - events_start);
@@ -1822,6 +2108,7 @@ protected:
 
             ctx.exp_leaves_visited += value;
             ctx.exp_primitives_queried += value * double(prim_count);
+            ctx.leaf_count++;
             if (prim_count < sizeof(ctx.prim_buckets) / sizeof(Size))
                 ctx.prim_buckets[prim_count]++;
             if (prim_count > ctx.max_prims_in_leaf)
@@ -1849,10 +2136,14 @@ protected:
             Throw("The number of min-max bins must be > 2");
         if (m_stop_primitives <= 0)
             Throw("The stopping primitive count must be greater than zero");
-        if (m_exact_prim_threshold <= m_stop_primitives)
+        if (m_exact_prim_threshold != 0 &&
+            m_exact_prim_threshold <= m_stop_primitives)
             Throw("The exact primitive threshold must be bigger than the "
                   "stopping primitive count");
 
+        auto build_start = Clock::now();
+        m_build_report = KDTreeBuildReport();
+
         Size prim_count = derived().primitive_count();
         if (m_max_depth == 0)
             m_max_depth = (int) (8 + 1.3f * dr::log2i(prim_count));
@@ -1865,8 +2156,11 @@ protected:
         Log(m_log_level, "   Scene bounding box (min) : %s", m_bbox.min);
         Log(m_log_level, "   Scene bounding box (max) : %s", m_bbox.max);
         Log(m_log_level, "   Min-max bins             : %i", m_min_max_bins);
-        Log(m_log_level, "   O(n log n) method        : use for <= %i primitives",
-            m_exact_prim_threshold);
+        if (m_exact_prim_threshold > 0)
+            Log(m_log_level, "   O(n log n) method        : use for <= %i primitives",
+                m_exact_prim_threshold);
+        else
+            Log(m_log_level, "   O(n log n) method        : disabled");
         Log(m_log_level, "   Stopping primitive count : %i", m_stop_primitives);
         Log(m_log_level, "   Perfect splits           : %s",
             m_clip_primitives ? "yes" : "no");
@@ -1890,6 +2184,7 @@ protected:
         /* ==================================================================== */
 
         Scalar final_cost = 0;
+        auto construction_start = Clock::now();
         if (prim_count == 0) {
             Log(Warn, "kd-tree contains no geometry!");
             ctx.node_storage[0].set_leaf_node(0, 0);
@@ -1900,13 +2195,19 @@ protected:
                 util::mem_string(prim_count * sizeof(Index)).c_str());
 
             IndexVector indices(prim_count);
-            for (size_t i = 0; i < prim_count; ++i)
-                indices[i] = (Index) i;
+            dr::parallel_for(
+                dr::blocked_range<Size>(0u, prim_count, grain_size(prim_count)),
+                [&](const dr::blocked_range<Size> &range) {
+                    for (Size i = range.begin(); i != range.end(); ++i)
+                        indices[i] = (Index) i;
+                }
+            );
 
             BuildTask task = BuildTask(ctx, 0, std::move(indices), m_bbox,
                                        m_bbox, 0, 0, &final_cost);
             task.execute();
         }
+        m_build_report.construction_time = elapsed_ns(construction_start) * 1e-6;
 
         Log(m_log_level, "Structural kd-tree statistics:");
 
@@ -1914,12 +2215,14 @@ protected:
         /*     Store the node and index lists in a compact contiguous format    */
         /* ==================================================================== */
 
+        auto compaction_start = Clock::now();
+
         m_node_count  = (Index) ctx.node_storage.size();
         m_index_count = (Index) ctx.index_storage.size();
 
-        m_indices.reset(new Index[m_index_count]);
+        m_indices = Storage<Index>(new Index[m_index_count]);
         dr::parallel_for(
-            dr::blocked_range<Size>(0u, m_index_count, MI_KD_GRAIN_SIZE),
+            dr::blocked_range<Size>(0u, m_index_count, grain_size(m_index_count)),
             [&](const dr::blocked_range<Size> &range) {
                 for (Size i = range.begin(); i != range.end(); ++i)
                     m_indices[i] = ctx.index_storage[i];
@@ -1927,9 +2230,9 @@ protected:
         );
         ctx.index_storage.release();
 
-        m_nodes.reset(new KDNode[m_node_count]);
+        m_nodes = Storage<KDNode>(new KDNode[m_node_count]);
         dr::parallel_for(
-            dr::blocked_range<Size>(0u, m_node_count, MI_KD_GRAIN_SIZE),
+            dr::blocked_range<Size>(0u, m_node_count, grain_size(m_node_count)),
             [&](const dr::blocked_range<Size> &range) {
                 for (Size i = range.begin(); i != range.end(); ++i)
                     m_nodes[i] = ctx.node_storage[i];
@@ -1937,6 +2240,8 @@ protected:
         );
         ctx.node_storage.release();
 
+        m_build_report.compaction_time = elapsed_ns(compaction_start) * 1e-6;
+
         /* Slightly avoid the bounding box to avoid numerical issues
            involving geometry that exactly lies on the boundary */
         Vector extra = (m_bbox.extents() + 1.f) * dr::Epsilon<Scalar>;
@@ -1944,21 +2249,53 @@ protected:
         m_bbox.max += extra;
 
         /* ==================================================================== */
-        /*         Print various tree statistics if requested by the user       */
+        /*           Compute tree statistics and fill the build report          */
         /* ==================================================================== */
 
-        if (Thread::thread()->logger()->log_level() <= m_log_level) {
-            compute_statistics(ctx, m_nodes.get(), m_bbox, 0);
+        auto statistics_start = Clock::now();
+        compute_statistics(ctx, m_nodes.get(), m_bbox, 0);
 
-            // Trigger per-thread data release
-            // ctx.local.clear(); // TODO is this necessary?
+        double bbox_cost = (double) CostModel::eval(m_bbox);
+        if (bbox_cost > 0) {
+            ctx.exp_traversal_steps /= bbox_cost;
+            ctx.exp_leaves_visited /= bbox_cost;
+            ctx.exp_primitives_queried /= bbox_cost;
+        }
+        ctx.temp_storage += ctx.node_storage.size() * sizeof(KDNode);
+        ctx.temp_storage += ctx.index_storage.size() * sizeof(Index);
+
+        KDTreeBuildReport &report = m_build_report;
+        report.binning_time = ctx.binning_time * 1e-6;
+        report.event_sort_time = ctx.event_sort_time * 1e-6;
+        report.cost = (double) final_cost;
+        report.expected_traversals = ctx.exp_traversal_steps;
+        report.expected_leaf_visits = ctx.exp_leaves_visited;
+        report.expected_primitive_visits = ctx.exp_primitives_queried;
+        report.primitive_count = prim_count;
+        report.index_count = m_index_count;
+        report.duplication_factor =
+            prim_count > 0 ? m_index_count / (double) prim_count : 0.0;
+        report.node_count = m_node_count;
+        report.leaf_count = ctx.leaf_count;
+        report.nonempty_leaf_count = ctx.nonempty_leaf_count;
+        report.max_depth = ctx.max_depth;
+        report.max_leaf_size = ctx.max_prims_in_leaf;
+        for (size_t i = 0; i < report.leaf_histogram.size(); ++i)
+            report.leaf_histogram[i] = ctx.prim_buckets[i];
+        report.retracted_splits = ctx.retracted_splits;
+        report.bad_refines = ctx.bad_refines;
+        report.pruned = ctx.pruned;
+        report.work_units = ctx.work_units;
+        report.subtree_tasks = ctx.subtree_tasks;
+        report.temp_storage = ctx.temp_storage;
+        report.statistics_time = elapsed_ns(statistics_start) * 1e-6;
+        report.total_time = elapsed_ns(build_start) * 1e-6;
 
-            ctx.exp_traversal_steps /= (double) CostModel::eval(m_bbox);
-            ctx.exp_leaves_visited /= (double) CostModel::eval(m_bbox);
-            ctx.exp_primitives_queried /= (double) CostModel::eval(m_bbox);
-            ctx.temp_storage += ctx.node_storage.size() * sizeof(KDNode);
-            ctx.temp_storage += ctx.index_storage.size() * sizeof(Index);
+        /* ==================================================================== */
+        /*         Print various tree statistics if requested by the user       */
+        /* ==================================================================== */
 
+        if (Thread::thread()->logger()->log_level() <= m_log_level) {
             Log(m_log_level, "   Primitive references        : %i (%s)",
                 m_index_count, util::mem_string(m_index_count * sizeof(Index)));
 
@@ -1974,6 +2311,9 @@ protected:
             Log(m_log_level, "   Parallel work units         : %i",
                 ctx.work_units);
 
+            Log(m_log_level, "   Parallel subtree tasks      : %i",
+                ctx.subtree_tasks);
+
             std::ostringstream oss;
             Size prim_bucket_count = sizeof(ctx.prim_buckets) / sizeof(Size);
             oss << "   Leaf node histogram         : ";
@@ -2007,13 +2347,30 @@ protected:
                 ctx.exp_primitives_queried);
             Log(m_log_level, "   Final cost                  : %.2f",
                 final_cost);
+            Log(m_log_level, "   Duplication factor          : %.2f",
+                report.duplication_factor);
+            Log(m_log_level, "");
+
+            Log(m_log_level, "kd-tree build timings:");
+            Log(m_log_level, "   Construction (wall clock)   : %s",
+                util::time_string((float) report.construction_time, true));
+            Log(m_log_level, "   Binning (all threads)       : %s",
+                util::time_string((float) report.binning_time, true));
+            Log(m_log_level, "   Event sorting (all threads) : %s",
+                util::time_string((float) report.event_sort_time, true));
+            Log(m_log_level, "   Compaction                  : %s",
+                util::time_string((float) report.compaction_time, true));
             Log(m_log_level, "");
         }
     }
 
 protected:
-    std::unique_ptr<KDNode[]> m_nodes;
-    std::unique_ptr<Index[]> m_indices;
+    /// Node or index array, which may point into a memory-mapped cache file
+    template <typename T>
+    using Storage = std::unique_ptr<T[], detail::KDStorageDeleter<T>>;
+
+    Storage<KDNode> m_nodes;
+    Storage<Index> m_indices;
     Size m_node_count = 0;
     Size m_index_count = 0;
 
@@ -2027,6 +2384,7 @@ protected:
     Size m_min_max_bins = 128;
     LogLevel m_log_level = Debug;
     BoundingBox m_bbox;
+    KDTreeBuildReport m_build_report;
 };
 
 template <typename Float> class SurfaceAreaHeuristic3 {
@@ -2131,7 +2489,8 @@ private:
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB ShapeKDTree : public TShapeKDTree<BoundingBox<Point<dr::scalar_t<Float>, 3>>, uint32_t,
                                                           SurfaceAreaHeuristic3<dr::scalar_t<Float>>,
-                                                          ShapeKDTree<Float, Spectrum>> {
+                                                          ShapeKDTree<Float, Spectrum>>,
+                                    public AccelPrimitives<Float, Spectrum> {
 public:
     MI_IMPORT_TYPES(Shape, Mesh)
 
@@ -2142,6 +2501,7 @@ public:
     using Index                  = uint32_t;
 
     using Base = TShapeKDTree<ScalarBoundingBox3f, uint32_t, SurfaceAreaHeuristic3f, ShapeKDTree>;
+    using Prims = AccelPrimitives<Float, Spectrum>;
     using typename Base::KDNode;
     using Base::ready;
     using Base::set_clip_primitives;
@@ -2156,9 +2516,25 @@ public:
     using Base::m_indices;
     using Base::m_index_count;
     using Base::m_node_count;
+    using Base::m_build_report;
+    using Prims::bbox;
+    using Prims::shape;
+    using Prims::shape_count;
+    using Prims::primitive_count;
+    using Prims::is_coherent;
+    using Prims::ray_intersect_naive;
 
-    /// Create an empty kd-tree and take build-related parameters from \c props.
-    ShapeKDTree(const Properties &props);
+    /**
+     * \brief Create an empty kd-tree and take build-related parameters from
+     * \c props.
+     *
+     * The \c quality selects defaults for these parameters: \c High runs the
+     * full SAH optimization with primitive clipping, \c Medium only uses the
+     * exact O(n log n) method for smaller nodes, and \c Low only uses
+     * Min-Max binning without clipping.
+     */
+    ShapeKDTree(const Properties &props,
+                AccelQuality quality = AccelQuality::High);
 
     /// Clear the kd-tree (build-related parameters remain)
     void clear();
@@ -2166,32 +2542,26 @@ public:
     /// Register a new shape with the kd-tree (to be called before \ref build())
     void add_shape(Shape *shape);
 
-    /// Build the kd-tree
+    /**
+     * \brief Build the kd-tree
+     *
+     * When a cache directory was specified, a tree built earlier from the
+     * same geometry and parameters is memory-mapped from the cache instead.
+     * Otherwise, the newly built tree is added to the cache.
+     */
     void build();
 
-    /// Return the number of registered shapes
-    Size shape_count() const { return Size(m_shapes.size()); }
-
-    /// Return the number of registered primitives
-    Size primitive_count() const { return m_primitive_map.back(); }
-
-    /// Return the i-th shape (const version)
-    const Shape *shape(size_t i) const { Assert(i < m_shapes.size()); return m_shapes[i]; }
-
-    /// Return the i-th shape
-    Shape *shape(size_t i) { Assert(i < m_shapes.size()); return m_shapes[i]; }
-
-    /// Return the bounding box of the i-th primitive
-    MI_INLINE ScalarBoundingBox3f bbox(Index i) const {
-        Index shape_index = find_shape(i);
-        return m_shapes[shape_index]->bbox(i);
-    }
+    /// Return the directory of the acceleration cache (empty if disabled)
+    const fs::path &cache_dir() const { return m_cache_dir; }
 
-    /// Return the (clipped) bounding box of the i-th primitive
-    MI_INLINE ScalarBoundingBox3f bbox(Index i, const ScalarBoundingBox3f &clip) const {
-        Index shape_index = find_shape(i);
-        return m_shapes[shape_index]->bbox(i, clip);
-    }
+    /**
+     * \brief Compute a hash of everything the tree structure depends on
+     *
+     * This includes the build parameters and the bounds of all primitives.
+     * For meshes, the world-space positions of the triangle vertices are
+     * hashed instead, since primitive clipping depends on them.
+     */
+    uint64_t content_hash() const;
 
     template <bool ShadowRay>
     MI_INLINE PreliminaryIntersection3f ray_intersect_preliminary(const Ray3f &ray,
@@ -2301,16 +2671,33 @@ public:
         return pi;
     }
 
-#if 0
-    template <bool ShadowRay>
-    MI_INLINE PreliminaryIntersection3f ray_intersect_packet(Ray3f ray,
-                                                              Mask active) const {
+    /// Does the kd-tree trace coherent packets with \ref ray_intersect_packet()?
+    bool packet_traversal() const { return m_packet_traversal; }
+
+    /**
+     * \brief Trace a packet of rays through the kd-tree
+     *
+     * All lanes walk the tree together. Each stack entry records a per-lane
+     * ray segment and activity mask, so that a subtree is only entered when
+     * at least one lane overlaps it, and lanes disagreeing on the near/far
+     * order at an inner node are outvoted but still visit both children.
+     * Leaves test each primitive against all active lanes at once.
+     *
+     * The packet width must be one of the widths supported by \ref
+     * Shape::ray_intersect_preliminary_packet() (4, 8 or 16).
+     */
+    template <bool ShadowRay, typename FloatP>
+    PacketIntersection<FloatP>
+    ray_intersect_packet(Ray<Point<FloatP, 3>, Spectrum> ray,
+                         dr::mask_t<FloatP> active) const {
+        using MaskP = dr::mask_t<FloatP>;
+
         /// Ray traversal stack entry
         struct KDStackEntry {
-            // Ray distance associated with the node entry and exit point
-            Float mint, maxt;
-            // Is the corresponding SIMD lane enabled?
-            Mask active;
+            // Per-lane ray distance associated with the node entry and exit point
+            FloatP mint, maxt;
+            // Which lanes overlap the node?
+            MaskP active;
             // Pointer to the far child
             const KDNode *node;
         };
@@ -2320,94 +2707,88 @@ public:
         int32_t stack_index = 0;
 
         // Resulting intersection struct
-        PreliminaryIntersection3f pi = dr::zeros<PreliminaryIntersection3f>();
+        PacketIntersection<FloatP> pi;
 
-        const KDNode *node = m_nodes.get();
+        // Intersect against the scene bounding box
+        auto [bbox_valid, bbox_mint, bbox_maxt] = m_bbox.ray_intersect(ray);
+        FloatP mint = dr::maximum(0.f, bbox_mint),
+               maxt = dr::minimum(ray.maxt, bbox_maxt);
+        active &= bbox_valid;
 
-        /* Intersect against the scene bounding box */
-        auto bbox_result = m_bbox.ray_intersect(ray);
-        Float mint = dr::maximum(ray.mint, std::get<1>(bbox_result));
-        Float maxt = dr::minimum(ray.maxt, std::get<2>(bbox_result));
+        Vector<FloatP, 3> d_rcp = dr::rcp(ray.d);
 
+        const KDNode *node = m_nodes.get();
         while (true) {
-            active = active && (maxt >= mint);
-            if (ShadowRay)
-                active = active && !pi.is_valid();
+            active &= maxt >= mint;
+            if constexpr (ShadowRay)
+                active &= !pi.valid;
 
             if (likely(dr::any(active))) {
                 if (likely(!node->leaf())) { // Inner node
-                    const dr::scalar_t<Float> split = node->split();
-                    const uint32_t axis = node->axis();
-
-                    // Compute parametric distance along the rays to the split plane
-                    Float t_plane          = (split - ray.o[axis]) * ray.d_rcp[axis];
-                    Mask left_first        = (ray.o[axis] < split) ||
-                                              (dr::eq(ray.o[axis], split) && ray.d[axis] >= 0.f),
-                         start_after       = t_plane < mint,
-                         end_before        = t_plane > maxt || t_plane < 0.f || !dr::isfinite(t_plane),
-                         single_node       = start_after || end_before,
-                         visit_left        = dr::eq(end_before, left_first),
-                         visit_only_left   = single_node &&  visit_left,
-                         visit_only_right  = single_node && !visit_left;
-
-                    bool all_visit_only_left  = dr::all(visit_only_left || !active),
-                         all_visit_only_right = dr::all(visit_only_right || !active),
-                         all_visit_same_node  = all_visit_only_left || all_visit_only_right;
-
-                    /* If we only need to visit one node, just pick the correct one and continue */
-                    if (all_visit_same_node) {
-                        node = node->left() + (all_visit_only_left ? 0 : 1);
+                    const ScalarFloat split = node->split();
+                    const uint32_t axis     = node->axis();
+
+                    /* Compute parametric distance along the rays to the split plane */
+                    FloatP t_plane = (split - ray.o[axis]) * d_rcp[axis];
+
+                    MaskP left_first  = (ray.o[axis] < split) ||
+                                        (ray.o[axis] == split && ray.d[axis] >= 0.f),
+                          start_after = t_plane < mint,
+                          end_before  = t_plane > maxt || t_plane < 0.f ||
+                                        !dr::isfinite(t_plane),
+                          single_node = start_after || end_before,
+                          visit_left  = !(end_before ^ left_first);
+
+                    bool all_left  = dr::all(!active || (single_node &&  visit_left)),
+                         all_right = dr::all(!active || (single_node && !visit_left));
+
+                    /* If all lanes only need to visit one node, just pick the correct one and continue */
+                    if (all_left || all_right) {
+                        node = node->left() + (all_left ? 0 : 1);
                         continue;
                     }
 
-                    size_t left_votes  = count(left_first && active),
-                           right_votes = count(!left_first && active);
-
-                    bool go_left = left_votes >= right_votes;
+                    /* Otherwise, the majority of lanes decides which child comes first */
+                    bool go_left = dr::count(active && left_first) >=
+                                   dr::count(active && !left_first);
 
-                    Mask go_left_bcast = Mask(go_left),
-                         correct_order = dr::eq(left_first, go_left_bcast),
-                         visit_both    = !single_node,
-                         visit_cur     = visit_both || eq (visit_left, go_left_bcast),
-                         visit_next    = visit_both || dr::neq(visit_left, go_left_bcast);
+                    MaskP correct_order = go_left ? left_first : !left_first,
+                          visit_both    = !single_node,
+                          visit_cur     = visit_both || (go_left ? visit_left : !visit_left),
+                          visit_next    = visit_both || (go_left ? !visit_left : visit_left);
 
-                    /* Visit both child nodes in the right order */
                     Index node_offset = go_left ? 0 : 1;
                     const KDNode *left   = node->left(),
                                  *n_cur  = left + node_offset,
                                  *n_next = left + (1 - node_offset);
 
-                    /* Postpone visit to 'n_next' */
-                    Mask sel0 =  correct_order && visit_both,
-                         sel1 = !correct_order && visit_both;
+                    /* Postpone visit to 'n_next'. Lanes whose preferred order
+                       disagrees with the vote visit their far segment first. */
+                    MaskP sel0 =  correct_order && visit_both,
+                          sel1 = !correct_order && visit_both;
+
                     KDStackEntry& entry = stack[stack_index++];
-                    entry.mint = dr::select(sel0, t_plane, mint);
-                    entry.maxt = dr::select(sel1, t_plane, maxt);
+                    entry.mint   = dr::select(sel0, t_plane, mint);
+                    entry.maxt   = dr::select(sel1, t_plane, maxt);
                     entry.active = active && visit_next;
-                    entry.node = n_next;
+                    entry.node   = n_next;
 
                     /* Visit 'n_cur' now */
-                    mint = dr::select(sel1, t_plane, mint);
-                    maxt = dr::select(sel0, t_plane, maxt);
+                    mint   = dr::select(sel1, t_plane, mint);
+                    maxt   = dr::select(sel0, t_plane, maxt);
                     active = active && visit_cur;
-                    node = n_cur;
+                    node   = n_cur;
                     continue;
                 } else if (node->primitive_count() > 0) { // Arrived at a leaf node
                     Index prim_start = node->primitive_offset();
                     Index prim_end = prim_start + node->primitive_count();
                     for (Index i = prim_start; i < prim_end; i++) {
-                        Index prim_index = m_indices[i];
-
-                        PreliminaryIntersection3f prim_pi =
-                            intersect_prim<ShadowRay>(prim_index, ray, active);
+                        intersect_prim_packet<ShadowRay>(m_indices[i], ray,
+                                                         active, pi);
 
-                        dr::masked(pi, prim_pi.is_valid()) = prim_pi;
-
-                        if constexpr (!ShadowRay) {
-                            Assert(dr::all(!prim_pi.is_valid() ||
-                                       (prim_pi.t >= ray.mint &&
-                                        prim_pi.t <= ray.maxt)));
-                            dr::masked(ray.maxt, prim_pi.is_valid()) = prim_pi.t;
+                        if constexpr (ShadowRay) {
+                            if (dr::all(pi.valid || !active))
+                                break;
                         }
                     }
                 }
@@ -2416,10 +2797,10 @@ public:
             if (likely(stack_index > 0)) {
                 --stack_index;
                 KDStackEntry& entry = stack[stack_index];
-                mint = entry.mint;
-                maxt = dr::minimum(entry.maxt, ray.maxt);
+                mint   = entry.mint;
+                maxt   = dr::minimum(entry.maxt, ray.maxt);
                 active = entry.active;
-                node = entry.node;
+                node   = entry.node;
             } else {
                 break;
             }
@@ -2427,115 +2808,26 @@ public:
 
         return pi;
     }
-#endif
-
-    /// Brute force intersection routine for debugging purposes
-    template <bool ShadowRay>
-    MI_INLINE PreliminaryIntersection3f
-    ray_intersect_naive(Ray3f ray, Mask active) const {
-        if constexpr (!dr::is_array_v<Float>) {
-            PreliminaryIntersection3f pi = dr::zeros<PreliminaryIntersection3f>();
-
-            for (Size i = 0; i < primitive_count(); ++i) {
-                PreliminaryIntersection3f prim_pi = intersect_prim<ShadowRay>(i, ray);
-
-                if constexpr (dr::is_array_v<Float>) {
-                    dr::masked(pi, prim_pi.is_valid()) = prim_pi;
-                } else if (prim_pi.is_valid()) {
-                    pi = prim_pi;
-                    ray.maxt = prim_pi.t;
-                }
-
-                if (ShadowRay && dr::all(pi.is_valid() || !active))
-                    break;
-            }
-
-            return pi;
-        } else {
-            Throw("kdtree should only be used in scalar mode");
-        }
-    }
 
     /// Return a human-readable string representation of the scene contents.
     virtual std::string to_string() const override;
 
     MI_DECLARE_CLASS(ShapeKDTree)
 protected:
-    /**
-     * \brief Map an abstract \ref TShapeKDTree primitive index to a specific
-     * shape managed by the \ref ShapeKDTree.
-     *
-     * The function returns the shape index and updates the \a idx parameter to
-     * point to the primitive index (e.g. triangle ID) within the shape.
-     */
-    MI_INLINE Index find_shape(Index &i) const {
-        Assert(i < primitive_count());
-
-        Index shape_index = math::find_interval<Index>(
-            Size(m_primitive_map.size()),
-            [&](Index k) DRJIT_INLINE_LAMBDA {
-                return m_primitive_map[k] <= i;
-            }
-        );
+    using Prims::find_shape;
+    using Prims::intersect_prim;
+    using Prims::intersect_prim_packet;
+    using Prims::m_shapes;
+    template <typename T> using Storage = typename Base::template Storage<T>;
 
-        Assert(shape_index < shape_count() &&
-               m_primitive_map.size() == shape_count() + 1);
+    /// Try to memory-map a tree with the given hash from the cache directory
+    bool load_cache(const fs::path &filename, uint64_t hash);
 
-        Assert(i >= m_primitive_map[shape_index]);
-        Assert(i <  m_primitive_map[shape_index + 1]);
-        i -= m_primitive_map[shape_index];
+    /// Write the tree to the cache directory
+    void write_cache(const fs::path &filename, uint64_t hash) const;
 
-        return shape_index;
-    }
-
-    /**
-     * \brief Check whether a primitive is intersected by the given ray.
-     *
-     * Some temporary space is supplied to store data that can later be used to
-     * create a detailed intersection record.
-     */
-    template <bool ShadowRay = false>
-    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
-    intersect_prim(Index prim_index, const ScalarRay3f &ray) const {
-        Index shape_index  = find_shape(prim_index);
-        const Shape *shape = this->shape(shape_index);
-        const Mesh *mesh = (const Mesh *) shape;
-
-        PreliminaryIntersection<ScalarFloat, Shape> pi;
-
-        if constexpr (ShadowRay) {
-            bool hit;
-            if (shape->is_mesh()) {
-                hit = std::get<0>(
-                    mesh->ray_intersect_triangle_scalar(prim_index, ray));
-            } else {
-                hit = shape->ray_test_scalar(ray);
-            }
-            pi.valid = hit;
-            pi.t = dr::select(hit, ScalarFloat(0), dr::Infinity<ScalarFloat>);
-        } else {
-            uint32_t inst_index = (uint32_t) -1;
-            if (shape->is_mesh()) {
-                std::tie(pi.valid, pi.t, pi.prim_uv) =
-                    mesh->ray_intersect_triangle_scalar(prim_index, ray);
-            } else {
-                std::tie(pi.valid, pi.t, pi.prim_uv, inst_index, prim_index) =
-                    shape->ray_intersect_preliminary_scalar(ray);
-            }
-            pi.prim_index = prim_index;
-
-            bool hit_inst  = (inst_index != (uint32_t) -1);
-            pi.shape       = hit_inst ? (const Shape *) (size_t) shape_index : shape; // shape_index for LLVM + kdtree
-            pi.instance    = hit_inst ? shape : nullptr;
-            pi.shape_index = hit_inst ? inst_index : shape_index;
-        }
-
-        return pi;
-    }
-
-protected:
-    std::vector<ref<Shape>> m_shapes;
-    std::vector<Size> m_primitive_map;
+    bool m_packet_traversal = true;
+    fs::path m_cache_dir;
 };
 
 MI_EXTERN_CLASS(ShapeKDTree)
@@ -0,0 +1,128 @@
+/*
+    lighttree.h -- Spatially aware emitter selection for scenes with many lights
+*/
+
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/distr_1d.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/interaction.h>
+#include <drjit/traversable_base.h>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Bounding volume hierarchy over the emitters of a scene
+ *
+ * The light tree selects an emitter with a probability that depends on the
+ * reference point and normal of the shading location. Each node stores the
+ * bounding box of its emitters, a cone bounding their emission directions
+ * (axis, spread angle \f$\theta_o\f$ of the normals, and emission angle
+ * \f$\theta_e\f$ around them) and their total sampling weight. Traversal
+ * evaluates a conservative bound of the contribution of both children of a
+ * node and descends stochastically into one of them, following "Importance
+ * Sampling of Many Lights with Adaptive Tree Splitting" by Conty Estevez and
+ * Kulla (2018).
+ *
+ * The sampling weight of an emitter (see \ref Emitter::sampling_weight())
+ * stands in for its power. Emitters without a finite bounding box (e.g.
+ * environment maps and directional emitters) are kept outside of the tree and
+ * selected proportionally to their sampling weight.
+ *
+ * Since the selection probability only depends on the reference interaction,
+ * \ref pmf() reproduces the probability of \ref sample() exactly, which is
+ * required for multiple importance sampling.
+ */
+template <typename Float, typename Spectrum>
+struct MI_EXPORT_LIB LightTree : drjit::TraversableBase {
+    MI_IMPORT_TYPES(Emitter, EmitterPtr, Shape, Mesh)
+
+    /// Build a light tree over the given list of emitters
+    LightTree(const std::vector<ref<Emitter>> &emitters);
+
+    /**
+     * \brief Sample an emitter for the given reference interaction
+     *
+     * \return
+     *    The index of the chosen emitter (or <tt>(uint32_t) -1</tt> when no
+     *    emitter can contribute), along with the sampling weight (equal to the
+     *    inverse probability mass) and the reused sample.
+     */
+    std::tuple<UInt32, Float, Float> sample(const Interaction3f &ref,
+                                            Float sample,
+                                            Mask active = true) const;
+
+    /// Evaluate the probability of sampling \c emitter from \c ref
+    Float pmf(const Interaction3f &ref, const EmitterPtr &emitter,
+              Mask active = true) const;
+
+    /// Return the number of nodes of the tree
+    size_t node_count() const { return m_node_count; }
+
+protected:
+    /// Emission bounds of a set of emitters
+    struct LightBounds {
+        ScalarBoundingBox3f bbox;
+        ScalarVector3f axis { 0.f, 0.f, 1.f };
+        ScalarFloat cos_theta_o = 1.f;
+        ScalarFloat cos_theta_e = 1.f;
+        ScalarFloat phi = 0.f;
+
+        /// Expand the bounds to include those of another set of emitters
+        void expand(const LightBounds &other);
+    };
+
+    /// Compute the emission bounds of a single emitter
+    LightBounds emitter_bounds(const Emitter *emitter) const;
+
+    /// Recursively build the subtree of \c node over <tt>items[begin, end)</tt>
+    void build_node(std::vector<std::pair<LightBounds, uint32_t>> &items,
+                    std::vector<LightBounds> &nodes,
+                    std::vector<uint32_t> &info,
+                    std::vector<uint32_t> &parent,
+                    uint32_t node, size_t begin, size_t end, uint32_t depth);
+
+    /// Upper bound of the contribution of the emitters below \c node to \c ref
+    Float importance(const UInt32 &node, const Point3f &p, const Normal3f &n,
+                     Mask active) const;
+
+    /// Map an emitter pointer to its index in the scene's emitter list
+    UInt32 emitter_index(const EmitterPtr &emitter, Mask active) const;
+
+    /// Flag marking leaf nodes in \c m_node_info and infinite emitters in
+    /// \c m_emitter_node
+    static constexpr uint32_t LeafFlag = 0x80000000u;
+
+protected:
+    /// Node bounds, 12 values per node: bounding box (6), cone axis (3),
+    /// cos(theta_o), cos(theta_e), and sampling weight
+    FloatStorage m_node_data;
+    /// Index of the first child for inner nodes, emitter index for leaves
+    UInt32Storage m_node_info;
+    /// Parent of every node (root: 0)
+    UInt32Storage m_node_parent;
+    /// Leaf node of every emitter, or index into \c m_infinite_index
+    UInt32Storage m_emitter_node;
+
+    /// Emitters outside of the tree and their selection probability
+    UInt32Storage m_infinite_index;
+    std::unique_ptr<DiscreteDistribution<Float>> m_infinite_distr;
+    /// Probability of selecting an emitter from the tree
+    ScalarFloat m_tree_prob = 0.f;
+
+    size_t m_node_count = 0;
+
+    /// Lookup tables from emitter pointers (scalar variants) or registry IDs
+    /// (JIT variants) to the index of an emitter
+    std::unordered_map<const void *, uint32_t> m_emitter_map;
+    UInt32Storage m_registry_map;
+
+    MI_TRAVERSE_CB(drjit::TraversableBase, m_node_data, m_node_info,
+                   m_node_parent, m_emitter_node, m_infinite_index,
+                   m_infinite_distr, m_registry_map)
+};
+
+MI_EXTERN_STRUCT(LightTree)
+NAMESPACE_END(mitsuba)
@@ -49,9 +49,15 @@ public:
      * \return         This method returns a MediumInteraction.
      *                 The MediumInteraction will always be valid,
      *                 except if the ray missed the Medium's bounding box.
+     *
+     * The default implementation samples the distance using the single
+     * majorant returned by \ref get_majorant(). Media with spatially
+     * varying majorants override this function.
      */
-    MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
-                                           UInt32 channel, Mask active) const;
+    virtual MediumInteraction3f sample_interaction(const Ray3f &ray,
+                                                   Float sample,
+                                                   UInt32 channel,
+                                                   Mask active) const;
 
     /**
      * \brief Compute the transmittance and PDF
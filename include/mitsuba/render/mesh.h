@@ -166,10 +166,10 @@ template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB Mesh : public Shape<Float, Spectrum> {
 public:
     MI_IMPORT_TYPES(BSDF, DirectedEdge)
-    MI_IMPORT_BASE(Shape, m_to_world, mark_dirty, m_emitter, m_sensor, m_bsdf,
-                   m_interior_medium, m_exterior_medium, m_is_instance,
-                   m_discontinuity_types, m_shape_type, m_initialized,
-                   get_children_string)
+    MI_IMPORT_BASE(Shape, m_to_world, mark_dirty, m_dirty_flags, m_emitter,
+                   m_sensor, m_bsdf, m_interior_medium, m_exterior_medium,
+                   m_is_instance, m_discontinuity_types, m_shape_type,
+                   m_initialized, get_children_string)
 
     // Mesh is always stored in single precision
     using InputFloat    = float;
@@ -490,6 +490,22 @@ public:
     /// Does this mesh use face normals?
     bool has_face_normals() const { return m_face_normals; }
 
+    /**
+     * \brief Are the vertex records quantized?
+     *
+     * This is the case for meshes constructed with the ``quantize``
+     * property, see \ref QuantizedMesh for the encoding.
+     */
+    bool is_quantized() const { return !m_quantized_vertices.empty(); }
+
+    /// Largest distance between a decoded position of a quantized mesh and
+    /// its full-precision value
+    ScalarFloat quantization_error() const { return m_quantization_error; }
+
+    /// Number of bytes occupied by the vertex and face records, whether
+    /// packed or quantized
+    size_t storage_size() const;
+
     //! @}
     // =========================================================================
 
@@ -509,6 +525,15 @@ public:
     MI_INLINE auto vertex_position(Index index,
                                    dr::mask_t<Index> active = true) const {
         using Value = dr::replace_scalar_t<Index, InputFloat>;
+        if (is_quantized()) {
+            Index base = index * QuantizedVertexStride;
+            auto [offset, scale] = quantized_cluster<Value>(index, active);
+            return quantized_position(
+                dr::gather<Index>(m_quantized_vertices, base, active),
+                dr::gather<Index>(m_quantized_vertices, base + 1u, active),
+                offset, scale);
+        }
+
         Index base = index * MeshVertexStride + PackedPositionOffset;
         return Point<Value, 3>(
             dr::gather<Value>(m_packed_vertices, base, active),
@@ -519,17 +544,34 @@ public:
     /// Returns the normal direction of the vertex with index \c index
     MI_INLINE Normal<Float32, 3> vertex_normal(UInt32 index,
                                                Mask active = true) const {
-        UInt32 base = index * MeshVertexStride + PackedFrameOffset;
-        Vector<Float32, 3> f(
-            dr::gather<Float32>(m_packed_vertices, base, active),
-            dr::gather<Float32>(m_packed_vertices, base + 1u, active),
-            dr::gather<Float32>(m_packed_vertices, base + 2u, active));
+        Vector<Float32, 3> f;
+        if (is_quantized()) {
+            UInt32 base = index * QuantizedVertexStride,
+                   w1 = dr::gather<UInt32>(m_quantized_vertices, base + 1u, active),
+                   w2 = dr::gather<UInt32>(m_quantized_vertices, base + 2u, active);
+            f = Vector<Float32, 3>(quantized_snorm(w1),
+                                   quantized_snorm(UInt32(w2 << 16)),
+                                   quantized_snorm(w2));
+        } else {
+            UInt32 base = index * MeshVertexStride + PackedFrameOffset;
+            f = Vector<Float32, 3>(
+                dr::gather<Float32>(m_packed_vertices, base, active),
+                dr::gather<Float32>(m_packed_vertices, base + 1u, active),
+                dr::gather<Float32>(m_packed_vertices, base + 2u, active));
+        }
         return packs_tangent() ? frame_decode(f).first : Normal<Float32, 3>(f);
     }
 
     /// Returns the UV texture coordinates of the vertex with index \c index
     MI_INLINE Point<Float32, 2> vertex_texcoord(UInt32 index,
                                                 Mask active = true) const {
+        if (is_quantized()) {
+            UInt32 w3 = dr::gather<UInt32>(
+                m_quantized_vertices, index * QuantizedVertexStride + 3u, active);
+            return Point<Float32, 2>(quantized_half(w3),
+                                     quantized_half(UInt32(w3 >> 16)));
+        }
+
         UInt32 base = index * MeshVertexStride + PackedTexcoordOffset;
         return Point<Float32, 2>(
             dr::gather<Float32>(m_packed_vertices, base, active),
@@ -558,6 +600,15 @@ public:
                target   = dr::select(source == 2u, 0u, source + 1u),
                opposing = dr::select(source == 0u, 2u, source - 1u);
 
+        if (!m_quantized_faces.empty()) {
+            PackedFace<> rec = packed_face(DirectedEdge::face(index), active);
+            auto corner = [&](const UInt32 &k) {
+                return dr::select(k == 0u, rec[0],
+                                  dr::select(k == 1u, rec[1], rec[2]));
+            };
+            return Vector3u(corner(source), corner(target), corner(opposing));
+        }
+
         return Vector3u(
             dr::gather<UInt32>(m_packed_faces, base + source, active),
             dr::gather<UInt32>(m_packed_faces, base + target, active),
@@ -662,7 +713,8 @@ public:
     //! @{ \name Functions to access the packed vertex state
     // =========================================================================
 
-    /// Return the packed per-vertex buffer
+    /// Return the packed per-vertex buffer, which is empty when the mesh
+    /// \ref is_quantized()
     FloatBuffer& packed_vertices() { return m_packed_vertices; }
 
     /// Const variant of \ref packed_vertices.
@@ -672,6 +724,15 @@ public:
     template <typename Index>
     MI_INLINE PackedFace<Index>
     packed_face(Index index, dr::mask_t<Index> active = true) const {
+        if (!m_quantized_faces.empty()) {
+            using UInt32 = dr::uint32_array_t<Index>;
+            Index base = index * QuantizedFaceStride;
+            return quantized_face(
+                dr::gather<UInt32>(m_quantized_faces, base, active),
+                dr::gather<UInt32>(m_quantized_faces, base + 1u, active),
+                dr::gather<UInt32>(m_quantized_face_base,
+                                   index / QuantizedFaceCluster, active));
+        }
         return dr::gather<PackedFace<Index>>(m_packed_faces, index, active);
     }
 
@@ -683,6 +744,14 @@ public:
     MI_INLINE PackedVertex packed_vertex(UInt32 index, Mask active = true,
                                          bool detach = false) const {
         DRJIT_MARK_USED(detach);
+        if (is_quantized()) {
+            // Decoded records carry no derivatives
+            auto [offset, scale] = quantized_cluster<Float32>(index, active);
+            return quantized_vertex(
+                dr::gather<dr::Array<UInt32, QuantizedVertexStride>>(
+                    m_quantized_vertices, index, active),
+                offset, scale);
+        }
         if constexpr (dr::is_diff_v<Float>)
             return dr::gather<PackedVertex>(
                 detach ? dr::detach(m_packed_vertices) : m_packed_vertices,
@@ -799,26 +868,11 @@ public:
     //! @{ \name Ray-triangle intersection
     // =========================================================================
 
-    /** \brief Ray-triangle intersection test
-     *
-     * Uses the algorithm by Moeller and Trumbore discussed at
-     * <tt>http://www.acm.org/jgt/papers/MollerTrumbore97/code.html</tt>.
-     *
-     * \param index
-     *    Index of the triangle to be intersected.
-     * \param ray
-     *    The ray segment to be used for the intersection query.
-     * \return
-     *    Returns an ordered tuple <tt>(valid, t, uv)</tt>, where \c valid
-     *    indicates whether an intersection was found, \c t contains the
-     *    distance from the ray origin to the intersection point, and \c uv
-     *    contains the first two barycentric coordinates.
-     */
-    template <typename T, typename Ray3>
-    std::tuple<dr::mask_t<T>, T, Point<T, 2>>
-    ray_intersect_triangle_impl(const dr::uint32_array_t<T> &index,
-                                const Ray3 &ray,
-                                dr::mask_t<T> active = true) const {
+    /// Fetch the vertex positions of triangle \c index
+    template <typename T>
+    MI_INLINE std::array<Point<T, 3>, 3>
+    triangle_positions(const dr::uint32_array_t<T> &index,
+                       dr::mask_t<T> active = true) const {
         using Point3T = Point<T, 3>;
         using Faces = dr::Array<dr::uint32_array_t<T>, 3>;
 
@@ -826,16 +880,44 @@ public:
         Point3T p0, p1, p2;
 #if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
         // Ensure we don't rely on drjit-core when called from an LLVM kernel
-        if constexpr (!dr::is_array_v<T> && dr::is_llvm_v<Float>) {
-            auto rec = dr::gather<dr::Array<dr::uint32_array_t<T>, 4>>(
-                m_packed_faces_ptr, index, active);
-            fi = Faces(rec[0], rec[1], rec[2]);
-            auto packed_position = [&](uint32_t v) {
-                uint32_t base = v * MeshVertexStride;
-                return InputPoint3f(
-                    dr::gather<InputFloat>(m_packed_vertices_ptr, base, active),
-                    dr::gather<InputFloat>(m_packed_vertices_ptr, base + 1, active),
-                    dr::gather<InputFloat>(m_packed_vertices_ptr, base + 2, active));
+        if constexpr (!dr::is_jit_v<T> && dr::is_llvm_v<Float>) {
+            using UInt32T = dr::uint32_array_t<T>;
+            if (m_quantized_faces_ptr) {
+                UInt32T base = index * QuantizedFaceStride;
+                auto rec = quantized_face(
+                    dr::gather<UInt32T>(m_quantized_faces_ptr, base, active),
+                    dr::gather<UInt32T>(m_quantized_faces_ptr, base + 1, active),
+                    dr::gather<UInt32T>(m_quantized_face_base_ptr,
+                                        index / QuantizedFaceCluster, active));
+                fi = Faces(rec[0], rec[1], rec[2]);
+            } else {
+                auto rec = dr::gather<dr::Array<UInt32T, 4>>(
+                    m_packed_faces_ptr, index, active);
+                fi = Faces(rec[0], rec[1], rec[2]);
+            }
+            using InputT = dr::replace_scalar_t<T, InputFloat>;
+            auto packed_position = [&](const UInt32T &v) {
+                if (m_quantized_vertices_ptr) {
+                    UInt32T base = v * QuantizedVertexStride,
+                            cluster = v / QuantizedVertexCluster *
+                                      QuantizedClusterStride;
+                    InputT c[QuantizedClusterStride];
+                    for (uint32_t k = 0; k < QuantizedClusterStride; ++k)
+                        c[k] = dr::gather<InputT>(m_quantized_clusters_ptr,
+                                                  cluster + k, active);
+                    return quantized_position(
+                        dr::gather<UInt32T>(m_quantized_vertices_ptr, base,
+                                            active),
+                        dr::gather<UInt32T>(m_quantized_vertices_ptr, base + 1,
+                                            active),
+                        Point<InputT, 3>(c[0], c[1], c[2]),
+                        Vector<InputT, 3>(c[3], c[4], c[5]));
+                }
+                UInt32T base = v * MeshVertexStride;
+                return Point<InputT, 3>(
+                    dr::gather<InputT>(m_packed_vertices_ptr, base, active),
+                    dr::gather<InputT>(m_packed_vertices_ptr, base + 1, active),
+                    dr::gather<InputT>(m_packed_vertices_ptr, base + 2, active));
             };
             p0 = packed_position(fi[0]);
             p1 = packed_position(fi[1]);
@@ -849,10 +931,51 @@ public:
             p2 = vertex_position(fi[2], active);
         }
 
+        return { p0, p1, p2 };
+    }
+
+    /** \brief Ray-triangle intersection test
+     *
+     * Uses the algorithm by Moeller and Trumbore discussed at
+     * <tt>http://www.acm.org/jgt/papers/MollerTrumbore97/code.html</tt>.
+     *
+     * \param index
+     *    Index of the triangle to be intersected.
+     * \param ray
+     *    The ray segment to be used for the intersection query.
+     * \return
+     *    Returns an ordered tuple <tt>(valid, t, uv)</tt>, where \c valid
+     *    indicates whether an intersection was found, \c t contains the
+     *    distance from the ray origin to the intersection point, and \c uv
+     *    contains the first two barycentric coordinates.
+     */
+    template <typename T, typename Ray3>
+    std::tuple<dr::mask_t<T>, T, Point<T, 2>>
+    ray_intersect_triangle_impl(const dr::uint32_array_t<T> &index,
+                                const Ray3 &ray,
+                                dr::mask_t<T> active = true) const {
+        auto [p0, p1, p2] = triangle_positions<T>(index, active);
         auto [t, uv, hit] = moeller_trumbore(ray, p0, p1, p2, active);
         return { hit, dr::select(hit, t, dr::Infinity<T>), uv };
     }
 
+    /** \brief Intersect a packet of rays against a single triangle
+     *
+     * The vertices of triangle \c index are fetched once and broadcast to
+     * all lanes of \c ray. This is the leaf test of the kd-tree's packet
+     * traversal, where every active lane visits the same primitive.
+     */
+    template <typename T, typename Ray3>
+    MI_INLINE std::tuple<dr::mask_t<T>, T, Point<T, 2>>
+    ray_intersect_triangle_broadcast(ScalarUInt32 index, const Ray3 &ray,
+                                     dr::mask_t<T> active = true) const {
+        auto [p0, p1, p2] = triangle_positions<ScalarFloat>(index, true);
+        auto [t, uv, hit] =
+            moeller_trumbore(ray, Point<T, 3>(p0), Point<T, 3>(p1),
+                             Point<T, 3>(p2), active);
+        return { hit, dr::select(hit, t, dr::Infinity<T>), uv };
+    }
+
     MI_INLINE PreliminaryIntersection3f
     ray_intersect_triangle(const UInt32 &index, const Ray3f &ray,
                            Mask active = true) const {
@@ -888,6 +1011,30 @@ public:
     MI_DECLARE_RAY_INTERSECT_TRI_PACKET(8)
     MI_DECLARE_RAY_INTERSECT_TRI_PACKET(16)
 
+    /* Per-primitive intersection routines of the Shape interface. Embree
+       intersects quantized meshes through them as a user geometry, since it
+       cannot consume the quantized records directly (see \ref describe()). */
+    PreliminaryIntersection3f
+    ray_intersect_preliminary(const Ray3f &ray, ScalarIndex prim_index = 0,
+                              Mask active = true) const override {
+        return ray_intersect_triangle(UInt32(prim_index), ray, active);
+    }
+
+#define MI_MESH_RAY_INTERSECT_PACKET(N)                                        \
+    std::tuple<MaskP##N, FloatP##N, Point2fP##N, UInt32P##N, UInt32P##N>     \
+    ray_intersect_preliminary_packet(const Ray3fP##N &ray,                    \
+                                     ScalarIndex prim_index = 0,              \
+                                     MaskP##N active = true) const override { \
+        auto [hit, t, uv] = ray_intersect_triangle_broadcast<FloatP##N>(      \
+            prim_index, ray, active);                                         \
+        return { hit, t, uv, UInt32P##N((uint32_t) -1),                       \
+                 UInt32P##N(prim_index) };                                    \
+    }
+
+    MI_MESH_RAY_INTERSECT_PACKET(4)
+    MI_MESH_RAY_INTERSECT_PACKET(8)
+    MI_MESH_RAY_INTERSECT_PACKET(16)
+
     //! @}
     // =========================================================================
 
@@ -1106,6 +1253,35 @@ protected:
     /// ``(V, 3)`` tensor
     TensorXf32 compute_tangents() const;
 
+    /**
+     * \brief Replace the packed records by their quantized encoding
+     *
+     * Called by \ref refresh() when the mesh was constructed with the
+     * ``quantize`` property. Each nonempty packed buffer is quantized and
+     * released, which also updates the bounding box when the vertex records
+     * change. Face records whose offsets exceed 16 bits stay unquantized.
+     */
+    void quantize();
+
+    /// Return the packed vertex records, decoding them if they are quantized
+    FloatBuffer vertex_records() const;
+
+    /// Return the packed face records, decoding them if they are quantized
+    IndexBuffer face_records() const;
+
+    /// Gather the position offset and scale of the quantized vertex cluster
+    /// containing the vertex \c index
+    template <typename Value, typename Index>
+    MI_INLINE std::pair<Point<Value, 3>, Vector<Value, 3>>
+    quantized_cluster(const Index &index, dr::mask_t<Index> active) const {
+        Index base = index / QuantizedVertexCluster * QuantizedClusterStride;
+        Value c[QuantizedClusterStride];
+        for (uint32_t k = 0; k < QuantizedClusterStride; ++k)
+            c[k] = dr::gather<Value>(m_quantized_clusters, base + k, active);
+        return { Point<Value, 3>(c[0], c[1], c[2]),
+                 Vector<Value, 3>(c[3], c[4], c[5]) };
+    }
+
     /** \brief Moeller and Trumbore algorithm for computing ray-triangle
      * intersection
      *
@@ -1238,6 +1414,26 @@ protected:
     /// Content of the packed vertex records
     Layout m_layout = Layout::Positions;
 
+    /// Store the records in quantized form? (see \ref quantize())
+    bool m_quantize = false;
+
+    /// Quantized vertex records (4 x UInt32 per vertex). Replaces
+    /// \ref m_packed_vertices when the mesh \ref is_quantized().
+    IndexBuffer m_quantized_vertices;
+
+    /// Position offset and scale of each quantized vertex cluster
+    FloatBuffer m_quantized_clusters;
+
+    /// Quantized face records (2 x UInt32 per face). Replaces
+    /// \ref m_packed_faces unless some face cluster overflowed.
+    IndexBuffer m_quantized_faces;
+
+    /// Smallest vertex index of each quantized face cluster
+    IndexBuffer m_quantized_face_base;
+
+    /// See \ref quantization_error()
+    ScalarFloat m_quantization_error = 0.f;
+
     /// Vertex index to position index map. Optional.
     IndexBuffer m_position_index;
 
@@ -1266,6 +1462,10 @@ protected:
     // Fast explicit access to data pointers for use with LLVM and Embree
     float* m_packed_vertices_ptr;
     uint32_t* m_packed_faces_ptr;
+    uint32_t* m_quantized_vertices_ptr = nullptr;
+    float* m_quantized_clusters_ptr = nullptr;
+    uint32_t* m_quantized_faces_ptr = nullptr;
+    uint32_t* m_quantized_face_base_ptr = nullptr;
 #endif
 
     /// Custom mesh attributes. The use of a node-based map is intentional
@@ -1284,6 +1484,8 @@ protected:
     Scene<Float, Spectrum>* m_scene = nullptr;
 
     MI_DECLARE_TRAVERSE_CB(m_packed_vertices, m_packed_faces,
+                           m_quantized_vertices, m_quantized_clusters,
+                           m_quantized_faces, m_quantized_face_base,
                            m_positions, m_normals, m_texcoords,
                            m_position_index, m_normal_index,
                            m_dedge, m_sil_dedge_pmf, m_mesh_attributes,
@@ -224,6 +224,161 @@ private:
     bool m_written = false;
 };
 
+/// Number of consecutive vertices that share a position bounding box
+constexpr uint32_t QuantizedVertexCluster = 256;
+
+/// Number of consecutive faces that share a base vertex index
+constexpr uint32_t QuantizedFaceCluster = 64;
+
+/// Number of 32-bit words per quantized vertex record
+constexpr uint32_t QuantizedVertexStride = 4;
+
+/// Number of 32-bit words per quantized face record
+constexpr uint32_t QuantizedFaceStride = 2;
+
+/// Number of floats per vertex cluster (offset and scale of the positions)
+constexpr uint32_t QuantizedClusterStride = 6;
+
+/// Bit flag of the 16-bit face flags which indicates a face with flipped UVs
+constexpr uint32_t QuantizedFaceUVFlipped = 0x8000u;
+
+/// Bit mask of the 16-bit face flags used to encode the BSDF index
+constexpr uint32_t QuantizedFaceBSDFIndexMask = 0x7fffu;
+
+/**
+ * \brief Decode a position from the first two words of a quantized vertex
+ * record, given the \c offset and \c scale of its cluster
+ */
+template <typename UInt32, typename Value>
+Point<Value, 3> quantized_position(const UInt32 &w0, const UInt32 &w1,
+                                   const Point<Value, 3> &offset,
+                                   const Vector<Value, 3> &scale) {
+    return Point<Value, 3>(
+        dr::fmadd(Value(w0 & 0xffffu), scale.x(), offset.x()),
+        dr::fmadd(Value(w0 >> 16),     scale.y(), offset.y()),
+        dr::fmadd(Value(w1 & 0xffffu), scale.z(), offset.z()));
+}
+
+/// Decode a 16-bit signed normalized value stored in the upper half of \c w
+template <typename UInt32>
+dr::float32_array_t<UInt32> quantized_snorm(const UInt32 &w) {
+    using Int32 = dr::int32_array_t<UInt32>;
+    using Value = dr::float32_array_t<UInt32>;
+    Int32 s = dr::reinterpret_array<Int32>(w) >> 16;
+    return dr::maximum(Value(s) * (1.f / 32767.f), -1.f);
+}
+
+/// Decode the half precision float stored in the lower half of \c w
+template <typename UInt32>
+dr::float32_array_t<UInt32> quantized_half(const UInt32 &w) {
+    using Value = dr::float32_array_t<UInt32>;
+    // Move the exponent and mantissa into place, then rebias the exponent
+    // with a multiplication, which also normalizes subnormal inputs
+    Value mag = dr::reinterpret_array<Value>((w & 0x7fffu) << 13) * 0x1p112f;
+    return dr::reinterpret_array<Value>(dr::reinterpret_array<UInt32>(mag) |
+                                        ((w & 0x8000u) << 16));
+}
+
+/**
+ * \brief Decode the words \c w of a quantized vertex record into a packed
+ * vertex record, given the \c offset and \c scale of its cluster
+ */
+template <typename UInt32, typename Value>
+dr::Array<Value, MeshVertexStride>
+quantized_vertex(const dr::Array<UInt32, QuantizedVertexStride> &w,
+                 const Point<Value, 3> &offset,
+                 const Vector<Value, 3> &scale) {
+    Point<Value, 3> p = quantized_position(w[0], w[1], offset, scale);
+
+    dr::Array<Value, MeshVertexStride> rec;
+    for (uint32_t k = 0; k < 3; ++k)
+        rec[PackedPositionOffset + k] = p[k];
+    rec[PackedFrameOffset]        = quantized_snorm(w[1]);
+    rec[PackedFrameOffset + 1]    = quantized_snorm(UInt32(w[2] << 16));
+    rec[PackedFrameOffset + 2]    = quantized_snorm(w[2]);
+    rec[PackedTexcoordOffset]     = quantized_half(w[3]);
+    rec[PackedTexcoordOffset + 1] = quantized_half(UInt32(w[3] >> 16));
+    rec[MeshVertexStride - 1]     = 0.f;
+    return rec;
+}
+
+/**
+ * \brief Decode a quantized face record into the words of a packed face
+ * record, given the smallest vertex index \c base of its cluster
+ */
+template <typename UInt32>
+Vector<UInt32, MeshFaceStride> quantized_face(const UInt32 &w0,
+                                              const UInt32 &w1,
+                                              const UInt32 &base) {
+    UInt32 flags = w1 >> 16;
+    return Vector<UInt32, MeshFaceStride>(
+        base + (w0 & 0xffffu), base + (w0 >> 16), base + (w1 & 0xffffu),
+        (flags & QuantizedFaceBSDFIndexMask) |
+            ((flags & QuantizedFaceUVFlipped) << 16));
+}
+
+/**
+ * \brief Quantized storage of the packed records of a \ref Mesh
+ *
+ * Meshes constructed with the ``quantize`` property replace their packed
+ * records (\ref MeshVertexStride floats per vertex and \ref MeshFaceStride
+ * words per face) with the more compact encoding below, which \ref Mesh
+ * decodes on the fly when it intersects rays or evaluates surface
+ * interactions.
+ *
+ * Vertices form clusters of \ref QuantizedVertexCluster consecutive records.
+ * The positions of a cluster are stored as 16-bit fixed point values
+ * relative to its bounding box, the normal or shading frame as 16-bit
+ * signed normalized values, and the texture coordinates as half precision
+ * floats. Faces form clusters of \ref QuantizedFaceCluster records, which
+ * store 16-bit offsets relative to the smallest vertex index of the
+ * cluster, along with the BSDF index and UV orientation bit.
+ *
+ * A quantized vertex record consists of the words
+ * ``(x | y << 16, z | f0 << 16, f1 | f2 << 16, u | v << 16)``, where
+ * ``f0..f2`` refer to the lanes at \ref PackedFrameOffset, and a quantized
+ * face record of ``(d0 | d1 << 16, d2 | flags << 16)``.
+ */
+struct MI_EXPORT_LIB QuantizedMesh {
+    /// Quantized vertex records (\ref QuantizedVertexStride words each)
+    drjit::unique_buffer<uint32_t> vertices;
+
+    /// Offset and scale of the positions of each vertex cluster
+    drjit::unique_buffer<float> clusters;
+
+    /// Quantized face records (\ref QuantizedFaceStride words each). Empty
+    /// when some face cluster spans more than 65536 vertices or a BSDF
+    /// index does not fit into 15 bits.
+    drjit::unique_buffer<uint32_t> faces;
+
+    /// Smallest vertex index referenced by each face cluster
+    drjit::unique_buffer<uint32_t> face_base;
+
+    /// Bounding box of the decoded positions
+    BoundingBox<Point<float, 3>> bbox;
+
+    /// Largest distance between a decoded and the original position
+    float position_error = 0.f;
+
+    /// Largest deviation of a decoded texture coordinate
+    float texcoord_error = 0.f;
+
+    /// Number of bytes occupied by the buffers above
+    size_t memory() const;
+};
+
+/**
+ * \brief Quantize the packed vertex and face records of a mesh
+ *
+ * Either record array may be null, in which case the corresponding fields
+ * of the result stay empty. See \ref QuantizedMesh for the encoding, which
+ * the decoding helpers \ref quantized_position(), \ref quantized_snorm(),
+ * \ref quantized_half(), and \ref quantized_face() invert.
+ */
+extern MI_EXPORT_LIB QuantizedMesh
+quantize_packed_mesh(const float *vertices, size_t vertex_count,
+                     const uint32_t *faces, size_t face_count);
+
 /**
  * \brief Per-corner values of one attribute, see \ref CornerMesh
  *
@@ -342,10 +497,15 @@ corner_to_packed_mesh(JitBackend backend, const CornerMesh &desc,
                       const PackedMesh::ScalarAffineTransform4f &to_world = {});
 
 /// Magic number and current version of the ``.serialized`` mesh encoding,
-/// whose reader and writer are \c SerializedMesh::load_v5() and \ref
+/// whose reader and writer are \c SerializedMesh::load_v6() and \ref
 /// Mesh::write_serialized(Stream*). Keep the two in step.
 constexpr uint16_t SerializedMagic   = 0x041C;
-constexpr uint16_t SerializedVersion = 0x0005;
+constexpr uint16_t SerializedVersion = 0x0006;
+
+/// Uncompressed size of the independently compressed blocks that make up
+/// the arrays of a version 6 ``.serialized`` mesh. The reader takes the
+/// actual value from the file.
+constexpr uint32_t SerializedBlockSize = 1u << 20;
 
 /// Flag word of a ``.serialized`` file. The low bits store the
 /// \ref Layout of the vertex records verbatim.
@@ -355,4 +515,31 @@ enum class SerializedFlags : uint32_t {
     SinglePrecision = 0x1000,
 };
 
+/// Address and size in bytes of one array of a version 6 ``.serialized`` mesh
+struct SerializedArray {
+    void *data;
+    size_t size;
+};
+
+/**
+ * \brief Write arrays as the block payload of a version 6 ``.serialized``
+ * mesh
+ *
+ * Each array is cut into blocks of \c block_size bytes (the last one may be
+ * shorter), which are compressed independently and in parallel. The payload
+ * consists of one ``uint32`` compressed size per block, followed by the
+ * compressed blocks in order.
+ */
+extern MI_EXPORT_LIB void
+write_serialized_blocks(Stream *stream,
+                        const std::vector<SerializedArray> &arrays,
+                        uint32_t block_size = SerializedBlockSize);
+
+/// Read a payload written by \ref write_serialized_blocks() into \c arrays,
+/// decompressing the blocks in parallel
+extern MI_EXPORT_LIB void
+read_serialized_blocks(Stream *stream,
+                       const std::vector<SerializedArray> &arrays,
+                       uint32_t block_size);
+
 NAMESPACE_END(mitsuba)
@@ -4,6 +4,7 @@
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/fwd.h>
+#include <mitsuba/render/lighttree.h>
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/render/shapegroup.h>
 #include <mitsuba/render/accel.h>
@@ -547,6 +548,9 @@ public:
      * the sampled emitter position. However, approximations are acceptable as
      * long as these are reflected in the returned Monte Carlo sampling weight.
      *
+     * When the scene's \c light_tree flag is set, the emitter is chosen using
+     * a \ref LightTree, which accounts for the position and normal of \c ref.
+     *
      * \param ref
      *    A 3D reference location within the scene, which may influence the
      *    sampling process.
@@ -747,9 +751,38 @@ public:
      */
     bool shapes_grad_enabled() const { return m_shapes_grad_enabled; };
 
+    /**
+     * \brief Does any texture of the scene filter over the footprint given by
+     * the UV partials of a surface interaction? (see \ref
+     * Texture::needs_uv_partials())
+     */
+    bool needs_uv_partials() const { return m_needs_uv_partials; }
+
     /// Returns a union of ShapeType flags denoting what is present in the ShapeGroup
     uint32_t shape_types() const;
 
+    /**
+     * \brief Return statistics about the construction of the scene's kd-tree
+     *
+     * Returns \c nullptr unless the scene uses Mitsuba's builtin kd-tree
+     * (i.e. when Embree, OptiX, Metal, or the BVH are used instead).
+     */
+    const KDTreeBuildReport *kdtree_build_report() const;
+
+    /**
+     * \brief Return the build quality of the acceleration data structure
+     *
+     * This is the \c accel_quality scene parameter, with \c auto resolved
+     * based on the primitive and sample counts.
+     */
+    AccelQuality accel_quality() const { return m_accel_quality; }
+
+    /**
+     * \brief Return the time spent on the most recent build or update of the
+     * acceleration data structure (in milliseconds)
+     */
+    float accel_build_time() const { return m_accel_build_time; }
+
     /// Return a human-readable string representation of the scene contents.
     virtual std::string to_string() const override;
 
@@ -795,16 +828,22 @@ protected:
 
     ScalarFloat m_emitter_pmf;
     std::unique_ptr<DiscreteDistribution<Float>> m_emitter_distr = nullptr;
+    /// Spatially aware emitter selection (only if requested, see \ref LightTree)
+    std::unique_ptr<LightTree<Float, Spectrum>> m_light_tree = nullptr;
+    bool m_use_light_tree;
 
     std::vector<ref<Shape>> m_silhouette_shapes;
     DynamicBuffer<ShapePtr> m_silhouette_shapes_dr;
     std::unique_ptr<DiscreteDistribution<Float>> m_silhouette_distr = nullptr;
 
     bool m_shapes_grad_enabled;
+    bool m_needs_uv_partials;
     bool m_thread_reordering;
     /// Compact GPU acceleration structures after building. This reduces BLAS
     /// memory at the cost of an extra build-time query and compaction pass.
     bool m_compact_accel;
+    AccelQuality m_accel_quality;
+    float m_accel_build_time = 0.f;
 
     // The Accel class needs to access the scene's protected members.
     friend SceneAccel<Float, Spectrum>;
@@ -812,7 +851,8 @@ protected:
     MI_DECLARE_TRAVERSE_CB(m_accel, m_emitters, m_emitters_dr, m_shapes,
                            m_shapes_dr, m_shapegroups, m_sensors, m_sensors_dr,
                            m_children, m_integrator, m_environment,
-                           m_emitter_pmf, m_emitter_distr, m_silhouette_shapes,
+                           m_emitter_pmf, m_emitter_distr, m_light_tree,
+                           m_silhouette_shapes,
                            m_silhouette_shapes_dr, m_silhouette_distr)
 };
 
@@ -100,6 +100,21 @@ struct ShapeIR {
     /// BLAS-set cache key (shared by all instances of one ShapeGroup).
     const void *group_id = nullptr;
 
+    /// Keyframe of a motion-blurred instance, decomposed as
+    /// ``translate(trans) * rotate(quat) * scale``.
+    struct MotionKey {
+        /// Upper triangular scale/shear matrix (row-major: xx, xy, xz, yy, yz, zz)
+        float scale[6];
+        /// Rotation quaternion (r, i, j, k)
+        float quat[4];
+        float trans[3];
+    };
+
+    /// Keyframes of a motion-blurred instance spaced uniformly over
+    /// \ref motion_time (empty for static instances, see \ref to_world).
+    std::vector<MotionKey> motion;
+    float motion_time[2] = { 0.f, 1.f };
+
     /// Resolved per-shape POD byte count (see \ref data_size).
     size_t data_size_bytes() const {
         return data_size ? data_size : prim_count * pdata_size;
@@ -72,6 +72,34 @@ enum class DiscontinuityFlags : uint32_t {
 };
 MI_DECLARE_ENUM_OPERATORS(DiscontinuityFlags)
 
+/**
+ * \brief Describes how the geometry of a dirty shape changed
+ *
+ * The scene uses this information to update its acceleration data structure
+ * incrementally where possible (see \ref Scene::parameters_changed()).
+ */
+enum class ShapeDirtyFlags : uint32_t {
+    /// The geometry is unchanged
+    Clean = 0x0,
+
+    /**
+     * \brief Vertex positions moved, while the number of primitives and their
+     * connectivity stayed the same. The bounds of the acceleration data
+     * structure can be refit.
+     */
+    Vertices = 0x1,
+
+    /**
+     * \brief Only the transformation of an instance changed. The top level of
+     * the acceleration data structure must be rebuilt.
+     */
+    Transform = 0x2,
+
+    /// Any other change, which requires a full rebuild
+    Topology = 0x4
+};
+MI_DECLARE_ENUM_OPERATORS(ShapeDirtyFlags)
+
 /// Forward declaration for `SilhouetteSample`
 template <typename Float, typename Spectrum> class Shape;
 
@@ -602,6 +630,9 @@ public:
      * \param ray
      *     The ray to be tested for an intersection
      *
+     * \param prim_index
+     *     Index of the primitive to be intersected
+     *
      * \return
      *     A tuple containing the following field: \c valid, \c t, \c uv,
      *     \c shape_index, \c prim_index. The \c shape_index should be only used by the
@@ -609,8 +640,10 @@ public:
      */
     virtual std::tuple<bool, ScalarFloat, ScalarPoint2f,
                        ScalarUInt32, ScalarUInt32>
-    ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const;
-    virtual bool ray_test_scalar(const ScalarRay3f &ray) const;
+    ray_intersect_preliminary_scalar(const ScalarRay3f &ray,
+                                     ScalarIndex prim_index = 0) const;
+    virtual bool ray_test_scalar(const ScalarRay3f &ray,
+                                 ScalarIndex prim_index = 0) const;
 
     /// Macro to declare packet versions of the scalar routine above
     #define MI_DECLARE_RAY_INTERSECT_PACKET(N)                                  \
@@ -923,8 +956,19 @@ public:
     /// Return whether the shape's geometry has changed
     bool dirty() const { return m_dirty; }
 
-    /// Mark that the shape's geometry has changed
-    void mark_dirty() { m_dirty = true; }
+    /// Return how the shape's geometry has changed (see \ref ShapeDirtyFlags)
+    uint32_t dirty_flags() const { return m_dirty_flags; }
+
+    /**
+     * \brief Mark that the shape's geometry has changed
+     *
+     * Changes accumulate until the scene updates its acceleration data
+     * structure. The default conservatively requests a full rebuild.
+     */
+    void mark_dirty(ShapeDirtyFlags flags = ShapeDirtyFlags::Topology) {
+        m_dirty = true;
+        m_dirty_flags |= (uint32_t) flags;
+    }
 
     // Mark that shape as an instance
     void mark_as_instance() { m_is_instance = true; }
@@ -974,6 +1018,9 @@ protected:
     /// True if the shape's geometry has changed
     bool m_dirty = true;
 
+    /// How the shape's geometry has changed (see \ref ShapeDirtyFlags)
+    uint32_t m_dirty_flags = (uint32_t) ShapeDirtyFlags::Topology;
+
     /// True if the shape has called initialize() at least once
     bool m_initialized = false;
 
@@ -1055,11 +1102,13 @@ NAMESPACE_END(mitsuba)
     }                                                                                       \
     using typename Base::ScalarRay3f;                                                       \
     std::tuple<bool, ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>                \
-    ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const override {               \
-        return ray_intersect_preliminary_impl<ScalarFloat>(ray, 0, true);                   \
+    ray_intersect_preliminary_scalar(const ScalarRay3f &ray,                                \
+                                     ScalarIndex prim_index = 0) const override {           \
+        return ray_intersect_preliminary_impl<ScalarFloat>(ray, prim_index, true);          \
     }                                                                                       \
-    ScalarMask ray_test_scalar(const ScalarRay3f &ray) const override {                     \
-        return ray_test_impl<ScalarFloat>(ray, 0, true);                                    \
+    ScalarMask ray_test_scalar(const ScalarRay3f &ray,                                      \
+                               ScalarIndex prim_index = 0) const override {                 \
+        return ray_test_impl<ScalarFloat>(ray, prim_index, true);                           \
     }                                                                                       \
     MI_IMPLEMENT_RAY_INTERSECT_PACKET(4)                                                    \
     MI_IMPLEMENT_RAY_INTERSECT_PACKET(8)                                                    \
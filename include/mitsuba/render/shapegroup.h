@@ -13,10 +13,11 @@ NAMESPACE_BEGIN(mitsuba)
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB ShapeGroup : public Shape<Float, Spectrum> {
 public:
-    MI_IMPORT_BASE(Shape, m_dirty)
+    MI_IMPORT_BASE(Shape, m_dirty, m_dirty_flags)
     MI_IMPORT_TYPES(ShapeKDTree, ShapePtr)
 
     using typename Base::ScalarSize;
+    using typename Base::ScalarIndex;
     using typename Base::ScalarRay3f;
 
     ShapeGroup(const Properties &props);
@@ -24,8 +25,10 @@ public:
 
 #if !defined(MI_ENABLE_EMBREE)
     std::tuple<bool, ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
-    ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const override;
-    bool ray_test_scalar(const ScalarRay3f &ray) const override;
+    ray_intersect_preliminary_scalar(const ScalarRay3f &ray,
+                                     ScalarIndex prim_index = 0) const override;
+    bool ray_test_scalar(const ScalarRay3f &ray,
+                         ScalarIndex prim_index = 0) const override;
 #endif
 
     SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
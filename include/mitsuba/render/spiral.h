@@ -28,11 +28,19 @@ public:
     using Vector2u = Vector<uint32_t, 2>;
     using Point2i = Point<int32_t, 2>;
 
-    /// Create a new spiral generator for the given size, offset into a larger frame, and block size
+    /**
+     * \brief Create a new spiral generator for the given size, offset into a
+     * larger frame, and block size
+     *
+     * When \c scanline is set, the blocks are instead generated row by row
+     * from the top left, which streaming films rely on to write finished
+     * rows of the image to disk while rendering.
+     */
     Spiral(const Vector2u &size,
            const Vector2u &offset,
            uint32_t block_size,
-           uint32_t passes = 1);
+           uint32_t passes = 1,
+           bool scanline = false);
 
     /// Return the maximum block size
     uint32_t max_block_size() const { return m_block_size; }
@@ -66,6 +74,7 @@ protected:
     uint32_t m_block_size;    //< Size of the (square) blocks (in pixels)
     uint32_t m_steps_left;    //< Steps before next change of direction
     uint32_t m_spiral_size;   //< Current spiral size in blocks
+    bool m_scanline;          //< Generate blocks in scanline order?
 };
 
 NAMESPACE_END(mitsuba)
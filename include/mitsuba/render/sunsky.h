@@ -7,11 +7,13 @@
 #include <drjit/sphere.h>
 #include <drjit/tensor.h>
 #include <mitsuba/core/warp.h>
+#include <mitsuba/core/distr_2d.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/tensor.h>
+#include <nanothread/nanothread.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -175,6 +177,7 @@ public:
 
     using FloatStorage    = DynamicBuffer<Float>;
     using SamplingWeights = dr::Array<Float, MPDF_CHANNELS>;
+    using SkyWarp         = Hierarchical2D<Float, 0>;
 
     using USpec       = unpolarized_spectrum_t<Spectrum>;
     using USpecUInt32 = dr::uint32_array_t<USpec>;
@@ -208,6 +211,11 @@ public:
 
         m_complex_sun = props.get<bool>("complex_sun", false);
 
+        m_bake_sky = props.get<bool>("bake_sky", false);
+        m_sky_bake_res = props.get<ScalarUInt32>("sky_bake_resolution", 128);
+        if (m_sky_bake_res < 2)
+            Log(Error, "Invalid sky bake resolution: %u, must be at least 2!", m_sky_bake_res);
+
         m_albedo_tex = props.get_texture<Texture>("albedo", 0.3f);
         if (m_albedo_tex->is_spatially_varying())
             Log(Error, "Expected a non-spatially varying radiance spectra!");
@@ -294,6 +302,11 @@ public:
             << "\n\tSky scale = " << m_sky_scale
             << "\n\tSun aperture = " << dr::rad_to_deg(2 * m_sun_half_aperture)
             << "\n\tComplex sun model = " << (m_complex_sun ? "true" : "false");
+        if (m_bake_sky) {
+            ScalarVector2u cells = sky_map_cells();
+            oss << "\n\tBaked sky = " << cells.x() << "x" << cells.y()
+                << " (relative error: " << m_sky_bake_error << ")";
+        }
         return oss.str();
     }
 
@@ -327,9 +340,9 @@ public:
                                       Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
         const Point2f sun_angles = get_sun_angles(time);
-        active &= sun_angles.x() <= 0.5f * dr::Pi<Float>;
+        active &= sky_or_sun_up(sun_angles);
 
-        const Float sky_sampling_w = get_sky_sampling_weight(sun_angles.x(), active);
+        const Float sky_sampling_w = sky_sampling_weight(sun_angles, active);
 
         // 1. Sample spatial component
         Point2f offset = warp::square_to_uniform_disk_concentric(sample2);
@@ -398,9 +411,9 @@ public:
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
 
         const Point2f sun_angles = get_sun_angles(it.time);
-        active &= sun_angles.x() <= 0.5f * dr::Pi<Float>;
+        active &= sky_or_sun_up(sun_angles);
 
-        const Float sky_sampling_w = get_sky_sampling_weight(sun_angles.x(), active);
+        const Float sky_sampling_w = sky_sampling_weight(sun_angles, active);
 
         Mask pick_sky = sample.x() < sky_sampling_w;
 
@@ -442,9 +455,9 @@ public:
                     Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
         const Point2f sun_angles = get_sun_angles(ds.time);
-        active &= sun_angles.x() <= 0.5f * dr::Pi<Float>;
+        active &= sky_or_sun_up(sun_angles);
 
-        const Float sky_sampling_w = get_sky_sampling_weight(sun_angles.x(), active);
+        const Float sky_sampling_w = sky_sampling_weight(sun_angles, active);
 
         Vector3f local_dir = dr::normalize(m_to_world.value().inverse() * ds.d);
         Float sky_pdf, sun_pdf;
@@ -557,10 +570,12 @@ protected:
         Float cos_theta = Frame3f::cos_theta(local_wo),
               gamma = dr::unit_angle(sun_dir, local_wo);
 
-        active &= (cos_theta >= 0.f) &&
-                    (Frame3f::cos_theta(sun_dir) >= 0.f);
-
-        hit_sun &= active;
+        /* The baked sky already averages over the instants at which the sun
+           is down, only the sun itself follows the current elevation */
+        Mask sun_up = Frame3f::cos_theta(sun_dir) >= 0.f;
+        active &= cos_theta >= 0.f;
+        hit_sun &= active && sun_up;
+        Mask sky_active = m_bake_sky ? active : active && sun_up;
 
         USpec res = 0.f;
         if constexpr (!is_spectral_v<Spectrum>) {
@@ -572,8 +587,13 @@ protected:
                 idx = USpecUInt32(0);
 
             if (m_sky_scale > 0.f) {
-                const auto [ sky_rad, sky_params ] = get_sky_datasets(sun_angles.x(), idx, active);
-                res = m_sky_scale * eval_sky(cos_theta, gamma, sky_params, sky_rad);
+                if (m_bake_sky) {
+                    res = m_sky_scale * eval_sky_map(local_wo, idx, sky_active);
+                } else {
+                    const auto [ sky_rad, sky_params ] = get_sky_datasets(sun_angles.x(), idx, sky_active);
+                    res = m_sky_scale * eval_sky(cos_theta, gamma, sky_params, sky_rad);
+                }
+                res &= sky_active;
             }
 
             if (m_sun_scale > 0.f) {
@@ -595,14 +615,20 @@ protected:
             Wavelength lerp_factor = normalized_wavelengths - query_idx_low;
 
             if (m_sky_scale > 0.f) {
-                const auto [ sky_rad_low, sky_params_low ] = get_sky_datasets(sun_angles.x(), query_idx_low, active & valid_idx);
-                const auto [ sky_rad_high, sky_params_high ] = get_sky_datasets(sun_angles.x(), query_idx_high, active & valid_idx);
+                USpec sky_low, sky_high;
+                if (m_bake_sky) {
+                    sky_low  = eval_sky_map(local_wo, query_idx_low, sky_active & valid_idx);
+                    sky_high = eval_sky_map(local_wo, query_idx_high, sky_active & valid_idx);
+                } else {
+                    const auto [ sky_rad_low, sky_params_low ] = get_sky_datasets(sun_angles.x(), query_idx_low, sky_active & valid_idx);
+                    const auto [ sky_rad_high, sky_params_high ] = get_sky_datasets(sun_angles.x(), query_idx_high, sky_active & valid_idx);
+                    sky_low  = eval_sky(cos_theta, gamma, sky_params_low, sky_rad_low);
+                    sky_high = eval_sky(cos_theta, gamma, sky_params_high, sky_rad_high);
+                }
 
                 // Linearly interpolate the sky's irradiance across the spectrum
-                res = m_sky_scale * dr::lerp(
-                    eval_sky(cos_theta, gamma, sky_params_low, sky_rad_low),
-                    eval_sky(cos_theta, gamma, sky_params_high, sky_rad_high),
-                    lerp_factor);
+                res = m_sky_scale * dr::lerp(sky_low, sky_high, lerp_factor);
+                res &= sky_active;
             }
 
             if (m_sun_scale > 0.f) {
@@ -787,8 +813,24 @@ protected:
     // ===================================== SAMPLING FUNCTIONS =======================================
     // ================================================================================================
 
+    /// Indicates lanes where the emitter is visible, i.e. where the sun is up or the sky is baked
+    Mask sky_or_sun_up(const Point2f &sun_angles) const {
+        return Mask(m_bake_sky) || sun_angles.x() <= 0.5f * dr::Pi<Float>;
+    }
+
+    /// Probability of sampling the sky, which is the only choice for a baked sky at night
+    Float sky_sampling_weight(const Point2f &sun_angles, const Mask &active) const {
+        Float weight = get_sky_sampling_weight(sun_angles.x(), active);
+        if (m_bake_sky)
+            dr::masked(weight, sun_angles.x() > 0.5f * dr::Pi<Float>) = 1.f;
+        return weight;
+    }
+
 
     Vector3f sample_sky(Point2f sample, const Point2f& sun_angles, const Mask& active) const {
+        if (m_bake_sky)
+            return sky_map_dir(m_sky_warp.sample(sample, nullptr, active).first);
+
         SamplingWeights weights = get_sampling_weights(sun_angles.x(), active);
 
         Mask sample_trunc_gaussian = sample.x() < weights[0];
@@ -848,6 +890,18 @@ protected:
 
 
     Float eval_sky_pdf(const Point2f& angles, const Point2f& sun_angles, Mask active) const {
+        if (m_bake_sky) {
+            Float u = angles.y() * dr::InvTwoPi<Float>,
+                  sin_theta = dr::sin(angles.x());
+            active &= (angles.x() <= 0.5f * dr::Pi<Float>) && (sin_theta > 0.f);
+
+            // Jacobian of the mapping from the unit square to the hemisphere
+            Float pdf = m_sky_warp.eval(
+                Point2f(u - dr::floor(u), angles.x() * (2.f * dr::InvPi<Float>)),
+                nullptr, active) / (dr::square(dr::Pi<Float>) * sin_theta);
+            return dr::select(active, pdf, 0.f);
+        }
+
         Point2f uv {
             dr::cos(angles.x()), // cos_theta
             angles.y()  // phi
@@ -934,6 +988,247 @@ protected:
         return {sky_pdf, sun_pdf};
     }
 
+    // ================================================================================================
+    // ======================================== BAKED SKY =============================================
+    // ================================================================================================
+
+    /**
+     * \brief Indicates whether a parameter update invalidates the baked sky
+     *
+     * The sky and sun scales as well as the transform are applied on lookup,
+     * so that updating them does not require a new bake.
+     */
+    bool sky_bake_outdated(const std::vector<std::string> &keys) const {
+        if (!m_bake_sky)
+            return false;
+        for (const std::string &key : keys)
+            if (key != "sky_scale" && key != "sun_scale" && key != "to_world")
+                return true;
+        return keys.empty();
+    }
+
+    /**
+     * \brief Tabulates the sky radiance and builds a sampling warp proportional to it
+     *
+     * The sky is stored in an equirectangular map over the upper hemisphere,
+     * which \ref eval() and the sky sampling routines then use instead of the
+     * analytic model. The sun is unaffected. Time-dependent skies are
+     * averaged over the given time interval. Subclasses must call this
+     * function whenever their sky datasets change. It does nothing unless
+     * the ``bake_sky`` parameter was set.
+     *
+     * \param time_start Start of the time interval to average over
+     * \param time_end End of the time interval to average over
+     * \param time_samples Number of instants to average
+     */
+    void bake_sky(ScalarFloat time_start = 0.f, ScalarFloat time_end = 0.f,
+                  uint32_t time_samples = 1) {
+        if (!m_bake_sky)
+            return;
+
+        ScalarVector2u cells = sky_map_cells(),
+                       res   = cells + 1u;
+
+        /* The map stores the vertices. Its error is estimated at the centers
+           of a sparse subset of the cells, which keeps the cost of the
+           estimate small compared to the bake itself. */
+        constexpr uint32_t error_stride = 4;
+        ScalarVector2u ref_size = (cells + (error_stride - 1)) / error_stride;
+        m_sky_map = tabulate_sky(res, 1, 0.f, time_start, time_end, time_samples);
+        FloatStorage ref = tabulate_sky(ref_size, error_stride, .5f, time_start,
+                                        time_end, time_samples);
+
+        auto &&map_host = dr::migrate(m_sky_map, JitBackend::None);
+        auto &&ref_host = dr::migrate(ref, JitBackend::None);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        const ScalarFloat *map_ptr = (const ScalarFloat *) map_host.data(),
+                          *ref_ptr = (const ScalarFloat *) ref_host.data();
+
+        // Sampling density: luminance scaled by the Jacobian of the parameterization
+        ScalarFloat theta_scale = .5f * dr::Pi<ScalarFloat> / cells.y();
+        std::unique_ptr<ScalarFloat[]> lum(new ScalarFloat[dr::prod(res)]);
+        double lum_sum = 0.0;
+        for (uint32_t y = 0; y < res.y(); ++y) {
+            ScalarFloat sin_theta = dr::sin(y * theta_scale);
+            for (uint32_t x = 0; x < res.x(); ++x) {
+                size_t i = (size_t) y * res.x() + x;
+                const ScalarFloat *value = map_ptr + i * CHANNEL_COUNT;
+
+                ScalarFloat l = 0.f;
+                if constexpr (is_rgb_v<Spectrum>) {
+                    l = luminance(ScalarColor3f(value[0], value[1], value[2]));
+                } else {
+                    for (uint32_t c = 0; c < CHANNEL_COUNT; ++c)
+                        l += value[c];
+                    l /= CHANNEL_COUNT;
+                }
+
+                lum[i] = dr::maximum(l, 0.f) * sin_theta;
+                lum_sum += lum[i];
+            }
+        }
+
+        // The sky vanishes when the sun is below the horizon, sample uniformly
+        if (lum_sum == 0.0) {
+            for (uint32_t y = 0; y < res.y(); ++y)
+                for (uint32_t x = 0; x < res.x(); ++x)
+                    lum[(size_t) y * res.x() + x] = dr::sin(y * theta_scale);
+        }
+
+        m_sky_warp = SkyWarp(lum.get(), res);
+
+        // Relative L1 error of the bilinear reconstruction, which is largest at the cell centers
+        double err = 0.0, norm = 0.0;
+        for (uint32_t y = 0; y < ref_size.y(); ++y) {
+            uint32_t cy = y * error_stride;
+            double sin_theta = dr::sin((cy + .5f) * theta_scale);
+            for (uint32_t x = 0; x < ref_size.x(); ++x) {
+                uint32_t cx = x * error_stride;
+                const ScalarFloat *v00 = map_ptr + ((size_t) cy * res.x() + cx) * CHANNEL_COUNT,
+                                  *v01 = v00 + (size_t) res.x() * CHANNEL_COUNT,
+                                  *r = ref_ptr + ((size_t) y * ref_size.x() + x) * CHANNEL_COUNT;
+
+                for (uint32_t c = 0; c < CHANNEL_COUNT; ++c) {
+                    double baked = .25 * ((double) v00[c] + v00[c + CHANNEL_COUNT] +
+                                          v01[c] + v01[c + CHANNEL_COUNT]);
+                    err  += dr::abs(baked - r[c]) * sin_theta;
+                    norm += dr::abs((double) r[c]) * sin_theta;
+                }
+            }
+        }
+        m_sky_bake_error = norm > 0.0 ? ScalarFloat(err / norm) : 0.f;
+
+        Log(Debug, "Baked the sky radiance into a %ux%u map (relative error: %.3g%%)",
+            cells.x(), cells.y(), 100.f * m_sky_bake_error);
+    }
+
+    /**
+     * \brief Evaluates the analytic sky model on a regular grid over the
+     * coordinates of the baked sky map
+     *
+     * \param size Number of grid points along each axis
+     * \param stride Spacing of the grid points, in units of map cells
+     * \param offset Offset of the grid points, in units of map cells
+     * \param time_start Start of the time interval to average over
+     * \param time_end End of the time interval to average over
+     * \param time_samples Number of instants to average
+     * \return The sky radiance of all channels, interleaved per grid point
+     */
+    FloatStorage tabulate_sky(const ScalarVector2u &size, uint32_t stride,
+                              ScalarFloat offset, ScalarFloat time_start,
+                              ScalarFloat time_end, uint32_t time_samples) const {
+        constexpr size_t SpecSize = dr::size_v<USpec>;
+
+        ScalarVector2f cells(sky_map_cells());
+        uint32_t point_count = dr::prod(size);
+        ScalarFloat weight = 1.f / time_samples;
+
+        FloatStorage result = dr::zeros<FloatStorage>(point_count * CHANNEL_COUNT);
+
+        // Each lane evaluates one grid point at one instant
+        auto tabulate = [&](const UInt32 &index) {
+            UInt32 point = index % point_count,
+                   time_idx = index / point_count;
+
+            Point2f uv(dr::fmadd(Float(point % size.x()), (ScalarFloat) stride, offset) / cells.x(),
+                       dr::fmadd(Float(point / size.x()), (ScalarFloat) stride, offset) / cells.y());
+            Vector3f d = sky_map_dir(uv);
+
+            Float time = time_start + (time_end - time_start) * ((Float(time_idx) + .5f) * weight);
+            Point2f sun_angles = get_sun_angles(time);
+            Vector3f sun_dir = sph_to_dir(sun_angles.x(), sun_angles.y());
+
+            Float cos_theta = Frame3f::cos_theta(d),
+                  gamma = dr::unit_angle(sun_dir, d);
+            Mask active = (cos_theta >= 0.f) && (Frame3f::cos_theta(sun_dir) >= 0.f);
+
+            for (uint32_t c = 0; c < CHANNEL_COUNT; c += SpecSize) {
+                USpecUInt32 channel_idx;
+                for (size_t i = 0; i < SpecSize; ++i)
+                    channel_idx[i] = c + (uint32_t) i;
+                USpecMask valid = channel_idx < CHANNEL_COUNT;
+
+                const auto [ sky_rad, sky_params ] =
+                    get_sky_datasets(sun_angles.x(), channel_idx, active & valid);
+                USpec value = eval_sky(cos_theta, gamma, sky_params, sky_rad);
+
+                for (size_t i = 0; i < SpecSize && c + i < CHANNEL_COUNT; ++i)
+                    dr::scatter_reduce(ReduceOp::Add, result, value[i] * weight,
+                                       point * CHANNEL_COUNT + c + (uint32_t) i,
+                                       active);
+            }
+        };
+
+        if constexpr (dr::is_jit_v<Float>) {
+            tabulate(dr::arange<UInt32>(point_count * time_samples));
+        } else {
+            // Threads own disjoint grid points, so their accumulations don't race
+            dr::parallel_for(
+                dr::blocked_range<uint32_t>(0, point_count, 64),
+                [&](const dr::blocked_range<uint32_t> &range) {
+                    for (uint32_t point = range.begin(); point != range.end(); ++point)
+                        for (uint32_t t = 0; t < time_samples; ++t)
+                            tabulate(t * point_count + point);
+                });
+        }
+
+        dr::eval(result);
+        return result;
+    }
+
+    /**
+     * \brief Bilinearly interpolates the baked sky radiance
+     *
+     * \param local_wo Direction in local space
+     * \param channel_idx Indices of the queried channels
+     * \param active Indicates which channels are valid indices
+     * \return The sky radiance (not scaled by the sky scale)
+     */
+    USpec eval_sky_map(const Vector3f &local_wo, const USpecUInt32 &channel_idx,
+                       const USpecMask &active) const {
+        ScalarVector2u cells = sky_map_cells(),
+                       res   = cells + 1u;
+
+        Point2f uv = sky_map_uv(local_wo),
+                pos(uv.x() * cells.x(), uv.y() * cells.y());
+        Point2u p0 = dr::minimum(dr::floor2int<Point2u>(pos),
+                                 Point2u(res.x() - 2, res.y() - 2));
+        Point2f w1 = pos - Point2f(p0),
+                w0 = 1.f - w1;
+
+        UInt32 i00 = (p0.y() * res.x() + p0.x()) * CHANNEL_COUNT,
+               i10 = i00 + CHANNEL_COUNT,
+               i01 = i00 + res.x() * CHANNEL_COUNT,
+               i11 = i01 + CHANNEL_COUNT;
+
+        auto fetch = [&](const UInt32 &offset) {
+            return dr::gather<USpec>(m_sky_map, offset + channel_idx, active);
+        };
+
+        USpec v0 = dr::fmadd(w0.x(), fetch(i00), w1.x() * fetch(i10)),
+              v1 = dr::fmadd(w0.x(), fetch(i01), w1.x() * fetch(i11));
+
+        return dr::fmadd(w0.y(), v0, w1.y() * v1);
+    }
+
+    /// Number of cells of the baked sky map along the azimuth and the elevation
+    MI_INLINE ScalarVector2u sky_map_cells() const {
+        return { 4 * m_sky_bake_res, m_sky_bake_res };
+    }
+
+    /// Maps a local direction of the upper hemisphere to the unit square of the baked sky map
+    MI_INLINE Point2f sky_map_uv(const Vector3f &d) const {
+        Float u = dr::atan2(d.y(), d.x()) * dr::InvTwoPi<Float>;
+        return { u - dr::floor(u),
+                 dr::clip(dr::safe_acos(d.z()) * (2.f * dr::InvPi<Float>), 0.f, 1.f) };
+    }
+
+    /// Inverse of \ref sky_map_uv()
+    MI_INLINE Vector3f sky_map_dir(const Point2f &uv) const {
+        return sph_to_dir(uv.y() * (.5f * dr::Pi<Float>), uv.x() * dr::TwoPi<Float>);
+    }
+
     // ================================================================================================
     // ====================================== HELPER FUNCTIONS ========================================
     // ================================================================================================
@@ -1182,6 +1477,18 @@ protected:
 
     ScalarFloat m_sun_half_aperture;
 
+    // ========= Baked sky =========
+    /// Indicates if the sky radiance is tabulated in \ref m_sky_map
+    ScalarBool m_bake_sky;
+    /// Number of cells of the baked sky map along the elevation
+    ScalarUInt32 m_sky_bake_res;
+    /// Sky radiance at the vertices of the baked map, with interleaved channels
+    FloatStorage m_sky_map;
+    /// Sampling warp proportional to the luminance of the baked sky
+    SkyWarp m_sky_warp;
+    /// Relative L1 error of the baked sky with respect to the analytic model
+    ScalarFloat m_sky_bake_error = 0.f;
+
     // Precomputed dataset
     FloatStorage m_sun_radiance;
 
@@ -213,6 +213,13 @@ public:
     /// Does this texture evaluation depend on the UV coordinates
     virtual bool is_spatially_varying() const { return false; }
 
+    /**
+     * \brief Does this texture filter over the footprint given by the UV
+     * partials of the surface interaction? Integrators only compute these
+     * partials when some texture of the scene requests them.
+     */
+    virtual bool needs_uv_partials() const { return false; }
+
     /// Convenience function returning the standard D65 illuminant
     static ref<Texture> D65(ScalarFloat scale = 1.f);
 
@@ -60,9 +60,27 @@ public:
      */
     virtual void max_per_channel(ScalarFloat *out) const;
 
+    /**
+     * \brief Compute upper bounds of the volume over the cells of a coarse
+     * grid
+     *
+     * The grid of resolution \c res subdivides the unit cube of the volume's
+     * local coordinate system. Entry <tt>(z * res.y() + y) * res.x() + x</tt>
+     * of \c out receives an upper bound of the values returned by \ref eval()
+     * and \ref eval_1() anywhere within cell <tt>(x, y, z)</tt>, accounting
+     * for interpolation. The default implementation fills the grid with
+     * \ref max().
+     *
+     * Pointer allocation/deallocation must be performed by the caller.
+     */
+    virtual void max_grid(const ScalarVector3u &res, ScalarFloat *out) const;
+
     /// Returns the bounding box of the volume
     ScalarBoundingBox3f bbox() const { return m_bbox; }
 
+    /// Returns the transformation from world space into the volume's unit cube
+    const ScalarAffineTransform4f &to_local() const { return m_to_local; }
+
     /**
      * \brief Returns the resolution of the volume, assuming that it is based
      * on a discrete representation.
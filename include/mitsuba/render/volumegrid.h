@@ -10,6 +10,15 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Version of the bricked sparse volume format (see \ref VolumeGrid::write_sparse())
+constexpr uint8_t SparseVolumeVersion = 1;
+
+/// Brick index entry denoting an empty brick in a sparse volume file
+constexpr uint32_t SparseVolumeEmptyBrick = 0xFFFFFFFFu;
+
+/// Alignment of the brick data in a sparse volume file
+constexpr size_t SparseVolumeAlignment = 4096;
+
 /**
  * \brief Class to read and write 3D volume grids
  *
@@ -104,6 +113,25 @@ public:
      */
     void write(Stream *stream) const;
 
+    /**
+     * \brief Write the volume grid to a bricked sparse volume file
+     *
+     * The grid is split into dense bricks of <tt>brick_size^3</tt> voxels
+     * (8 or 16), and bricks whose voxels are all zero are omitted. Such files
+     * are read by the \c sparsegridvolume plugin, whose documentation
+     * specifies the format.
+     *
+     * \param path
+     *    Target file name
+     *
+     * \param brick_size
+     *    Number of voxels along each side of a brick
+     */
+    void write_sparse(const fs::path &path, uint32_t brick_size = 16) const;
+
+    /// Write the volume grid to a stream using the bricked sparse format
+    void write_sparse(Stream *stream, uint32_t brick_size = 16) const;
+
     /// Return a human-readable summary of this volume grid
     virtual std::string to_string() const override;
 
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Compare the results of ``mitsuba-bench`` against a stored baseline.
+
+Both files are JSON documents written by ``mitsuba-bench -o <file>``::
+
+    python3 resources/bench_compare.py baseline.json results.json
+
+Measurements are matched by variant, scene and metric name. Metrics ending
+in ``_per_s`` are throughputs (higher is better), all others are times or
+memory sizes (lower is better). The relative change of every metric is
+printed, and the script exits with status 1 if any of them regressed by more
+than the given threshold (10% by default), so that it can gate a CI job.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import sys
+
+
+def load(filename: str) -> dict[tuple[str, str, str], float]:
+    with open(filename) as f:
+        doc = json.load(f)
+
+    result = {}
+    for record in doc['results']:
+        for name, value in record.items():
+            if name in ('variant', 'scene'):
+                continue
+            result[(record['variant'], record['scene'], name)] = float(value)
+    return result
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('baseline', help='JSON file with the reference results')
+    parser.add_argument('results', help='JSON file with the new results')
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='relative change that counts as a regression '
+                             '(default: 0.1)')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    results = load(args.results)
+
+    regressions = 0
+    for key in sorted(baseline.keys() & results.keys()):
+        old, new = baseline[key], results[key]
+        if old == 0:
+            continue
+        change = (new - old) / old
+        higher_is_better = key[2].endswith('_per_s')
+        regressed = (-change if higher_is_better else change) > args.threshold
+        regressions += regressed
+        print('%-20s %-12s %-26s %12.3f -> %12.3f (%+6.1f%%)%s' % (
+            *key, old, new, change * 100, '  REGRESSION' if regressed else ''))
+
+    for key in sorted(baseline.keys() - results.keys()):
+        print('%-20s %-12s %-26s missing from the new results' % key)
+
+    if regressions:
+        print('\n%i metric(s) regressed by more than %g%%.' %
+              (regressions, args.threshold * 100))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1371,18 +1371,29 @@ void Bitmap::read_exr(Stream *stream) {
     }
 }
 
-void Bitmap::write_exr(Stream *stream, int quality) const {
-    ScopedPhase phase(ProfilerPhase::BitmapWrite);
+/// Map a component format onto the corresponding OpenEXR pixel type
+static Imf::PixelType exr_pixel_type(sj::Type type) {
+    switch (type) {
+        case sj::Type::Float32: return Imf::FLOAT;
+        case sj::Type::Float16: return Imf::HALF;
+        case sj::Type::UInt32:  return Imf::UINT;
+        default: Throw("Unexpected field type!");
+    }
+}
 
-    PixelFormat pixel_format = m_pixel_format;
+/// Create the header of an OpenEXR file with the metadata and pixel format of a bitmap
+static Imf::Header exr_header(const Bitmap *bitmap, const Vector<uint32_t, 2> &size,
+                              int quality) {
+    using PixelFormat = Bitmap::PixelFormat;
+    PixelFormat pixel_format = bitmap->pixel_format();
 
-    Properties metadata(m_metadata);
+    Properties metadata(bitmap->metadata());
     if (!metadata.has_property("generatedBy"))
         metadata.set("generatedBy", "Mitsuba version " MI_VERSION);
 
     Imf::Header header(
-        (int) m_size.x(),  // width
-        (int) m_size.y(),  // height,
+        (int) size.x(),    // width
+        (int) size.y(),    // height,
         1.f,               // pixelAspectRatio
         Imath::V2f(0, 0),  // screenWindowCenter,
         1.f,               // screenWindowWidth
@@ -1446,32 +1457,128 @@ void Bitmap::write_exr(Stream *stream, int quality) const {
             Imath::V2f(1.f / 3.f, 1.f / 3.f)));
     }
 
-    size_t pixel_stride = m_struct.nbytes(),
-           row_stride = pixel_stride * m_size.x();
+    for (auto field : bitmap->struct_())
+        header.channels().insert(field.name, Imf::Channel(exr_pixel_type(field.type)));
+
+    return header;
+}
+
+/**
+ * \brief Create an OpenEXR frame buffer referencing the pixels of a bitmap
+ *
+ * The bitmap holds rows <tt>[y, y + height)</tt> of the image, which lets
+ * the frame buffer describe just a band of a larger image.
+ */
+static Imf::FrameBuffer exr_framebuffer(const Bitmap *bitmap, uint32_t y = 0) {
+    size_t pixel_stride = bitmap->struct_().nbytes(),
+           row_stride = pixel_stride * bitmap->width();
 
-    Imf::ChannelList &channels = header.channels();
     Imf::FrameBuffer framebuffer;
-    const uint8_t *ptr = uint8_data();
-    for (auto field : m_struct) {
-        Imf::PixelType comp_type;
-        switch (field.type) {
-            case sj::Type::Float32: comp_type = Imf::FLOAT; break;
-            case sj::Type::Float16: comp_type = Imf::HALF; break;
-            case sj::Type::UInt32: comp_type = Imf::UINT; break;
-            default: Throw("Unexpected field type!");
-        }
+    const uint8_t *ptr = bitmap->uint8_data() - y * row_stride;
+    for (auto field : bitmap->struct_())
+        framebuffer.insert(field.name,
+                           Imf::Slice(exr_pixel_type(field.type),
+                                      (char *) (ptr + field.offset),
+                                      pixel_stride, row_stride));
+
+    return framebuffer;
+}
 
-        Imf::Slice slice(comp_type, (char *) (ptr + field.offset), pixel_stride, row_stride);
-        channels.insert(field.name, Imf::Channel(comp_type));
-        framebuffer.insert(field.name, slice);
-    }
+void Bitmap::write_exr(Stream *stream, int quality) const {
+    ScopedPhase phase(ProfilerPhase::BitmapWrite);
 
     EXROStream ostr(stream);
-    Imf::OutputFile file(ostr, header);
-    file.setFrameBuffer(framebuffer);
+    Imf::OutputFile file(ostr, exr_header(this, m_size, quality));
+    file.setFrameBuffer(exr_framebuffer(this));
     file.writePixels((int) m_size.y());
 }
 
+struct BitmapStreamWriter::BitmapStreamWriterPrivate {
+    fs::path filename;
+    ref<const Bitmap> layout;
+    uint32_t height = 0;
+    uint32_t rows_written = 0;
+    ref<FileStream> stream;
+    std::unique_ptr<EXROStream> ostr;
+    std::unique_ptr<Imf::OutputFile> file;
+};
+
+BitmapStreamWriter::BitmapStreamWriter(const fs::path &filename,
+                                       const Bitmap *layout, uint32_t height)
+    : d(new BitmapStreamWriterPrivate()) {
+    d->filename = filename;
+    d->layout = layout;
+    d->height = height;
+
+    if (height == 0 || layout->width() == 0)
+        Throw("BitmapStreamWriter: cannot write an empty image!");
+
+    d->stream = new FileStream(filename, FileStream::ETruncReadWrite);
+    d->ostr = std::make_unique<EXROStream>(d->stream.get());
+    d->file = std::make_unique<Imf::OutputFile>(
+        *d->ostr, exr_header(layout, Vector<uint32_t, 2>(layout->width(), height), 0));
+}
+
+BitmapStreamWriter::~BitmapStreamWriter() {
+    try {
+        close();
+    } catch (const std::exception &e) {
+        Log(Warn, "BitmapStreamWriter: could not finish writing \"%s\": %s",
+            d->filename.string(), e.what());
+    }
+}
+
+void BitmapStreamWriter::write(const Bitmap *band) {
+    ScopedPhase phase(ProfilerPhase::BitmapWrite);
+
+    if (!d->file)
+        Throw("BitmapStreamWriter::write(): the file was already closed!");
+
+    const Bitmap *layout = d->layout.get();
+    if (band->width() != layout->width() ||
+        band->pixel_format() != layout->pixel_format() ||
+        band->component_format() != layout->component_format() ||
+        band->channel_count() != layout->channel_count())
+        Throw("BitmapStreamWriter::write(): the band must match the width "
+              "and channel layout of the image (%s)!", layout->to_string());
+
+    if (d->rows_written + band->height() > d->height)
+        Throw("BitmapStreamWriter::write(): too many rows (%u + %u > %u)!",
+              d->rows_written, band->height(), d->height);
+
+    d->file->setFrameBuffer(exr_framebuffer(band, d->rows_written));
+    d->file->writePixels((int) band->height());
+    d->rows_written += (uint32_t) band->height();
+
+    if (d->rows_written == d->height)
+        close();
+}
+
+void BitmapStreamWriter::close() {
+    if (!d->file)
+        return;
+    if (d->rows_written != d->height)
+        Log(Warn, "BitmapStreamWriter: closing \"%s\" after writing only %u "
+            "of %u rows.", d->filename.string(), d->rows_written, d->height);
+    d->file.reset();
+    d->ostr.reset();
+    d->stream->close();
+}
+
+uint32_t BitmapStreamWriter::rows_written() const { return d->rows_written; }
+uint32_t BitmapStreamWriter::height() const { return d->height; }
+const fs::path &BitmapStreamWriter::filename() const { return d->filename; }
+
+std::string BitmapStreamWriter::to_string() const {
+    std::ostringstream oss;
+    oss << "BitmapStreamWriter[" << std::endl
+        << "  filename = \"" << d->filename.string() << "\"," << std::endl
+        << "  size = [" << d->layout->width() << ", " << d->height << "]," << std::endl
+        << "  rows_written = " << d->rows_written << std::endl
+        << "]";
+    return oss.str();
+}
+
 // -----------------------------------------------------------------------------
 //   JPEG bitmap I/O
 // -----------------------------------------------------------------------------
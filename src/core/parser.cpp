@@ -6,6 +6,7 @@
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/formatter.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/frame.h>
@@ -1388,6 +1389,224 @@ void transform_merge_equivalent(const ParserConfig &/*config*/, ParserState &sta
         Log(Info, "Merged %zu duplicate nodes", total_merged_count);
 }
 
+/// Hash the contents of a file that has been mapped into memory
+static uint64_t hash_file_contents(const void *data, size_t size) {
+    const uint8_t *ptr = (const uint8_t *) data;
+    uint64_t h = 0xcbf29ce484222325ull ^ size;
+
+    auto mix = [&h](uint64_t value) {
+        h = (h ^ value) * 0x9e3779b97f4a7c15ull;
+        h ^= h >> 32;
+    };
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t value;
+        memcpy(&value, ptr + i, 8);
+        mix(value);
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, ptr + i, size - i);
+    mix(tail);
+
+    return h;
+}
+
+/// Check whether two files have identical contents
+static bool files_equal(const fs::path &a, const fs::path &b) {
+    try {
+        ref<MemoryMappedFile> ma = new MemoryMappedFile(a),
+                              mb = new MemoryMappedFile(b);
+        return ma->size() == mb->size() &&
+               memcmp(ma->data(), mb->data(), ma->size()) == 0;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
+void transform_dedup_geometry(const ParserConfig &/*config*/, ParserState &state) {
+    if (state.empty() || state.root().type != ObjectType::Scene)
+        return;
+
+    // Count references, since only shapes with a single parent are replaced
+    std::vector<uint32_t> ref_count(state.size(), 0);
+    for (const auto &node : state.nodes)
+        for (const auto &prop : node.props.filter(Properties::Type::ResolvedReference))
+            ref_count[prop.get<Properties::ResolvedReference>().index()]++;
+
+    // A candidate is a top-level shape that loads a mesh file and that could
+    // be moved into a shape group (i.e., it is neither an emitter nor a sensor)
+    struct Candidate {
+        size_t node;
+        size_t file;
+    };
+
+    std::vector<Candidate> candidates;
+    std::vector<fs::path> files;
+    tsl::robin_map<std::string, size_t, std::hash<std::string_view>,
+                   std::equal_to<>> file_map;
+    ref<FileResolver> fr = mitsuba::file_resolver();
+
+    for (const auto &prop : state.root().props.filter(Properties::Type::ResolvedReference)) {
+        size_t idx = prop.get<Properties::ResolvedReference>().index();
+        const SceneNode &node = state[idx];
+        std::string_view plugin = node.props.plugin_name();
+
+        if (node.type != ObjectType::Shape || ref_count[idx] != 1 ||
+            (plugin != "ply" && plugin != "obj" && plugin != "serialized") ||
+            !node.props.has_property("filename") ||
+            node.props.type("filename") != Properties::Type::String)
+            continue;
+
+        bool eligible = true;
+        for (const auto &prop2 : node.props.filter(Properties::Type::ResolvedReference)) {
+            ObjectType type = state[prop2.get<Properties::ResolvedReference>().index()].type;
+            if (type == ObjectType::Emitter || type == ObjectType::Sensor)
+                eligible = false;
+        }
+
+        fs::path path = fr->resolve(node.props.get<std::string_view>("filename"));
+        if (!eligible || !fs::exists(path))
+            continue;
+
+        auto [it, inserted] = file_map.try_emplace(path.string(), files.size());
+        if (inserted)
+            files.push_back(path);
+        candidates.push_back({ idx, it->second });
+    }
+
+    if (candidates.size() < 2)
+        return;
+
+    // Hash the contents of all referenced files in parallel
+    std::vector<uint64_t> file_hash(files.size(), 0);
+    std::vector<size_t> file_size(files.size(), 0);
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, files.size(), 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                ref<MemoryMappedFile> mmap;
+                try {
+                    mmap = new MemoryMappedFile(files[i]);
+                } catch (const std::exception &) {
+                    continue;
+                }
+                file_size[i] = mmap->size();
+                file_hash[i] = hash_file_contents(mmap->data(), mmap->size());
+            }
+        }
+    );
+
+    // Unreadable files are left for the shape plugin to report
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [&](const Candidate &c) { return file_size[c.file] == 0; }),
+                     candidates.end());
+
+    // Map each file to the first file with identical contents. Matching
+    // hashes are confirmed by comparing the files byte by byte.
+    std::vector<size_t> file_canonical(files.size());
+    tsl::robin_map<uint64_t, std::vector<size_t>> files_by_hash;
+    for (size_t i = 0; i < files.size(); ++i) {
+        file_canonical[i] = i;
+        if (file_size[i] == 0)
+            continue;
+
+        std::vector<size_t> &matches = files_by_hash[file_hash[i]];
+        for (size_t j : matches) {
+            if (file_size[i] == file_size[j] && files_equal(files[i], files[j])) {
+                file_canonical[i] = j;
+                break;
+            }
+        }
+        if (file_canonical[i] == i)
+            matches.push_back(i);
+    }
+
+    /* Group candidates whose properties match apart from the transform and
+       the file name (which is replaced by the canonical file index) */
+    std::vector<Properties> keys;
+    keys.reserve(candidates.size());
+    for (const Candidate &c : candidates) {
+        Properties key = state[c.node].props;
+        key.remove_property("to_world");
+        key.remove_property("filename");
+        key.set("filename", std::to_string(file_canonical[c.file]), false);
+        keys.push_back(std::move(key));
+    }
+
+    struct KeyHasher {
+        const std::vector<Properties> *keys;
+        size_t operator()(size_t i) const { return (*keys)[i].hash(); }
+    };
+
+    struct KeyEqual {
+        const std::vector<Properties> *keys;
+        bool operator()(size_t a, size_t b) const { return (*keys)[a] == (*keys)[b]; }
+    };
+
+    tsl::robin_map<size_t, std::vector<size_t>, KeyHasher, KeyEqual>
+        groups(16, KeyHasher{ &keys }, KeyEqual{ &keys });
+    std::vector<size_t> group_order;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        auto [it, inserted] = groups.try_emplace(i);
+        if (inserted)
+            group_order.push_back(i);
+        it.value().push_back(i);
+    }
+
+    // Move one copy of each duplicated shape into a shape group and replace
+    // all copies by instances of that group
+    size_t instance_count = 0, group_count = 0, saved = 0;
+    bool track_paths = state.node_paths.size() == state.size();
+    for (size_t first : group_order) {
+        const std::vector<size_t> &members = groups.find(first)->second;
+        if (members.size() < 2)
+            continue;
+
+        SceneNode proto = state[candidates[first].node];
+        proto.props.remove_property("to_world");
+        proto.props.set_id("");
+
+        SceneNode group;
+        group.type = ObjectType::Shape;
+        group.file_index = proto.file_index;
+        group.offset = proto.offset;
+        group.props.set_plugin_name("shapegroup");
+        group.props.set("_arg_0", Properties::ResolvedReference(state.size()), false);
+
+        size_t group_idx = state.size() + 1;
+        state.nodes.push_back(std::move(proto));
+        state.nodes.push_back(std::move(group));
+        if (track_paths) {
+            std::string path = state.node_paths[candidates[first].node];
+            state.node_paths.push_back(path);
+            state.node_paths.push_back(path);
+        }
+
+        for (size_t i : members) {
+            SceneNode &node = state[candidates[i].node];
+            Properties props;
+            props.set_plugin_name("instance");
+            props.set_id(node.props.id());
+            if (node.props.has_property("to_world"))
+                props.set("to_world",
+                          node.props.get<ScalarAffineTransform4d>("to_world"), false);
+            props.set("_arg_0", Properties::ResolvedReference(group_idx), false);
+            node.props = std::move(props);
+        }
+
+        instance_count += members.size();
+        group_count++;
+        saved += (members.size() - 1) * file_size[candidates[first].file];
+    }
+
+    if (group_count > 0)
+        Log(Info, "Replaced %zu shapes by instances of %zu shape groups "
+            "(avoids loading %s of duplicate mesh files)",
+            instance_count, group_count, util::mem_string(saved));
+}
+
 // Section names corresponding to order indices (see node_order_id)
 static const char* section_names[] = {
     "Camera and Rendering Parameters", // 0: Integrator
@@ -1589,6 +1808,8 @@ void transform_all(const ParserConfig &config, ParserState &state) {
     transform_resolve(config, state);
     if (config.merge_equivalent)
         transform_merge_equivalent(config, state);
+    if (config.dedup_geometry)
+        transform_dedup_geometry(config, state);
     if (config.merge_meshes)
         transform_merge_meshes(config, state);
 }
@@ -1720,10 +1941,14 @@ static Task* instantiate_node(const ParserConfig &config,
                   plugin_type_name(node.type), props.plugin_name(), e.what());
         }
 
-        // Expand the object once and store the results
-        s.objects = obj->expand();
-        if (s.objects.empty())
-            s.objects.push_back(obj);
+        // Expand the object once and publish the results to dependent nodes
+        std::vector<ref<Object>> expanded = obj->expand();
+        if (expanded.empty())
+            expanded.push_back(obj);
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.objects = std::move(expanded);
+        }
 
 #if defined(MI_ENABLE_METAL)
         // Commit this worker's per-thread command buffer so its buffer uploads
@@ -1796,9 +2021,13 @@ static Task* instantiate_node(const ParserConfig &config,
     } else {
         // Non-root nodes
         if (config.parallel) {
-            // Schedule asynchronous instantiation with dependencies
-            s.task = dr::do_async(instantiate, deps.data(), deps.size());
-            return s.task;
+            /* Schedule asynchronous instantiation with dependencies. This also
+               applies to scalar variants, whose plugins are constructed on the
+               nanothread pool without a JIT scope. */
+            Task *task = dr::do_async(instantiate, deps.data(), deps.size());
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.task = task;
+            return task;
         } else {
             // Instantiate synchronously
             instantiate();
@@ -1815,7 +2044,8 @@ std::vector<ref<Object>> instantiate(const ParserConfig &config, ParserState &st
     // Flush pending side effects here and now, to avoid potentially dirty
     // user-provided Dr.Jit arrays/tensor from being propagated to plugin
     // loaders running on a different thread. Side effects are queued in
-    // per-thread data structures.
+    // per-thread data structures. Scalar variants have no such state, but are
+    // still instantiated in parallel below.
     if (config.parallel && !string::starts_with(config.variant, "scalar_")) {
         // Flush side effects
         jit_eval();
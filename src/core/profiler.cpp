@@ -2,6 +2,14 @@
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/util.h>
 
+#if defined(MI_ENABLE_PROFILER)
+#  include <atomic>
+#  include <cstring>
+#  include <pthread.h>
+#  include <signal.h>
+#  include <sys/time.h>
+#endif
+
 NAMESPACE_BEGIN(mitsuba)
 
 #if defined(MI_ENABLE_ITTNOTIFY)
@@ -10,6 +18,112 @@ __itt_string_handle *
     mitsuba_itt_phase[int(ProfilerPhase::ProfilerPhaseCount)] { };
 #endif
 
+#if defined(MI_ENABLE_PROFILER)
+std::atomic<bool> profiler_enabled { false };
+thread_local std::atomic<uint64_t> *profiler_slot = nullptr;
+
+/**
+ * Registry of the per-thread phase masks. The signal handler must not access
+ * thread-local storage, which is not async-signal-safe in shared libraries.
+ * Instead, it looks up the slot of the interrupted thread by its identifier.
+ */
+struct ProfilerThread {
+    /// 0: free, 1: being claimed, 2: owned by \c thread
+    std::atomic<int> state { 0 };
+    pthread_t thread;
+    std::atomic<uint64_t> flags { 0 };
+};
+
+static constexpr size_t profiler_max_threads = 1024;
+static ProfilerThread profiler_threads[profiler_max_threads];
+static std::atomic<size_t> profiler_thread_count { 0 };
+
+/// Threads beyond \ref profiler_max_threads use this untracked slot
+static std::atomic<uint64_t> profiler_overflow_slot { 0 };
+
+/// Releases the slot of a thread when it exits
+struct ProfilerThreadGuard {
+    ProfilerThread *entry = nullptr;
+    ~ProfilerThreadGuard() {
+        if (!entry)
+            return;
+        profiler_slot = nullptr;
+        entry->state.store(0, std::memory_order_release);
+    }
+};
+
+static thread_local ProfilerThreadGuard profiler_thread_guard;
+
+std::atomic<uint64_t> *profiler_register_thread() {
+    size_t count = profiler_thread_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < profiler_max_threads; ++i) {
+        ProfilerThread &entry = profiler_threads[i];
+        int expected = 0;
+        if (!entry.state.compare_exchange_strong(expected, 1,
+                                                 std::memory_order_acquire))
+            continue;
+
+        entry.thread = pthread_self();
+        entry.flags.store(0, std::memory_order_relaxed);
+        entry.state.store(2, std::memory_order_release);
+
+        // Let the signal handler scan up to this entry
+        while (count <= i && !profiler_thread_count.compare_exchange_weak(
+                                 count, i + 1, std::memory_order_release))
+            ;
+
+        profiler_thread_guard.entry = &entry;
+        return profiler_slot = &entry.flags;
+    }
+
+    return profiler_slot = &profiler_overflow_slot;
+}
+
+/// Sampling interval (in microseconds of CPU time)
+static constexpr long profiler_interval = 1000;
+
+/**
+ * Histogram of the sampled phase masks. The signal handler may neither lock
+ * nor allocate, hence this is a fixed-size hash table with linear probing.
+ * Keys are stored with an offset of one, so that zero marks empty slots.
+ */
+static constexpr size_t profiler_table_size = 4096;
+static std::atomic<uint64_t> profiler_keys[profiler_table_size];
+static std::atomic<uint64_t> profiler_counts[profiler_table_size];
+static std::atomic<uint64_t> profiler_dropped { 0 };
+static bool profiler_running = false;
+
+static void profiler_callback(int, siginfo_t *, void *) {
+    pthread_t self = pthread_self();
+    uint64_t flags = 0;
+    size_t count = profiler_thread_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        const ProfilerThread &entry = profiler_threads[i];
+        if (entry.state.load(std::memory_order_acquire) == 2 &&
+            pthread_equal(entry.thread, self)) {
+            flags = entry.flags.load(std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    uint64_t key = flags + 1;
+    size_t index = (size_t) ((key * 0x9E3779B97F4A7C15ull) >> 52);
+
+    for (size_t i = 0; i < profiler_table_size; ++i) {
+        uint64_t expected = 0;
+        if (profiler_keys[index].load(std::memory_order_relaxed) == key ||
+            profiler_keys[index].compare_exchange_strong(expected, key) ||
+            expected == key) {
+            profiler_counts[index].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        index = (index + 1) % profiler_table_size;
+    }
+
+    profiler_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
 void Profiler::static_initialization() {
 #if defined(MI_ENABLE_ITTNOTIFY)
     mitsuba_itt_domain = __itt_domain_create("mitsuba");
@@ -18,6 +132,134 @@ void Profiler::static_initialization() {
 #endif
 }
 
-void Profiler::static_shutdown() { }
+void Profiler::static_shutdown() {
+#if defined(MI_ENABLE_PROFILER)
+    stop();
+#endif
+}
+
+bool Profiler::available() {
+#if defined(MI_ENABLE_PROFILER)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Profiler::start() {
+#if defined(MI_ENABLE_PROFILER)
+    stop();
+
+    for (size_t i = 0; i < profiler_table_size; ++i) {
+        profiler_keys[i].store(0, std::memory_order_relaxed);
+        profiler_counts[i].store(0, std::memory_order_relaxed);
+    }
+    profiler_dropped.store(0, std::memory_order_relaxed);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = profiler_callback;
+    sa.sa_flags = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, nullptr))
+        Throw("Profiler::start(): could not install the signal handler!");
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = profiler_interval;
+    timer.it_value = timer.it_interval;
+    profiler_enabled.store(true, std::memory_order_relaxed);
+    if (setitimer(ITIMER_PROF, &timer, nullptr)) {
+        profiler_enabled.store(false, std::memory_order_relaxed);
+        Throw("Profiler::start(): could not set up the timer!");
+    }
+
+    profiler_running = true;
+#else
+    Log(Warn, "Profiler::start(): the builtin profiler is not available in "
+              "this build (see the MI_PROFILER_SAMPLING CMake option).");
+#endif
+}
+
+void Profiler::stop() {
+#if defined(MI_ENABLE_PROFILER)
+    if (!profiler_running)
+        return;
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    // Discard signals that may still be pending
+    signal(SIGPROF, SIG_IGN);
+    profiler_enabled.store(false, std::memory_order_relaxed);
+    profiler_running = false;
+#endif
+}
+
+void Profiler::print_report() {
+#if defined(MI_ENABLE_PROFILER)
+    constexpr int phase_count = (int) ProfilerPhase::ProfilerPhaseCount;
+
+    /* Attribute each sample to the innermost phase ("self") and to all
+       phases that were active ("total") */
+    uint64_t self[phase_count] { }, total[phase_count] { },
+             idle = 0, sample_count = 0;
+
+    for (size_t i = 0; i < profiler_table_size; ++i) {
+        uint64_t key = profiler_keys[i].load(std::memory_order_relaxed),
+                 count = profiler_counts[i].load(std::memory_order_relaxed);
+        if (key == 0 || count == 0)
+            continue;
+
+        uint64_t flags = key - 1;
+        sample_count += count;
+        if (flags == 0) {
+            idle += count;
+            continue;
+        }
+
+        int innermost = 0;
+        for (int j = 0; j < phase_count; ++j) {
+            if (flags & (1ull << j)) {
+                total[j] += count;
+                innermost = j;
+            }
+        }
+        self[innermost] += count;
+    }
+
+    uint64_t dropped = profiler_dropped.load(std::memory_order_relaxed);
+    if (sample_count == 0) {
+        Log(Info, "Profiler: no samples were taken.");
+        return;
+    }
+
+    auto time = [&](uint64_t count) {
+        return tfm::format("%8s (%5.1f%%)",
+                           util::time_string(float(count * profiler_interval) / 1000.f),
+                           count * 100.0 / sample_count);
+    };
+
+    std::ostringstream oss;
+    oss << tfm::format("Profiler: %s of CPU time in %i samples",
+                       util::time_string(float(sample_count * profiler_interval) / 1000.f),
+                       sample_count);
+    if (dropped > 0)
+        oss << tfm::format(" (%i samples dropped)", dropped);
+    oss << std::endl
+        << tfm::format("  %-40s %17s %17s", "Phase", "Self", "Total") << std::endl;
+
+    for (int j = 0; j < phase_count; ++j) {
+        if (total[j] == 0)
+            continue;
+        oss << tfm::format("  %-40s %s %s", profiler_phase_id[j],
+                           time(self[j]), time(total[j])) << std::endl;
+    }
+    oss << tfm::format("  %-40s %s", "(outside of any phase)", time(idle));
+
+    Log(Info, "%s", oss.str());
+#endif
+}
 
 NAMESPACE_END(mitsuba)
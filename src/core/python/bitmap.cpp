@@ -463,3 +463,17 @@ MI_PY_EXPORT(Bitmap) {
         return nb::str(result.get(), p - result.get());
     });
 }
+
+MI_PY_EXPORT(BitmapStreamWriter) {
+    MI_PY_CLASS(BitmapStreamWriter, Object)
+        .def(nb::init<const fs::path &, const Bitmap *, uint32_t>(),
+             "filename"_a, "layout"_a, "height"_a,
+             D(BitmapStreamWriter, BitmapStreamWriter))
+        .def("write", &BitmapStreamWriter::write, "band"_a,
+             nb::call_guard<nb::gil_scoped_release>(),
+             D(BitmapStreamWriter, write))
+        .def_method(BitmapStreamWriter, close)
+        .def_method(BitmapStreamWriter, rows_written)
+        .def_method(BitmapStreamWriter, height)
+        .def_method(BitmapStreamWriter, filename);
+}
@@ -338,7 +338,9 @@ MI_PY_EXPORT(parser) {
         .def_rw("merge_equivalent", &ParserConfig::merge_equivalent,
                 "Enable merging of equivalent nodes (deduplication) (default: true)")
         .def_rw("merge_meshes", &ParserConfig::merge_meshes,
-                "Enable merging of meshes into a single merge shape (default: true)");
+                "Enable merging of meshes into a single merge shape (default: true)")
+        .def_rw("dedup_geometry", &ParserConfig::dedup_geometry,
+                "Replace shapes that load identical mesh files by instances of a shared shape group (default: false)");
 
     // Export SceneNode
     nb::class_<SceneNode>(parser, "SceneNode")
@@ -423,6 +425,10 @@ MI_PY_EXPORT(parser) {
           "config"_a, "state"_a,
           "Merge equivalent nodes to reduce memory usage and improve performance");
 
+    parser.def("transform_dedup_geometry", &transform_dedup_geometry,
+          "config"_a, "state"_a,
+          "Replace shapes that load identical mesh files by instances of a shared shape group");
+
     parser.def("transform_merge_meshes", &transform_merge_meshes,
           "config"_a, "state"_a,
           "Combine meshes with identical materials");
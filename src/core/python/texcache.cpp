@@ -0,0 +1,56 @@
+#include <nanobind/nanobind.h> // Needs to be first, to get `ref<T>` caster
+#include <mitsuba/core/texcache.h>
+#include <mitsuba/python/python.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
+
+MI_PY_EXPORT(TextureCache) {
+    MI_PY_CLASS(TiledImage, Object)
+        .def(nb::init<const fs::path &>(), D(TiledImage, TiledImage),
+             "filename"_a)
+        .def_method(TiledImage, filename)
+        .def_method(TiledImage, level_count)
+        .def("size", [](const TiledImage &t, uint32_t level) {
+            auto s = t.size(level);
+            return nb::make_tuple(s.x(), s.y());
+        }, "level"_a = 0, D(TiledImage, size))
+        .def("tile_size", [](const TiledImage &t) {
+            auto s = t.tile_size();
+            return nb::make_tuple(s.x(), s.y());
+        }, D(TiledImage, tile_size))
+        .def("tile_count", [](const TiledImage &t, uint32_t level) {
+            auto s = t.tile_count(level);
+            return nb::make_tuple(s.x(), s.y());
+        }, "level"_a = 0, D(TiledImage, tile_count))
+        .def_method(TiledImage, channel_count);
+
+    auto tc = nb::class_<TextureCache>(m, "TextureCache", D(TextureCache))
+        .def_static("open", &TextureCache::open, "filename"_a,
+                    D(TextureCache, open))
+        .def_static("close", &TextureCache::close, "image"_a,
+                    D(TextureCache, close))
+        .def_static("set_budget", &TextureCache::set_budget, "bytes"_a,
+                    D(TextureCache, set_budget))
+        .def_static("budget", &TextureCache::budget, D(TextureCache, budget))
+        .def_static("statistics", &TextureCache::statistics,
+                    D(TextureCache, statistics))
+        .def_static("reset_statistics", &TextureCache::reset_statistics,
+                    D(TextureCache, reset_statistics))
+        .def_static("clear", &TextureCache::clear, D(TextureCache, clear));
+
+    nb::class_<TextureCache::Statistics>(tc, "Statistics",
+                                         D(TextureCache, Statistics))
+        .def_ro("hits", &TextureCache::Statistics::hits,
+                D(TextureCache, Statistics, hits))
+        .def_ro("misses", &TextureCache::Statistics::misses,
+                D(TextureCache, Statistics, misses))
+        .def_ro("evictions", &TextureCache::Statistics::evictions,
+                D(TextureCache, Statistics, evictions))
+        .def_ro("tile_count", &TextureCache::Statistics::tile_count,
+                D(TextureCache, Statistics, tile_count))
+        .def_ro("memory", &TextureCache::Statistics::memory,
+                D(TextureCache, Statistics, memory))
+        .def_ro("peak_memory", &TextureCache::Statistics::peak_memory,
+                D(TextureCache, Statistics, peak_memory))
+        .def("__repr__", &TextureCache::Statistics::to_string);
+}
@@ -2505,3 +2505,105 @@ def test67_dict_resource_path_management(variant_scalar_rgb, tmp_path):
                 "type": "resources"
             }
         })
+
+
+def test68_parallel_instantiation_spectral(variant_scalar_spectral):
+    """Scalar variants instantiate independent plugins on the thread pool,
+    including ones that lazily load shared state (spectral upsampling)"""
+
+    def make_scene():
+        scene = { "type": "scene" }
+        for i in range(64):
+            scene[f"shape_{i}"] = {
+                "type": "rectangle",
+                "id": f"rect_{i}",
+                "bsdf": {
+                    "type": "diffuse",
+                    "reflectance": {
+                        "type": "rgb",
+                        "value": [i / 64, 0.5, 1 - i / 64]
+                    }
+                }
+            }
+        return scene
+
+    serial = mi.load_dict(make_scene(), parallel=False)
+    parallel = mi.load_dict(make_scene(), parallel=True)
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.wavelengths = [450, 520, 580, 640]
+    for a, b in zip(serial.shapes(), parallel.shapes()):
+        assert a.id() == b.id()
+        ra = a.bsdf().eval_diffuse_reflectance(si)
+        rb = b.bsdf().eval_diffuse_reflectance(si)
+        assert dr.allclose(ra, rb)
+
+
+def test69_transform_dedup_geometry(variant_scalar_rgb, tmp_path):
+    """Shapes that load identical mesh files become instances of a shared shape group"""
+    import shutil
+    from mitsuba.test.util import find_resource
+
+    src = mi.file_resolver().resolve(find_resource("resources/data/common/meshes/bunny_lowres.ply"))
+    shutil.copy(str(src), str(tmp_path / 'a.ply'))
+    shutil.copy(str(src), str(tmp_path / 'b.ply'))
+    a, b = str(tmp_path / 'a.ply'), str(tmp_path / 'b.ply')
+
+    shift = 2 * mi.load_dict({'type': 'ply', 'filename': a}).bbox().extents().x
+    T = mi.ScalarTransform4f()
+
+    scene_dict = {
+        'type': 'scene',
+        # Same file under different IDs
+        'a1': { 'type': 'ply', 'filename': a },
+        'a2': { 'type': 'ply', 'filename': a, 'to_world': T.translate([shift, 0, 0]) },
+        # Byte-identical copy of the file
+        'b': { 'type': 'ply', 'filename': b, 'to_world': T.translate([-shift, 0, 0]) },
+        # Different properties
+        'c': { 'type': 'ply', 'filename': a, 'flip_normals': True,
+               'to_world': T.translate([0, shift, 0]) },
+        # Emitters cannot be instanced
+        'light': { 'type': 'ply', 'filename': a, 'emitter': { 'type': 'area' },
+                   'to_world': T.translate([0, -shift, 0]) }
+    }
+
+    state = mi.parser.parse_dict(config, scene_dict)
+    mi.parser.transform_resolve(config, state)
+    mi.parser.transform_dedup_geometry(config, state)
+
+    children = dict(get_children(state, state.root))
+    for name in ['a1', 'a2', 'b']:
+        assert children[name].props.plugin_name() == 'instance'
+        assert children[name].props.id() == name
+    assert children['c'].props.plugin_name() == 'ply'
+    assert children['light'].props.plugin_name() == 'ply'
+
+    groups = {children[name].props['_arg_0'].index() for name in ['a1', 'a2', 'b']}
+    assert len(groups) == 1
+    group = state.nodes[groups.pop()]
+    assert group.props.plugin_name() == 'shapegroup'
+    proto = get_children(state, group)[0][1]
+    assert proto.props.plugin_name() == 'ply'
+    assert not proto.props.has_property('to_world')
+
+    # The deduplicated scene must look like the original one
+    config_dedup = mi.parser.ParserConfig('scalar_rgb')
+    config_dedup.dedup_geometry = True
+    state = mi.parser.parse_dict(config_dedup, scene_dict)
+    mi.parser.transform_all(config_dedup, state)
+    scene_dedup = mi.parser.instantiate(config_dedup, state)
+    scene_ref = mi.load_dict(scene_dict)
+
+    bbox = scene_ref.bbox()
+    for i in range(16):
+        for j in range(16):
+            o = mi.ScalarPoint3f(
+                dr.lerp(bbox.min.x, bbox.max.x, (i + .5) / 16),
+                dr.lerp(bbox.min.y, bbox.max.y, (j + .5) / 16),
+                bbox.max.z + 1)
+            ray = mi.Ray3f(o, mi.Vector3f(0, 0, -1))
+            si_ref = scene_ref.ray_intersect(ray)
+            si_dedup = scene_dedup.ray_intersect(ray)
+            assert si_ref.is_valid() == si_dedup.is_valid()
+            if si_ref.is_valid():
+                assert dr.allclose(si_ref.t, si_dedup.t, rtol=1e-4)
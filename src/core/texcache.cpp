@@ -0,0 +1,462 @@
+#include <mitsuba/core/texcache.h>
+#include <mitsuba/core/hash.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/util.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+
+/* OpenEXR */
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wdeprecated-register"
+#  pragma clang diagnostic ignored "-Wunused-parameter"
+#elif defined(__GNUG__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wdeprecated"
+#endif
+
+#include <ImfInputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfTestFile.h>
+#include <ImathBox.h>
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(__GNUG__)
+#  pragma GCC diagnostic pop
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Number of independently locked parts of the texture cache
+static constexpr size_t texture_cache_shards = 16;
+
+size_t TextureTile::memory() const {
+    return sizeof(TextureTile) +
+           (size_t) size.x() * size.y() * channel_count * sizeof(float);
+}
+
+// -----------------------------------------------------------------------------
+//   TiledImage
+// -----------------------------------------------------------------------------
+
+struct TiledImage::TiledImagePrivate {
+    fs::path filename;
+    std::unique_ptr<Imf::TiledInputFile> tiled;
+    std::unique_ptr<Imf::InputFile> scanline;
+    std::vector<std::string> channels;
+    Imath::Box2i data_window;
+    std::vector<Vector2u> sizes, tile_counts;
+    Vector2u tile_size;
+
+    /// OpenEXR binds a frame buffer to the file, so reads are serialized
+    std::mutex mutex;
+};
+
+TiledImage::TiledImage(const fs::path &filename) : d(new TiledImagePrivate()) {
+    d->filename = filename;
+    std::string name = filename.string();
+
+    bool is_tiled = false;
+    if (!Imf::isOpenExrFile(name.c_str(), is_tiled))
+        Throw("TiledImage: \"%s\" is not an OpenEXR file!", name);
+
+    try {
+        const Imf::Header *header;
+        if (is_tiled) {
+            d->tiled = std::make_unique<Imf::TiledInputFile>(name.c_str());
+            header = &d->tiled->header();
+        } else {
+            d->scanline = std::make_unique<Imf::InputFile>(name.c_str());
+            header = &d->scanline->header();
+        }
+
+        const Imf::ChannelList &channels = header->channels();
+        if (channels.findChannel("R") && channels.findChannel("G") &&
+            channels.findChannel("B"))
+            d->channels = { "R", "G", "B" };
+        else if (channels.findChannel("Y"))
+            d->channels = { "Y" };
+
+        d->data_window = header->dataWindow();
+
+        if (is_tiled) {
+            Imf::TiledInputFile &file = *d->tiled;
+            uint32_t levels = 1;
+            switch (file.levelMode()) {
+                case Imf::MIPMAP_LEVELS: levels = file.numLevels(); break;
+                // Only use the isotropic levels of RIP maps
+                case Imf::RIPMAP_LEVELS:
+                    levels = std::min(file.numXLevels(), file.numYLevels());
+                    break;
+                default: break;
+            }
+
+            d->tile_size = Vector2u(file.tileXSize(), file.tileYSize());
+            for (uint32_t l = 0; l < levels; ++l) {
+                d->sizes.emplace_back(file.levelWidth(l), file.levelHeight(l));
+                d->tile_counts.emplace_back(file.numXTiles(l), file.numYTiles(l));
+            }
+        } else {
+            Vector2u size(d->data_window.max.x - d->data_window.min.x + 1,
+                          d->data_window.max.y - d->data_window.min.y + 1);
+            d->tile_size = Vector2u(size.x(), scanline_tile_height);
+            d->sizes.push_back(size);
+            d->tile_counts.emplace_back(
+                1, (size.y() + scanline_tile_height - 1) / scanline_tile_height);
+        }
+    } catch (const std::exception &e) {
+        Throw("TiledImage: could not open \"%s\": %s", name, e.what());
+    }
+
+    if (d->channels.empty())
+        Throw("TiledImage: \"%s\" must contain RGB or Y channels!", name);
+
+    static std::atomic<uint32_t> id_counter { 0 };
+    m_id = id_counter++;
+
+    Log(Debug, "Opened \"%s\" (%s, %u level%s, %ux%u tiles)",
+        filename.filename().string(), is_tiled ? "tiled" : "scanline",
+        level_count(), level_count() > 1 ? "s" : "", d->tile_size.x(),
+        d->tile_size.y());
+}
+
+TiledImage::~TiledImage() { }
+
+const fs::path &TiledImage::filename() const { return d->filename; }
+
+uint32_t TiledImage::level_count() const { return (uint32_t) d->sizes.size(); }
+
+TiledImage::Vector2u TiledImage::size(uint32_t level) const {
+    return d->sizes.at(level);
+}
+
+TiledImage::Vector2u TiledImage::tile_size() const { return d->tile_size; }
+
+TiledImage::Vector2u TiledImage::tile_count(uint32_t level) const {
+    return d->tile_counts.at(level);
+}
+
+uint32_t TiledImage::channel_count() const {
+    return (uint32_t) d->channels.size();
+}
+
+std::shared_ptr<const TextureTile> TiledImage::tile(uint32_t level, uint32_t x,
+                                                    uint32_t y) const {
+    return TextureCache::tile(this, level, x, y);
+}
+
+std::shared_ptr<TextureTile> TiledImage::read_tile(uint32_t level, uint32_t x,
+                                                   uint32_t y) const {
+    ScopedPhase phase(ProfilerPhase::BitmapRead);
+
+    if (level >= level_count() || x >= d->tile_counts[level].x() ||
+        y >= d->tile_counts[level].y())
+        Throw("TiledImage::read_tile(): tile (%u, %u) of level %u is out of "
+              "bounds!", x, y, level);
+
+    Imath::Box2i range;
+    if (d->tiled) {
+        range = d->tiled->dataWindowForTile((int) x, (int) y, (int) level,
+                                            (int) level);
+    } else {
+        int y0 = d->data_window.min.y + (int) (y * scanline_tile_height);
+        range = Imath::Box2i(
+            Imath::V2i(d->data_window.min.x, y0),
+            Imath::V2i(d->data_window.max.x,
+                       std::min(y0 + (int) scanline_tile_height - 1,
+                                d->data_window.max.y)));
+    }
+
+    auto tile = std::make_shared<TextureTile>();
+    tile->size = Vector2u(range.max.x - range.min.x + 1,
+                          range.max.y - range.min.y + 1);
+    tile->channel_count = (uint32_t) d->channels.size();
+
+    size_t channels     = d->channels.size(),
+           pixel_stride = channels * sizeof(float),
+           row_stride   = pixel_stride * tile->size.x();
+    tile->data = std::unique_ptr<float[]>(
+        new float[(size_t) tile->size.x() * tile->size.y() * channels]);
+
+    // Tell OpenEXR where the tile data should be put
+    char *ptr = (char *) tile->data.get() - range.min.x * pixel_stride -
+                range.min.y * row_stride;
+    Imf::FrameBuffer framebuffer;
+    for (size_t i = 0; i < channels; ++i)
+        framebuffer.insert(d->channels[i],
+                           Imf::Slice(Imf::FLOAT, ptr + i * sizeof(float),
+                                      pixel_stride, row_stride));
+
+    try {
+        std::lock_guard<std::mutex> guard(d->mutex);
+        if (d->tiled) {
+            d->tiled->setFrameBuffer(framebuffer);
+            d->tiled->readTile((int) x, (int) y, (int) level, (int) level);
+        } else {
+            d->scanline->setFrameBuffer(framebuffer);
+            d->scanline->readPixels(range.min.y, range.max.y);
+        }
+    } catch (const std::exception &e) {
+        Throw("TiledImage: could not read tile (%u, %u) of level %u from "
+              "\"%s\": %s", x, y, level, d->filename.string(), e.what());
+    }
+
+    return tile;
+}
+
+std::string TiledImage::to_string() const {
+    std::ostringstream oss;
+    oss << "TiledImage[" << std::endl
+        << "  filename = \"" << d->filename.string() << "\"," << std::endl
+        << "  size = " << size() << "," << std::endl
+        << "  channel_count = " << channel_count() << "," << std::endl
+        << "  level_count = " << level_count() << "," << std::endl
+        << "  tile_size = " << d->tile_size << std::endl
+        << "]";
+    return oss.str();
+}
+
+// -----------------------------------------------------------------------------
+//   TextureCache
+// -----------------------------------------------------------------------------
+
+/// Identifies a tile by image, MIP level, and tile position
+struct TileKey {
+    uint32_t image, level, x, y;
+
+    bool operator==(const TileKey &k) const {
+        return image == k.image && level == k.level && x == k.x && y == k.y;
+    }
+};
+
+struct TileKeyHasher {
+    size_t operator()(const TileKey &k) const {
+        return hash_combine(hash_combine(hash(k.image), hash(k.level)),
+                            hash_combine(hash(k.x), hash(k.y)));
+    }
+};
+
+/// Least recently used tiles of one shard of the cache
+struct TextureCacheShard {
+    struct Entry {
+        std::shared_ptr<const TextureTile> tile;
+        std::list<TileKey>::iterator lru;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<TileKey, Entry, TileKeyHasher> entries;
+    /// Most recently used tiles at the front
+    std::list<TileKey> lru;
+    size_t memory = 0;
+};
+
+/// Identifies an open file by its absolute path, modification time, and size
+using FileKey = std::tuple<std::string, int64_t, size_t>;
+
+struct FileKeyHasher {
+    size_t operator()(const FileKey &k) const { return hash(k); }
+};
+
+/// Open file along with the number of handles given out by \ref open()
+struct FileEntry {
+    ref<TiledImage> image;
+    size_t handles = 0;
+};
+
+struct TextureCacheState {
+    TextureCacheShard shards[texture_cache_shards];
+    std::atomic<size_t> budget { size_t(2) << 30 };
+    std::atomic<size_t> hits { 0 }, misses { 0 }, evictions { 0 },
+        memory { 0 }, peak_memory { 0 };
+
+    std::mutex files_mutex;
+    std::unordered_map<FileKey, FileEntry, FileKeyHasher> files;
+};
+
+static TextureCacheState *texture_cache = nullptr;
+
+void TextureCache::static_initialization() {
+    texture_cache = new TextureCacheState();
+}
+
+void TextureCache::static_shutdown() {
+    if (texture_cache && texture_cache->misses > 0)
+        Log(Debug, "Texture cache: %s", statistics().to_string());
+    delete texture_cache;
+    texture_cache = nullptr;
+}
+
+static TextureCacheState &texture_cache_state() {
+    if (!texture_cache)
+        Throw("TextureCache: static_initialization() was not called!");
+    return *texture_cache;
+}
+
+ref<TiledImage> TextureCache::open(const fs::path &filename) {
+    TextureCacheState &s = texture_cache_state();
+    if (!fs::is_regular_file(filename))
+        Throw("TextureCache::open(): file \"%s\" does not exist!",
+              filename.string());
+
+    FileKey key { fs::absolute(filename).string(),
+                  fs::last_write_time(filename), fs::file_size(filename) };
+
+    std::lock_guard<std::mutex> guard(s.files_mutex);
+    auto it = s.files.find(key);
+    if (it == s.files.end())
+        it = s.files.emplace(key, FileEntry{ new TiledImage(filename) }).first;
+
+    it->second.handles++;
+    return it->second.image;
+}
+
+void TextureCache::close(const TiledImage *image) {
+    // Textures may outlive the cache when the process shuts down
+    if (!image || !texture_cache)
+        return;
+
+    TextureCacheState &s = *texture_cache;
+    ref<TiledImage> released;
+    {
+        std::lock_guard<std::mutex> guard(s.files_mutex);
+        for (auto it = s.files.begin(); it != s.files.end(); ++it) {
+            if (it->second.image.get() != image)
+                continue;
+            if (--it->second.handles == 0) {
+                released = std::move(it->second.image);
+                s.files.erase(it);
+            }
+            break;
+        }
+    }
+
+    if (!released)
+        return;
+
+    // Image IDs are never reused, so no other image can own these tiles
+    for (TextureCacheShard &shard : s.shards) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (it->first.image != image->id()) {
+                ++it;
+                continue;
+            }
+            size_t tile_memory = it->second.tile->memory();
+            shard.memory -= tile_memory;
+            s.memory -= tile_memory;
+            shard.lru.erase(it->second.lru);
+            it = shard.entries.erase(it);
+        }
+    }
+}
+
+void TextureCache::set_budget(size_t bytes) {
+    texture_cache_state().budget = bytes;
+}
+
+size_t TextureCache::budget() { return texture_cache_state().budget; }
+
+TextureCache::Statistics TextureCache::statistics() {
+    TextureCacheState &s = texture_cache_state();
+    Statistics stats;
+    stats.hits = s.hits;
+    stats.misses = s.misses;
+    stats.evictions = s.evictions;
+    stats.memory = s.memory;
+    stats.peak_memory = s.peak_memory;
+    for (TextureCacheShard &shard : s.shards) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        stats.tile_count += shard.entries.size();
+    }
+    return stats;
+}
+
+void TextureCache::reset_statistics() {
+    TextureCacheState &s = texture_cache_state();
+    s.hits = s.misses = s.evictions = 0;
+    s.peak_memory = s.memory.load();
+}
+
+void TextureCache::clear() {
+    TextureCacheState &s = texture_cache_state();
+    for (TextureCacheShard &shard : s.shards) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        s.memory -= shard.memory;
+        shard.entries.clear();
+        shard.lru.clear();
+        shard.memory = 0;
+    }
+}
+
+std::shared_ptr<const TextureTile>
+TextureCache::tile(const TiledImage *image, uint32_t level, uint32_t x,
+                   uint32_t y) {
+    TextureCacheState &s = texture_cache_state();
+    TileKey key { image->id(), level, x, y };
+    TextureCacheShard &shard =
+        s.shards[TileKeyHasher()(key) % texture_cache_shards];
+
+    {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+            s.hits++;
+            return it->second.tile;
+        }
+    }
+
+    /* Read the tile without holding the lock. Concurrent misses of the same
+       tile may read it twice, in which case the first copy is kept. */
+    s.misses++;
+    std::shared_ptr<const TextureTile> tile = image->read_tile(level, x, y);
+    size_t tile_memory = tile->memory();
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto [it, inserted] = shard.entries.try_emplace(key);
+    if (!inserted)
+        return it->second.tile;
+
+    shard.lru.push_front(key);
+    it->second = { tile, shard.lru.begin() };
+    shard.memory += tile_memory;
+
+    size_t memory = (s.memory += tile_memory), peak = s.peak_memory;
+    while (memory > peak && !s.peak_memory.compare_exchange_weak(peak, memory))
+        ;
+
+    // Evict the least recently used tiles beyond this shard's share
+    size_t shard_budget = s.budget / texture_cache_shards;
+    while (shard.memory > shard_budget && shard.lru.size() > 1) {
+        auto victim = shard.entries.find(shard.lru.back());
+        size_t victim_memory = victim->second.tile->memory();
+        shard.memory -= victim_memory;
+        s.memory -= victim_memory;
+        shard.lru.pop_back();
+        shard.entries.erase(victim);
+        s.evictions++;
+    }
+
+    return tile;
+}
+
+std::string TextureCache::Statistics::to_string() const {
+    size_t requests = hits + misses;
+    std::ostringstream oss;
+    oss << tfm::format("%zu hits, %zu misses (%.1f%% hit rate), %zu evictions, "
+                       "%zu tiles resident (%s, peak: %s)",
+                       hits, misses,
+                       requests > 0 ? 100.0 * hits / requests : 0.0,
+                       evictions, tile_count, util::mem_string(memory),
+                       util::mem_string(peak_memory));
+    return oss.str();
+}
+
+NAMESPACE_END(mitsuba)
@@ -156,6 +156,32 @@ ZStream::~ZStream() {
     close();
 }
 
+std::vector<uint8_t> ZStream::compress_block(const void *ptr, size_t size,
+                                             int level) {
+    uLongf out_size = compressBound((uLong) size);
+    std::vector<uint8_t> result(out_size);
+
+    int retval = compress2(result.data(), &out_size, (const Bytef *) ptr,
+                           (uLong) size, level);
+    if (retval != Z_OK)
+        Throw("compress_block(): compression failed: error code %i", retval);
+
+    result.resize(out_size);
+    return result;
+}
+
+void ZStream::decompress_block(const void *src, size_t src_size, void *dst,
+                               size_t size) {
+    uLongf out_size = (uLongf) size;
+    int retval = uncompress((Bytef *) dst, &out_size, (const Bytef *) src,
+                            (uLong) src_size);
+    if (retval != Z_OK)
+        Throw("decompress_block(): decompression failed: error code %i", retval);
+    if (out_size != size)
+        Throw("decompress_block(): block decompressed to %zu bytes, expected %zu!",
+              (size_t) out_size, size);
+}
+
 std::string ZStream::to_string() const {
     std::ostringstream oss;
 
@@ -100,6 +100,15 @@ Sun and sky emitter (:monosp:`sunsky`)
      This is more expensive to evaluate, but produces a more realistic sun appearance.
      Both implementations integrate to the same total power.
 
+ * - bake_sky
+   - |bool|
+   - Tabulate the sky radiance once instead of evaluating the sky model for every query (Default: false).
+     See below for details.
+
+ * - sky_bake_resolution
+   - |int|
+   - Number of rows of the baked sky map, which has four times as many columns (Default: 128).
+
  * - to_world
    - |transform|
    - Specifies an optional emitter-to-world transformation.  (Default: none, i.e. emitter space = world space)
@@ -118,6 +127,14 @@ environment map, but evaluates the spectral radiance whenever it is needed.
 Consequently, sampling is done through a composition of a downwards warp (for the horizon)
 and a truncated gaussian aligned on the sun's azimuth.
 
+When ``bake_sky`` is set, the sky radiance is instead tabulated once into an
+equirectangular map of the upper hemisphere, which is bilinearly interpolated
+on lookup and importance sampled like the :ref:`envmap <emitter-envmap>`
+plugin. This makes emitter queries considerably cheaper, at the cost of a
+small reconstruction error that is estimated at load time and reported in
+the debug log. The map is rebuilt whenever a parameter changes. The sun is
+never baked, as it would require a very high resolution.
+
 Parameter influence
 ********************
 
@@ -272,6 +289,8 @@ public:
 
         dr::eval(m_sky_params, m_sky_radiance, m_sky_sampling_w,
                  m_mpdf_weights, m_spectral_distr, m_sun_irrad);
+
+        Base::bake_sky();
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -338,6 +357,9 @@ public:
 
         dr::eval(m_sky_params, m_sky_radiance, m_sky_sampling_w,
                  m_mpdf_weights, m_spectral_distr, m_sun_irrad);
+
+        if (Base::sky_bake_outdated(keys))
+            Base::bake_sky();
         #undef CHANGED
     }
 
@@ -541,6 +563,8 @@ private:
         Base::m_sampling_params,
         Base::m_sky_irrad_dataset,
         Base::m_sun_irrad_dataset,
+        Base::m_sky_map,
+        Base::m_sky_warp,
         m_sun_dir,
         m_sun_angles,
         m_time,
@@ -428,3 +428,76 @@ def test10_invalid_sun_angles(variants_vec_backends_once_spectral):
         albedo=0.5, sun_scale=1.0, sky_scale=1.0,
         complex_sun=True)
     assert dr.all(plugin.eval(si) == 0.0, axis=None)
+
+
+@pytest.mark.parametrize("sun_theta", [dr.deg2rad(20), dr.deg2rad(70)])
+def test11_baked_sky(variants_vec_backends_once, sun_theta):
+    if mi.is_polarized:
+        pytest.skip('Test must be adapted to polarized rendering.')
+
+    sp_sun, cp_sun = dr.sincos(dr.pi / 3)
+    st, ct = dr.sincos(sun_theta)
+
+    def make_emitter(bake):
+        return mi.load_dict({
+            "type": "sunsky",
+            "sun_direction": [cp_sun * st, sp_sun * st, ct],
+            "sun_scale": 0.0,
+            "turbidity": 3.0,
+            "albedo": 0.3,
+            "bake_sky": bake
+        })
+
+    analytic, baked = make_emitter(False), make_emitter(True)
+
+    rng = mi.PCG32(size=10_000)
+    d = mi.warp.square_to_uniform_hemisphere(
+        mi.Point2f(rng.next_float32(), rng.next_float32()))
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.wi = -d
+    if mi.is_spectral:
+        si.wavelengths = mi.Wavelength(410, 490, 570, 650)
+
+    # The bilinear reconstruction closely matches the analytic model
+    ref, res = analytic.eval(si), baked.eval(si)
+    err = dr.sum(dr.abs(res - ref), axis=None) / dr.sum(dr.abs(ref), axis=None)
+    assert err < 0.01, f"Baked sky deviates from the analytic model {err = }"
+
+    # Sampling densities are consistent
+    it = dr.zeros(mi.Interaction3f)
+    ds, w = baked.sample_direction(
+        it, mi.Point2f(rng.next_float32(), rng.next_float32()))
+    dr.assert_allclose(ds.pdf, baked.pdf_direction(it, ds), rtol=1e-3)
+    assert dr.all(ds.d.z >= 0)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize("turb",      [2.2, 6.0])
+@pytest.mark.parametrize("sun_theta", [dr.deg2rad(20), dr.deg2rad(50)])
+def test12_baked_sky_sampling(variants_vec_backends_once, turb, sun_theta):
+    phi_sun = -4*dr.pi/5
+    sp_sun, cp_sun = dr.sincos(phi_sun)
+    st, ct = dr.sincos(sun_theta)
+
+    sky = {
+        "type": "sunsky",
+        "sun_direction": [cp_sun * st, sp_sun * st, ct],
+        "sun_scale": 0.0,
+        "turbidity": turb,
+        "albedo": 0.5,
+        "bake_sky": True
+    }
+
+    sample_func, pdf_func = mi.chi2.EmitterAdapter("sunsky", sky)
+    test = mi.chi2.ChiSquareTest(
+        domain=CroppedSphericalDomain(),
+        pdf_func= pdf_func,
+        sample_func= sample_func,
+        sample_dim=2,
+        sample_count=200_000,
+        res=55,
+        ires=32
+    )
+
+    assert test.run(), "Chi2 test failed"
@@ -264,4 +264,46 @@ def test05_complex_sun(variants_vec_spectral,  turb, hour, sun_aperture):
     timed_irrad = sun_integrand(timed_sunsky, points, weights, sunsky_params["sun_direction"], sun_cos_cutoff)
     timed_irrad = dr.sum(timed_irrad, axis=1)
 
-    assert np.allclose(sunsky_irrad, timed_irrad, rtol=0.2)
\ No newline at end of file
+    assert np.allclose(sunsky_irrad, timed_irrad, rtol=0.2)
+
+def test06_baked_sky_average(variants_vec_backends_once):
+    if mi.is_polarized:
+        pytest.skip('Test must be adapted to polarized rendering.')
+
+    render_res = (64, 32)
+
+    def make_emitter(bake):
+        return mi.load_dict({
+            "type": "timed_sunsky",
+            "end_year": 2025,
+            "end_day": 2,
+            "window_start_time": 0,
+            "window_end_time": 24,
+            "sun_scale": 0,
+            "bake_sky": bake
+        })
+
+    # The baked sky is the time average of the analytic one
+    ref = generate_average(make_emitter(False), render_res, 1000)
+
+    # Averaging the baked sky over random instants, which include nighttime
+    # ones, must preserve the average of the analytic sky
+    baked = make_emitter(True)
+    si = generate_rays(render_res)
+    res = dr.zeros(mi.Float, dr.size_v(mi.Spectrum) * dr.prod(render_res))
+    times = np.random.default_rng(seed=0).random(64)
+    for t in times:
+        si.time = float(t)
+        res += dr.ravel(baked.eval(si)) / len(times)
+    res = mi.TensorXf(res, (*render_res[::-1], dr.size_v(mi.Spectrum)))
+
+    err = dr.sum(dr.abs(res - ref), axis=None) / \
+          dr.maximum(dr.sum(dr.abs(ref), axis=None), 1e-6)
+    assert err < 0.02, f"Baked sky does not match the time average {err = }"
+
+    # At night, the baked sky is still visible and sampled consistently
+    it = dr.zeros(mi.Interaction3f)
+    it.time = 0.0
+    ds, w = baked.sample_direction(it, mi.Point2f(0.3, 0.6))
+    assert dr.all(ds.pdf > 0) and dr.all(dr.max(w) > 0)
+    dr.assert_allclose(baked.pdf_direction(it, ds), ds.pdf, rtol=1e-4)
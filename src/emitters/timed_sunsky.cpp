@@ -113,6 +113,19 @@ Timed sun and sky emitter (:monosp:`timed_sunsky`)
      This is more expensive to evaluate, but produces a more realistic sun appearance.
      Both implementations integrate to the same total power.
 
+ * - bake_sky
+   - |bool|
+   - Tabulate the sky radiance averaged over the shutter interval once instead of
+     evaluating the sky model for every query (Default: false). See below for details.
+
+ * - sky_bake_resolution
+   - |int|
+   - Number of rows of the baked sky map, which has four times as many columns (Default: 128).
+
+ * - sky_bake_time_samples
+   - |int|
+   - Number of instants of the shutter interval averaged by the baked sky map (Default: 64).
+
  * - to_world
    - |transform|
    - Specifies an optional emitter-to-world transformation.  (Default: none, i.e. emitter space = world space)
@@ -135,6 +148,22 @@ The plugin works by dynamically computing the Hosek-Wilkie sun :cite:`HosekSun20
 The time parameter is controlled by the ``shutter_open`` and ``shutter_close``
 parameters that should thus be the same as the sensor's.
 
+When ``bake_sky`` is set, the sky radiance is averaged over ``sky_bake_time_samples``
+instants of the shutter interval and tabulated once into an equirectangular map,
+which is then used for lookups and importance sampling. For a static scene, this
+converges to the same image as the time-dependent sky, while being considerably
+cheaper to evaluate. The sun is still evaluated for the time of each query,
+whereas the baked sky no longer depends on it: nighttime instants already
+contribute zero radiance to its average, hence it stays visible at night.
+
+Baking evaluates the sky model once per texel and time sample (about 4.2 million
+evaluations with the default settings, plus a sixteenth of that to estimate the
+baking error on a sparse subset of the texels). It is repeated whenever a
+parameter that affects the sky changes, but not when only ``sky_scale``,
+``sun_scale`` or ``to_world`` are updated.
+Reduce ``sky_bake_time_samples`` or ``sky_bake_resolution`` if this becomes a
+bottleneck, e.g. when the emitter is updated in an optimization loop.
+
 **Render with default settings and HDR film yielding an average over a year:**
 
 .. image:: https://d38rqfq1h7iukm.cloudfront.net/media/uploads/wjakob/2025/09/15/sunsky/emitter_timed_sunsky.jpg
@@ -258,6 +287,12 @@ public:
         std::tie(m_sky_sampling_weight_tex, m_sun_irrad_tex) = update_irradiance_data();
 
         dr::eval(m_nb_days, m_sky_rad, m_sky_params, m_sky_sampling_weight_tex, m_sun_irrad_tex);
+
+        m_sky_bake_time_samples = props.get<ScalarUInt32>("sky_bake_time_samples", 64);
+        if (m_sky_bake_time_samples == 0)
+            Log(Error, "The number of sky bake time samples must be positive!");
+
+        bake_sky();
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -295,6 +330,9 @@ public:
 
         dr::eval(m_nb_days, m_sky_rad, m_sky_params,
             m_sky_sampling_weight_tex, m_sun_irrad_tex);
+
+        if (Base::sky_bake_outdated(keys))
+            bake_sky();
     }
 
     std::string to_string() const override {
@@ -318,6 +356,12 @@ public:
 
 private:
 
+    /// Bakes the sky averaged over the shutter interval
+    void bake_sky() {
+        Base::bake_sky(m_shutter_open, m_shutter_open + 1.f / m_inv_shutter_open_time,
+                       m_sky_bake_time_samples);
+    }
+
     Point2f get_sun_angles(const Float& time) const override {
         DateTimeRecord<Float> date_time = dr::zeros<DateTimeRecord<Float>>();
         date_time.year = m_start_date.year;
@@ -509,6 +553,9 @@ private:
 
     ScalarFloat m_shutter_open, m_inv_shutter_open_time;
 
+    /// Number of instants averaged by the baked sky
+    ScalarUInt32 m_sky_bake_time_samples;
+
     Float m_window_start_time, m_window_end_time;
     DateTimeRecord<Float> m_start_date, m_end_date;
     LocationRecord<Float> m_location;
@@ -540,6 +587,8 @@ private:
         Base::m_sky_irrad_dataset,
         Base::m_sun_irrad_dataset,
         Base::m_sampling_params,
+        Base::m_sky_map,
+        Base::m_sky_warp,
         m_window_start_time,
         m_window_end_time,
         m_start_date,
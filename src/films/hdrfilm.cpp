@@ -6,9 +6,22 @@
 #include <mitsuba/render/film.h>
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/imageblock.h>
+#include <nanothread/nanothread.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <mutex>
 
+/// Side length (in pixels) of the cells used by striped film accumulation
+#define HDRFILM_LOCK_CELL 16
+
+/// Number of locks shared by all cells in striped film accumulation
+#define HDRFILM_LOCK_STRIPES 1024u
+
+/// Height (in pixels) of the bands of rows that a streaming film writes to disk
+#define HDRFILM_STREAM_ROWS 32u
+
 NAMESPACE_BEGIN(mitsuba)
 
 /**!
@@ -19,7 +32,7 @@ High dynamic range film (:monosp:`hdrfilm`)
 -------------------------------------------
 
 .. pluginparameters::
- :extra-rows: 8
+ :extra-rows: 10
 
  * - width, height
    - |int|
@@ -55,6 +68,19 @@ High dynamic range film (:monosp:`hdrfilm`)
      improve the image quality at the edges, especially when using very large reconstruction
      filters. In general, this is not needed though. (Default: |false|, i.e. disabled)
 
+ * - striped_accumulation
+   - |bool|
+   - Scalar variants only: if set to |true|, image blocks are merged into the film
+     cell by cell while holding one of many striped locks, so that worker threads
+     only wait for each other when their blocks actually overlap. Otherwise, a
+     single lock serializes all merges. (Default: |true|)
+
+ * - stream_filename
+   - |string|
+   - Scalar variants only: if specified, the film operates in streaming mode and
+     writes finished rows of the image to this OpenEXR file while rendering,
+     instead of holding the full image in memory (see below). (Default: unused)
+
  * - (Nested plugin)
    - :paramtype:`rfilter`
    - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
@@ -102,6 +128,29 @@ When RGB(A) output is selected, the measured spectral power distributions are
 converted to linear RGB based on the CIE 1931 XYZ color matching curves and
 the ITU-R Rec. BT.709-3 primaries with a D65 white point.
 
+In scalar variants, the worker threads of the renderer continually merge
+finished image blocks into the film. With many threads and small blocks, a
+single lock around this step can become a bottleneck, which is why the film
+by default partitions its storage into small cells and protects them with a
+fixed set of striped locks (see the :monosp:`striped_accumulation`
+parameter). The interior of a block is then merged without any contention,
+and only the filter borders shared with neighboring blocks may occasionally
+wait. The number of merges that had to wait for a lock is reported in the
+film's string representation and logged at the debug level when the film is
+developed.
+
+Very large images, such as gigapixel panoramas with many AOVs, may not fit
+into memory. When the :monosp:`stream_filename` parameter is given, the film
+instead holds only the bands of rows that are currently being rendered
+(including the filter borders shared with neighboring bands) and writes each
+band to a scanline OpenEXR file as soon as no further samples can reach it.
+Memory usage then only depends on the width of the image. The renderer
+generates image blocks in scanline order for such films and requires a single
+rendering pass; other integrators (e.g., particle tracers) are not supported.
+The developed image is not available in memory: ``develop()`` and ``bitmap()``
+raise an error, and ``write()`` moves the finished file to the requested
+location. This mode only supports the :monosp:`openexr` file format.
+
 The following XML snippet describes a film that writes a full-HD RGBA OpenEXR file:
 
 .. tabs::
@@ -215,6 +264,25 @@ public:
             }
         }
 
+        if (props.has_property("stream_filename")) {
+            if constexpr (dr::is_jit_v<Float>)
+                Throw("The \"stream_filename\" parameter is only supported in "
+                      "scalar variants.");
+            if (m_file_format != Bitmap::FileFormat::OpenEXR)
+                Throw("The \"stream_filename\" parameter requires "
+                      "file_format=\"openexr\".");
+            m_stream_filename = props.get<std::string_view>("stream_filename");
+            if (string::to_lower(m_stream_filename.extension().string()) != ".exr")
+                m_stream_filename.replace_extension(".exr");
+            m_flags |= +FilmFlags::Streaming;
+        }
+
+        m_striped_accumulation = props.get<bool>("striped_accumulation", true);
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (m_striped_accumulation)
+                m_stripes.reset(new Stripe[HDRFILM_LOCK_STRIPES]);
+        }
+
         props.mark_queried("banner"); // no banner in Mitsuba 3
 
         if (props.has_property("compensate")) {
@@ -257,9 +325,15 @@ public:
             std::lock_guard<std::mutex> lock(m_mutex);
             if (dr::is_jit_v<Float> && m_storage == nullptr)
                 jit_freeze_discard(drjit::detail::backend<Float>::value, "Image Block was allocated");
-            m_storage = new ImageBlock(m_crop_size, m_crop_offset,
-                                       (uint32_t) channels.size());
+            if (streaming())
+                reset_stream();
+            else
+                m_storage = new ImageBlock(m_crop_size, m_crop_offset,
+                                           (uint32_t) channels.size());
             m_channels = channels;
+            m_put_blocks = 0;
+            m_put_regions = 0;
+            m_put_contended = 0;
         }
 
         std::sort(channels.begin(), channels.end());
@@ -288,20 +362,55 @@ public:
     }
 
     void put_block(const ImageBlock *block) override {
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (streaming()) {
+                put_block_streaming(block);
+                return;
+            }
+        }
+
         Assert(m_storage != nullptr);
-        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (m_striped_accumulation) {
+                put_block_striped(block);
+                return;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+        bool contended = !lock.owns_lock();
+        if (contended)
+            lock.lock();
         m_storage->put_block(block);
+        lock.unlock();
+
+        update_put_stats(1, contended ? 1 : 0);
     }
 
     void clear() override {
         if (m_storage)
             m_storage->clear();
+        if (streaming()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            reset_stream();
+        }
     }
 
     TensorXf develop(bool raw = false) const override {
+        if (streaming())
+            Throw("HDRFilm::develop(): not available in streaming mode, the "
+                  "image is written to \"%s\".", m_stream_filename.string());
         if (!m_storage)
             Throw("No storage allocated, was prepare() called first?");
 
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (m_put_blocks > 0)
+                Log(Debug, "Merged %zu image blocks in %zu regions, %zu of "
+                    "which had to wait for a lock.", (size_t) m_put_blocks,
+                    (size_t) m_put_regions, (size_t) m_put_contended);
+        }
+
         if (raw) {
             std::lock_guard<std::mutex> lock(m_mutex);
             return m_storage->tensor();
@@ -412,11 +521,19 @@ public:
     }
 
     ref<Bitmap> bitmap(bool raw = false) const override {
+        if (streaming())
+            Throw("HDRFilm::bitmap(): not available in streaming mode, the "
+                  "image is written to \"%s\".", m_stream_filename.string());
         if (!m_storage)
             Throw("No storage allocated, was prepare() called first?");
 
         std::lock_guard<std::mutex> lock(m_mutex);
-        auto &&storage = dr::migrate(m_storage->tensor().array(), JitBackend::None);
+        return develop_block(m_storage.get(), raw);
+    }
+
+    /// Convert the contents of an image block into a bitmap of the output format
+    ref<Bitmap> develop_block(const ImageBlock *storage_block, bool raw) const {
+        auto &&storage = dr::migrate(storage_block->tensor().array(), JitBackend::None);
 
         if constexpr (dr::is_jit_v<Float>)
             dr::sync_thread();
@@ -431,8 +548,8 @@ public:
                                      : Bitmap::PixelFormat::MultiChannel;
 
         ref<Bitmap> source = new Bitmap(
-            source_fmt, struct_type_v<ScalarFloat>, m_storage->size(),
-            m_storage->channel_count(), m_channels, (uint8_t *) storage.data());
+            source_fmt, struct_type_v<ScalarFloat>, storage_block->size(),
+            storage_block->channel_count(), m_channels, (uint8_t *) storage.data());
 
         if (raw)
             return source;
@@ -447,11 +564,11 @@ public:
         uint32_t img_ch = to_y ? 1 : 3;
         uint32_t aovs_channel = has_aovs ? (img_ch + (uint32_t) alpha) : 0;
         uint32_t target_ch =
-            (uint32_t) m_storage->channel_count() - base_ch + aovs_channel;
+            (uint32_t) storage_block->channel_count() - base_ch + aovs_channel;
 
         ref<Bitmap> target = new Bitmap(
             has_aovs ? Bitmap::PixelFormat::MultiChannel : m_pixel_format,
-            struct_type_v<ScalarFloat>, m_storage->size(),
+            struct_type_v<ScalarFloat>, storage_block->size(),
             has_aovs ? target_ch : 0);
 
         if (has_aovs) {
@@ -551,35 +668,43 @@ public:
         if (extension != proper_extension)
             filename.replace_extension(proper_extension);
 
+        if (streaming()) {
+            write_streaming(filename);
+            return;
+        }
+
         #if !defined(_WIN32)
             Log(Info, "\U00002714  Developing \"%s\" ..", filename.string());
         #else
             Log(Info, "Developing \"%s\" ..", filename.string());
         #endif
 
-        ref<Bitmap> source = bitmap();
-        if (m_component_format != struct_type_v<ScalarFloat>) {
-            // Mismatch between the current format and the one expected by the film
-            // Conversion is necessary before saving to disk
-            std::vector<std::string> channel_names;
-            for (size_t i = 0; i < source->channel_count(); i++)
-                channel_names.push_back(source->struct_()[i].name);
-            ref<Bitmap> target = new Bitmap(
-                source->pixel_format(),
-                m_component_format,
-                source->size(),
-                source->channel_count(),
-                channel_names);
-            source->convert(target);
-
-            target->write(filename, m_file_format);
-        } else {
-            source->write(filename, m_file_format);
-        }
+        convert_component_format(bitmap())->write(filename, m_file_format);
+    }
+
+    /// Convert a developed bitmap into the component format of the output file
+    ref<Bitmap> convert_component_format(Bitmap *source) const {
+        if (m_component_format == struct_type_v<ScalarFloat>)
+            return source;
+
+        // Mismatch between the current format and the one expected by the film
+        // Conversion is necessary before saving to disk
+        std::vector<std::string> channel_names;
+        for (size_t i = 0; i < source->channel_count(); i++)
+            channel_names.push_back(source->struct_()[i].name);
+        ref<Bitmap> target = new Bitmap(
+            source->pixel_format(),
+            m_component_format,
+            source->size(),
+            source->channel_count(),
+            channel_names);
+        source->convert(target);
+        return target;
     }
 
     void schedule_storage() override {
-        dr::schedule(m_storage->tensor());
+        if (m_storage)
+            dr::schedule(m_storage->tensor());
     };
 
     std::string to_string() const override {
@@ -592,13 +717,311 @@ public:
             << "  filter = " << m_filter << "," << std::endl
             << "  file_format = " << m_file_format << "," << std::endl
             << "  pixel_format = " << m_pixel_format << "," << std::endl
-            << "  component_format = " << m_component_format << "," << std::endl
-            << "]";
+            << "  component_format = " << m_component_format << "," << std::endl;
+        if constexpr (!dr::is_jit_v<Float>)
+            oss << "  striped_accumulation = " << m_striped_accumulation << "," << std::endl
+                << "  put_block_stats = [blocks=" << m_put_blocks
+                << ", regions=" << m_put_regions
+                << ", contended=" << m_put_contended << "]," << std::endl;
+        if (streaming())
+            oss << "  stream_filename = \"" << m_stream_filename.string() << "\"," << std::endl
+                << "  stream_stats = [bands_written=" << m_stream_next_band
+                << ", peak_bands=" << m_stream_peak_bands << "]," << std::endl;
+        oss << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS(HDRFilm)
 protected:
+    /**
+     * \brief Merge an image block into the storage without a global lock
+     *
+     * The storage (including its border) is divided into square cells of
+     * \c HDRFILM_LOCK_CELL pixels, and each cell maps to one of a fixed
+     * number of striped locks. The block is merged one cell at a time while
+     * holding only that cell's lock. Cells that are busy on the first pass are
+     * deferred and merged at the end, so a thread rarely waits at all: only
+     * the filter border of a block overlaps with the blocks of other threads.
+     */
+    void put_block_striped(const ImageBlock *block) {
+        ScalarPoint2i  storage_offset = m_storage->offset() - m_storage->border_size(),
+                       block_offset   = block->offset() - block->border_size();
+        ScalarVector2i storage_size(m_storage->size() + 2 * m_storage->border_size()),
+                       block_size(block->size() + 2 * block->border_size());
+
+        // Pixel region covered by both blocks, relative to the storage
+        ScalarPoint2i lo = dr::maximum(block_offset, storage_offset) - storage_offset,
+                      hi = dr::minimum(block_offset + block_size,
+                                       storage_offset + storage_size) - storage_offset;
+        if (dr::any(hi <= lo))
+            return;
+
+        ScalarPoint2i cell_lo = lo / HDRFILM_LOCK_CELL,
+                      cell_hi = (hi - 1) / HDRFILM_LOCK_CELL;
+        int cells_x = (storage_size.x() + HDRFILM_LOCK_CELL - 1) / HDRFILM_LOCK_CELL;
+
+        auto merge_cell = [&](int x, int y) {
+            ScalarPoint2i p = ScalarPoint2i(x, y) * HDRFILM_LOCK_CELL;
+            ScalarPoint2i region_lo = dr::maximum(lo, p),
+                          region_hi = dr::minimum(hi, p + HDRFILM_LOCK_CELL);
+            m_storage->put_block(block, storage_offset + region_lo,
+                                 region_hi - region_lo);
+        };
+
+        auto stripe = [&](int x, int y) -> std::mutex & {
+            return m_stripes[(uint32_t) (y * cells_x + x) % HDRFILM_LOCK_STRIPES].mutex;
+        };
+
+        std::vector<ScalarPoint2i> deferred;
+        size_t regions = 0;
+
+        for (int y = cell_lo.y(); y <= cell_hi.y(); ++y) {
+            for (int x = cell_lo.x(); x <= cell_hi.x(); ++x) {
+                std::unique_lock<std::mutex> lock(stripe(x, y), std::try_to_lock);
+                if (!lock.owns_lock()) {
+                    deferred.emplace_back(x, y);
+                    continue;
+                }
+                merge_cell(x, y);
+                regions++;
+            }
+        }
+
+        for (const ScalarPoint2i &cell : deferred) {
+            std::lock_guard<std::mutex> lock(stripe(cell.x(), cell.y()));
+            merge_cell(cell.x(), cell.y());
+            regions++;
+        }
+
+        update_put_stats(regions, deferred.size());
+    }
+
+    void update_put_stats(size_t regions, size_t contended) {
+        m_put_blocks.fetch_add(1, std::memory_order_relaxed);
+        m_put_regions.fetch_add(regions, std::memory_order_relaxed);
+        if (contended)
+            m_put_contended.fetch_add(contended, std::memory_order_relaxed);
+    }
+
+    bool streaming() const { return !m_stream_filename.empty(); }
+
+    /// Number of bands of \c HDRFILM_STREAM_ROWS rows covering the crop window
+    uint32_t stream_band_count() const {
+        return (m_crop_size.y() + HDRFILM_STREAM_ROWS - 1) / HDRFILM_STREAM_ROWS;
+    }
+
+    /// First and last+1 row (relative to the crop window) that are rendered
+    std::pair<int, int> stream_rendered_rows() const {
+        int border = m_sample_border ? (int) m_filter->border_size() : 0;
+        return { -border, (int) m_crop_size.y() + border };
+    }
+
+    /**
+     * \brief Return the row (relative to the crop window) up to which all
+     * rendered rows must be complete before band \c b can be written
+     *
+     * Samples splat into rows up to the filter's border size away, so this
+     * includes the rows below the band that still contribute to it.
+     */
+    int stream_required_rows(uint32_t b) const {
+        int end = (int) std::min((b + 1) * HDRFILM_STREAM_ROWS, m_crop_size.y()) +
+                  (int) m_filter->border_size();
+        return std::min(end, stream_rendered_rows().second);
+    }
+
+    /// Reset the streaming state (assumes that \c m_mutex is held)
+    void reset_stream() {
+        auto [lo, hi] = stream_rendered_rows();
+        m_stream_bands.clear();
+        m_stream_row_pixels.assign((size_t) (hi - lo), 0);
+        m_stream_rows_done = 0;
+        m_stream_next_band = 0;
+        m_stream_peak_bands = 0;
+        m_stream_puts = 0;
+        m_stream_writer = nullptr;
+
+        /* Allow threads to work on a few bands beyond the next one that will
+           be written, but at least enough for one block row per thread */
+        uint32_t n_threads = (uint32_t) (pool_size() + 1),
+                 width     = std::max(m_crop_size.x(), 1u);
+        m_stream_lookahead =
+            4 + (n_threads * HDRFILM_STREAM_ROWS + width - 1) / width;
+    }
+
+    /**
+     * \brief Merge an image block into the in-memory bands of a streaming film
+     *
+     * The block is accumulated into every band that it (including its filter
+     * border) overlaps, and the number of pixels rendered into each row is
+     * counted. Bands are written in order once all rows that can contribute
+     * to them are complete.
+     *
+     * Blocks far below the next band to be written wait until the film has
+     * caught up, which bounds the number of bands held in memory. Blocks that
+     * the next band depends on never wait, so rendering cannot deadlock; a
+     * thread also stops waiting when no other block has been merged for a
+     * while (e.g., because the render was cancelled).
+     */
+    void put_block_streaming(const ImageBlock *block) {
+        ScalarPoint2i offset = block->offset() - ScalarPoint2i(m_crop_offset);
+        ScalarVector2i size(block->size());
+        int border = (int) block->border_size();
+        auto [lo, hi] = stream_rendered_rows();
+        uint32_t band_count = stream_band_count();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        auto ready = [&] {
+            return m_stream_next_band + m_stream_lookahead >= band_count ||
+                   offset.y() < stream_required_rows(m_stream_next_band +
+                                                     m_stream_lookahead);
+        };
+
+        while (!ready()) {
+            size_t puts = m_stream_puts;
+            if (!m_stream_cv.wait_for(lock, std::chrono::seconds(1), ready) &&
+                puts == m_stream_puts)
+                break;
+        }
+
+        // Accumulate into the overlapping bands
+        int y0 = std::max(offset.y() - border, 0),
+            y1 = std::min(offset.y() + size.y() + border, (int) m_crop_size.y());
+        if (y0 < y1) {
+            uint32_t b0 = (uint32_t) y0 / HDRFILM_STREAM_ROWS,
+                     b1 = (uint32_t) (y1 - 1) / HDRFILM_STREAM_ROWS;
+            if (b0 < m_stream_next_band)
+                Throw("HDRFilm: received an image block for rows that were "
+                      "already written to \"%s\". Streaming films require "
+                      "image blocks in scanline order from a single rendering "
+                      "pass.", m_stream_filename.string());
+            for (uint32_t b = b0; b <= b1; ++b)
+                stream_band(b)->put_block(block);
+            m_stream_peak_bands =
+                std::max(m_stream_peak_bands, m_stream_bands.size());
+        }
+        m_stream_puts++;
+
+        // Count the rendered pixels of each row covered by the block interior
+        int x0 = std::max(offset.x(), lo),
+            x1 = std::min(offset.x() + size.x(), (int) m_crop_size.x() - lo);
+        if (x0 < x1) {
+            for (int y = std::max(offset.y(), lo),
+                     y_end = std::min(offset.y() + size.y(), hi); y < y_end; ++y)
+                m_stream_row_pixels[y - lo] += (uint32_t) (x1 - x0);
+        }
+
+        uint32_t row_width = m_crop_size.x() - 2 * lo,
+                 row_count = (uint32_t) m_stream_row_pixels.size();
+        while (m_stream_rows_done < row_count &&
+               m_stream_row_pixels[m_stream_rows_done] >= row_width)
+            m_stream_rows_done++;
+
+        // Write all bands whose contributing rows are complete
+        uint32_t first = m_stream_next_band;
+        while (m_stream_next_band < band_count &&
+               (int) m_stream_rows_done + lo >=
+                   stream_required_rows(m_stream_next_band))
+            m_stream_next_band++;
+
+        if (first != m_stream_next_band) {
+            flush_bands(lock, first, m_stream_next_band);
+            m_stream_cv.notify_all();
+        }
+    }
+
+    /// Return the in-memory band with the given index, creating it if needed
+    ImageBlock *stream_band(uint32_t b) {
+        ref<ImageBlock> &band = m_stream_bands[b];
+        if (!band) {
+            uint32_t y      = b * HDRFILM_STREAM_ROWS,
+                     height = std::min(HDRFILM_STREAM_ROWS, m_crop_size.y() - y);
+            band = new ImageBlock(ScalarVector2u(m_crop_size.x(), height),
+                                  m_crop_offset + ScalarPoint2u(0, y),
+                                  (uint32_t) m_channels.size());
+        }
+        return band.get();
+    }
+
+    /**
+     * \brief Develop the bands <tt>[first, last)</tt> and append them to the
+     * output file
+     *
+     * Must be called with \c m_mutex held, which is released while the bands
+     * are written. \c m_stream_write_mutex is acquired beforehand so that
+     * concurrent flushes reach the file in band order.
+     */
+    void flush_bands(std::unique_lock<std::mutex> &lock, uint32_t first,
+                     uint32_t last) {
+        std::vector<ref<ImageBlock>> bands;
+        for (uint32_t b = first; b < last; ++b) {
+            ImageBlock *band = stream_band(b);
+            bands.push_back(band);
+            m_stream_bands.erase(b);
+        }
+
+        std::lock_guard<std::mutex> write_lock(m_stream_write_mutex);
+        lock.unlock();
+
+        for (ImageBlock *band : bands) {
+            ref<Bitmap> bitmap = convert_component_format(develop_block(band, false));
+            if (!m_stream_writer)
+                m_stream_writer = new BitmapStreamWriter(
+                    m_stream_filename, bitmap.get(), m_crop_size.y());
+            m_stream_writer->write(bitmap.get());
+        }
+
+        if (last == stream_band_count())
+            Log(Info, "Wrote %u rows to \"%s\" (holding up to %zu bands of %u "
+                "rows in memory).", m_crop_size.y(), m_stream_filename.string(),
+                m_stream_peak_bands, HDRFILM_STREAM_ROWS);
+
+        lock.lock();
+    }
+
+    /// Write any remaining bands and move the output file to \c filename
+    void write_streaming(const fs::path &filename) {
+        /* locked */ {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_stream_row_pixels.empty())
+                Throw("HDRFilm::write(): nothing was rendered, was prepare() "
+                      "called first?");
+            uint32_t first = m_stream_next_band;
+            m_stream_next_band = stream_band_count();
+            if (first != m_stream_next_band) {
+                if (m_stream_rows_done < m_stream_row_pixels.size())
+                    Log(Warn, "HDRFilm::write(): the image is incomplete, "
+                        "writing the remaining rows as rendered so far.");
+                flush_bands(lock, first, m_stream_next_band);
+            }
+            m_stream_cv.notify_all();
+        }
+
+        std::lock_guard<std::mutex> write_lock(m_stream_write_mutex);
+        if (m_stream_writer) {
+            m_stream_writer->close();
+            m_stream_writer = nullptr;
+        }
+
+        if (fs::exists(filename) && fs::equivalent(filename, m_stream_filename))
+            return;
+
+        Log(Info, "Moving \"%s\" to \"%s\" ..", m_stream_filename.string(),
+            filename.string());
+        if (!fs::rename(m_stream_filename, filename)) {
+            if (!fs::copy_file(m_stream_filename, filename))
+                Throw("HDRFilm::write(): could not copy \"%s\" to \"%s\"!",
+                      m_stream_filename.string(), filename.string());
+            fs::remove(m_stream_filename);
+        }
+    }
+
+protected:
+    /// Cache line-aligned lock, to avoid false sharing between stripes
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+    };
+
     Bitmap::FileFormat m_file_format;
     Bitmap::PixelFormat m_pixel_format;
     sj::Type m_component_format;
@@ -606,6 +1029,34 @@ protected:
     mutable std::mutex m_mutex;
     std::vector<std::string> m_channels;
 
+    bool m_striped_accumulation;
+    std::unique_ptr<Stripe[]> m_stripes;
+
+    /// Number of merged blocks, of merged regions (one per cell in striped
+    /// mode), and of regions that had to wait for a lock
+    std::atomic<size_t> m_put_blocks { 0 };
+    std::atomic<size_t> m_put_regions { 0 };
+    std::atomic<size_t> m_put_contended { 0 };
+
+    /// Streaming mode: output file (empty if disabled) and its writer
+    fs::path m_stream_filename;
+    ref<BitmapStreamWriter> m_stream_writer;
+    /// Bands of rows that have not been written yet, by index
+    std::map<uint32_t, ref<ImageBlock>> m_stream_bands;
+    /// Number of rendered pixels of each row (starting with the top border)
+    std::vector<uint32_t> m_stream_row_pixels;
+    /// Number of leading rows in \c m_stream_row_pixels that are complete
+    uint32_t m_stream_rows_done = 0;
+    /// Index of the next band to be written
+    uint32_t m_stream_next_band = 0;
+    /// Number of bands past the next one that threads may render into
+    uint32_t m_stream_lookahead = 0;
+    /// Number of blocks merged so far, and largest number of bands in memory
+    size_t m_stream_puts = 0;
+    size_t m_stream_peak_bands = 0;
+    std::condition_variable m_stream_cv;
+    std::mutex m_stream_write_mutex;
+
     MI_TRAVERSE_CB(Base, m_storage)
 };
 
@@ -1,6 +1,7 @@
 import pytest
 import drjit as dr
 import mitsuba as mi
+import numpy as np
 
 
 def test01_construct(variant_scalar_rgb):
@@ -236,3 +237,98 @@ def test07_luminance_alpha_mono(variants_all):
     image = mi.TensorXf(film.bitmap())
 
     assert image.shape[2] == 2
+
+
+def test08_striped_accumulation(variant_scalar_rgb, np_rng):
+    # Overlapping blocks with filter borders must accumulate to the same image
+    # whether they are merged under a single lock or cell by cell
+    def make_film(striped):
+        film = mi.load_dict({
+            'type': 'hdrfilm',
+            'width': 70,
+            'height': 45,
+            'striped_accumulation': striped,
+        })
+        film.prepare([])
+        return film
+
+    films = [make_film(False), make_film(True)]
+
+    for _ in range(20):
+        size = np_rng.integers(1, 40, 2)
+        offset = np_rng.integers(-5, 60, 2)
+        block = films[0].create_block(size=mi.ScalarVector2u(size), borders=True)
+        block.set_offset(mi.ScalarPoint2i(offset))
+        for _ in range(16):
+            pos = mi.ScalarPoint2f(offset + np_rng.random(2) * size)
+            block.put(pos, list(np_rng.random(4)))
+        for film in films:
+            film.put_block(block)
+
+    ref, striped = [film.develop(raw=True) for film in films]
+    assert dr.allclose(ref, striped)
+
+    assert 'blocks=20' in str(films[1])
+    assert 'contended=0' in str(films[1])
+
+
+def test09_streaming(variant_scalar_rgb, np_rng, tmpdir):
+    # A streaming film must write the same image as a film that keeps
+    # everything in memory, as long as the blocks arrive in scanline order
+    def make_film(**kwargs):
+        film = mi.load_dict({
+            'type': 'hdrfilm',
+            'width': 70,
+            'height': 100,
+            'sample_border': True,
+            'pixel_format': 'rgba',
+            **kwargs
+        })
+        film.prepare(['aov'])
+        return film
+
+    stream_filename = str(tmpdir.join('stream.exr'))
+    film = make_film()
+    stream = make_film(stream_filename=stream_filename)
+    assert mi.has_flag(stream.flags(), mi.FilmFlags.Streaming)
+    assert not mi.has_flag(film.flags(), mi.FilmFlags.Streaming)
+
+    border = film.rfilter().border_size()
+    spiral = mi.Spiral(film.crop_size() + 2 * border, film.crop_offset(),
+                       block_size=16, scanline=True)
+
+    while True:
+        offset, size, _ = spiral.next_block()
+        if dr.prod(size) == 0:
+            break
+        block = film.create_block(size=size, borders=True)
+        block.set_offset(offset - border)
+        for _ in range(16):
+            pos = mi.ScalarPoint2f(offset - border + np_rng.random(2) * size)
+            block.put(pos, list(np_rng.random(6)))
+        film.put_block(block)
+        stream.put_block(block)
+
+    # The image was written while rendering, and is not held in memory
+    with pytest.raises(RuntimeError):
+        stream.develop()
+
+    ref_filename = str(tmpdir.join('ref.exr'))
+    out_filename = str(tmpdir.join('out.exr'))
+    film.write(ref_filename)
+    stream.write(out_filename)
+
+    ref = mi.Bitmap(ref_filename)
+    out = mi.Bitmap(out_filename)
+    assert out.size() == ref.size()
+    assert out.channel_count() == ref.channel_count()
+    assert np.allclose(np.array(out), np.array(ref))
+
+    # Blocks for rows that were already written are rejected
+    stream.prepare(['aov'])
+    block = stream.create_block(size=mi.ScalarVector2u(70 + 2 * border, 40 + border),
+                                borders=False)
+    block.set_offset(mi.ScalarPoint2i(-border))
+    stream.put_block(block)
+    with pytest.raises(RuntimeError, match='already written'):
+        stream.put_block(block)
@@ -192,7 +192,7 @@ public:
 
         dr::tie(ls) = dr::while_loop(dr::make_tuple(ls),
             [](const LoopState& ls) { return ls.active; },
-            [this, scene, bsdf_ctx](LoopState& ls) {
+            [this, scene, bsdf_ctx, &ray_](LoopState& ls) {
 
             /* dr::while_loop implicitly masks all code in the loop using the
                'active' flag, so there is no need to pass it to every function */
@@ -230,6 +230,14 @@ public:
                 return; // early exit for scalar mode
             }
 
+            // Texture filtering footprint of camera rays (e.g. for MIP maps)
+            if (scene->needs_uv_partials() && ray_.has_differentials &&
+                dr::any_or<true>(ls.depth == 0u)) {
+                si.compute_uv_partials(ray_);
+                dr::masked(si.duv_dx, ls.depth > 0u) = 0.f;
+                dr::masked(si.duv_dy, ls.depth > 0u) = 0.f;
+            }
+
             BSDFPtr bsdf = si.bsdf(ls.ray);
 
             // ---------------------- Emitter sampling ----------------------
@@ -51,3 +51,51 @@ def test02_path_directly_visible(variants_all_rgb):
     })
     img = mi.render(scene, integrator=integrator)
     assert dr.allclose(img.array, 0)
+
+
+def test03_progressive_converged(variants_all_rgb):
+    scene_description = mi.cornell_box()
+    # Look only at light, whose radiance has no variance
+    scene_description['sensor']['film']['crop_offset_x'] = 120
+    scene_description['sensor']['film']['crop_offset_y'] = 35
+    scene_description['sensor']['film']['crop_width'] = 8
+    scene_description['sensor']['film']['crop_height'] = 4
+    scene_description['sensor']['film']['rfilter'] = {'type': 'box'}
+    scene_description['sensor']['sampler']['sample_count'] = 256
+    scene = mi.load_dict(scene_description)
+
+    ref = mi.render(scene, integrator=mi.load_dict({
+        'type': 'path',
+        'max_depth': 1
+    }))
+    img = mi.render(scene, integrator=mi.load_dict({
+        'type': 'path',
+        'max_depth': 1,
+        'error_threshold': 0.01,
+        'pass_samples': 4
+    }))
+    assert dr.allclose(img.array, ref.array, rtol=1e-3)
+
+
+@pytest.mark.parametrize('options', [
+    { 'error_threshold': 0.05 },
+    { 'time_budget': 1e-6 }
+])
+def test04_progressive_consistent(variants_all_rgb, options):
+    """Stopping early leaves a complete image that agrees with the full render"""
+    scene_description = mi.cornell_box()
+    scene_description['sensor']['film']['width'] = 32
+    scene_description['sensor']['film']['height'] = 32
+    scene_description['sensor']['sampler']['sample_count'] = 128
+    scene = mi.load_dict(scene_description)
+
+    ref = mi.render(scene, integrator=mi.load_dict({'type': 'path'}))
+    img = mi.render(scene, integrator=mi.load_dict({
+        'type': 'path',
+        'pass_samples': 4,
+        **options
+    }))
+
+    assert dr.all(dr.isfinite(img.array))
+    ref_mean, img_mean = dr.mean(ref.array), dr.mean(img.array)
+    assert dr.abs(img_mean - ref_mean) < 0.05 * ref_mean
@@ -234,3 +234,16 @@ def test07_adjoint_integrator_trampoline(variants_all_ad_rgb):
     mi.load_dict({
         'type': 'myptracer'
     })
+
+
+def test08_render_many_ranges(variant_scalar_rgb):
+    """
+    Worker buffers accumulate many work ranges each; the result must not
+    depend on how ranges were assigned to them.
+    """
+    scene, integrator = create_test_scene(emitter='area')
+    image1 = integrator.render(scene, seed=0, spp=256, develop=True)
+    image2 = integrator.render(scene, seed=0, spp=256, develop=True)
+    assert dr.all(dr.isfinite(dr.ravel(image1)))
+    assert dr.count(dr.ravel(image1) > 0) >= 0.2 * dr.prod(dr.shape(image1))
+    assert dr.allclose(dr.ravel(image1), dr.ravel(image2), rtol=1e-4, atol=1e-5)
@@ -169,7 +169,7 @@ public:
 
         dr::tie(ls) = dr::while_loop(dr::make_tuple(ls),
             [](const LoopState& ls) { return ls.active; },
-            [this, scene, channel](LoopState& ls) {
+            [this, scene, channel, &ray_](LoopState& ls) {
 
             Mask& active = ls.active;
             UInt32& depth = ls.depth;
@@ -345,6 +345,15 @@ public:
             if (dr::any_or<true>(active_surface)) {
                 // --------------------- Emitter sampling ---------------------
                 BSDFContext ctx;
+
+                // Texture filtering footprint of camera rays (e.g. for MIP maps)
+                if (scene->needs_uv_partials() && ray_.has_differentials &&
+                    dr::any_or<true>(depth == 0u)) {
+                    si.compute_uv_partials(ray_);
+                    dr::masked(si.duv_dx, depth > 0u) = 0.f;
+                    dr::masked(si.duv_dy, depth > 0u) = 0.f;
+                }
+
                 BSDFPtr bsdf  = si.bsdf(ray);
                 Mask active_e = active_surface && has_flag(bsdf->flags(), BSDFFlags::Smooth) && (depth + 1 < (uint32_t) m_max_depth);
 
@@ -488,7 +497,7 @@ public:
                 Mask is_spectral = medium->has_spectral_extinction() && active_medium;
                 Mask not_spectral = !is_spectral && active_medium;
                 if (dr::any_or<true>(is_spectral)) {
-                    Float t      = dr::minimum(remaining_dist, dr::minimum(mei.t, si.t)) - mei.mint;
+                    Float t      = dr::maximum(0.f, dr::minimum(remaining_dist, dr::minimum(mei.t, si.t)) - mei.mint);
                     UnpolarizedSpectrum tr  = dr::exp(-t * mei.combined_extinction);
                     UnpolarizedSpectrum free_flight_pdf = dr::select(si.t < mei.t || mei.t > remaining_dist, tr, tr * mei.combined_extinction);
                     Float tr_pdf = index_spectrum(free_flight_pdf, channel);
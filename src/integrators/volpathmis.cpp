@@ -545,7 +545,7 @@ public:
                 Mask is_spectral = medium->has_spectral_extinction() && active_medium;
                 Mask not_spectral = !is_spectral && active_medium;
                 if (dr::any_or<true>(is_spectral)) {
-                    Float t      = dr::minimum(remaining_dist, dr::minimum(mei.t, si.t)) - mei.mint;
+                    Float t      = dr::maximum(0.f, dr::minimum(remaining_dist, dr::minimum(mei.t, si.t)) - mei.mint);
                     UnpolarizedSpectrum tr  = dr::exp(-t * mei.combined_extinction);
                     UnpolarizedSpectrum free_flight_pdf = dr::select(si.t < mei.t || mei.t > remaining_dist, tr, tr * mei.combined_extinction);
                     update_weights(p_over_f_nee, free_flight_pdf, tr, channel, is_spectral);
@@ -1,6 +1,8 @@
 #include <mitsuba/core/frame.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/transform.h>
 #include <mitsuba/core/warp.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/medium.h>
@@ -38,6 +40,14 @@ Heterogeneous medium (:monosp:`heterogeneous`)
      units, or to simply tweak the density of the medium. (Default: 1)
    - |exposed|
 
+ * - majorant_resolution_factor
+   - |int|
+   - Downsampling factor of the majorant grid with respect to the resolution
+     of :paramtype:`sigma_t`. Free-flight distances are sampled by walking
+     this coarse grid of local upper bounds of the extinction, which greatly
+     reduces the number of null collisions in sparse volumes. A value of 0
+     disables the grid in favor of a single global majorant. (Default: 8)
+
  * - sample_emitters
    - |bool|
    - Flag to specify whether shadow rays should be cast from inside the volume (Default: |true|)
@@ -68,6 +78,15 @@ meters and the coefficients are in inverse millimeters, set scale to 1000.
 Both the albedo and the extinction coefficient can either be constant or textured,
 and both parameters are allowed to be spectrally varying.
 
+Null-collision methods sample tentative collisions with a density given by an
+upper bound (*majorant*) of the extinction coefficient. By default, this plugin
+partitions the extinction volume into a coarse grid and stores the maximum of
+each cell, accounting for the interpolation of the voxel data. Distances are
+then sampled by traversing this grid with a 3D digital differential analyzer
+(DDA), so that empty or thin regions are skipped instead of being crossed
+with the majorant of the densest voxel. This is particularly effective for
+sparse data such as smoke or clouds.
+
 .. tabs::
     .. code-tab:: xml
         :name: lst-heterogeneous
@@ -152,6 +171,8 @@ public:
                     m_phase_function)
     MI_IMPORT_TYPES(Scene, Sampler, Texture, Volume)
 
+    using FloatStorage = DynamicBuffer<Float>;
+
     HeterogeneousMedium(const Properties &props) : Base(props) {
         m_is_homogeneous = false;
         m_albedo = props.get_volume<Volume>("albedo", 0.75f);
@@ -160,7 +181,11 @@ public:
         m_scale = props.get<ScalarFloat>("scale", 1.0f);
         m_has_spectral_extinction = props.get<bool>("has_spectral_extinction", true);
 
+        m_majorant_factor =
+            props.get<ScalarUInt32>("majorant_resolution_factor", 8);
+
         m_max_density = dr::opaque<Float>(m_scale * m_sigmat->max());
+        update_majorant_grid();
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -170,15 +195,144 @@ public:
         Base::traverse(cb);
     }
 
-    void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
+    void parameters_changed(const std::vector<std::string> &keys = {}) override {
         m_max_density = dr::opaque<Float>(m_scale * m_sigmat->max());
+
+        // Rebuilding the majorant grid requires reading back the volume
+        bool extinction_changed = keys.empty();
+        for (const std::string &key : keys)
+            extinction_changed |=
+                key == "scale" || string::starts_with(key, "sigma_t");
+        if (extinction_changed)
+            update_majorant_grid();
     }
 
     UnpolarizedSpectrum
-    get_majorant(const MediumInteraction3f & /* mi */,
+    get_majorant(const MediumInteraction3f &mi,
                  Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
-        return m_max_density;
+        if (m_majorant_res.x() == 0)
+            return m_max_density;
+
+        Vector3i cell = dr::clip(
+            dr::floor2int<Vector3i>(m_to_grid * mi.p), 0,
+            ScalarVector3i(m_majorant_res) - 1);
+        return lookup_majorant(cell, active);
+    }
+
+    MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
+                                           UInt32 channel,
+                                           Mask active) const override {
+        if (m_majorant_res.x() == 0)
+            return Base::sample_interaction(ray, sample, channel, active);
+
+        MI_MASKED_FUNCTION(ProfilerPhase::MediumSample, active);
+
+        MediumInteraction3f mei = dr::zeros<MediumInteraction3f>();
+        mei.wi          = -ray.d;
+        mei.sh_frame    = Frame3f(mei.wi);
+        mei.time        = ray.time;
+        mei.wavelengths = ray.wavelengths;
+
+        Mask aabb_its;
+        Float mint, maxt;
+        std::tie(aabb_its, mint, maxt) = intersect_aabb(ray);
+        aabb_its &= (dr::isfinite(mint) || dr::isfinite(maxt));
+        active &= aabb_its;
+        dr::masked(mint, !active) = 0.f;
+        dr::masked(maxt, !active) = dr::Infinity<Float>;
+
+        mint = dr::maximum(0.f, mint);
+        maxt = dr::minimum(ray.maxt, maxt);
+
+        // The majorants are not spectrally varying: any channel will do
+        DRJIT_MARK_USED(channel);
+
+        /* Walk the majorant grid with a 3D DDA, consuming the sampled
+           optical depth cell by cell. Ray distances are preserved by the
+           affine map into grid space. */
+        ScalarVector3i res(m_majorant_res);
+        Point3f o  = m_to_grid * ray.o;
+        Vector3f d = m_to_grid * ray.d;
+
+        Vector3i cell = dr::clip(dr::floor2int<Vector3i>(dr::fmadd(d, mint, o)),
+                                 0, res - 1);
+        Vector3i step = dr::select(d >= 0.f, Vector3i(1), Vector3i(-1));
+        Vector3f d_rcp = dr::rcp(d),
+                 t_delta = dr::select(d == 0.f, dr::Infinity<Float>,
+                                      dr::abs(d_rcp)),
+                 t_next = dr::select(
+                     d == 0.f, dr::Infinity<Float>,
+                     (Vector3f(cell + dr::select(d >= 0.f, Vector3i(1),
+                                                  Vector3i(0))) - o) * d_rcp);
+
+        Float tau = -dr::log(1.f - sample),
+              tau_left = tau,
+              t = mint,
+              sampled_t = dr::Infinity<Float>,
+              majorant = 0.f;
+        Mask active_dda = active && (mint < maxt);
+
+        std::tie(cell, t_next, t, tau_left, sampled_t, majorant, active_dda) =
+            dr::while_loop(
+                std::make_tuple(cell, t_next, t, tau_left, sampled_t,
+                                majorant, active_dda),
+            [](const Vector3i &, const Vector3f &, const Float &,
+               const Float &, const Float &, const Float &,
+               const Mask &active_dda) { return active_dda; },
+            [this, res, step, t_delta, maxt](
+                Vector3i &cell, Vector3f &t_next, Float &t, Float &tau_left,
+                Float &sampled_t, Float &majorant, Mask &active_dda) {
+                Float t_exit = dr::clip(dr::min(t_next), t, maxt),
+                      m = lookup_majorant(cell, active_dda),
+                      tau_cell = m * (t_exit - t);
+
+                // Does the collision happen within the current cell?
+                Mask hit = active_dda && (m > 0.f) && (tau_left <= tau_cell);
+                dr::masked(sampled_t, hit) = t + tau_left / m;
+                dr::masked(majorant, hit) = m;
+                dr::masked(tau_left, active_dda && !hit) = tau_left - tau_cell;
+                active_dda &= !hit && (t_exit < maxt);
+
+                // Advance to the neighboring cell through the closest face
+                Mask step_x = t_next.x() <= dr::minimum(t_next.y(), t_next.z()),
+                     step_y = !step_x && t_next.y() <= t_next.z(),
+                     step_z = !step_x && !step_y;
+                Mask step_mask[3] = { active_dda && step_x,
+                                      active_dda && step_y,
+                                      active_dda && step_z };
+                dr::masked(t, active_dda) = t_exit;
+                for (size_t i = 0; i < 3; ++i) {
+                    dr::masked(cell[i], step_mask[i]) += step[i];
+                    dr::masked(t_next[i], step_mask[i]) += t_delta[i];
+                }
+                active_dda &= dr::all(cell >= 0 && cell < res);
+            },
+            "Heterogeneous medium DDA");
+
+        Mask valid_mi = active && (sampled_t <= maxt);
+        mei.t      = dr::select(valid_mi, sampled_t, dr::Infinity<Float>);
+        mei.p      = ray(sampled_t);
+        mei.medium = this;
+
+        /* Integrators evaluate exp(-(t - mint) * combined_extinction). After
+           a collision, shift 'mint' so that this reproduces the sampled
+           optical depth. Otherwise, report the mean majorant along the
+           traversed segment, which keeps the exponent bounded. */
+        Float tau_path = tau - tau_left;
+        mei.mint = dr::select(valid_mi, sampled_t - tau / majorant, mint);
+        dr::masked(majorant, !valid_mi) =
+            dr::select(maxt > mint, tau_path / (maxt - mint), 0.f);
+
+        std::tie(mei.sigma_s, std::ignore, mei.sigma_t) =
+            get_scattering_coefficients(mei, valid_mi);
+        mei.combined_extinction = majorant;
+
+        /* Use the majorant of the cell in which the collision was sampled. A
+           new lookup at mei.p may return a neighboring cell at a boundary,
+           which would bias the null-collision weight */
+        mei.sigma_n = dr::select(valid_mi, majorant - mei.sigma_t, 0.f);
+        return mei;
     }
 
     std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
@@ -191,7 +345,7 @@ public:
             sigmat *= m_phase_function->projected_area(mi, active);
 
         auto sigmas = sigmat * m_albedo->eval(mi, active);
-        auto sigman = m_max_density - sigmat;
+        auto sigman = get_majorant(mi, active) - sigmat;
         return { sigmas, sigman, sigmat };
     }
 
@@ -205,18 +359,62 @@ public:
         oss << "HeterogeneousMedium[" << std::endl
             << "  albedo  = " << string::indent(m_albedo) << std::endl
             << "  sigma_t = " << string::indent(m_sigmat) << std::endl
-            << "  scale   = " << string::indent(m_scale) << std::endl
+            << "  scale   = " << string::indent(m_scale) << "," << std::endl
+            << "  majorant_grid = " << m_majorant_res << std::endl
             << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS(HeterogeneousMedium)
+private:
+    /// Fetch the majorant of a cell of the majorant grid
+    MI_INLINE Float lookup_majorant(const Vector3i &cell, Mask active) const {
+        ScalarVector3i res(m_majorant_res);
+        UInt32 index = UInt32((cell.z() * res.y() + cell.y()) * res.x() +
+                              cell.x());
+        return dr::gather<Float>(m_majorant_grid, index, active);
+    }
+
+    /// (Re-)build the grid of local majorants from the extinction volume
+    void update_majorant_grid() {
+        m_majorant_res = ScalarVector3u(0);
+        m_majorant_grid = FloatStorage();
+        if (m_majorant_factor == 0)
+            return;
+
+        ScalarVector3u res =
+            (ScalarVector3u(m_sigmat->resolution()) + m_majorant_factor - 1) /
+            m_majorant_factor;
+        size_t size = dr::prod(res);
+        if (size == 1)
+            return; // Nothing to gain over the global majorant
+
+        std::unique_ptr<ScalarFloat[]> values(new ScalarFloat[size]);
+        m_sigmat->max_grid(res, values.get());
+        for (size_t i = 0; i < size; ++i)
+            values[i] *= m_scale;
+
+        m_majorant_grid = dr::load<FloatStorage>(values.get(), size);
+        m_majorant_res = res;
+        m_to_grid = ScalarAffineTransform4f::scale(ScalarVector3f(res)) *
+                    m_sigmat->to_local();
+
+        Log(Debug, "Built a majorant grid of resolution %s.", res);
+    }
+
 private:
     ref<Volume> m_sigmat, m_albedo;
     ScalarFloat m_scale;
     Float m_max_density;
 
-    MI_TRAVERSE_CB(Base, m_sigmat, m_albedo, m_max_density)
+    /// Local majorants over a coarse grid (empty if disabled)
+    FloatStorage m_majorant_grid;
+    ScalarVector3u m_majorant_res = ScalarVector3u(0);
+    /// Transformation from world space into majorant grid cells
+    ScalarAffineTransform4f m_to_grid;
+    ScalarUInt32 m_majorant_factor;
+
+    MI_TRAVERSE_CB(Base, m_sigmat, m_albedo, m_max_density, m_majorant_grid)
 };
 
 MI_EXPORT_PLUGIN(HeterogeneousMedium)
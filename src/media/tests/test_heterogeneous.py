@@ -0,0 +1,65 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import numpy as np
+
+
+def sparse_medium(majorant_resolution_factor):
+    # A thin haze containing a single dense voxel, as found in smoke and clouds
+    data = np.full((32, 32, 32, 1), 0.1, dtype=np.float32)
+    data[20, 9, 14] = 200.0
+    return mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'gridvolume',
+            'grid': mi.VolumeGrid(mi.TensorXf(data))
+        },
+        'majorant_resolution_factor': majorant_resolution_factor
+    })
+
+
+def ratio_tracking(medium, n):
+    """Estimate the transmittance along axis-aligned rays through the medium,
+    returning the estimates and the number of null collisions per ray"""
+    rng = mi.PCG32(size=n)
+    ray = mi.Ray3f(o=mi.Point3f(rng.next_float32(), rng.next_float32(), -1),
+                   d=mi.Vector3f(0, 0, 1))
+
+    active = mi.Bool(True)
+    tr = mi.Float(1)
+    collisions = mi.UInt32(0)
+    while dr.any(active):
+        mei = medium.sample_interaction(ray, rng.next_float32(),
+                                        mi.UInt32(0), active)
+        active &= mei.is_valid()
+        tr[active] *= mei.sigma_n[0] / mei.combined_extinction[0]
+        collisions[active] += 1
+        ray.o = dr.select(active, mei.p, ray.o)
+
+    return np.array(tr), np.array(collisions)
+
+
+def test01_majorant_grid(variants_vec_backends_once_rgb):
+    """Distance sampling on the majorant grid is unbiased and skips most of
+    the null collisions caused by the dense voxel"""
+    n = 1 << 16
+    tr_global, collisions_global = ratio_tracking(sparse_medium(0), n)
+    tr_grid, collisions_grid = ratio_tracking(sparse_medium(8), n)
+
+    assert np.all(tr_grid >= 0) and np.all(tr_grid <= 1)
+    assert abs(tr_grid.mean() - tr_global.mean()) < 5e-3
+    assert collisions_grid.mean() * 10 < collisions_global.mean()
+
+
+def test02_majorant_grid_lookup(variants_vec_backends_once_rgb):
+    """Local majorants bound the extinction and drop far from the dense voxel"""
+    medium = sparse_medium(8)
+
+    mei = dr.zeros(mi.MediumInteraction3f, 3)
+    mei.p = mi.Point3f([0.45, 0.05, 0.95], [0.3, 0.05, 0.95], [0.64, 0.05, 0.95])
+    majorant = medium.get_majorant(mei)[0]
+    sigma_s, sigma_n, sigma_t = medium.get_scattering_coefficients(mei)
+
+    assert dr.allclose(majorant, [200, 0.1, 0.1])
+    assert dr.all(sigma_n[0] >= 0)
+    assert dr.allclose(sigma_n + sigma_t, majorant)
@@ -0,0 +1,838 @@
+#include <mitsuba/mitsuba.h>
+#include <mitsuba/core/argparser.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/parser.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/texcache.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/scene.h>
+#include <mitsuba/render/sensor.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#endif
+
+using namespace mitsuba;
+
+/// Initialize the JIT backend a variant requires; return whether it is
+/// available. Scalar variants need no backend and always succeed.
+static bool init_variant_backend(std::string_view variant) {
+    if (string::starts_with(variant, "scalar_"))
+        return true;
+
+#if defined(MI_ENABLE_CUDA)
+    if (string::starts_with(variant, "cuda_")) {
+        jit_init(1u << (uint32_t) JitBackend::CUDA);
+        return jit_has_backend(JitBackend::CUDA);
+    }
+#endif
+
+#if defined(MI_ENABLE_LLVM)
+    if (string::starts_with(variant, "llvm_")) {
+        jit_init(1u << (uint32_t) JitBackend::LLVM);
+        return jit_has_backend(JitBackend::LLVM);
+    }
+#endif
+
+#if defined(MI_ENABLE_METAL)
+    if (string::starts_with(variant, "metal_")) {
+        jit_init(1u << (uint32_t) JitBackend::Metal);
+        return jit_has_backend(JitBackend::Metal);
+    }
+#endif
+
+    return false;
+}
+
+// =======================================================================
+//! @{ \name Canonical benchmark scenes
+// =======================================================================
+
+/* The scenes are assembled from assets in 'resources/data'. They share a
+   sensor and a ground plane, and the "$spp" and "$res" parameters set the
+   sample count and film resolution. */
+
+static std::string scene_begin(const std::string &floor_bsdf) {
+    return R"(<scene version="3.0.0">
+    <sensor type="perspective">
+        <float name="fov" value="45"/>
+        <transform name="to_world">
+            <lookat origin="0, 5, 10" target="0, 0, 0" up="0, 1, 0"/>
+        </transform>
+        <sampler type="independent">
+            <integer name="sample_count" value="$spp"/>
+        </sampler>
+        <film type="hdrfilm">
+            <integer name="width" value="$res"/>
+            <integer name="height" value="$res"/>
+        </film>
+    </sensor>
+
+    <shape type="rectangle">
+        <transform name="to_world">
+            <rotate x="1" angle="-90"/>
+            <scale value="8"/>
+        </transform>
+        )" + floor_bsdf + R"(
+    </shape>
+)";
+}
+
+static const char *scene_end = "</scene>\n";
+
+/// Grid of separate triangle meshes
+static std::string scene_triangles() {
+    std::ostringstream oss;
+    oss << scene_begin(R"(<bsdf type="diffuse"/>)");
+    for (int i = 0; i < 16; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            oss << R"(
+    <shape type="obj">
+        <string name="filename" value="common/meshes/sphere.obj"/>
+        <transform name="to_world">
+            <scale value="0.2"/>
+            <translate x=")" << -3.75f + .5f * i << R"(" y="0.2" z=")"
+                << -3.75f + .5f * j << R"("/>
+        </transform>
+        <bsdf type="roughplastic"/>
+    </shape>)";
+        }
+    }
+    oss << R"(
+    <emitter type="constant">
+        <rgb name="radiance" value="0.5"/>
+    </emitter>
+    <emitter type="directional">
+        <vector name="direction" value="1, -2, -1"/>
+        <rgb name="irradiance" value="2"/>
+    </emitter>
+)" << scene_end;
+    return oss.str();
+}
+
+/// Hundreds of small area lights and a few point lights
+static std::string scene_lights() {
+    std::ostringstream oss;
+    oss << scene_begin(R"(<bsdf type="diffuse"/>)");
+    for (int i = 0; i < 3; ++i) {
+        oss << R"(
+    <shape type="sphere">
+        <point name="center" x=")" << 2.5f * (i - 1) << R"(" y="1" z="0"/>
+        <float name="radius" value="1"/>
+        <bsdf type="roughconductor"/>
+    </shape>)";
+    }
+    for (int i = 0; i < 16; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            oss << R"(
+    <shape type="sphere">
+        <point name="center" x=")" << -3.75f + .5f * i << R"(" y="2.5" z=")"
+                << -3.75f + .5f * j << R"("/>
+        <float name="radius" value="0.05"/>
+        <emitter type="area">
+            <rgb name="radiance" value=")" << 1 + (i % 4) << ", "
+                << 1 + (j % 4) << ", " << 1 + ((i + j) % 4) << R"("/>
+        </emitter>
+    </shape>)";
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        oss << R"(
+    <emitter type="point">
+        <point name="position" x=")" << (i % 2 ? 3 : -3) << R"(" y="4" z=")"
+            << (i / 2 ? 3 : -3) << R"("/>
+        <rgb name="intensity" value="5"/>
+    </emitter>)";
+    }
+    oss << "\n" << scene_end;
+    return oss.str();
+}
+
+/// Heterogeneous participating medium inside a cube
+static std::string scene_volume() {
+    return scene_begin(R"(<bsdf type="diffuse"/>)") + R"(
+    <medium type="heterogeneous" id="medium">
+        <volume type="gridvolume" name="albedo">
+            <string name="filename" value="tests/scenes/participating_media/textures/albedo.vol"/>
+            <transform name="to_world">
+                <scale value="3"/>
+                <translate x="-1.5" y="0" z="-1.5"/>
+            </transform>
+        </volume>
+        <float name="sigma_t" value="2"/>
+    </medium>
+
+    <shape type="cube">
+        <transform name="to_world">
+            <scale value="1.5"/>
+            <translate y="1.5"/>
+        </transform>
+        <bsdf type="null"/>
+        <ref name="interior" id="medium"/>
+    </shape>
+
+    <emitter type="constant">
+        <rgb name="radiance" value="0.5"/>
+    </emitter>
+    <emitter type="point">
+        <point name="position" x="3" y="5" z="3"/>
+        <rgb name="intensity" value="20"/>
+    </emitter>
+)" + scene_end;
+}
+
+/// Bitmap textures and an environment map
+static std::string scene_textures() {
+    std::ostringstream oss;
+    oss << scene_begin(R"(<bsdf type="diffuse">
+            <texture type="bitmap" name="reflectance">
+                <string name="filename" value="common/textures/wood.jpg"/>
+                <transform name="to_uv">
+                    <scale value="4"/>
+                </transform>
+            </texture>
+        </bsdf>)");
+    const char *textures[] = { "common/textures/carrot.png",
+                               "common/textures/gradient.jpg",
+                               "common/textures/flower.bmp" };
+    for (int i = 0; i < 3; ++i) {
+        oss << R"(
+    <shape type="sphere">
+        <point name="center" x=")" << 2.5f * (i - 1) << R"(" y="1" z="0"/>
+        <float name="radius" value="1"/>
+        <bsdf type="roughplastic">
+            <texture type="bitmap" name="diffuse_reflectance">
+                <string name="filename" value=")" << textures[i] << R"("/>
+            </texture>
+        </bsdf>
+    </shape>)";
+    }
+    oss << R"(
+    <emitter type="envmap">
+        <string name="filename" value="common/textures/museum.exr"/>
+    </emitter>
+)" << scene_end;
+    return oss.str();
+}
+
+/// Thousands of instances of a shape group
+static std::string scene_instancing() {
+    std::ostringstream oss;
+    oss << scene_begin(R"(<bsdf type="diffuse"/>)") << R"(
+    <shape type="shapegroup" id="group">
+        <shape type="obj">
+            <string name="filename" value="common/meshes/sphere.obj"/>
+            <transform name="to_world">
+                <scale value="0.05"/>
+                <translate y="0.05"/>
+            </transform>
+            <bsdf type="roughplastic"/>
+        </shape>
+        <shape type="cube">
+            <transform name="to_world">
+                <scale value="0.03"/>
+                <translate x="0.07" y="0.03"/>
+            </transform>
+            <bsdf type="diffuse"/>
+        </shape>
+    </shape>
+)";
+    for (int i = 0; i < 48; ++i) {
+        for (int j = 0; j < 48; ++j) {
+            oss << R"(
+    <shape type="instance">
+        <ref id="group"/>
+        <transform name="to_world">
+            <rotate y="1" angle=")" << (i * 48 + j) * 37 % 360 << R"("/>
+            <translate x=")" << -3.76f + .16f * i << R"(" z=")"
+                << -3.76f + .16f * j << R"("/>
+        </transform>
+    </shape>)";
+        }
+    }
+    oss << R"(
+    <emitter type="constant">
+        <rgb name="radiance" value="0.5"/>
+    </emitter>
+    <emitter type="directional">
+        <vector name="direction" value="1, -2, -1"/>
+        <rgb name="irradiance" value="2"/>
+    </emitter>
+)" << scene_end;
+    return oss.str();
+}
+
+struct BenchScene {
+    const char *name;
+    std::string (*xml)();
+};
+
+static const BenchScene bench_scenes[] = {
+    { "triangles",  scene_triangles  },
+    { "lights",     scene_lights     },
+    { "volume",     scene_volume     },
+    { "textures",   scene_textures   },
+    { "instancing", scene_instancing }
+};
+
+//! @}
+// =======================================================================
+
+/// Settings shared by all benchmarks
+struct BenchConfig {
+    uint32_t resolution = 256;
+    uint32_t spp = 16;
+    uint32_t ray_count = 1u << 20;
+    uint32_t repeat = 3;
+    std::vector<std::string> scenes;
+    std::vector<std::string> integrators;
+};
+
+/// Shortest wall time of a throughput measurement (in seconds)
+static constexpr double bench_min_time = 0.1;
+
+/// Monotonic clock with sub-microsecond resolution
+using BenchClock = std::chrono::steady_clock;
+
+/// Return the time elapsed since \c start (in seconds)
+static double elapsed(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+/// Measurements of one scene rendered with one variant
+struct BenchResult {
+    std::string variant, scene;
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+/**
+ * \brief Reset the peak resident set size of the process
+ *
+ * This is only possible on Linux. Elsewhere, \ref peak_rss() reports the
+ * high-water mark since the process started.
+ */
+static void reset_peak_rss() {
+#if defined(__linux__)
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+/// Return the peak resident set size of the process (in bytes)
+static size_t peak_rss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return (size_t) counters.PeakWorkingSetSize;
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (string::starts_with(line, "VmHWM:"))
+            return (size_t) std::stoull(line.substr(6)) * 1024;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#  if defined(__APPLE__)
+    return (size_t) usage.ru_maxrss; // bytes
+#  else
+    return (size_t) usage.ru_maxrss * 1024; // kilobytes
+#  endif
+#endif
+}
+
+template <typename Float, typename Spectrum>
+class SceneBenchmark {
+public:
+    MI_IMPORT_TYPES(Scene, Sensor, Sampler, Integrator)
+
+    /// Rays of a benchmark: a wavefront in JIT variants, an array otherwise
+    using RayBuffer = std::conditional_t<dr::is_jit_v<Float>, Ray3f,
+                                         std::vector<Ray3f>>;
+
+    SceneBenchmark(const std::string &variant, const BenchConfig &config)
+        : m_variant(variant), m_config(config) {
+        Properties props("independent");
+        m_sampler = PluginManager::instance()->create_object<Sampler>(props);
+    }
+
+    BenchResult run(const BenchScene &desc) {
+        BenchResult result;
+        result.variant = m_variant;
+        result.scene = desc.name;
+        auto add = [&](const std::string &name, double value) {
+            result.metrics.emplace_back(name, value);
+        };
+
+        Log(Info, "Benchmarking scene \"%s\" ..", desc.name);
+        reset_peak_rss();
+
+        BenchClock::time_point start = BenchClock::now();
+        parser::ParserConfig config(m_variant);
+        parser::ParserState state = parser::parse_string(
+            config, desc.xml(),
+            { { "spp", std::to_string(m_config.spp) },
+              { "res", std::to_string(m_config.resolution) } });
+        parser::transform_all(config, state);
+        std::vector<ref<Object>> objects = parser::instantiate(config, state);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        add("load_ms", elapsed(start) * 1000.0);
+
+        m_scene = dynamic_cast<Scene *>(objects[0].get());
+        if (!m_scene)
+            Throw("Benchmark scene \"%s\" is not a <scene>!", desc.name);
+        objects.clear();
+        add("accel_ms", (double) m_scene->accel_build_time());
+
+        Sensor *sensor = m_scene->sensors()[0].get();
+        ScalarBoundingBox3f bbox = m_scene->bbox();
+
+        auto primary = [&](Sampler *sampler) {
+            Float sample_wav = sampler->next_1d();
+            Point2f sample_pos = sampler->next_2d(),
+                    sample_aperture = sampler->next_2d();
+            auto [ray, weight] = sensor->sample_ray(0.f, sample_wav, sample_pos,
+                                                    sample_aperture);
+            DRJIT_MARK_USED(weight);
+            return std::make_pair(ray, Mask(true));
+        };
+
+        auto shadow = [&](Sampler *sampler) {
+            auto [ray, active] = primary(sampler);
+            SurfaceInteraction3f si = m_scene->ray_intersect(ray, active);
+            auto [ds, weight] = m_scene->sample_emitter_direction(
+                si, sampler->next_2d(), false, si.is_valid());
+            DRJIT_MARK_USED(weight);
+            return std::make_pair(si.spawn_ray_to(ds.p),
+                                  si.is_valid() && ds.pdf > 0.f);
+        };
+
+        auto incoherent = [&](Sampler *sampler) {
+            Point2f sample_xy = sampler->next_2d();
+            Float sample_z = sampler->next_1d();
+            Point3f o = Point3f(bbox.min) +
+                        Vector3f(bbox.extents()) *
+                            Point3f(sample_xy.x(), sample_xy.y(), sample_z);
+            Vector3f d = warp::square_to_uniform_sphere(sampler->next_2d());
+            return std::make_pair(Ray3f(o, d), Mask(true));
+        };
+
+        add("primary_mrays_per_s",    trace(generate(primary), true, false));
+        add("shadow_mrays_per_s",     trace(generate(shadow), false, true));
+        add("incoherent_mrays_per_s", trace(generate(incoherent), false, false));
+
+        for (const std::string &name : m_config.integrators)
+            add(name + "_msamples_per_s", render(name));
+
+        add("peak_rss_mib", (double) peak_rss() / (1024.0 * 1024.0));
+        m_scene = nullptr;
+
+        return result;
+    }
+
+protected:
+    /// Generate rays using \c func, dropping those that it marks inactive
+    template <typename Func> RayBuffer generate(Func func) {
+        uint32_t count = m_config.ray_count;
+        if constexpr (dr::is_jit_v<Float>) {
+            m_sampler->seed(0, count);
+            auto [ray, active] = func(m_sampler.get());
+            // Broadcast masks that are uniformly true
+            active &= dr::full<Mask>(true, count);
+            Ray3f result = dr::gather<Ray3f>(ray, dr::compress(active));
+            dr::eval(result);
+            dr::sync_thread();
+            return result;
+        } else {
+            m_sampler->seed(0);
+            std::vector<Ray3f> result;
+            result.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                auto [ray, active] = func(m_sampler.get());
+                if (active)
+                    result.push_back(ray);
+            }
+            return result;
+        }
+    }
+
+    /// Return the best throughput (in Mrays/s) of tracing \c rays
+    double trace(const RayBuffer &rays, bool coherent, bool shadow) {
+        size_t count = 0;
+        if constexpr (dr::is_jit_v<Float>)
+            count = dr::width(rays);
+        else
+            count = rays.size();
+        if (count == 0)
+            return 0.0;
+
+        auto trace_once = [&]() {
+            if constexpr (dr::is_jit_v<Float>) {
+                if (shadow)
+                    dr::eval(m_scene->ray_test(rays, coherent, true));
+                else
+                    dr::eval(m_scene->ray_intersect_preliminary(rays, coherent).t);
+                dr::sync_thread();
+            } else {
+                dr::parallel_for(
+                    dr::blocked_range<size_t>(0, count, 1024),
+                    [&](const dr::blocked_range<size_t> &range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            if (shadow)
+                                m_scene->ray_test(rays[i]);
+                            else
+                                m_scene->ray_intersect_preliminary(rays[i],
+                                                                   coherent);
+                        }
+                    });
+            }
+        };
+
+        return best_rate(count, trace_once);
+    }
+
+    /// Return the best throughput (in Msamples/s) of the given integrator
+    double render(const std::string &name) {
+        ref<Integrator> integrator =
+            PluginManager::instance()->create_object<Integrator>(Properties(name));
+        Sensor *sensor = m_scene->sensors()[0].get();
+        size_t count = (size_t) dr::prod(sensor->film()->crop_size()) *
+                       sensor->sampler()->sample_count();
+
+        uint32_t seed = 0;
+        auto render_once = [&]() {
+            integrator->render(m_scene.get(), sensor, seed++, 0,
+                               false /* develop */, true /* evaluate */);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+        };
+
+        return best_rate(count, render_once);
+    }
+
+    /**
+     * \brief Return the highest throughput (in millions of items per second)
+     * of \c func, which processes \c count items per call
+     *
+     * Each of the \c repeat measurements calls \c func until at least
+     * \ref bench_min_time seconds have passed, so that short runs are not
+     * dominated by timer resolution and jitter. JIT variants first run
+     * \c func once without timing it, so that kernel compilation is excluded.
+     */
+    template <typename Func> double best_rate(size_t count, Func func) {
+        if constexpr (dr::is_jit_v<Float>)
+            func();
+
+        double best = 0.0;
+        for (uint32_t i = 0; i < m_config.repeat; ++i) {
+            BenchClock::time_point start = BenchClock::now();
+            size_t calls = 0;
+            double time;
+            do {
+                func();
+                calls++;
+                time = elapsed(start);
+            } while (time < bench_min_time);
+            best = std::max(best, (double) (count * calls) / time * 1e-6);
+        }
+        return best;
+    }
+
+private:
+    std::string m_variant;
+    const BenchConfig &m_config;
+    ref<Sampler> m_sampler;
+    ref<Scene> m_scene;
+};
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_initialization() {
+    Scene<Float, Spectrum>::static_accel_initialization();
+}
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_shutdown() {
+    Scene<Float, Spectrum>::static_accel_shutdown();
+}
+
+template <typename Float, typename Spectrum>
+void bench_variant(const std::string &variant, const BenchConfig &config,
+                   std::vector<BenchResult> &results) {
+    SceneBenchmark<Float, Spectrum> bench(variant, config);
+    for (const BenchScene &desc : bench_scenes) {
+        if (!config.scenes.empty() &&
+            std::find(config.scenes.begin(), config.scenes.end(), desc.name) ==
+                config.scenes.end())
+            continue;
+        results.push_back(bench.run(desc));
+    }
+}
+
+/// Serialize the benchmark results (one record per variant and scene)
+static std::string to_json(const BenchConfig &config,
+                           const std::vector<BenchResult> &results) {
+    std::ostringstream oss;
+    oss << "{\n"
+        << "  \"version\": \"" << MI_VERSION << "\",\n"
+        << "  \"threads\": " << pool_size() + 1 << ",\n"
+        << "  \"resolution\": " << config.resolution << ",\n"
+        << "  \"spp\": " << config.spp << ",\n"
+        << "  \"ray_count\": " << config.ray_count << ",\n"
+        << "  \"repeat\": " << config.repeat << ",\n"
+        << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        oss << (i > 0 ? "," : "") << "\n    {\n"
+            << "      \"variant\": \"" << r.variant << "\",\n"
+            << "      \"scene\": \"" << r.scene << "\"";
+        for (const auto &[name, value] : r.metrics)
+            oss << ",\n      \"" << name << "\": " << value;
+        oss << "\n    }";
+    }
+    oss << "\n  ]\n}\n";
+    return oss.str();
+}
+
+static void help(int thread_count) {
+    std::cout << util::info_build(thread_count) << std::endl;
+    std::cout << util::info_copyright() << std::endl;
+    std::cout << R"(
+Usage: mitsuba-bench [options]
+
+Renders a set of canonical scenes assembled from 'resources/data' and
+reports, for every variant and scene: the load time and acceleration data
+structure build time (in milliseconds), the throughput of primary, shadow,
+and incoherent rays (in millions of rays per second), the throughput of each
+integrator (in millions of samples per second), and the peak resident set
+size (in MiB). The results are written as JSON, which can be compared with
+a stored baseline using 'resources/bench_compare.py'.
+
+Options:
+
+    -h, --help
+        Display this help text.
+
+    -m <variant>, --mode <variant>
+        Benchmark the given variant (can be specified multiple times).
+        Default: all variants whose backend is available at runtime.
+
+        Available:
+              )" << string::indent(MI_VARIANTS, 14) << R"(
+    -s <name1>,<name2>,.., --scenes <name1>,<name2>,..
+        Only benchmark the given scenes. Available: triangles, lights,
+        volume, textures, instancing.
+
+    -i <name1>,<name2>,.., --integrators <name1>,<name2>,..
+        Integrators to measure (default: direct,path,volpath).
+
+    -o <filename>, --output <filename>
+        Write the JSON results to "filename" instead of the console.
+
+    -a <path1>;<path2>;..
+        Add one or more entries to the resource search path. Default: the
+        'resources/data' directory of the source tree.
+
+    -t <count>, --threads <count>
+        Use the specified number of threads.
+
+    -r <count>, --resolution <count>
+        Film width and height (default: 256).
+
+    -p <count>, --spp <count>
+        Samples per pixel of the rendering benchmarks (default: 16).
+
+    -n <count>, --rays <count>
+        Number of rays per ray tracing benchmark (default: 1048576).
+
+    -R <count>, --repeat <count>
+        Repeat each measurement and report the best (default: 3). Every
+        throughput measurement runs for at least 100 ms.
+
+    -v, --verbose
+        Be more verbose. (can be specified multiple times)
+
+)";
+}
+
+int main(int argc, char *argv[]) {
+    Thread::static_initialization();
+    Logger::static_initialization();
+    Bitmap::static_initialization();
+    TextureCache::static_initialization();
+
+    ArgParser parser;
+    using StringVec     = std::vector<std::string>;
+    auto arg_help        = parser.add(StringVec{ "-h", "--help" });
+    auto arg_mode        = parser.add(StringVec{ "-m", "--mode" }, true);
+    auto arg_scenes      = parser.add(StringVec{ "-s", "--scenes" }, true);
+    auto arg_integrators = parser.add(StringVec{ "-i", "--integrators" }, true);
+    auto arg_output      = parser.add(StringVec{ "-o", "--output" }, true);
+    auto arg_paths       = parser.add(StringVec{ "-a" }, true);
+    auto arg_threads     = parser.add(StringVec{ "-t", "--threads" }, true);
+    auto arg_resolution  = parser.add(StringVec{ "-r", "--resolution" }, true);
+    auto arg_spp         = parser.add(StringVec{ "-p", "--spp" }, true);
+    auto arg_rays        = parser.add(StringVec{ "-n", "--rays" }, true);
+    auto arg_repeat      = parser.add(StringVec{ "-R", "--repeat" }, true);
+    auto arg_verbose     = parser.add(StringVec{ "-v", "--verbose" }, false);
+
+    std::vector<std::string> variants;
+    std::string error_msg;
+    bool cuda = false, llvm = false, metal = false, initialized = false;
+
+    try {
+        parser.parse(argc, argv);
+
+        // Results may be written to the console, keep it free of log messages
+        // unless they are requested
+        int log_level = 0;
+        auto arg = arg_verbose;
+        while (arg && *arg) {
+            log_level++;
+            arg = arg->next();
+        }
+        mitsuba::LogLevel log_level_mitsuba[] = { Warn, Info, Debug, Trace };
+        Thread::thread()->logger()->set_log_level(
+            log_level_mitsuba[std::min(log_level, 3)]);
+
+        if (*arg_help) {
+            help(pool_size() + 1);
+        } else {
+            if (*arg_threads) {
+                int thread_count = arg_threads->as_int();
+                if (thread_count < 1)
+                    Throw("The thread count must be at least 1!");
+                pool_set_size(nullptr, thread_count - 1);
+            }
+
+            BenchConfig config;
+            if (*arg_resolution)
+                config.resolution = (uint32_t) arg_resolution->as_int();
+            if (*arg_spp)
+                config.spp = (uint32_t) arg_spp->as_int();
+            if (*arg_rays)
+                config.ray_count = (uint32_t) arg_rays->as_int();
+            if (*arg_repeat)
+                config.repeat = (uint32_t) arg_repeat->as_int();
+            if (config.resolution == 0 || config.spp == 0 ||
+                config.ray_count == 0 || config.repeat == 0)
+                Throw("Benchmark settings must be positive!");
+
+            if (*arg_scenes)
+                config.scenes = string::tokenize(arg_scenes->as_string(), ",");
+            for (const std::string &name : config.scenes) {
+                bool found = false;
+                for (const BenchScene &desc : bench_scenes)
+                    found |= name == desc.name;
+                if (!found)
+                    Throw("Unknown benchmark scene \"%s\"!", name);
+            }
+
+            config.integrators = string::tokenize(
+                *arg_integrators ? arg_integrators->as_string()
+                                 : std::string("direct,path,volpath"), ",");
+
+            while (arg_mode && *arg_mode) {
+                std::string variant = arg_mode->as_string();
+                if (!init_variant_backend(variant))
+                    Throw("The backend of variant \"%s\" is not available!", variant);
+                variants.push_back(variant);
+                arg_mode = arg_mode->next();
+            }
+            if (variants.empty()) {
+                for (const std::string &v : string::tokenize(MI_VARIANTS, "\n")) {
+                    if (init_variant_backend(v))
+                        variants.push_back(v);
+                }
+            }
+
+            for (const std::string &v : variants) {
+                cuda  |= string::starts_with(v, "cuda_");
+                llvm  |= string::starts_with(v, "llvm_");
+                metal |= string::starts_with(v, "metal_");
+            }
+
+            Profiler::static_initialization();
+            color_management_static_initialization(cuda, llvm, metal);
+            initialized = true;
+
+            // Resolve the scene assets relative to 'resources/data'
+            ref<FileResolver> fr = file_resolver();
+            fs::path base_path = util::library_path().parent_path();
+            if (!fr->contains(base_path))
+                fr->append(base_path);
+            if (*arg_paths) {
+                for (auto &path : string::tokenize(arg_paths->as_string(), ";")) {
+                    if (!fr->contains(path))
+                        fr->append(path);
+                }
+            } else {
+                fr->append(MI_BENCH_DATA_DIR);
+            }
+
+            Log(Info, "%s", util::info_build(pool_size() + 1));
+
+            std::vector<BenchResult> results;
+            for (const std::string &variant : variants) {
+                Log(Info, "Benchmarking the \"%s\" variant ..", variant);
+                MI_INVOKE_VARIANT(variant, scene_static_accel_initialization);
+                MI_INVOKE_VARIANT(variant, bench_variant, variant, config, results);
+                MI_INVOKE_VARIANT(variant, scene_static_accel_shutdown);
+            }
+
+            std::string json = to_json(config, results);
+            if (*arg_output) {
+                std::ofstream os(arg_output->as_string());
+                if (!os.good())
+                    Throw("Could not write \"%s\"!", arg_output->as_string());
+                os << json;
+            } else {
+                std::cout << json;
+            }
+        }
+    } catch (const std::exception &e) {
+        error_msg = std::string("Caught a critical exception: ") + e.what();
+    } catch (...) {
+        error_msg = std::string("Caught a critical exception of unknown type!");
+    }
+
+    if (!error_msg.empty())
+        std::cerr << std::endl << error_msg << std::endl;
+
+    if (initialized) {
+        color_management_static_shutdown();
+        Profiler::static_shutdown();
+    }
+    TextureCache::static_shutdown();
+    Bitmap::static_shutdown();
+    struct_jit::clear_cache();
+    Logger::static_shutdown();
+    Thread::static_shutdown();
+
+#if defined(MI_ENABLE_CUDA) || defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_METAL)
+    if (cuda || llvm || metal)
+        jit_shutdown();
+#endif
+
+    return error_msg.empty() ? 0 : -1;
+}
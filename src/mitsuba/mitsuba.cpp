@@ -5,6 +5,7 @@
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/texcache.h>
 #include <mitsuba/core/thread.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
@@ -93,6 +94,20 @@ Options:
     -o <filename>, --output <filename>
         Write the output image to the file "filename".
 
+    -P, --profile
+        Sample the phases (ray tracing, BSDF evaluation, etc.) that the
+        rendering threads are in and print the time spent per phase after
+        each scene. This is only meaningful in scalar variants.
+
+    -T <MiB>, --texture-cache <MiB>
+        Memory budget of the cache that holds the tiles of textures loaded
+        with 'cache=true' (default: 2048). Cache statistics are printed
+        after each scene when this flag or '-v' is given.
+
+    -G, --dedup-geometry
+        Load meshes from identical files only once and replace the shapes
+        that use them by instances of a shared shape group.
+
  === The following options are only relevant for JIT (CUDA/LLVM) modes ===
 
     -O [0-5]
@@ -150,7 +165,9 @@ void render(Object *scene_, size_t sensor_i, fs::path filename) {
     if (!integrator)
         Throw("No integrator specified for scene: %s", scene);
 
-    develop_callback_fn = [film]() { film->develop(); };
+    // Streaming films have no image in memory, their rows are already on disk
+    if (!has_flag(film->flags(), FilmFlags::Streaming))
+        develop_callback_fn = [film]() { film->develop(); };
 
     integrator->render(scene, (uint32_t) sensor_i,
                        0 /* seed */,
@@ -176,6 +193,7 @@ int main(int argc, char *argv[]) {
     Thread::static_initialization();
     Logger::static_initialization();
     Bitmap::static_initialization();
+    TextureCache::static_initialization();
 
     ArgParser parser;
     using StringVec    = std::vector<std::string>;
@@ -186,7 +204,10 @@ int main(int argc, char *argv[]) {
     auto arg_output    = parser.add(StringVec{ "-o", "--output" }, true);
     auto arg_help      = parser.add(StringVec{ "-h", "--help" });
     auto arg_mode      = parser.add(StringVec{ "-m", "--mode" }, true);
+    auto arg_profile   = parser.add(StringVec{ "-P", "--profile" });
     auto arg_paths     = parser.add(StringVec{ "-a" }, true);
+    auto arg_tex_cache = parser.add(StringVec{ "-T", "--texture-cache" }, true);
+    auto arg_dedup     = parser.add(StringVec{ "-G", "--dedup-geometry" });
     auto arg_extra     = parser.add("", true);
 
     // Specialized flags for the JIT compiler
@@ -257,6 +278,13 @@ int main(int argc, char *argv[]) {
         }
         pool_set_size(nullptr, thread_count - 1);
 
+        if (*arg_tex_cache) {
+            int budget = arg_tex_cache->as_int();
+            if (budget < 1)
+                Throw("The texture cache budget must be at least 1 MiB!");
+            TextureCache::set_budget(size_t(budget) << 20);
+        }
+
         while (arg_define && *arg_define) {
             std::string value = arg_define->as_string();
             auto sep = value.find('=');
@@ -328,6 +356,10 @@ int main(int argc, char *argv[]) {
             (*arg_optim_lev || *arg_wavefront || *arg_source || *arg_vec_width))
             Throw("Specified an argument that only makes sense in a JIT (LLVM/CUDA/Metal) mode!");
 
+        if (*arg_profile && jit)
+            Log(Warn, "The profiler only records the phases of rendering in "
+                      "scalar variants, JIT variants merely trace them!");
+
         Profiler::static_initialization();
         color_management_static_initialization(cuda, llvm, metal);
 
@@ -365,6 +397,7 @@ int main(int argc, char *argv[]) {
         }
 
         parser::ParserConfig config(mode);
+        config.dedup_geometry = (bool) *arg_dedup;
 
         while (arg_extra && *arg_extra) {
             fs::path filename(arg_extra->as_string());
@@ -379,6 +412,9 @@ int main(int argc, char *argv[]) {
             if (*arg_output)
                 filename = fs::path(arg_output->as_string());
 
+            if (*arg_profile)
+                Profiler::start();
+
             // Parse the XML file
             parser::ParserState state = parser::parse_file(
                 config, arg_extra->as_string(), params);
@@ -395,6 +431,18 @@ int main(int argc, char *argv[]) {
                       "multiple objects, only a single object is expected!");
 
             MI_INVOKE_VARIANT(mode, render, objects[0].get(), sensor_i, filename);
+
+            if (*arg_profile) {
+                Profiler::stop();
+                Profiler::print_report();
+            }
+
+            TextureCache::Statistics tc_stats = TextureCache::statistics();
+            if (tc_stats.hits + tc_stats.misses > 0) {
+                Log(*arg_tex_cache ? Info : Debug, "Texture cache: %s",
+                    tc_stats.to_string());
+                TextureCache::reset_statistics();
+            }
             arg_extra = arg_extra->next();
         }
     } catch (const std::exception &e) {
@@ -423,6 +471,7 @@ int main(int argc, char *argv[]) {
     MI_INVOKE_VARIANT(mode, scene_static_accel_shutdown);
     color_management_static_shutdown();
     Profiler::static_shutdown();
+    TextureCache::static_shutdown();
     Bitmap::static_shutdown();
     struct_jit::clear_cache();
     Logger::static_shutdown();
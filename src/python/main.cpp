@@ -3,6 +3,7 @@
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/texcache.h>
 #include <mitsuba/python/python.h>
 
 
@@ -14,6 +15,7 @@ MI_PY_DECLARE(Struct);
 MI_PY_DECLARE(Appender);
 MI_PY_DECLARE(ArgParser);
 MI_PY_DECLARE(Bitmap);
+MI_PY_DECLARE(BitmapStreamWriter);
 MI_PY_DECLARE(Formatter);
 MI_PY_DECLARE(FileResolver);
 MI_PY_DECLARE(Logger);
@@ -25,6 +27,7 @@ MI_PY_DECLARE(MemoryStream);
 MI_PY_DECLARE(ZStream);
 MI_PY_DECLARE(ProgressReporter);
 MI_PY_DECLARE(rfilter);
+MI_PY_DECLARE(TextureCache);
 MI_PY_DECLARE(Thread);
 MI_PY_DECLARE(Timer);
 MI_PY_DECLARE(Properties);
@@ -38,6 +41,7 @@ MI_PY_DECLARE(RayFlags);
 MI_PY_DECLARE(MicrofacetType);
 MI_PY_DECLARE(PhaseFunctionExtras);
 MI_PY_DECLARE(Spiral);
+MI_PY_DECLARE(KDTreeBuildReport);
 MI_PY_DECLARE(Sensor);
 MI_PY_DECLARE(VolumeGrid);
 MI_PY_DECLARE(FilmFlags);
@@ -119,6 +123,7 @@ NB_MODULE(mitsuba_ext, m) {
     Thread::static_initialization();
     Logger::static_initialization();
     Bitmap::static_initialization();
+    TextureCache::static_initialization();
     Profiler::static_initialization();
 
 #if defined(NDEBUG)
@@ -142,6 +147,7 @@ NB_MODULE(mitsuba_ext, m) {
     MI_PY_IMPORT(rfilter);
     MI_PY_IMPORT(Stream);
     MI_PY_IMPORT(Bitmap);
+    MI_PY_IMPORT(BitmapStreamWriter);
     MI_PY_IMPORT(Formatter);
     MI_PY_IMPORT(FileResolver);
     MI_PY_IMPORT(Logger);
@@ -153,6 +159,7 @@ NB_MODULE(mitsuba_ext, m) {
     MI_PY_IMPORT(ProgressReporter);
     MI_PY_IMPORT(Thread);
     MI_PY_IMPORT(Timer);
+    MI_PY_IMPORT(TextureCache);
     MI_PY_IMPORT(Properties);
     MI_PY_IMPORT(parser);
     MI_PY_IMPORT(misc);
@@ -163,6 +170,7 @@ NB_MODULE(mitsuba_ext, m) {
     MI_PY_IMPORT(MicrofacetType);
     MI_PY_IMPORT(PhaseFunctionExtras);
     MI_PY_IMPORT(Spiral);
+    MI_PY_IMPORT(KDTreeBuildReport);
     MI_PY_IMPORT(Sensor);
     MI_PY_IMPORT(FilmFlags);
     MI_PY_IMPORT(DiscontinuityFlags);
@@ -182,6 +190,7 @@ NB_MODULE(mitsuba_ext, m) {
 
         struct_jit::clear_cache();
         Profiler::static_shutdown();
+        TextureCache::static_shutdown();
         Bitmap::static_shutdown();
         Logger::static_shutdown();
         Thread::static_shutdown();
@@ -0,0 +1,394 @@
+#include <mitsuba/render/bvh.h>
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+NAMESPACE_BEGIN(mitsuba)
+
+MI_VARIANT struct ShapeBVH<Float, Spectrum>::BuildContext {
+    const BuildPrimitive *prims;
+    BVHNode *nodes;
+    std::atomic<Size> node_count { 1 };
+    std::atomic<Size> leaf_count { 0 };
+    std::atomic<Size> max_depth { 0 };
+};
+
+MI_VARIANT ShapeBVH<Float, Spectrum>::ShapeBVH(const Properties &props,
+                                               AccelQuality quality) {
+    /* BVH construction: Number of centroid bins per axis used to evaluate
+       the surface area heuristic */
+    uint32_t bins = quality == AccelQuality::Low      ? 8
+                    : quality == AccelQuality::Medium ? 12
+                                                      : 16;
+    m_bins = props.get<uint32_t>("bvh_bins", bins);
+    if (m_bins < 2)
+        Throw("The number of BVH bins must be at least 2");
+
+    /* BVH construction: Maximum number of primitives in a leaf node that the
+       builder will keep when the SAH advises against splitting it further */
+    m_max_leaf_size = props.get<uint32_t>("bvh_max_leaf_size", 8);
+    if (m_max_leaf_size < 1)
+        Throw("The maximum BVH leaf size must be at least 1");
+
+    /* Ray tracing: trace coherent groups of rays in LLVM variants through the
+       BVH together as packets, rather than one lane at a time. */
+    m_packet_traversal = props.get<bool>("bvh_packet", true);
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::clear() {
+    Prims::clear_primitives();
+    m_bbox.reset();
+    m_nodes.reset();
+    m_indices.reset();
+    m_node_count = 0;
+    m_index_count = 0;
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::add_shape(Shape *shape) {
+    Assert(!ready());
+    Prims::add_primitives(shape);
+    m_bbox.expand(shape->bbox());
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::build() {
+    if (ready())
+        Throw("The BVH has already been built!");
+
+    Timer timer;
+    Size prim_count = primitive_count();
+    Log(Info, "Building a binned SAH BVH (%i primitives) ..", prim_count);
+
+    /* Compute primitive bounds and centroids in parallel */
+    std::unique_ptr<BuildPrimitive[]> prims(new BuildPrimitive[prim_count]);
+    dr::parallel_for(
+        dr::blocked_range<Size>(0u, prim_count, MI_BVH_GRAIN_SIZE),
+        [&](const dr::blocked_range<Size> &range) {
+            for (Size i = range.begin(); i != range.end(); ++i) {
+                BuildPrimitive &prim = prims[i];
+                prim.bbox = bbox(i);
+                prim.centroid = prim.bbox.center();
+            }
+        }
+    );
+
+    /* Primitives with an invalid bounding box can never be hit */
+    std::unique_ptr<Index[]> indices(new Index[prim_count]);
+    Size index_count = 0;
+    for (Size i = 0; i < prim_count; ++i) {
+        if (likely(prims[i].bbox.valid()))
+            indices[index_count++] = i;
+    }
+
+    if (index_count == 0) {
+        Log(Warn, "BVH contains no geometry!");
+        return;
+    }
+
+    /* A binary tree whose leaves are nonempty has at most 2N - 1 nodes */
+    std::unique_ptr<BVHNode[]> nodes(new BVHNode[2 * index_count - 1]);
+
+    BuildContext ctx;
+    ctx.prims = prims.get();
+    ctx.nodes = nodes.get();
+
+    m_indices = std::move(indices);
+    m_index_count = index_count;
+
+    build_node(ctx, 0, 0, index_count, 1);
+
+    /* Store the nodes in a compact contiguous format */
+    m_node_count = ctx.node_count;
+    m_nodes.reset(new BVHNode[m_node_count]);
+    memcpy(m_nodes.get(), nodes.get(), m_node_count * sizeof(BVHNode));
+
+    Log(Debug, "Structural BVH statistics:");
+    Log(Debug, "   Primitive references        : %i (%s)", m_index_count,
+        util::mem_string(m_index_count * sizeof(Index)));
+    Log(Debug, "   BVH nodes                   : %i (%s)", m_node_count,
+        util::mem_string(m_node_count * sizeof(BVHNode)));
+    Log(Debug, "   BVH depth                   : %i", (Size) ctx.max_depth);
+    Log(Debug, "   Avg. prims/leaf             : %.2f",
+        m_index_count / (double) ctx.leaf_count);
+
+    Log(Info, "Finished. (%s of storage, took %s)",
+        util::mem_string(m_index_count * sizeof(Index) +
+                         m_node_count * sizeof(BVHNode)),
+        util::time_string((float) timer.value())
+    );
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::build_node(BuildContext &ctx,
+                                                     Index node_index,
+                                                     Index begin, Index end,
+                                                     Size depth) {
+    Size count = end - begin, bin_count = m_bins;
+    Index *indices = m_indices.get();
+    const BuildPrimitive *prims = ctx.prims;
+    BVHNode &node = ctx.nodes[node_index];
+
+    Size max_depth = ctx.max_depth;
+    while (depth > max_depth &&
+           !ctx.max_depth.compare_exchange_weak(max_depth, depth))
+        ;
+
+    /* Process the primitive range in parallel when it is large, and combine
+       the partial results of all workers via 'merge' */
+    auto reduce = [&](auto &&init, auto &&accumulate, auto &&merge) {
+        if (count <= MI_BVH_GRAIN_SIZE) {
+            auto result = init();
+            for (Index i = begin; i != end; ++i)
+                accumulate(result, prims[indices[i]]);
+            return result;
+        }
+
+        auto result = init();
+        std::mutex mutex;
+        dr::parallel_for(
+            dr::blocked_range<Index>(begin, end, MI_BVH_GRAIN_SIZE),
+            [&](const dr::blocked_range<Index> &range) {
+                auto local = init();
+                for (Index i = range.begin(); i != range.end(); ++i)
+                    accumulate(local, prims[indices[i]]);
+                std::lock_guard<std::mutex> guard(mutex);
+                merge(result, local);
+            }
+        );
+        return result;
+    };
+
+    /* ==================================================================== */
+    /*                 Bounds of the primitives and centroids               */
+    /* ==================================================================== */
+
+    using BoundsPair = std::pair<ScalarBoundingBox3f, ScalarBoundingBox3f>;
+    BoundsPair node_bounds = reduce(
+        [] { return BoundsPair(); },
+        [](BoundsPair &b, const BuildPrimitive &prim) {
+            b.first.expand(prim.bbox);
+            b.second.expand(prim.centroid);
+        },
+        [](BoundsPair &b, const BoundsPair &local) {
+            b.first.expand(local.first);
+            b.second.expand(local.second);
+        }
+    );
+    const ScalarBoundingBox3f &bounds = node_bounds.first,
+                              &centroid_bounds = node_bounds.second;
+
+    node.set_bbox(bounds);
+
+    auto make_leaf = [&]() {
+        node.offset = begin;
+        node.data = count;
+        ctx.leaf_count++;
+    };
+
+    if (count == 1) {
+        make_leaf();
+        return;
+    }
+
+    ScalarVector3f extents = centroid_bounds.extents();
+    bool degenerate = dr::all(extents == 0.f);
+
+    int axis = -1;
+    Index mid = begin;
+
+    /* ==================================================================== */
+    /*                      Binned surface area heuristic                   */
+    /* ==================================================================== */
+
+    if (!degenerate && depth < MI_BVH_MEDIAN_DEPTH) {
+        struct Bin {
+            ScalarBoundingBox3f bbox;
+            Size count = 0;
+        };
+        using Bins = std::vector<Bin>;
+
+        ScalarVector3f scale =
+            dr::select(extents > 0.f, ScalarFloat(bin_count) / extents, 0.f);
+
+        auto bin_index = [&](const ScalarPoint3f &centroid, size_t axis_) {
+            Size b = (Size) ((centroid[axis_] - centroid_bounds.min[axis_]) *
+                             scale[axis_]);
+            return std::min(b, bin_count - 1);
+        };
+
+        Bins bins = reduce(
+            [&] { return Bins(3 * bin_count); },
+            [&](Bins &b, const BuildPrimitive &prim) {
+                for (size_t k = 0; k < 3; ++k) {
+                    Bin &bin = b[k * bin_count + bin_index(prim.centroid, k)];
+                    bin.bbox.expand(prim.bbox);
+                    bin.count++;
+                }
+            },
+            [](Bins &b, const Bins &local) {
+                for (size_t k = 0; k < b.size(); ++k) {
+                    b[k].bbox.expand(local[k].bbox);
+                    b[k].count += local[k].count;
+                }
+            }
+        );
+
+        /* Cost of a traversal step relative to a primitive intersection */
+        const ScalarFloat traversal_cost = .125f;
+
+        ScalarFloat best_cost = dr::Infinity<ScalarFloat>,
+                    inv_area  = 1.f / bounds.surface_area();
+        Size best_bin = 0;
+        std::vector<ScalarFloat> right_cost(bin_count);
+
+        for (size_t k = 0; k < 3; ++k) {
+            if (extents[k] == 0.f)
+                continue;
+            const Bin *b = bins.data() + k * bin_count;
+
+            /* Sweep from the right to accumulate the cost of the right side */
+            ScalarBoundingBox3f acc;
+            Size acc_count = 0;
+            for (Size i = bin_count - 1; i > 0; --i) {
+                acc.expand(b[i].bbox);
+                acc_count += b[i].count;
+                right_cost[i] = acc_count > 0
+                    ? acc.surface_area() * acc_count : 0.f;
+            }
+
+            /* Sweep from the left and evaluate splits after bins 0 .. n-2 */
+            acc.reset();
+            acc_count = 0;
+            for (Size i = 0; i + 1 < bin_count; ++i) {
+                acc.expand(b[i].bbox);
+                acc_count += b[i].count;
+                if (acc_count == 0 || acc_count == count)
+                    continue;
+
+                ScalarFloat cost =
+                    traversal_cost +
+                    (acc.surface_area() * acc_count + right_cost[i + 1]) * inv_area;
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_bin  = i;
+                    axis      = (int) k;
+                }
+            }
+        }
+
+        if (axis >= 0 && best_cost >= (ScalarFloat) count &&
+            count <= m_max_leaf_size) {
+            make_leaf();
+            return;
+        }
+
+        if (axis >= 0)
+            mid = Index(std::partition(indices + begin, indices + end,
+                                       [&](Index i) {
+                                           return bin_index(prims[i].centroid,
+                                                            axis) <= best_bin;
+                                       }) - indices);
+    }
+
+    /* ==================================================================== */
+    /*                 Fall back to an object median split                  */
+    /* ==================================================================== */
+
+    if (axis < 0) {
+        if (count <= m_max_leaf_size) {
+            make_leaf();
+            return;
+        }
+
+        axis = (int) centroid_bounds.major_axis();
+        mid = begin + count / 2;
+        std::nth_element(indices + begin, indices + mid, indices + end,
+                         [&](Index a, Index b) {
+                             return prims[a].centroid[axis] <
+                                    prims[b].centroid[axis];
+                         });
+    }
+
+    Assert(mid > begin && mid < end);
+
+    /* ==================================================================== */
+    /*                              Recursion                               */
+    /* ==================================================================== */
+
+    Index children = ctx.node_count.fetch_add(2);
+    node.offset = children;
+    node.data = (uint32_t) axis << 30;
+
+    if (count > MI_BVH_GRAIN_SIZE) {
+        Task *left_task = dr::do_async([&, children, begin, mid, depth]() {
+            build_node(ctx, children, begin, mid, depth + 1);
+        });
+        build_node(ctx, children + 1, mid, end, depth + 1);
+        task_wait_and_release(left_task);
+    } else {
+        build_node(ctx, children, begin, mid, depth + 1);
+        build_node(ctx, children + 1, mid, end, depth + 1);
+    }
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::refit() {
+    if (!ready())
+        return;
+
+    Timer timer;
+    BVHNode *nodes = m_nodes.get();
+
+    /* Leaves first: recompute the bounds of their primitives in parallel */
+    dr::parallel_for(
+        dr::blocked_range<Size>(0u, m_node_count, MI_BVH_GRAIN_SIZE / 8),
+        [&](const dr::blocked_range<Size> &range) {
+            for (Size i = range.begin(); i != range.end(); ++i) {
+                BVHNode &node = nodes[i];
+                if (!node.leaf())
+                    continue;
+                ScalarBoundingBox3f bounds;
+                Index prim_end = node.offset + node.primitive_count();
+                for (Index j = node.offset; j < prim_end; ++j)
+                    bounds.expand(bbox(m_indices[j]));
+                node.set_bbox(bounds);
+            }
+        }
+    );
+
+    /* Children are always allocated after their parent, hence a reverse
+       sweep visits them before it */
+    for (Size i = m_node_count; i-- > 0;) {
+        BVHNode &node = nodes[i];
+        if (node.leaf())
+            continue;
+        const BVHNode &left = nodes[node.offset], &right = nodes[node.offset + 1];
+        for (size_t k = 0; k < 3; ++k) {
+            node.bbox_min[k] = std::min(left.bbox_min[k], right.bbox_min[k]);
+            node.bbox_max[k] = std::max(left.bbox_max[k], right.bbox_max[k]);
+        }
+    }
+
+    m_bbox.reset();
+    for (const Shape *shape : m_shapes)
+        m_bbox.expand(shape->bbox());
+
+    Log(Debug, "Refit the BVH (%i nodes, took %s)", m_node_count,
+        util::time_string((float) timer.value()));
+}
+
+MI_VARIANT std::string ShapeBVH<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "ShapeBVH[" << std::endl
+        << "  shapes = [" << std::endl;
+    for (auto shape : m_shapes)
+        oss << "    " << string::indent(shape, 4)
+            << "," << std::endl;
+    oss << "  ]" << std::endl << "]";
+    return oss.str();
+}
+
+MI_INSTANTIATE_CLASS(ShapeBVH)
+NAMESPACE_END(mitsuba)
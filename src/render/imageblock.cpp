@@ -189,6 +189,38 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put_block(const ImageBlock *block)
     }
 }
 
+MI_VARIANT void ImageBlock<Float, Spectrum>::put_block(const ImageBlock *block,
+                                                       const ScalarPoint2i &region_offset,
+                                                       const ScalarVector2i &region_size) {
+    ScopedPhase sp(ProfilerPhase::ImageBlockPut);
+
+    if (unlikely(block->channel_count() != channel_count()))
+        Throw("ImageBlock::put_block(): mismatched channel counts! (%u, "
+              "expected %u)", block->channel_count(), channel_count());
+
+    ScalarVector2u source_size   = block->size() + 2 * block->border_size(),
+                   target_size   =        size() + 2 *        border_size();
+
+    ScalarPoint2i  source_offset = block->offset() - block->border_size(),
+                   target_offset =        offset() -        border_size();
+
+    if constexpr (dr::is_jit_v<Float>) {
+        accumulate_2d<Float &, const Float &>(
+            block->tensor().array(), source_size,
+            m_tensor.array(), target_size,
+            region_offset - source_offset, region_offset - target_offset,
+            region_size, channel_count()
+        );
+    } else {
+        accumulate_2d(
+            block->tensor().data(), source_size,
+            m_tensor.data(), target_size,
+            region_offset - source_offset, region_offset - target_offset,
+            region_size, channel_count()
+        );
+    }
+}
+
 MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                                                  const Float *values,
                                                  Mask active) {
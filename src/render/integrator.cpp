@@ -19,6 +19,16 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Relate the acceleration data structure build time to the render time
+template <typename Float, typename Spectrum>
+static void log_accel_build_time(const Scene<Float, Spectrum> *scene,
+                                 float render_time) {
+    float build_time = scene->accel_build_time();
+    Log(Info, "Acceleration data structure build took %s (%.1f%% of the "
+        "render time).", util::time_string(build_time, true),
+        100.f * build_time / std::max(render_time, 1e-3f));
+}
+
 // -----------------------------------------------------------------------------
 
 MI_VARIANT Integrator<Float, Spectrum>::Integrator(const Properties &props)
@@ -124,6 +134,73 @@ Integrator<Float, Spectrum>::skip_area_emitters(const Scene *scene,
 
 // -----------------------------------------------------------------------------
 
+/// Passes needed before progressive rendering trusts its error estimate
+static constexpr uint32_t progressive_min_passes = 4;
+
+/**
+ * Luminance added to the denominator of the relative error, which prevents
+ * the progressive renderer from refining noise in nearly black regions
+ */
+static constexpr double progressive_min_luminance = 1e-2;
+
+/// Per-block state of progressive rendering in scalar variants
+struct ProgressiveBlock {
+    std::mutex mutex;
+    /// Number of passes accounted for in \c sum and \c sum2
+    uint32_t passes = 0;
+    /// Set once no pixel of the block exceeds the error threshold
+    bool converged = false;
+    /// Per-pixel sums of the luminance estimates of all passes and of their squares
+    std::vector<double> sum, sum2;
+};
+
+/**
+ * \brief Add the luminance estimates of a freshly rendered pass over \c
+ * block to the statistics of \c state, and return the largest relative
+ * error of a pixel (or infinity during the first passes)
+ */
+template <typename Block>
+static double progressive_update(ProgressiveBlock &state,
+                                 const Block *block,
+                                 uint32_t weight_channel) {
+    uint32_t border = block->border_size(),
+             channels = block->channel_count(),
+             width = block->size().x() + 2 * border,
+             pixels = dr::prod(block->size());
+    const auto *data = block->tensor().array().data();
+
+    if (state.sum.size() != pixels) {
+        state.sum.assign(pixels, 0.0);
+        state.sum2.assign(pixels, 0.0);
+    }
+
+    uint32_t n = ++state.passes;
+    double max_error = n < progressive_min_passes ? dr::Infinity<double> : 0.0;
+
+    for (uint32_t y = 0, i = 0; y < block->size().y(); ++y) {
+        for (uint32_t x = 0; x < block->size().x(); ++x, ++i) {
+            const auto *px = data + ((size_t) (y + border) * width + x + border) * channels;
+            double weight = (double) px[weight_channel],
+                   value = 0.0;
+            if (weight > 0.0)
+                value = (0.212671 * (double) px[0] + 0.715160 * (double) px[1] +
+                         0.072169 * (double) px[2]) / weight;
+
+            state.sum[i] += value;
+            state.sum2[i] += value * value;
+
+            if (n >= progressive_min_passes) {
+                double mean = state.sum[i] / n,
+                       var = dr::maximum(state.sum2[i] / n - mean * mean, 0.0) / (n - 1);
+                max_error = dr::maximum(max_error, dr::sqrt(var / n) /
+                                        (dr::abs(mean) + progressive_min_luminance));
+            }
+        }
+    }
+
+    return max_error;
+}
+
 MI_VARIANT SamplingIntegrator<Float, Spectrum>::SamplingIntegrator(const Properties &props)
     : Base(props) {
 
@@ -144,6 +221,16 @@ MI_VARIANT SamplingIntegrator<Float, Spectrum>::SamplingIntegrator(const Propert
                   "Please leave it undefined; Mitsuba will then automatically "
                   "choose the necessary number of passes.");
     }
+
+    m_error_threshold = props.get<ScalarFloat>("error_threshold", 0.f);
+    if (m_error_threshold < 0.f)
+        Throw("\"error_threshold\" must be a non-negative number!");
+
+    m_time_budget = props.get<ScalarFloat>("time_budget", -1.f);
+
+    m_pass_samples = props.get<uint32_t>("pass_samples", 8);
+    if (m_pass_samples == 0)
+        Throw("\"pass_samples\" must be greater than zero!");
 }
 
 MI_VARIANT SamplingIntegrator<Float, Spectrum>::~SamplingIntegrator() { }
@@ -174,18 +261,50 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
                                     ? spp
                                     : std::min(m_samples_per_pass, spp);
 
+    /* Progressive rendering: use the largest pass that does not exceed
+       'pass_samples' and evenly divides the sample count */
+    bool progressive = m_error_threshold > 0.f || m_time_budget > 0.f;
+    if (progressive) {
+        spp_per_pass = std::min(m_pass_samples, spp);
+        while (spp % spp_per_pass != 0)
+            spp_per_pass--;
+    }
+
     if ((spp % spp_per_pass) != 0)
         Throw("sample_count (%d) must be a multiple of spp_per_pass (%d).",
               spp, spp_per_pass);
 
     uint32_t n_passes = spp / spp_per_pass;
 
+    if (m_error_threshold > 0.f && has_flag(film->flags(), FilmFlags::Special))
+        Throw("The \"error_threshold\" parameter is not supported by films "
+              "with a special channel layout (e.g. spectral films)!");
+
+    // Channel holding the sample weights (see render_sample())
+    uint32_t weight_channel = has_flag(film->flags(), FilmFlags::Alpha) ? 4 : 3;
+
     // Determine output channels and prepare the film with this information
     size_t n_channels = film->prepare(aov_names());
 
     // Start the render timer (used for timeouts & log messages)
     m_render_timer.reset();
 
+    // Has the time budget of progressive rendering been used up?
+    auto budget_exhausted = [&]() {
+        return m_time_budget > 0.f &&
+               m_render_timer.value() > 1000.f * m_time_budget;
+    };
+
+    if (progressive)
+        Log(Info, "Progressive rendering: passes of %u sample%s%s%s.",
+            spp_per_pass, spp_per_pass == 1 ? "" : "s",
+            m_error_threshold > 0.f
+                ? tfm::format(", relative error threshold %g", m_error_threshold)
+                : std::string(),
+            m_time_budget > 0.f
+                ? tfm::format(", time budget %.2f seconds", m_time_budget)
+                : std::string());
+
     TensorXf result;
     if constexpr (!dr::is_jit_v<Float>) {
         // Render on the CPU using a spiral pattern
@@ -212,7 +331,15 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
             }
         }
 
-        Spiral spiral(film_size, film->crop_offset(), block_size, n_passes);
+        /* Streaming films write finished rows to disk while rendering and
+           therefore need the blocks in scanline order from a single pass */
+        bool streaming = has_flag(film->flags(), FilmFlags::Streaming);
+        if (streaming && n_passes > 1)
+            Throw("Streaming films require rendering in a single pass (the "
+                  "current configuration requires %u passes).", n_passes);
+
+        Spiral spiral(film_size, film->crop_offset(), block_size, n_passes,
+                      streaming);
 
         std::mutex mutex;
         ref<ProgressReporter> progress;
@@ -230,6 +357,13 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         // Avoid overlaps in RNG seeding RNG when a seed is manually specified
         seed *= dr::prod(film_size);
 
+        // Convergence statistics of progressive rendering (per block)
+        uint32_t block_count = spiral.block_count();
+        std::unique_ptr<ProgressiveBlock[]> progressive_blocks;
+        if (progressive)
+            progressive_blocks.reset(new ProgressiveBlock[block_count]);
+        std::atomic<uint32_t> blocks_rendered(0);
+
         dr::parallel_for(
             dr::blocked_range<uint32_t>(0, total_blocks, grain_size),
             [&](const dr::blocked_range<uint32_t> &range) {
@@ -249,16 +383,39 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
                     auto [offset, size, block_id] = spiral.next_block();
                     Assert(dr::prod(size) != 0);
 
-                    if (film->sample_border())
-                        offset -= film->rfilter()->border_size();
+                    /* Progressive rendering skips converged blocks and stops
+                       refining once the time budget is used up, but the
+                       first pass always completes */
+                    ProgressiveBlock *state = nullptr;
+                    bool skip = false;
+                    if (progressive) {
+                        state = &progressive_blocks[block_id % block_count];
+                        bool first_pass = block_id >= (n_passes - 1) * block_count;
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        skip = state->converged || (!first_pass && budget_exhausted());
+                    }
+
+                    if (!skip) {
+                        if (film->sample_border())
+                            offset -= film->rfilter()->border_size();
+
+                        block->set_size(size);
+                        block->set_offset(offset);
 
-                    block->set_size(size);
-                    block->set_offset(offset);
+                        render_block(scene, sensor, sampler, block, aovs.get(),
+                                     spp_per_pass, seed, block_id, block_size);
 
-                    render_block(scene, sensor, sampler, block, aovs.get(),
-                                 spp_per_pass, seed, block_id, block_size);
+                        if (m_error_threshold > 0.f && !should_stop()) {
+                            std::lock_guard<std::mutex> lock(state->mutex);
+                            double error = progressive_update(*state, block.get(),
+                                                              weight_channel);
+                            if (error < m_error_threshold)
+                                state->converged = true;
+                        }
 
-                    film->put_block(block);
+                        film->put_block(block);
+                        blocks_rendered++;
+                    }
 
                     /* Critical section: update progress bar */
                     if (progress) {
@@ -270,7 +427,17 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
             }
         );
 
-        if (develop)
+        if (progressive) {
+            uint32_t converged = 0;
+            for (uint32_t i = 0; i < block_count; ++i)
+                converged += progressive_blocks[i].converged ? 1 : 0;
+            Log(Info, "Progressive rendering used %.1f of %u samples per "
+                "pixel on average (%u/%u blocks converged).",
+                blocks_rendered * (double) spp_per_pass / block_count, spp,
+                converged, block_count);
+        }
+
+        if (develop && !streaming)
             result = film->develop();
     } else {
         size_t wavefront_size = (size_t) film_size.x() *
@@ -344,19 +511,92 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         Timer timer;
         std::unique_ptr<Float[]> aovs(new Float[n_channels]);
 
-        // Potentially render multiple passes
-        for (size_t i = 0; i < n_passes; i++) {
-            render_sample(scene, sensor, sampler, block, aovs.get(), pos,
-                          diff_scale_factor);
+        if (!progressive) {
+            // Potentially render multiple passes
+            for (size_t i = 0; i < n_passes; i++) {
+                render_sample(scene, sensor, sampler, block, aovs.get(), pos,
+                              diff_scale_factor);
 
-            if (n_passes > 1) {
-                sampler->advance(); // Will trigger a kernel launch of size 1
+                if (n_passes > 1) {
+                    sampler->advance(); // Will trigger a kernel launch of size 1
+                    sampler->schedule_state();
+                    dr::eval(block->tensor());
+                }
+            }
+
+            film->put_block(block);
+        } else {
+            /* Render passes into a cleared block that is then added to the
+               film, which keeps the film consistent after every pass and
+               exposes each pass to the convergence statistics. Converged
+               pixels are masked out of subsequent passes. */
+            ScalarVector2u block_size = block->size();
+            uint32_t pixel_count = dr::prod(block_size),
+                     channels    = block->channel_count();
+
+            // Block pixel refined by each sample
+            Vector2i sample_pixel = dr::clip(
+                pos - ScalarVector2i(film->crop_offset()), 0,
+                ScalarVector2i(block_size) - 1);
+            UInt32 sample_index = UInt32(sample_pixel.y()) * block_size.x() +
+                                  UInt32(sample_pixel.x());
+
+            // Per-pixel sums of the pass estimates and of their squares
+            Float sum  = dr::zeros<Float>(pixel_count),
+                  sum2 = dr::zeros<Float>(pixel_count);
+            Mask converged = dr::full<Mask>(false, pixel_count);
+            UInt32 pixel_offset = dr::arange<UInt32>(pixel_count) * channels;
+
+            uint32_t passes = 0;
+            while (passes < n_passes && !should_stop() &&
+                   (passes == 0 || !budget_exhausted())) {
+                block->clear();
+                render_sample(scene, sensor, sampler, block, aovs.get(), pos,
+                              diff_scale_factor,
+                              !dr::gather<Mask>(converged, sample_index));
+                sampler->advance();
                 sampler->schedule_state();
-                dr::eval(block->tensor());
+                film->put_block(block);
+                passes++;
+
+                if (m_error_threshold > 0.f) {
+                    const Float &data = block->tensor().array();
+                    Color3f rgb(dr::gather<Float>(data, pixel_offset),
+                                dr::gather<Float>(data, pixel_offset + 1),
+                                dr::gather<Float>(data, pixel_offset + 2));
+                    Float weight = dr::gather<Float>(data, pixel_offset + weight_channel),
+                          value  = dr::select(weight > 0.f, luminance(rgb) / weight, 0.f);
+
+                    dr::masked(sum, !converged)  += value;
+                    dr::masked(sum2, !converged) += dr::square(value);
+
+                    if (passes >= progressive_min_passes) {
+                        Float mean = sum / (ScalarFloat) passes,
+                              var  = dr::maximum(sum2 / (ScalarFloat) passes -
+                                                 dr::square(mean), 0.f) /
+                                     (ScalarFloat) (passes - 1);
+                        converged |= dr::sqrt(var / (ScalarFloat) passes) <
+                                     m_error_threshold *
+                                         (dr::abs(mean) +
+                                          (ScalarFloat) progressive_min_luminance);
+                    }
+
+                    dr::eval(sum, sum2, converged);
+                }
+
+                film->schedule_storage();
+                dr::eval();
+
+                if (m_error_threshold > 0.f && dr::all(converged))
+                    break;
             }
-        }
 
-        film->put_block(block);
+            uint32_t converged_count =
+                m_error_threshold > 0.f ? (uint32_t) dr::count(converged)[0] : 0;
+            Log(Info, "Progressive rendering stopped after %u of %u passes "
+                "(%u/%u pixels converged).", passes, n_passes,
+                converged_count, pixel_count);
+        }
 
         if (n_passes == 1 && jit_flag(JitFlag::VCallRecord) &&
             jit_flag(JitFlag::LoopRecord)) {
@@ -388,9 +628,12 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         }
     }
 
-    if (!m_stop && (evaluate || !dr::is_jit_v<Float>))
+    if (!m_stop && (evaluate || !dr::is_jit_v<Float>)) {
+        float render_time = (float) m_render_timer.value();
         Log(Info, "Rendering finished. (took %s)",
-            util::time_string((float) m_render_timer.value(), true));
+            util::time_string(render_time, true));
+        log_accel_build_time(scene, render_time);
+    }
 
     return result;
 }
@@ -584,6 +827,10 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
     ScalarVector2u film_size = film->size(),
                    crop_size = film->crop_size();
 
+    if (has_flag(film->flags(), FilmFlags::Streaming))
+        Throw("Streaming films are not supported by adjoint integrators, "
+              "which splat samples anywhere on the film.");
+
     // Potentially adjust the number of samples per pixel if spp != 0
     Sampler *sampler = sensor->sampler();
     if (spp)
@@ -649,6 +896,32 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
         seed *= (uint32_t) (total_samples / grain_size);
         std::atomic<size_t> samples_done(0);
 
+        /* Splatting buffers. Each worker acquires a crop-sized buffer from
+           this pool for the duration of a range and returns it afterwards.
+           Since at most 'n_threads' ranges are processed concurrently, the
+           pool never grows beyond that size, and buffers keep accumulating
+           across ranges instead of being allocated, cleared, and merged into
+           the film every time. */
+        std::vector<ref<ImageBlock>> blocks, free_blocks;
+
+        auto acquire_block = [&]() -> ref<ImageBlock> {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!free_blocks.empty()) {
+                ref<ImageBlock> block = free_blocks.back();
+                free_blocks.pop_back();
+                return block;
+            }
+
+            ref<ImageBlock> block = film->create_block(
+                ScalarVector2u(0) /* use crop size */,
+                true /* normalize */,
+                false /* border */);
+            block->set_offset(film->crop_offset());
+            block->clear();
+            blocks.push_back(block);
+            return block;
+        };
+
         // Start the render timer (used for timeouts & log messages)
         m_render_timer.reset();
 
@@ -659,15 +932,8 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
                 // Fork a non-overlapping sampler for the current worker
                 ref<Sampler> sampler = sensor->sampler()->clone();
 
-                ref<ImageBlock> block = film->create_block(
-                    ScalarVector2u(0) /* use crop size */,
-                    true /* normalize */,
-                    false /* border */);
-
-                block->set_offset(film->crop_offset());
-
-                // Clear block (it's being reused)
-                block->clear();
+                // Reuse an accumulation buffer of a (now idle) worker
+                ref<ImageBlock> block = acquire_block();
 
                 sampler->seed(seed +
                               (uint32_t) range.begin() / (uint32_t) grain_size);
@@ -685,17 +951,42 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
                         progress->update(samples_done / (ScalarFloat) total_samples);
                     }
                 }
-                total_samples += ctr;
 
-                // When all samples are done for this range, commit to the film
                 /* locked */ {
                     std::lock_guard<std::mutex> lock(mutex);
+                    samples_done += ctr;
                     progress->update(samples_done / (ScalarFloat) total_samples);
-                    film->put_block(block);
+                    free_blocks.push_back(block);
                 }
             }
         );
 
+        if (!blocks.empty()) {
+            /* Tiled parallel reduction of the worker buffers: each task sums
+               a contiguous range of the storage of all buffers into the
+               first one, which is then committed to the film. */
+            size_t buffer_size = blocks[0]->tensor().size();
+            ScalarFloat *target = blocks[0]->tensor().array().data();
+
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, buffer_size, 16384),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t j = 1; j < blocks.size(); ++j) {
+                        const ScalarFloat *source =
+                            blocks[j]->tensor().array().data();
+                        for (size_t i = range.begin(); i != range.end(); ++i)
+                            target[i] += source[i];
+                    }
+                }
+            );
+
+            film->put_block(blocks[0]);
+
+            Log(Info, "Splatting buffers: %zu x %s (peak: %s)", blocks.size(),
+                util::mem_string(buffer_size * sizeof(ScalarFloat)),
+                util::mem_string(blocks.size() * buffer_size * sizeof(ScalarFloat)));
+        }
+
         if (develop)
             result = film->develop();
     } else {
@@ -780,9 +1071,12 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
         }
     }
 
-    if (!m_stop && (evaluate || !dr::is_jit_v<Float>))
+    if (!m_stop && (evaluate || !dr::is_jit_v<Float>)) {
+        float render_time = (float) m_render_timer.value();
         Log(Info, "Rendering finished. (took %s)",
-            util::time_string((float) m_render_timer.value(), true));
+            util::time_string(render_time, true));
+        log_accel_build_time(scene, render_time);
+    }
 
     return result;
 }
@@ -1,14 +1,73 @@
 #include <mitsuba/render/kdtree.h>
 #include <mitsuba/render/mesh.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/properties.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Version of the kd-tree cache file format
+static constexpr uint32_t KDCacheVersion = 1;
+
+/// Number of primitives that are hashed by a single parallel work unit
+static constexpr uint32_t KDCacheHashBlockSize = 16384;
+
+/// Header of a kd-tree cache file, followed by the node and index arrays
+struct KDCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t hash;
+    uint32_t scalar_size;
+    uint32_t primitive_count;
+    uint32_t node_count;
+    uint32_t index_count;
+    double bbox_min[3];
+    double bbox_max[3];
+};
+
+static_assert(sizeof(KDCacheHeader) % 8 == 0,
+              "KDCacheHeader must preserve the alignment of the node array");
+
+/// Simple 64-bit hash that mixes in one value at a time
+struct KDCacheHasher {
+    uint64_t state = 0xcbf29ce484222325ull;
+
+    void put(uint64_t value) {
+        uint64_t x = state ^ (value + 0x9e3779b97f4a7c15ull + (state << 6) + (state >> 2));
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        state = x ^ (x >> 31);
+    }
+
+    void put(float value) { put((uint64_t) dr::memcpy_cast<uint32_t>(value)); }
+    void put(double value) { put(dr::memcpy_cast<uint64_t>(value)); }
+
+    void put(std::string_view value) {
+        put((uint64_t) value.size());
+        for (char c : value)
+            put((uint64_t) (uint8_t) c);
+    }
+};
+
+/// Create the directory \c dir along with any missing parent directories
+static bool kd_cache_create_directories(const fs::path &dir) {
+    if (dir.empty() || fs::is_directory(dir))
+        return true;
+
+    fs::path parent = dir.parent_path();
+    if (parent != dir && !kd_cache_create_directories(parent))
+        return false;
+
+    // Another process may have created the directory in the meantime
+    return fs::create_directory(dir) || fs::is_directory(dir);
+}
+
 template <typename B, typename I, typename C, typename D>
 thread_local typename TShapeKDTree<B, I, C, D>::LocalBuildContext
     TShapeKDTree<B, I, C, D>::BuildTask::m_local = {};
 
-MI_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
+MI_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props,
+                                                     AccelQuality quality)
     : Base(SurfaceAreaHeuristic3f(
           /* kd-tree construction: Relative cost of a shape intersection
              operation in the surface area heuristic. */
@@ -20,6 +79,16 @@ MI_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
              empty space */
           props.get<ScalarFloat>("kd_empty_space_bonus", .9f))) {
 
+    /* Defaults for the requested build quality. The binned phase is linear
+       per tree level, while the exact phase sorts and clips primitives. */
+    if (quality == AccelQuality::Low) {
+        set_exact_primitive_threshold(0);
+        set_clip_primitives(false);
+        set_min_max_bins(32);
+    } else if (quality == AccelQuality::Medium) {
+        set_exact_primitive_threshold(4096);
+    }
+
     /* kd-tree construction: A kd-tree node containing this many or fewer
        primitives will not be split */
     if (props.has_property("kd_stop_prims"))
@@ -48,22 +117,54 @@ MI_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
     if (props.has_property("kd_exact_primitive_threshold"))
         set_exact_primitive_threshold(props.get<int>("kd_exact_primitive_threshold"));
 
-    m_primitive_map.push_back(0);
+    /* Ray tracing: trace coherent groups of rays in LLVM variants through the
+       kd-tree together as packets, rather than one lane at a time. */
+    m_packet_traversal = props.get<bool>("kd_packet", true);
+
+    /* Acceleration cache: directory where built kd-trees are stored, so that
+       later loads of the same geometry can skip the build. */
+    m_cache_dir = props.get<std::string_view>("accel_cache", "");
 }
 
 MI_VARIANT void ShapeKDTree<Float, Spectrum>::clear() {
-    m_shapes.clear();
-    m_primitive_map.clear();
-    m_primitive_map.push_back(0);
+    Prims::clear_primitives();
     m_bbox.reset();
-    m_nodes.release();
-    m_indices.release();
+    m_nodes = Storage<KDNode>();
+    m_indices = Storage<Index>();
     m_node_count = 0;
     m_index_count = 0;
+    m_build_report = KDTreeBuildReport();
 }
 
 MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
     Timer timer;
+
+    uint64_t hash = 0;
+    fs::path cache_file;
+    if (!m_cache_dir.empty() && primitive_count() > 0) {
+        hash = content_hash();
+        cache_file = m_cache_dir / tfm::format("kdtree_%016llx.bin",
+                                               (unsigned long long) hash);
+
+        if (load_cache(cache_file, hash)) {
+            m_build_report = KDTreeBuildReport();
+            m_build_report.cached = true;
+            m_build_report.primitive_count = primitive_count();
+            m_build_report.index_count = m_index_count;
+            m_build_report.node_count = m_node_count;
+            m_build_report.duplication_factor =
+                m_index_count / (double) primitive_count();
+            m_build_report.total_time = (double) timer.value();
+
+            Log(Info, "Loaded a SAH kd-tree (%i primitives) from \"%s\" "
+                "(%s of storage, took %s)", primitive_count(), cache_file,
+                util::mem_string(m_index_count * sizeof(Index) +
+                                 m_node_count * sizeof(KDNode)),
+                util::time_string((float) timer.value()));
+            return;
+        }
+    }
+
     Log(Info, "Building a SAH kd-tree (%i primitives) ..",
         primitive_count());
 
@@ -74,13 +175,172 @@ MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
                         m_node_count * sizeof(KDNode)),
         util::time_string((float) timer.value())
     );
+
+    if (!cache_file.empty())
+        write_cache(cache_file, hash);
+}
+
+MI_VARIANT uint64_t ShapeKDTree<Float, Spectrum>::content_hash() const {
+    KDCacheHasher hasher;
+
+    /* Build parameters */
+    hasher.put((uint64_t) KDCacheVersion);
+    hasher.put((uint64_t) sizeof(ScalarFloat));
+    SurfaceAreaHeuristic3f model = Base::cost_model();
+    hasher.put(model.query_cost());
+    hasher.put(model.traversal_cost());
+    hasher.put(model.empty_space_bonus());
+    hasher.put((uint64_t) Base::clip_primitives());
+    hasher.put((uint64_t) Base::retract_bad_splits());
+    hasher.put((uint64_t) Base::max_depth());
+    hasher.put((uint64_t) Base::stop_primitives());
+    hasher.put((uint64_t) Base::max_bad_refines());
+    hasher.put((uint64_t) Base::exact_primitive_threshold());
+    hasher.put((uint64_t) Base::min_max_bins());
+
+    /* Split the primitives of all shapes into blocks that are hashed in
+       parallel, and combine the block hashes in a fixed order */
+    struct Block { const Shape *shape; Index start, end; };
+    std::vector<Block> blocks;
+
+    hasher.put((uint64_t) shape_count());
+    for (Size i = 0; i < shape_count(); ++i) {
+        const Shape *s = shape(i);
+        Index count = s->primitive_count();
+        hasher.put(s->class_name());
+        hasher.put((uint64_t) count);
+
+        for (Index j = 0; j < count; j += KDCacheHashBlockSize)
+            blocks.push_back({ s, j, std::min(j + KDCacheHashBlockSize, count) });
+    }
+
+    std::vector<uint64_t> block_hashes(blocks.size());
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, blocks.size(), 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                const Block &block = blocks[i];
+                KDCacheHasher h;
+
+                if (block.shape->is_mesh()) {
+                    const Mesh *mesh = static_cast<const Mesh *>(block.shape);
+                    for (Index j = block.start; j < block.end; ++j) {
+                        ScalarVector3u fi = mesh->face_indices(j);
+                        for (size_t k = 0; k < 3; ++k) {
+                            ScalarPoint3f p = mesh->vertex_position(fi[k]);
+                            h.put(p.x()); h.put(p.y()); h.put(p.z());
+                        }
+                    }
+                } else {
+                    for (Index j = block.start; j < block.end; ++j) {
+                        ScalarBoundingBox3f bbox = block.shape->bbox(j);
+                        for (size_t k = 0; k < 3; ++k) {
+                            h.put(bbox.min[k]);
+                            h.put(bbox.max[k]);
+                        }
+                    }
+                }
+
+                block_hashes[i] = h.state;
+            }
+        }
+    );
+
+    for (uint64_t value : block_hashes)
+        hasher.put(value);
+
+    return hasher.state;
+}
+
+MI_VARIANT bool ShapeKDTree<Float, Spectrum>::load_cache(const fs::path &filename,
+                                                         uint64_t hash) {
+    if (!fs::exists(filename))
+        return false;
+
+    ref<MemoryMappedFile> mmap;
+    try {
+        mmap = new MemoryMappedFile(filename);
+    } catch (const std::exception &e) {
+        Log(Warn, "Could not open the kd-tree cache file \"%s\": %s",
+            filename, e.what());
+        return false;
+    }
+
+    const KDCacheHeader *header = (const KDCacheHeader *) mmap->data();
+    if (mmap->size() < sizeof(KDCacheHeader) ||
+        memcmp(header->magic, "MIKD", 4) != 0 ||
+        header->version != KDCacheVersion ||
+        header->hash != hash ||
+        header->scalar_size != sizeof(ScalarFloat) ||
+        header->primitive_count != primitive_count() ||
+        mmap->size() != sizeof(KDCacheHeader) +
+                            header->node_count * sizeof(KDNode) +
+                            header->index_count * sizeof(Index)) {
+        Log(Warn, "Ignoring the invalid or outdated kd-tree cache file \"%s\"",
+            filename);
+        return false;
+    }
+
+    /* The node and index arrays keep the mapping alive */
+    uint8_t *ptr = (uint8_t *) mmap->data() + sizeof(KDCacheHeader);
+    m_node_count  = header->node_count;
+    m_index_count = header->index_count;
+    m_nodes = Storage<KDNode>((KDNode *) ptr,
+                              detail::KDStorageDeleter<KDNode>{ mmap.get() });
+    m_indices = Storage<Index>((Index *) (ptr + m_node_count * sizeof(KDNode)),
+                               detail::KDStorageDeleter<Index>{ mmap.get() });
+
+    for (size_t i = 0; i < 3; ++i) {
+        m_bbox.min[i] = (ScalarFloat) header->bbox_min[i];
+        m_bbox.max[i] = (ScalarFloat) header->bbox_max[i];
+    }
+
+    return true;
+}
+
+MI_VARIANT void ShapeKDTree<Float, Spectrum>::write_cache(const fs::path &filename,
+                                                          uint64_t hash) const {
+    KDCacheHeader header;
+    memcpy(header.magic, "MIKD", 4);
+    header.version = KDCacheVersion;
+    header.hash = hash;
+    header.scalar_size = (uint32_t) sizeof(ScalarFloat);
+    header.primitive_count = primitive_count();
+    header.node_count = m_node_count;
+    header.index_count = m_index_count;
+    for (size_t i = 0; i < 3; ++i) {
+        header.bbox_min[i] = (double) m_bbox.min[i];
+        header.bbox_max[i] = (double) m_bbox.max[i];
+    }
+
+    /* Write to a temporary file first, so that concurrent processes never
+       observe a partially written cache entry */
+    fs::path temp = filename;
+    temp.replace_extension(tfm::format(".%llx.tmp",
+        (unsigned long long) std::chrono::steady_clock::now().time_since_epoch().count()));
+
+    try {
+        if (!kd_cache_create_directories(m_cache_dir))
+            Throw("could not create the cache directory \"%s\"", m_cache_dir);
+
+        ref<FileStream> stream = new FileStream(temp, FileStream::ETruncReadWrite);
+        stream->write(&header, sizeof(KDCacheHeader));
+        stream->write(m_nodes.get(), m_node_count * sizeof(KDNode));
+        stream->write(m_indices.get(), m_index_count * sizeof(Index));
+        stream->close();
+
+        if (!fs::rename(temp, filename))
+            Throw("could not rename \"%s\"", temp);
+    } catch (const std::exception &e) {
+        fs::remove(temp);
+        Log(Warn, "Could not write the kd-tree cache file \"%s\": %s",
+            filename, e.what());
+    }
 }
 
 MI_VARIANT void ShapeKDTree<Float, Spectrum>::add_shape(Shape *shape) {
     Assert(!ready());
-    m_primitive_map.push_back(m_primitive_map.back() +
-                              shape->primitive_count());
-    m_shapes.push_back(shape);
+    Prims::add_primitives(shape);
     m_bbox.expand(shape->bbox());
 }
 
@@ -0,0 +1,516 @@
+#include <mitsuba/render/lighttree.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/core/util.h>
+#include <drjit-core/jit.h>
+#include <drjit/while_loop.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Number of centroid buckets per axis used to evaluate split candidates
+static constexpr size_t light_tree_buckets = 12;
+
+/// Beyond this depth, the builder switches to median splits
+static constexpr uint32_t light_tree_median_depth = 32;
+
+/// Number of values stored per node in \c m_node_data
+static constexpr uint32_t light_tree_node_size = 12;
+
+MI_VARIANT
+void LightTree<Float, Spectrum>::LightBounds::expand(const LightBounds &other) {
+    if (!other.bbox.valid())
+        return;
+
+    if (!bbox.valid()) {
+        *this = other;
+        return;
+    }
+
+    bbox.expand(other.bbox);
+    phi += other.phi;
+    cos_theta_e = dr::minimum(cos_theta_e, other.cos_theta_e);
+
+    // Bounding cone of the two normal cones (Conty Estevez & Kulla 2018)
+    ScalarFloat theta_a = dr::safe_acos(cos_theta_o),
+                theta_b = dr::safe_acos(other.cos_theta_o),
+                theta_d = dr::safe_acos(dr::dot(axis, other.axis));
+
+    if (dr::minimum(theta_d + theta_b, dr::Pi<ScalarFloat>) <= theta_a)
+        return;
+
+    if (dr::minimum(theta_d + theta_a, dr::Pi<ScalarFloat>) <= theta_b) {
+        axis = other.axis;
+        cos_theta_o = other.cos_theta_o;
+        return;
+    }
+
+    ScalarFloat theta_o = .5f * (theta_a + theta_d + theta_b);
+    ScalarVector3f w_r = dr::cross(axis, other.axis);
+    if (theta_o >= dr::Pi<ScalarFloat> || dr::squared_norm(w_r) == 0.f) {
+        cos_theta_o = -1.f;
+        return;
+    }
+
+    // Rotate 'axis' towards 'other.axis' around the perpendicular 'w_r'
+    auto [sin_theta_r, cos_theta_r] = dr::sincos(theta_o - theta_a);
+    w_r = dr::normalize(w_r);
+    axis = dr::normalize(axis * cos_theta_r + dr::cross(w_r, axis) * sin_theta_r);
+    cos_theta_o = dr::cos(theta_o);
+}
+
+MI_VARIANT typename LightTree<Float, Spectrum>::LightBounds
+LightTree<Float, Spectrum>::emitter_bounds(const Emitter *emitter) const {
+    LightBounds b;
+    if (has_flag(emitter->flags(), EmitterFlags::Infinite))
+        return b;
+
+    const Shape *shape = emitter->shape();
+    b.bbox = shape ? shape->bbox() : emitter->bbox();
+    if (!dr::all(dr::isfinite(b.bbox.min) && dr::isfinite(b.bbox.max)))
+        return LightBounds();
+
+    b.phi = emitter->sampling_weight();
+    b.cos_theta_e = 0.f;
+    b.cos_theta_o = -1.f;
+
+    if (!shape || !shape->is_mesh())
+        return b;
+
+    /* Bound the face normals, and the vertex normals used for shading, by
+       a cone around their average direction */
+    const Mesh *mesh = static_cast<const Mesh *>(shape);
+    uint32_t face_count = mesh->face_count(),
+             vertex_count = mesh->has_normals() ? mesh->vertex_count() : 0;
+    ScalarVector3f sum(0.f);
+    ScalarFloat cos_min = 1.f;
+
+    if constexpr (dr::is_jit_v<Float>) {
+        Vector3f n_f = mesh->face_normal(dr::arange<UInt32>(face_count));
+        dr::masked(n_f, !dr::all(dr::isfinite(n_f))) = 0.f;
+        Vector3f n_v;
+        if (vertex_count > 0)
+            n_v = Vector3f(mesh->vertex_normal(dr::arange<UInt32>(vertex_count)));
+
+        for (size_t i = 0; i < 3; ++i)
+            sum[i] = dr::slice(dr::sum(n_f[i]));
+        ScalarFloat norm = dr::norm(sum);
+        if (!(norm > 1e-3f * face_count))
+            return b;
+        ScalarVector3f axis = sum / norm;
+
+        Float cos_f = dr::select(dr::squared_norm(n_f) > 0.f,
+                                 dr::dot(n_f, Vector3f(axis)), 1.f);
+        cos_min = dr::slice(dr::min(cos_f));
+        if (vertex_count > 0)
+            cos_min = dr::minimum(
+                cos_min, dr::slice(dr::min(dr::dot(n_v, Vector3f(axis)))));
+        b.axis = axis;
+    } else {
+        for (uint32_t i = 0; i < face_count; ++i) {
+            ScalarVector3f n = mesh->face_normal(i);
+            if (dr::all(dr::isfinite(n)))
+                sum += n;
+        }
+        ScalarFloat norm = dr::norm(sum);
+        if (!(norm > 1e-3f * face_count))
+            return b;
+        b.axis = sum / norm;
+
+        for (uint32_t i = 0; i < face_count; ++i) {
+            ScalarVector3f n = mesh->face_normal(i);
+            if (dr::all(dr::isfinite(n)))
+                cos_min = dr::minimum(cos_min, dr::dot(n, b.axis));
+        }
+        for (uint32_t i = 0; i < vertex_count; ++i)
+            cos_min = dr::minimum(
+                cos_min, dr::dot(ScalarVector3f(mesh->vertex_normal(i)), b.axis));
+    }
+
+    // Leave some room for roundoff errors
+    b.cos_theta_o = dr::maximum(cos_min - 1e-4f, -1.f);
+    return b;
+}
+
+MI_VARIANT LightTree<Float, Spectrum>::LightTree(const std::vector<ref<Emitter>> &emitters) {
+    std::vector<std::pair<LightBounds, uint32_t>> items;
+    std::vector<uint32_t> emitter_node(emitters.size()),
+                          infinite_index;
+    std::vector<ScalarFloat> infinite_weight;
+    ScalarFloat tree_weight = 0.f;
+
+    for (uint32_t i = 0; i < (uint32_t) emitters.size(); ++i) {
+        LightBounds b = emitter_bounds(emitters[i].get());
+        if (b.bbox.valid()) {
+            items.emplace_back(b, i);
+            tree_weight += b.phi;
+        } else {
+            emitter_node[i] = LeafFlag | (uint32_t) infinite_index.size();
+            infinite_index.push_back(i);
+            infinite_weight.push_back(emitters[i]->sampling_weight());
+        }
+    }
+
+    ScalarFloat infinite_total = 0.f;
+    for (ScalarFloat w : infinite_weight)
+        infinite_total += w;
+
+    if (infinite_total > 0.f) {
+        m_infinite_distr = std::make_unique<DiscreteDistribution<Float>>(
+            infinite_weight.data(), infinite_weight.size());
+        m_infinite_index = dr::load<UInt32Storage>(infinite_index.data(),
+                                                   infinite_index.size());
+        m_tree_prob = items.empty() ? 0.f
+                                    : tree_weight / (tree_weight + infinite_total);
+    } else {
+        m_tree_prob = 1.f;
+    }
+
+    if (!items.empty()) {
+        std::vector<LightBounds> nodes(2 * items.size() - 1);
+        std::vector<uint32_t> info(nodes.size()), parent(nodes.size(), 0);
+        m_node_count = 1;
+        build_node(items, nodes, info, parent, 0, 0, items.size(), 0);
+
+        std::unique_ptr<ScalarFloat[]> data(
+            new ScalarFloat[nodes.size() * light_tree_node_size]);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const LightBounds &b = nodes[i];
+            ScalarFloat *ptr = data.get() + i * light_tree_node_size;
+            for (size_t j = 0; j < 3; ++j) {
+                ptr[j]     = b.bbox.min[j];
+                ptr[j + 3] = b.bbox.max[j];
+                ptr[j + 6] = b.axis[j];
+            }
+            ptr[9]  = b.cos_theta_o;
+            ptr[10] = b.cos_theta_e;
+            ptr[11] = b.phi;
+
+            if (info[i] & LeafFlag)
+                emitter_node[info[i] & ~LeafFlag] = (uint32_t) i;
+        }
+
+        m_node_data = dr::load<FloatStorage>(data.get(),
+                                             nodes.size() * light_tree_node_size);
+        m_node_info = dr::load<UInt32Storage>(info.data(), info.size());
+        m_node_parent = dr::load<UInt32Storage>(parent.data(), parent.size());
+    }
+
+    m_emitter_node = dr::load<UInt32Storage>(emitter_node.data(), emitter_node.size());
+
+    if constexpr (dr::is_jit_v<Float>) {
+        uint32_t max_id = 0;
+        for (const ref<Emitter> &e : emitters)
+            max_id = std::max(max_id, jit_registry_id(e.get()));
+        std::vector<uint32_t> registry_map(max_id + 1, (uint32_t) -1);
+        for (uint32_t i = 0; i < (uint32_t) emitters.size(); ++i)
+            registry_map[jit_registry_id(emitters[i].get())] = i;
+        m_registry_map = dr::load<UInt32Storage>(registry_map.data(),
+                                                 registry_map.size());
+    } else {
+        for (uint32_t i = 0; i < (uint32_t) emitters.size(); ++i)
+            m_emitter_map[emitters[i].get()] = i;
+    }
+
+    Log(Debug, "Light tree: %zu emitters (%zu nodes), %zu outside of the tree.",
+        items.size(), m_node_count, infinite_index.size());
+}
+
+MI_VARIANT void LightTree<Float, Spectrum>::build_node(
+        std::vector<std::pair<LightBounds, uint32_t>> &items,
+        std::vector<LightBounds> &nodes, std::vector<uint32_t> &info,
+        std::vector<uint32_t> &parent, uint32_t node, size_t begin, size_t end,
+        uint32_t depth) {
+    LightBounds bounds;
+    ScalarBoundingBox3f centroid_bbox;
+    for (size_t i = begin; i < end; ++i) {
+        bounds.expand(items[i].first);
+        centroid_bbox.expand(items[i].first.bbox.center());
+    }
+    nodes[node] = bounds;
+
+    if (end - begin == 1) {
+        info[node] = LeafFlag | items[begin].second;
+        return;
+    }
+
+    /* Surface area orientation heuristic: the cost of a set of emitters is
+       its weight times the solid angle measure of its emission cone times
+       the surface area of its bounding box */
+    auto cost = [](const LightBounds &b) {
+        ScalarFloat theta_o = dr::safe_acos(b.cos_theta_o),
+                    theta_e = dr::safe_acos(b.cos_theta_e),
+                    theta_w = dr::minimum(theta_o + theta_e, dr::Pi<ScalarFloat>),
+                    sin_theta_o = dr::safe_sqrt(1.f - dr::square(b.cos_theta_o));
+        ScalarFloat m_omega =
+            2.f * dr::Pi<ScalarFloat> * (1.f - b.cos_theta_o) +
+            .5f * dr::Pi<ScalarFloat> *
+                (2.f * theta_w * sin_theta_o - dr::cos(theta_o - 2.f * theta_w) -
+                 2.f * theta_o * sin_theta_o + b.cos_theta_o);
+        return b.phi * m_omega * b.bbox.surface_area();
+    };
+
+    ScalarVector3f extents = centroid_bbox.extents();
+    uint32_t best_axis = (uint32_t) -1, best_bucket = 0;
+    ScalarFloat best_cost = dr::Infinity<ScalarFloat>;
+
+    auto bucket_index = [&](const LightBounds &b, uint32_t axis) {
+        ScalarFloat rel = (b.bbox.center()[axis] - centroid_bbox.min[axis]) /
+                          extents[axis];
+        return std::min((size_t) (rel * light_tree_buckets),
+                        light_tree_buckets - 1);
+    };
+
+    if (depth < light_tree_median_depth) {
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            if (!(extents[axis] > 0.f))
+                continue;
+
+            LightBounds buckets[light_tree_buckets];
+            for (size_t i = begin; i < end; ++i)
+                buckets[bucket_index(items[i].first, axis)].expand(items[i].first);
+
+            // Penalize splits along short axes of elongated nodes
+            ScalarFloat k_r = dr::max(extents) / extents[axis];
+
+            for (size_t split = 1; split < light_tree_buckets; ++split) {
+                LightBounds left, right;
+                for (size_t i = 0; i < split; ++i)
+                    left.expand(buckets[i]);
+                for (size_t i = split; i < light_tree_buckets; ++i)
+                    right.expand(buckets[i]);
+                if (!left.bbox.valid() || !right.bbox.valid())
+                    continue;
+
+                ScalarFloat c = k_r * (cost(left) + cost(right));
+                if (c < best_cost) {
+                    best_cost = c;
+                    best_axis = axis;
+                    best_bucket = (uint32_t) split;
+                }
+            }
+        }
+    }
+
+    size_t mid;
+    if (best_axis != (uint32_t) -1 && best_cost > 0.f) {
+        mid = std::partition(items.begin() + begin, items.begin() + end,
+                             [&](const auto &item) {
+                                 return bucket_index(item.first, best_axis) <
+                                        best_bucket;
+                             }) - items.begin();
+    } else {
+        /* Fall back to a median split along the longest axis, e.g. when all
+           emitters are points or have a zero sampling weight */
+        uint32_t axis = 0;
+        for (uint32_t i = 1; i < 3; ++i)
+            if (extents[i] > extents[axis])
+                axis = i;
+        mid = (begin + end) / 2;
+        std::nth_element(items.begin() + begin, items.begin() + mid,
+                         items.begin() + end,
+                         [axis](const auto &a, const auto &b) {
+                             return a.first.bbox.center()[axis] <
+                                    b.first.bbox.center()[axis];
+                         });
+    }
+
+    uint32_t children = (uint32_t) m_node_count;
+    m_node_count += 2;
+    info[node] = children;
+    parent[children] = parent[children + 1] = node;
+
+    build_node(items, nodes, info, parent, children, begin, mid, depth + 1);
+    build_node(items, nodes, info, parent, children + 1, mid, end, depth + 1);
+}
+
+MI_VARIANT Float LightTree<Float, Spectrum>::importance(const UInt32 &node,
+                                                        const Point3f &p,
+                                                        const Normal3f &n,
+                                                        Mask active) const {
+    UInt32 base = node * light_tree_node_size;
+    auto value = [&](uint32_t offset) {
+        return dr::gather<Float>(m_node_data, base + offset, active);
+    };
+
+    Point3f bbox_min(value(0), value(1), value(2)),
+            bbox_max(value(3), value(4), value(5));
+    Vector3f axis(value(6), value(7), value(8));
+    Float cos_theta_o = value(9), cos_theta_e = value(10), phi = value(11);
+
+    // Clamp the distance to the radius of the bounding sphere
+    Vector3f d = p - .5f * (bbox_min + bbox_max);
+    Float dist_2   = dr::squared_norm(d),
+          radius_2 = .25f * dr::squared_norm(bbox_max - bbox_min);
+    Mask outside = dist_2 > radius_2;
+    Vector3f wi = dr::select(dist_2 > 0.f, d * dr::rsqrt(dist_2), Vector3f(0.f));
+
+    // cos(max(0, a - b)) and sin(max(0, a - b)) in terms of sines and cosines
+    auto cos_sub = [](const Float &sin_a, const Float &cos_a,
+                      const Float &sin_b, const Float &cos_b) {
+        return dr::select(cos_a > cos_b, 1.f, cos_a * cos_b + sin_a * sin_b);
+    };
+    auto sin_sub = [](const Float &sin_a, const Float &cos_a,
+                      const Float &sin_b, const Float &cos_b) {
+        return dr::select(cos_a > cos_b, 0.f, sin_a * cos_b - cos_a * sin_b);
+    };
+
+    // Angle subtended by the bounding sphere as seen from the reference point
+    Float cos_theta_b = dr::select(outside, dr::safe_sqrt(1.f - radius_2 / dist_2), -1.f),
+          sin_theta_b = dr::safe_sqrt(1.f - dr::square(cos_theta_b));
+
+    // Smallest angle between the emission cone and the reference point
+    Float cos_theta_w = dr::dot(axis, wi),
+          sin_theta_w = dr::safe_sqrt(1.f - dr::square(cos_theta_w)),
+          sin_theta_o = dr::safe_sqrt(1.f - dr::square(cos_theta_o)),
+          cos_theta_x = cos_sub(sin_theta_w, cos_theta_w, sin_theta_o, cos_theta_o),
+          sin_theta_x = sin_sub(sin_theta_w, cos_theta_w, sin_theta_o, cos_theta_o),
+          cos_theta_p = cos_sub(sin_theta_x, cos_theta_x, sin_theta_b, cos_theta_b);
+
+    Float result = phi * dr::maximum(cos_theta_p, 0.f) /
+                   dr::maximum(dr::maximum(dist_2, radius_2), dr::Epsilon<Float>);
+
+    // Account for the foreshortening at surface interactions
+    Float cos_theta_i = dr::abs(dr::dot(wi, n)),
+          sin_theta_i = dr::safe_sqrt(1.f - dr::square(cos_theta_i));
+    dr::masked(result, dr::squared_norm(n) > 0.f) *=
+        cos_sub(sin_theta_i, cos_theta_i, sin_theta_b, cos_theta_b);
+
+    return dr::select(active && cos_theta_p > cos_theta_e, result, 0.f);
+}
+
+MI_VARIANT typename LightTree<Float, Spectrum>::UInt32
+LightTree<Float, Spectrum>::emitter_index(const EmitterPtr &emitter,
+                                          Mask active) const {
+    if constexpr (dr::is_jit_v<Float>) {
+        UInt32 id = dr::reinterpret_array<UInt32>(emitter);
+        active &= id < (uint32_t) m_registry_map.size();
+        return dr::select(active, dr::gather<UInt32>(m_registry_map, id, active),
+                          (uint32_t) -1);
+    } else {
+        if (!active || !emitter)
+            return (uint32_t) -1;
+        auto it = m_emitter_map.find(emitter);
+        return it != m_emitter_map.end() ? it->second : (uint32_t) -1;
+    }
+}
+
+MI_VARIANT std::tuple<typename LightTree<Float, Spectrum>::UInt32, Float, Float>
+LightTree<Float, Spectrum>::sample(const Interaction3f &ref, Float sample,
+                                   Mask active) const {
+    UInt32 index = (uint32_t) -1;
+    Float pmf = 0.f;
+    Mask tree = active && (m_node_count > 0);
+
+    if (m_infinite_distr) {
+        tree &= sample < m_tree_prob;
+        Mask infinite = active && !tree;
+        auto [slot, sample_re, pmf_inf] = m_infinite_distr->sample_reuse_pmf(
+            (sample - m_tree_prob) / (1.f - m_tree_prob), infinite);
+        dr::masked(index, infinite) =
+            dr::gather<UInt32>(m_infinite_index, slot, infinite);
+        dr::masked(pmf, infinite) = pmf_inf * (1.f - m_tree_prob);
+        dr::masked(sample, infinite) = sample_re;
+    }
+
+    if (m_node_count > 0) {
+        struct TraversalState {
+            UInt32 info;
+            Float pmf;
+            Float sample;
+            Mask active;
+            DRJIT_STRUCT(TraversalState, info, pmf, sample, active)
+        };
+
+        TraversalState s{
+            dr::gather<UInt32>(m_node_info, UInt32(0), tree),
+            Float(m_tree_prob),
+            dr::minimum(sample / m_tree_prob, dr::OneMinusEpsilon<Float>),
+            tree
+        };
+
+        dr::tie(s) = dr::while_loop(
+            dr::make_tuple(s),
+            [](const TraversalState &s) {
+                return s.active && (s.info & LeafFlag) == 0u;
+            },
+            [&](TraversalState &s) {
+                // Descend into one of the two children
+                UInt32 child = s.info;
+                Float importance_l = importance(child, ref.p, ref.n, s.active),
+                      importance_r = importance(child + 1u, ref.p, ref.n, s.active),
+                      total = importance_l + importance_r,
+                      prob_l = importance_l / total,
+                      prob_r = importance_r / total;
+
+                s.active &= total > 0.f;
+                Mask left = s.sample < prob_l;
+                s.sample = dr::minimum(
+                    dr::select(left, s.sample / prob_l, (s.sample - prob_l) / prob_r),
+                    dr::OneMinusEpsilon<Float>);
+                s.pmf *= dr::select(left, prob_l, prob_r);
+                s.info = dr::gather<UInt32>(m_node_info,
+                                            dr::select(left, child, child + 1u),
+                                            s.active);
+            });
+
+        Mask valid = tree && s.active;
+        dr::masked(index, valid) = s.info & ~LeafFlag;
+        dr::masked(pmf, valid) = s.pmf;
+        dr::masked(sample, tree) = s.sample;
+    }
+
+    return { index, dr::select(pmf > 0.f, dr::rcp(pmf), 0.f), sample };
+}
+
+MI_VARIANT Float LightTree<Float, Spectrum>::pmf(const Interaction3f &ref,
+                                                 const EmitterPtr &emitter,
+                                                 Mask active) const {
+    UInt32 index = emitter_index(emitter, active);
+    active &= index != (uint32_t) -1;
+
+    UInt32 node = dr::gather<UInt32>(m_emitter_node, index, active);
+    Mask infinite = active && (node & LeafFlag) != 0u,
+         tree = active && !infinite;
+    Float result = 0.f;
+
+    if (m_infinite_distr)
+        dr::masked(result, infinite) =
+            m_infinite_distr->eval_pmf_normalized(node & ~LeafFlag, infinite) *
+            (1.f - m_tree_prob);
+
+    if (m_node_count > 0) {
+        struct TraversalState {
+            UInt32 node;
+            Float pmf;
+            Mask active;
+            DRJIT_STRUCT(TraversalState, node, pmf, active)
+        };
+
+        TraversalState s{ node, Float(m_tree_prob), tree };
+
+        // Walk up to the root, accounting for the choice made at every level
+        dr::tie(s) = dr::while_loop(
+            dr::make_tuple(s),
+            [](const TraversalState &s) {
+                return s.active && s.node != 0u;
+            },
+            [&](TraversalState &s) {
+                UInt32 sibling = dr::select((s.node & 1u) != 0u, s.node + 1u,
+                                            s.node - 1u);
+                Float importance_n = importance(s.node, ref.p, ref.n, s.active),
+                      importance_s = importance(sibling, ref.p, ref.n, s.active),
+                      total = importance_n + importance_s;
+
+                s.pmf = dr::select(total > 0.f, s.pmf * (importance_n / total), 0.f);
+                s.active &= s.pmf > 0.f;
+                s.node = dr::gather<UInt32>(m_node_parent, s.node, s.active);
+            });
+
+        dr::masked(result, tree) = s.pmf;
+    }
+
+    return result;
+}
+
+MI_INSTANTIATE_STRUCT(LightTree)
+NAMESPACE_END(mitsuba)
@@ -89,7 +89,8 @@ Medium<Float, Spectrum>::transmittance_eval_pdf(const MediumInteraction3f &mi,
                                                 Mask active) const {
     MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
 
-    Float t      = dr::minimum(mi.t, si.t) - mi.mint;
+    // Surfaces in front of the sampled segment leave the ray unattenuated
+    Float t      = dr::maximum(0.f, dr::minimum(mi.t, si.t) - mi.mint);
     UnpolarizedSpectrum tr  = dr::exp(-t * mi.combined_extinction);
     UnpolarizedSpectrum pdf = dr::select(si.t < mi.t, tr, tr * mi.combined_extinction);
     return { tr, pdf };
@@ -165,6 +165,7 @@ MI_VARIANT Mesh<Float, Spectrum>::Mesh(const Properties &props) : Base(props) {
     // Use per-face instead of per-vertex normals? This will give a faceted appearance.
     m_face_normals = props.get<bool>("face_normals", false);
     m_flip_normals = props.get<bool>("flip_normals", false);
+    m_quantize     = props.get<bool>("quantize", false);
 
     if (props.has_property("filename")) {
         m_source_path = file_resolver()->resolve(
@@ -176,6 +177,12 @@ MI_VARIANT Mesh<Float, Spectrum>::Mesh(const Properties &props) : Base(props) {
         m_filename = std::string(props.id());
     }
 
+    // OptiX and Metal build their acceleration structures from float vertex
+    // buffers, hence only the CPU ray tracers can intersect quantized records
+    if (m_quantize && (dr::is_cuda_v<Float> || dr::is_metal_v<Float>))
+        Throw("Mesh \"%s\": quantized storage is only supported by CPU "
+              "variants.", m_filename);
+
     m_discontinuity_types = (uint32_t) DiscontinuityFlags::PerimeterType;
     m_shape_type = ShapeType::Mesh;
 }
@@ -388,18 +395,20 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_views() {
          texcoords = has_texcoords(),
          tangents  = packs_tangent();
 
-    const FloatBuffer &packed = m_packed_vertices;
+    // Quantized meshes expose their decoded records
+    FloatBuffer packed = vertex_records();
+    IndexBuffer packed_faces = face_records();
 
     m_faces = TensorXu32(
         element_view<IndexBuffer>(F, 3, [&](const UInt32 &f, const UInt32 &lane) {
-            return dr::gather<UInt32>(m_packed_faces, f * 4u + lane);
+            return dr::gather<UInt32>(packed_faces, f * 4u + lane);
         }),
         { F, 3 });
 
     if (has_face_bsdfs())
         m_bsdf_index = element_view<IndexBuffer>(
             F, 1, [&](const UInt32 &f, const UInt32 &) {
-                return dr::gather<UInt32>(m_packed_faces, f * 4u + 3u) &
+                return dr::gather<UInt32>(packed_faces, f * 4u + 3u) &
                        FaceBSDFIndexMask;
             });
     else
@@ -775,10 +784,11 @@ Mesh<Float, Spectrum>::geometric_faces() const {
     if (m_position_index.empty())
         return faces();
 
+    IndexBuffer packed_faces = face_records();
     return TensorXu32(
         element_view<IndexBuffer>(
             m_face_count, 3, [&](const UInt32 &f, const UInt32 &lane) {
-                UInt32 vi = dr::gather<UInt32>(m_packed_faces, f * 4u + lane);
+                UInt32 vi = dr::gather<UInt32>(packed_faces, f * 4u + lane);
                 return gather_map(m_position_index, vi);
             }),
         { m_face_count, 3 });
@@ -786,7 +796,11 @@ Mesh<Float, Spectrum>::geometric_faces() const {
 
 MI_VARIANT
 void Mesh<Float, Spectrum>::refresh(const ScalarBoundingBox3f *bbox) {
-    if (bbox)
+    // Quantization releases the packed records and derives the bounding box
+    // from the decoded positions
+    if (m_quantize)
+        quantize();
+    else if (bbox)
         m_bbox = *bbox;
     else
         recompute_bbox();
@@ -807,6 +821,15 @@ void Mesh<Float, Spectrum>::refresh(const ScalarBoundingBox3f *bbox) {
 #if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
     m_packed_vertices_ptr = m_packed_vertices.data();
     m_packed_faces_ptr = m_packed_faces.data();
+    bool quantized_faces = !m_quantized_faces.empty();
+    m_quantized_vertices_ptr =
+        is_quantized() ? m_quantized_vertices.data() : nullptr;
+    m_quantized_clusters_ptr =
+        is_quantized() ? m_quantized_clusters.data() : nullptr;
+    m_quantized_faces_ptr =
+        quantized_faces ? m_quantized_faces.data() : nullptr;
+    m_quantized_face_base_ptr =
+        quantized_faces ? m_quantized_face_base.data() : nullptr;
 #endif
 
     mark_dirty();
@@ -814,8 +837,12 @@ void Mesh<Float, Spectrum>::refresh(const ScalarBoundingBox3f *bbox) {
     if (!m_initialized)
         Base::initialize();
 
-    // Potentially rebuild views into the new packed state
-    if (m_built && !m_positions.array().empty())
+    /* Potentially rebuild views into the new packed state. Decoded views of
+       quantized records would keep a full-precision copy of the mesh
+       resident, hence they are released and recreated on demand. */
+    if (is_quantized())
+        drop_views();
+    else if (m_built && !m_positions.array().empty())
         build_views();
 }
 
@@ -873,9 +900,19 @@ MI_VARIANT void Mesh<Float, Spectrum>::parameters_changed(const std::vector<std:
         if (has("normal_index"))
             m_normal_rep = IndexBuffer();
 
+        uint32_t dirty_flags = m_dirty_flags;
+        ScalarSize vertex_count = m_vertex_count,
+                   face_count   = m_face_count;
+
         pack(/* regenerate_normals */
              (topology || has("positions")) && !has("normals"),
              /* flip_normals */ false, /* updating */ true);
+
+        /* pack() conservatively flags a topology change. If the faces were
+           left alone, the acceleration data structure can simply be refit. */
+        if (!topology && vertex_count == m_vertex_count &&
+            face_count == m_face_count)
+            m_dirty_flags = dirty_flags | (uint32_t) ShapeDirtyFlags::Vertices;
     } else if (needs_tangents() != packs_tangent()) {
         // Nothing of the mesh itself changed, but the notification may
         // originate from the attached BSDF, whose flags decide the layout
@@ -961,8 +998,8 @@ MI_VARIANT void Mesh<Float, Spectrum>::write_ply(Stream *stream) const {
                   " groups, and %u vertices. Only seamless meshes where these agree are supported.",
             m_filename, m_position_count, m_normal_count, m_vertex_count);
 
-    const FloatBuffer &vertices = dr::migrate(m_packed_vertices, JitBackend::None);
-    const IndexBuffer &faces = dr::migrate(m_packed_faces, JitBackend::None);
+    const FloatBuffer &vertices = dr::migrate(vertex_records(), JitBackend::None);
+    const IndexBuffer &faces = dr::migrate(face_records(), JitBackend::None);
 
     using NamedAttribute = std::pair<std::string, MeshAttribute>;
     std::vector<NamedAttribute> vertex_attributes;
@@ -1089,8 +1126,8 @@ MI_VARIANT void Mesh<Float, Spectrum>::write_serialized(const fs::path &filename
 }
 
 MI_VARIANT void Mesh<Float, Spectrum>::write_serialized(Stream *stream) const {
-    const FloatBuffer &vertices_host = dr::migrate(m_packed_vertices, JitBackend::None);
-    const IndexBuffer &faces_host    = dr::migrate(m_packed_faces, JitBackend::None);
+    const FloatBuffer &vertices_host = dr::migrate(vertex_records(), JitBackend::None);
+    const IndexBuffer &faces_host    = dr::migrate(face_records(), JitBackend::None);
     const IndexBuffer &pidx_host     = dr::migrate(m_position_index, JitBackend::None);
     const IndexBuffer &nidx_host     = dr::migrate(m_normal_index, JitBackend::None);
 
@@ -1119,36 +1156,44 @@ MI_VARIANT void Mesh<Float, Spectrum>::write_serialized(Stream *stream) const {
     stream->write(SerializedMagic);
     stream->write(SerializedVersion);
 
-    ref<ZStream> z = new ZStream(stream);
-    z->set_byte_order(Stream::ELittleEndian);
-    z->write(flags);
-    z->write(m_filename);
-    z->write((uint64_t) m_vertex_count);
-    z->write((uint64_t) m_face_count);
-    z->write((uint64_t) (pmap ? m_position_count : 0));
-    z->write((uint64_t) (nmap ? m_normal_count : 0));
-
-    z->write_array(vertices_host.data(),
-                   (size_t) m_vertex_count * MeshVertexStride);
-    z->write_array(faces_host.data(),
-                   (size_t) m_face_count * MeshFaceStride);
+    // Uncompressed header, which describes the size of every array
+    stream->write(flags);
+    stream->write(m_filename);
+    stream->write((uint64_t) m_vertex_count);
+    stream->write((uint64_t) m_face_count);
+    stream->write((uint64_t) (pmap ? m_position_count : 0));
+    stream->write((uint64_t) (nmap ? m_normal_count : 0));
+    stream->write(SerializedBlockSize);
+
+    stream->write((uint32_t) attributes.size());
+    for (const auto &[name, attribute] : attributes) {
+        stream->write(name);
+        stream->write((uint8_t) (holds_rgb2spec_coeffs(name, attribute.dim) ? 1
+                                                                           : 0));
+        stream->write((uint32_t) attribute.dim);
+    }
+
+    // The arrays follow as independently compressed blocks
+    std::vector<SerializedArray> arrays = {
+        { (void *) vertices_host.data(),
+          (size_t) m_vertex_count * MeshVertexStride * sizeof(InputFloat) },
+        { (void *) faces_host.data(),
+          (size_t) m_face_count * MeshFaceStride * sizeof(ScalarIndex) }
+    };
     if (pmap)
-        z->write_array(pidx_host.data(), m_vertex_count);
+        arrays.push_back({ (void *) pidx_host.data(),
+                           (size_t) m_vertex_count * sizeof(ScalarIndex) });
     if (nmap)
-        z->write_array(nidx_host.data(), m_vertex_count);
-
-    z->write((uint32_t) attributes.size());
+        arrays.push_back({ (void *) nidx_host.data(),
+                           (size_t) m_vertex_count * sizeof(ScalarIndex) });
     for (const auto &[name, attribute] : attributes) {
-        z->write(name);
-        z->write((uint8_t) (holds_rgb2spec_coeffs(name, attribute.dim) ? 1
-                                                                      : 0));
-        z->write((uint32_t) attribute.dim);
         size_t rows = is_vertex_attribute(name) ? m_vertex_count
                                                 : m_face_count;
-        z->write_array(attribute.data.array().data(), rows * attribute.dim);
+        arrays.push_back({ (void *) attribute.data.array().data(),
+                           rows * attribute.dim * sizeof(InputFloat) });
     }
 
-    z->close();
+    write_serialized_blocks(stream, arrays);
 }
 
 MI_VARIANT void Mesh<Float, Spectrum>::recompute_normals() {
@@ -1355,6 +1400,87 @@ MI_VARIANT void Mesh<Float, Spectrum>::recompute_bbox() {
         /* Stride = */ MeshVertexStride>(m_packed_vertices, m_vertex_count);
 }
 
+MI_VARIANT size_t Mesh<Float, Spectrum>::storage_size() const {
+    return (m_packed_vertices.size() + m_quantized_clusters.size()) *
+               sizeof(InputFloat) +
+           (m_quantized_vertices.size() + m_packed_faces.size() +
+            m_quantized_faces.size() + m_quantized_face_base.size()) *
+               sizeof(ScalarIndex);
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::quantize() {
+    bool vertices = !m_packed_vertices.empty(),
+         faces    = !m_packed_faces.empty();
+    if (!vertices && !faces)
+        return;
+
+    if (dr::grad_enabled(m_packed_vertices))
+        Throw("Mesh \"%s\": quantized meshes are not differentiable.",
+              m_filename);
+
+    const FloatBuffer &vertices_host = dr::migrate(m_packed_vertices, JitBackend::None);
+    const IndexBuffer &faces_host    = dr::migrate(m_packed_faces, JitBackend::None);
+    if constexpr (dr::is_jit_v<Float>)
+        dr::sync_thread();
+
+    Timer timer;
+    QuantizedMesh qm = quantize_packed_mesh(
+        vertices ? vertices_host.data() : nullptr, m_vertex_count,
+        faces ? faces_host.data() : nullptr, m_face_count);
+
+    if (vertices) {
+        m_quantized_vertices =
+            dr::load<IndexBuffer>(qm.vertices.data(), qm.vertices.size());
+        m_quantized_clusters =
+            dr::load<FloatBuffer>(qm.clusters.data(), qm.clusters.size());
+        m_quantization_error = qm.position_error;
+        m_bbox = qm.bbox;
+        m_packed_vertices = FloatBuffer();
+    }
+
+    if (faces) {
+        if (qm.faces.size() == 0) {
+            m_quantized_faces = m_quantized_face_base = IndexBuffer();
+            Log(Debug, "Mesh \"%s\": storing full-precision face records, "
+                       "since a face cluster spans more than 65536 vertices "
+                       "or uses a BSDF index above 32767.", m_filename);
+        } else {
+            m_quantized_faces =
+                dr::load<IndexBuffer>(qm.faces.data(), qm.faces.size());
+            m_quantized_face_base =
+                dr::load<IndexBuffer>(qm.face_base.data(), qm.face_base.size());
+            m_packed_faces = IndexBuffer();
+        }
+    }
+
+    size_t full = (size_t) m_vertex_count * MeshVertexStride * sizeof(InputFloat) +
+                  (size_t) m_face_count * MeshFaceStride * sizeof(ScalarIndex);
+
+    Log(Info, "Mesh \"%s\": quantized to %s instead of %s (position error "
+              "%g, texcoord error %g, took %s)", m_filename,
+        util::mem_string(storage_size()), util::mem_string(full),
+        m_quantization_error, qm.texcoord_error,
+        util::time_string((float) timer.value()));
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::FloatBuffer
+Mesh<Float, Spectrum>::vertex_records() const {
+    if (!is_quantized())
+        return m_packed_vertices;
+
+    return interleaved<MeshVertexStride, FloatBuffer>(
+        m_vertex_count, [&](const UInt32 &v) { return packed_vertex(v); });
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::IndexBuffer
+Mesh<Float, Spectrum>::face_records() const {
+    if (m_quantized_faces.empty())
+        return m_packed_faces;
+
+    return interleaved<MeshFaceStride, IndexBuffer>(
+        m_face_count, [&](const UInt32 &f) { return packed_face(f); });
+}
+
 MI_VARIANT void Mesh<Float, Spectrum>::build_pmf() {
     if (m_face_count == 0)
         Throw("Cannot create sampling table for an empty mesh: %s", to_string());
@@ -1464,7 +1590,7 @@ Mesh<Float, Spectrum>::merge(const std::vector<Shape<Float, Spectrum> *> &shapes
         return std::make_tuple(
             m->emitter(), m->sensor(), m->bsdf(), m->interior_medium(),
             m->exterior_medium(), m->has_normals(), m->has_texcoords(),
-            m->has_face_normals(), m->packs_tangent());
+            m->has_face_normals(), m->packs_tangent(), m->m_quantize);
     };
 
     size_t V = 0, F = 0, P = 0, N = 0;
@@ -1506,9 +1632,12 @@ Mesh<Float, Spectrum>::merge(const std::vector<Shape<Float, Spectrum> *> &shapes
         if (nv == 0)
             continue;
 
+        FloatBuffer src_vertices = m->vertex_records();
+        IndexBuffer src_faces    = m->face_records();
+
         if constexpr (dr::is_jit_v<Float>) {
             UInt32 voff = dr::opaque<UInt32>((uint32_t) vbase);
-            dr::scatter(vertices, m->m_packed_vertices,
+            dr::scatter(vertices, src_vertices,
                         dr::arange<IndexBuffer>(nv * MeshVertexStride) +
                             dr::opaque<UInt32>((uint32_t) (vbase *
                                                            MeshVertexStride)),
@@ -1517,19 +1646,19 @@ Mesh<Float, Spectrum>::merge(const std::vector<Shape<Float, Spectrum> *> &shapes
             if (nf > 0) {
                 IndexBuffer j = dr::arange<IndexBuffer>(nf * MeshFaceStride);
                 dr::scatter(faces,
-                            dr::select((j & 3u) == 3u, m->m_packed_faces,
-                                       m->m_packed_faces + voff),
+                            dr::select((j & 3u) == 3u, src_faces,
+                                       src_faces + voff),
                             j + dr::opaque<UInt32>(
                                     (uint32_t) (fbase * MeshFaceStride)),
                             true, ReduceMode::NoConflicts);
             }
         } else {
             std::memcpy(vertices.data() + vbase * MeshVertexStride,
-                        m->m_packed_vertices.data(),
+                        src_vertices.data(),
                         nv * MeshVertexStride * sizeof(InputFloat));
 
             ScalarIndex *d = faces.data() + fbase * MeshFaceStride;
-            const ScalarIndex *s = m->m_packed_faces.data();
+            const ScalarIndex *s = src_faces.data();
             for (size_t j = 0; j < nf * MeshFaceStride; ++j)
                 d[j] = s[j] + ((j & 3) == 3 ? 0u : (ScalarIndex) vbase);
         }
@@ -1574,6 +1703,7 @@ Mesh<Float, Spectrum>::merge(const std::vector<Shape<Float, Spectrum> *> &shapes
     set_object("sensor", first->m_sensor.get());
     set_object("emitter", first->m_emitter.get());
     props.set("face_normals", first->has_face_normals());
+    props.set("quantize", first->m_quantize);
 
     ref<Mesh> result = new Mesh(props);
     result->m_filename = filename;
@@ -1610,7 +1740,7 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_parameterization() {
     mesh_props.set("face_normals", true);
     ref<Mesh> mesh = new Mesh(mesh_props);
 
-    const FloatBuffer &packed_host = dr::migrate(m_packed_vertices, JitBackend::None);
+    const FloatBuffer &packed_host = dr::migrate(vertex_records(), JitBackend::None);
     if constexpr (dr::is_jit_v<Float>)
         dr::sync_thread();
 
@@ -1630,7 +1760,7 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_parameterization() {
 
     mesh->from_packed(
         Layout::Positions,
-        TensorXu32(m_packed_faces, { m_face_count, MeshFaceStride }),
+        TensorXu32(face_records(), { m_face_count, MeshFaceStride }),
         TensorXf32(dr::load<FloatBuffer>(rec.data(), rec.size()),
                    { m_vertex_count, MeshVertexStride }),
         IndexBuffer(), IndexBuffer(), 0, 0, &bbox);
@@ -2076,10 +2206,13 @@ auto Mesh<Float, Spectrum>::precompute_silhouette(
         using Vec3f = ScalarVector3f;
         using Pt3f  = ScalarPoint3f;
 
-        const InputFloat *V          = m_packed_vertices.data();
+        FloatBuffer vertices = vertex_records();
+        IndexBuffer faces    = face_records();
+
+        const InputFloat *V          = vertices.data();
         const size_t vstride         = MeshVertexStride;
         const ScalarIndex *E2E_data  = dedge()->E2E().data();
-        const ScalarIndex *face_data = m_packed_faces.data();
+        const ScalarIndex *face_data = faces.data();
 
         ScalarIndex prim_count = 0u;
         std::vector<ScalarIndex> indices(m_face_count * 3u);
@@ -2746,6 +2879,9 @@ MI_VARIANT std::string Mesh<Float, Spectrum>::to_string() const {
         << "  face_count = " << m_face_count << "," << std::endl
         << "  faces = [" << util::mem_string(face_data_bytes() * m_face_count) << " of face data]," << std::endl;
 
+    if (is_quantized())
+        oss << "  quantization_error = " << m_quantization_error << "," << std::endl;
+
     if (!m_area_pmf.empty())
         oss << "  surface_area = " << m_area_pmf.sum() << "," << std::endl;
 
@@ -2795,6 +2931,12 @@ MI_VARIANT size_t Mesh<Float, Spectrum>::face_data_bytes() const {
 
 MI_VARIANT void
 Mesh<Float, Spectrum>::describe(ShapeIR &g) const {
+    // Quantized records are decoded by the per-primitive intersection routines
+    if (is_quantized()) {
+        Base::describe(g);
+        return;
+    }
+
     g.kind = ShapeIR::Kind::Triangles;
     g.type = m_shape_type;
     g.ctx = this;
@@ -2,8 +2,14 @@
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/stream.h>
+#include <mitsuba/core/zstream.h>
+#include <drjit-core/half.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
+#include <memory>
 #include <utility>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -510,4 +516,241 @@ PackedMesh corner_to_packed_mesh(
     return pm;
 }
 
+size_t QuantizedMesh::memory() const {
+    return (vertices.size() + faces.size() + face_base.size()) *
+               sizeof(uint32_t) + clusters.size() * sizeof(float);
+}
+
+QuantizedMesh quantize_packed_mesh(const float *vertices, size_t vertex_count,
+                                   const uint32_t *faces, size_t face_count) {
+    using ScalarPoint3f  = Point<float, 3>;
+    using ScalarVector3f = Vector<float, 3>;
+    using ScalarBoundingBox3f = BoundingBox<ScalarPoint3f>;
+    using Record = dr::Array<uint32_t, QuantizedVertexStride>;
+
+    QuantizedMesh qm;
+    if (!vertices)
+        vertex_count = 0;
+    if (!faces)
+        face_count = 0;
+
+    size_t vclusters = (vertex_count + QuantizedVertexCluster - 1) /
+                       QuantizedVertexCluster,
+           fclusters = (face_count + QuantizedFaceCluster - 1) /
+                       QuantizedFaceCluster;
+
+    qm.vertices = alloc<uint32_t>(JitBackend::None,
+                                  vertex_count * QuantizedVertexStride);
+    qm.clusters = alloc<float>(JitBackend::None,
+                               vclusters * QuantizedClusterStride);
+
+    // Per-cluster bounding boxes and errors, reduced at the end
+    std::vector<ScalarBoundingBox3f> bboxes(vclusters);
+    std::vector<float> position_error(vclusters, 0.f),
+                       texcoord_error(vclusters, 0.f);
+
+    auto snorm = [](float value) {
+        float v = std::rint(dr::clip(value, -1.f, 1.f) * 32767.f);
+        return (uint32_t) (uint16_t) (int16_t) v;
+    };
+
+    auto half = [](float value) {
+        return (uint32_t) dr::half(dr::clip(value, -65504.f, 65504.f)).value;
+    };
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, vclusters, 16),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t c = range.begin(); c != range.end(); ++c) {
+                size_t v0 = c * QuantizedVertexCluster,
+                       v1 = std::min(v0 + QuantizedVertexCluster, vertex_count);
+
+                ScalarBoundingBox3f bbox;
+                for (size_t v = v0; v < v1; ++v)
+                    bbox.expand(dr::load<ScalarPoint3f>(
+                        vertices + v * MeshVertexStride + PackedPositionOffset));
+
+                ScalarPoint3f offset = bbox.min;
+                ScalarVector3f scale = bbox.extents() * (1.f / 65535.f);
+                dr::store(qm.clusters.data() + c * QuantizedClusterStride,
+                          offset);
+                dr::store(qm.clusters.data() + c * QuantizedClusterStride + 3,
+                          scale);
+
+                ScalarBoundingBox3f decoded_bbox;
+                float perr = 0.f, terr = 0.f;
+
+                for (size_t v = v0; v < v1; ++v) {
+                    const float *rec = vertices + v * MeshVertexStride;
+
+                    uint32_t q[3];
+                    for (uint32_t k = 0; k < 3; ++k) {
+                        float t = scale[k] > 0.f
+                            ? (rec[PackedPositionOffset + k] - offset[k]) /
+                                  scale[k]
+                            : 0.f;
+                        q[k] = (uint32_t) dr::clip(std::rint(t), 0.f, 65535.f);
+                    }
+
+                    const float *f  = rec + PackedFrameOffset,
+                                *uv = rec + PackedTexcoordOffset;
+
+                    Record w(q[0] | q[1] << 16,
+                             q[2] | snorm(f[0]) << 16,
+                             snorm(f[1]) | snorm(f[2]) << 16,
+                             half(uv[0]) | half(uv[1]) << 16);
+                    dr::store(qm.vertices.data() + v * QuantizedVertexStride,
+                              w);
+
+                    // Measure the error of the decoded record
+                    auto dec = quantized_vertex(w, offset, scale);
+                    ScalarPoint3f p(dec[PackedPositionOffset],
+                                    dec[PackedPositionOffset + 1],
+                                    dec[PackedPositionOffset + 2]);
+                    decoded_bbox.expand(p);
+                    perr = std::max(perr, dr::norm(p - dr::load<ScalarPoint3f>(
+                                              rec + PackedPositionOffset)));
+                    for (uint32_t k = 0; k < 2; ++k)
+                        terr = std::max(
+                            terr,
+                            std::abs(dec[PackedTexcoordOffset + k] - uv[k]));
+                }
+
+                bboxes[c] = decoded_bbox;
+                position_error[c] = perr;
+                texcoord_error[c] = terr;
+            }
+        }
+    );
+
+    for (size_t c = 0; c < vclusters; ++c) {
+        qm.bbox.expand(bboxes[c]);
+        qm.position_error = std::max(qm.position_error, position_error[c]);
+        qm.texcoord_error = std::max(qm.texcoord_error, texcoord_error[c]);
+    }
+
+    if (face_count == 0)
+        return qm;
+
+    qm.faces = alloc<uint32_t>(JitBackend::None,
+                               face_count * QuantizedFaceStride);
+    qm.face_base = alloc<uint32_t>(JitBackend::None, fclusters);
+
+    // Clusters whose offsets or flags overflow 16 bits leave the face
+    // records unquantized
+    std::atomic<bool> overflow = false;
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, fclusters, 64),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t c = range.begin(); c != range.end(); ++c) {
+                size_t f0 = c * QuantizedFaceCluster,
+                       f1 = std::min(f0 + QuantizedFaceCluster, face_count);
+
+                uint32_t base = 0xFFFFFFFFu;
+                for (size_t f = f0; f < f1; ++f)
+                    for (uint32_t k = 0; k < 3; ++k)
+                        base = std::min(base, faces[f * MeshFaceStride + k]);
+                qm.face_base.data()[c] = base;
+
+                for (size_t f = f0; f < f1; ++f) {
+                    const uint32_t *rec = faces + f * MeshFaceStride;
+                    uint32_t d[3], bsdf = rec[3] & FaceBSDFIndexMask;
+                    for (uint32_t k = 0; k < 3; ++k)
+                        d[k] = rec[k] - base;
+
+                    if (std::max({ d[0], d[1], d[2] }) > 0xFFFFu ||
+                        bsdf > QuantizedFaceBSDFIndexMask) {
+                        overflow = true;
+                        return;
+                    }
+
+                    uint32_t flags =
+                        bsdf | ((rec[3] & FaceUVFlipped) ? QuantizedFaceUVFlipped
+                                                         : 0u);
+                    uint32_t *out = qm.faces.data() + f * QuantizedFaceStride;
+                    out[0] = d[0] | d[1] << 16;
+                    out[1] = d[2] | flags << 16;
+                }
+            }
+        }
+    );
+
+    if (overflow) {
+        qm.faces.reset();
+        qm.face_base.reset();
+    }
+
+    return qm;
+}
+
+/// Cut the arrays of a version 6 ``.serialized`` mesh into blocks
+static std::vector<std::pair<uint8_t *, size_t>>
+serialized_blocks(const std::vector<SerializedArray> &arrays,
+                  uint32_t block_size) {
+    if (block_size == 0)
+        Throw("Serialized mesh: invalid block size!");
+
+    // Blocks hold the raw in-memory arrays, which must be little endian
+    if (Stream::host_byte_order() != Stream::ELittleEndian)
+        Throw("Serialized mesh: block compression requires a little endian "
+              "host!");
+
+    std::vector<std::pair<uint8_t *, size_t>> blocks;
+    for (const SerializedArray &array : arrays) {
+        for (size_t offset = 0; offset < array.size; offset += block_size)
+            blocks.emplace_back((uint8_t *) array.data + offset,
+                                std::min((size_t) block_size,
+                                         array.size - offset));
+    }
+    return blocks;
+}
+
+void write_serialized_blocks(Stream *stream,
+                             const std::vector<SerializedArray> &arrays,
+                             uint32_t block_size) {
+    auto blocks = serialized_blocks(arrays, block_size);
+
+    std::vector<std::vector<uint8_t>> compressed(blocks.size());
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, blocks.size(), 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i)
+                compressed[i] = ZStream::compress_block(blocks[i].first,
+                                                        blocks[i].second);
+        }
+    );
+
+    for (const std::vector<uint8_t> &block : compressed)
+        stream->write((uint32_t) block.size());
+    for (const std::vector<uint8_t> &block : compressed)
+        stream->write(block.data(), block.size());
+}
+
+void read_serialized_blocks(Stream *stream,
+                            const std::vector<SerializedArray> &arrays,
+                            uint32_t block_size) {
+    auto blocks = serialized_blocks(arrays, block_size);
+
+    std::vector<uint32_t> sizes(blocks.size());
+    stream->read_array(sizes.data(), sizes.size());
+
+    std::vector<size_t> offsets(blocks.size() + 1, 0);
+    for (size_t i = 0; i < blocks.size(); ++i)
+        offsets[i + 1] = offsets[i] + sizes[i];
+
+    // Fetch the whole payload at once, then decompress it in parallel
+    std::unique_ptr<uint8_t[]> payload(new uint8_t[offsets.back()]);
+    stream->read(payload.get(), offsets.back());
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, blocks.size(), 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i)
+                ZStream::decompress_block(payload.get() + offsets[i], sizes[i],
+                                          blocks[i].first, blocks[i].second);
+        }
+    );
+}
+
 NAMESPACE_END(mitsuba)
@@ -7,5 +7,6 @@ MI_PY_EXPORT(FilmFlags) {
         .def_value(FilmFlags, Empty)
         .def_value(FilmFlags, Alpha)
         .def_value(FilmFlags, Spectral)
-        .def_value(FilmFlags, Special);
+        .def_value(FilmFlags, Special)
+        .def_value(FilmFlags, Streaming);
 }
@@ -23,8 +23,14 @@ MI_PY_EXPORT(ImageBlock) {
              "coalesce"_a = dr::is_jit_v<Float>,
              "warn_negative"_a = std::is_scalar_v<Float>,
              "warn_invalid"_a  = std::is_scalar_v<Float>)
-        .def("put_block", &ImageBlock::put_block, D(ImageBlock, put_block),
-             "block"_a)
+        .def("put_block",
+             nb::overload_cast<const ImageBlock *>(&ImageBlock::put_block),
+             D(ImageBlock, put_block), "block"_a)
+        .def("put_block",
+             nb::overload_cast<const ImageBlock *, const ScalarPoint2i &,
+                               const ScalarVector2i &>(&ImageBlock::put_block),
+             D(ImageBlock, put_block, 2), "block"_a, "region_offset"_a,
+             "region_size"_a)
         .def("put",
              nb::overload_cast<const Point2f &, const wavelength_t<Spectrum> &,
                                const Spectrum &, Float, Float,
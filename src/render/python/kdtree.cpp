@@ -0,0 +1,61 @@
+#include <mitsuba/render/kdtree.h>
+#include <mitsuba/python/python.h>
+#include <nanobind/stl/array.h>
+#include <nanobind/stl/string.h>
+
+MI_PY_EXPORT(KDTreeBuildReport) {
+    nb::class_<KDTreeBuildReport>(m, "KDTreeBuildReport", D(KDTreeBuildReport))
+        .def_ro("total_time", &KDTreeBuildReport::total_time,
+                D(KDTreeBuildReport, total_time))
+        .def_ro("construction_time", &KDTreeBuildReport::construction_time,
+                D(KDTreeBuildReport, construction_time))
+        .def_ro("binning_time", &KDTreeBuildReport::binning_time,
+                D(KDTreeBuildReport, binning_time))
+        .def_ro("event_sort_time", &KDTreeBuildReport::event_sort_time,
+                D(KDTreeBuildReport, event_sort_time))
+        .def_ro("compaction_time", &KDTreeBuildReport::compaction_time,
+                D(KDTreeBuildReport, compaction_time))
+        .def_ro("statistics_time", &KDTreeBuildReport::statistics_time,
+                D(KDTreeBuildReport, statistics_time))
+        .def_ro("cost", &KDTreeBuildReport::cost,
+                D(KDTreeBuildReport, cost))
+        .def_ro("expected_traversals", &KDTreeBuildReport::expected_traversals,
+                D(KDTreeBuildReport, expected_traversals))
+        .def_ro("expected_leaf_visits", &KDTreeBuildReport::expected_leaf_visits,
+                D(KDTreeBuildReport, expected_leaf_visits))
+        .def_ro("expected_primitive_visits", &KDTreeBuildReport::expected_primitive_visits,
+                D(KDTreeBuildReport, expected_primitive_visits))
+        .def_ro("primitive_count", &KDTreeBuildReport::primitive_count,
+                D(KDTreeBuildReport, primitive_count))
+        .def_ro("index_count", &KDTreeBuildReport::index_count,
+                D(KDTreeBuildReport, index_count))
+        .def_ro("duplication_factor", &KDTreeBuildReport::duplication_factor,
+                D(KDTreeBuildReport, duplication_factor))
+        .def_ro("node_count", &KDTreeBuildReport::node_count,
+                D(KDTreeBuildReport, node_count))
+        .def_ro("leaf_count", &KDTreeBuildReport::leaf_count,
+                D(KDTreeBuildReport, leaf_count))
+        .def_ro("nonempty_leaf_count", &KDTreeBuildReport::nonempty_leaf_count,
+                D(KDTreeBuildReport, nonempty_leaf_count))
+        .def_ro("max_depth", &KDTreeBuildReport::max_depth,
+                D(KDTreeBuildReport, max_depth))
+        .def_ro("max_leaf_size", &KDTreeBuildReport::max_leaf_size,
+                D(KDTreeBuildReport, max_leaf_size))
+        .def_ro("leaf_histogram", &KDTreeBuildReport::leaf_histogram,
+                D(KDTreeBuildReport, leaf_histogram))
+        .def_ro("retracted_splits", &KDTreeBuildReport::retracted_splits,
+                D(KDTreeBuildReport, retracted_splits))
+        .def_ro("bad_refines", &KDTreeBuildReport::bad_refines,
+                D(KDTreeBuildReport, bad_refines))
+        .def_ro("pruned", &KDTreeBuildReport::pruned,
+                D(KDTreeBuildReport, pruned))
+        .def_ro("work_units", &KDTreeBuildReport::work_units,
+                D(KDTreeBuildReport, work_units))
+        .def_ro("subtree_tasks", &KDTreeBuildReport::subtree_tasks,
+                D(KDTreeBuildReport, subtree_tasks))
+        .def_ro("temp_storage", &KDTreeBuildReport::temp_storage,
+                D(KDTreeBuildReport, temp_storage))
+        .def_ro("cached", &KDTreeBuildReport::cached,
+                D(KDTreeBuildReport, cached))
+        .def("__repr__", &KDTreeBuildReport::to_string);
+}
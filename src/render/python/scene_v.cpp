@@ -96,6 +96,10 @@ MI_PY_EXPORT(Scene) {
              "ss"_a, "active"_a = true,
              D(Scene, invert_silhouette_sample))
         .def("shape_types", &Scene::shape_types, D(Scene, shape_types))
+        .def("kdtree_build_report", &Scene::kdtree_build_report,
+             nb::rv_policy::reference_internal, D(Scene, kdtree_build_report))
+        .def_method(Scene, accel_quality)
+        .def_method(Scene, accel_build_time)
         // Accessors
         .def_method(Scene, bbox)
         .def("sensors",
@@ -158,6 +162,7 @@ MI_PY_EXPORT(Scene) {
              },
              D(Scene, integrator))
         .def_method(Scene, shapes_grad_enabled)
+        .def_method(Scene, needs_uv_partials)
         .def("__repr__", &Scene::to_string);
 
     dr::bind_traverse(scene);
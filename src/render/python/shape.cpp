@@ -33,4 +33,9 @@ MI_PY_EXPORT(DiscontinuityFlags) {
         .def_value(ShapeType, Ellipsoids)
         .def_value(ShapeType, EllipsoidsMesh)
         .def_value(ShapeType, Invalid);
+
+    nb::enum_<AccelQuality>(m, "AccelQuality", D(AccelQuality))
+        .def_value(AccelQuality, Low)
+        .def_value(AccelQuality, Medium)
+        .def_value(AccelQuality, High);
 }
@@ -574,6 +574,10 @@ MI_PY_EXPORT(Shape) {
 
         .def("has_tangents", &Mesh::has_tangents, D(Mesh, has_tangents))
         .def("packs_tangent", &Mesh::packs_tangent, D(Mesh, packs_tangent))
+        .def("is_quantized", &Mesh::is_quantized, D(Mesh, is_quantized))
+        .def("quantization_error", &Mesh::quantization_error,
+             D(Mesh, quantization_error))
+        .def("storage_size", &Mesh::storage_size, D(Mesh, storage_size))
         .def("recompute_normals", &Mesh::recompute_normals,
              D(Mesh, recompute_normals))
         .def("transform", &Mesh::transform, "t"_a, D(Mesh, transform))
@@ -6,8 +6,9 @@
 MI_PY_EXPORT(Spiral) {
     using Vector2u = typename Spiral::Vector2u;
     MI_PY_CLASS(Spiral, Object)
-        .def(nb::init<Vector2u, Vector2u, uint32_t, uint32_t>(),
+        .def(nb::init<Vector2u, Vector2u, uint32_t, uint32_t, bool>(),
             "size"_a, "offset"_a, "block_size"_a = MI_BLOCK_SIZE, "passes"_a = 1,
+            "scanline"_a = false,
             D(Spiral, Spiral))
         .def_method(Spiral, max_block_size)
         .def_method(Spiral, block_count)
@@ -83,6 +83,10 @@ public:
         NB_OVERRIDE(is_spatially_varying);
     }
 
+    bool needs_uv_partials() const override {
+        NB_OVERRIDE(needs_uv_partials);
+    }
+
     std::string to_string() const override {
         NB_OVERRIDE(to_string);
     }
@@ -150,7 +154,10 @@ template <typename Ptr, typename Cls> void bind_texture_generic(Cls &cls) {
              D(Texture, max))
         .def("is_spatially_varying",
              [](Ptr texture) { return texture->is_spatially_varying(); },
-             D(Texture, is_spatially_varying));
+             D(Texture, is_spatially_varying))
+        .def("needs_uv_partials",
+             [](Ptr texture) { return texture->needs_uv_partials(); },
+             D(Texture, needs_uv_partials));
 }
 
 MI_PY_EXPORT(Texture) {
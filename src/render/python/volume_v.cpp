@@ -85,6 +85,14 @@ MI_PY_EXPORT(Volume) {
                 return max_values;
             },
             D(Volume, max_per_channel))
+        .def("max_grid",
+            [] (const Volume *volume, const ScalarVector3u &res) {
+                std::vector<ScalarFloat> values(dr::prod(res));
+                volume->max_grid(res, values.data());
+                return values;
+            },
+            "res"_a, D(Volume, max_grid))
+        .def_method(Volume, to_local)
         .def_method(Volume, eval, "it"_a, "active"_a = true)
         .def_method(Volume, eval_1, "it"_a, "active"_a = true)
         .def_method(Volume, eval_3, "it"_a, "active"_a = true)
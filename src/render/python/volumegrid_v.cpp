@@ -93,6 +93,14 @@ MI_PY_EXPORT(VolumeGrid) {
         .def("write", nb::overload_cast<const fs::path &>(
                 &VolumeGrid::write, nb::const_), "path"_a, D(VolumeGrid, write, 2),
                 nb::call_guard<nb::gil_scoped_release>())
+        .def("write_sparse", nb::overload_cast<Stream *, uint32_t>(
+                &VolumeGrid::write_sparse, nb::const_),
+            "stream"_a, "brick_size"_a = 16, D(VolumeGrid, write_sparse, 2),
+            nb::call_guard<nb::gil_scoped_release>())
+        .def("write_sparse", nb::overload_cast<const fs::path &, uint32_t>(
+                &VolumeGrid::write_sparse, nb::const_),
+            "path"_a, "brick_size"_a = 16, D(VolumeGrid, write_sparse),
+            nb::call_guard<nb::gil_scoped_release>())
         .def_prop_ro("__array_interface__", [](VolumeGrid &grid) -> nb::object {
             nb::dict result;
             auto size = grid.size();
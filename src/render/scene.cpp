@@ -1,15 +1,19 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/timer.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/integrator.h>
+#include <mitsuba/render/texture.h>
+#include <unordered_set>
 
 #if defined(MI_ENABLE_EMBREE)
 #  include "scene_embree.inl"
 #else
 #  include <mitsuba/render/kdtree.h>
+#  include <mitsuba/render/bvh.h>
 #  include "scene_native.inl"
 #endif
 
@@ -23,10 +27,33 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Searches the object graph for a texture that needs UV partials
+template <typename Texture>
+struct UVPartialsCallback : public TraversalCallback {
+    void visit(Object *obj) {
+        if (found || !obj || !visited.insert(obj).second)
+            return;
+        if (Texture *texture = dynamic_cast<Texture *>(obj))
+            found = texture->needs_uv_partials();
+        obj->traverse(this);
+    }
+
+    void put_object(std::string_view, Object *obj, uint32_t) override {
+        visit(obj);
+    }
+
+    void put_value(std::string_view, void *, uint32_t,
+                   const std::type_info &) override { }
+
+    std::unordered_set<Object *> visited;
+    bool found = false;
+};
+
 MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     : JitObject<Scene>(props.id()) {
     m_thread_reordering = props.get<bool>("allow_thread_reordering", true);
     m_compact_accel = props.get<bool>("compact_acceleration_structures", false);
+    m_use_light_tree = props.get<bool>("light_tree", false);
 
     for (auto &prop : props.objects()) {
         ref<Object> v = prop.get<ref<Object>>();
@@ -78,6 +105,45 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     for (Sensor *sensor: m_sensors)
         sensor->set_scene(this);
 
+    std::string_view quality = props.get<std::string_view>("accel_quality", "high");
+    if (quality == "low") {
+        m_accel_quality = AccelQuality::Low;
+    } else if (quality == "medium") {
+        m_accel_quality = AccelQuality::Medium;
+    } else if (quality == "high") {
+        m_accel_quality = AccelQuality::High;
+    } else if (quality == "auto") {
+        /* A better tree only pays off if enough rays are traced through it.
+           Compare the number of camera samples to the number of primitives,
+           as both the build and the tracing cost scale with them. */
+        double prim_count = 0.0, sample_count = 0.0;
+        for (Shape *shape : m_shapes)
+            prim_count += (double) shape->effective_primitive_count();
+        for (Sensor *sensor : m_sensors)
+            sample_count = std::max(
+                sample_count, (double) dr::prod(sensor->film()->crop_size()) *
+                                  sensor->sampler()->sample_count());
+
+        double ratio = sample_count / std::max(prim_count, 1.0);
+        if (m_sensors.empty())
+            m_accel_quality = AccelQuality::Medium;
+        else if (ratio < 1.0)
+            m_accel_quality = AccelQuality::Low;
+        else if (ratio < 16.0)
+            m_accel_quality = AccelQuality::Medium;
+        else
+            m_accel_quality = AccelQuality::High;
+
+        Log(Debug, "Acceleration data structure quality: %s (%.3g samples "
+            "per primitive)",
+            m_accel_quality == AccelQuality::Low ? "low" :
+            m_accel_quality == AccelQuality::Medium ? "medium" : "high", ratio);
+    } else {
+        Throw("Scene: unsupported acceleration data structure quality \"%s\" "
+              "(must be \"low\", \"medium\", \"high\", or \"auto\")",
+              std::string(quality));
+    }
+
     // Mark backend-specific properties as queried
     props.mark_queried("embree_use_robust_intersections");
     props.mark_queried("kd_intersection_cost");
@@ -89,8 +155,16 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     props.mark_queried("kd_clip");
     props.mark_queried("kd_retract_bad_splits");
     props.mark_queried("kd_exact_primitive_threshold");
-
+    props.mark_queried("kd_packet");
+    props.mark_queried("accel_cache");
+    props.mark_queried("accel");
+    props.mark_queried("bvh_bins");
+    props.mark_queried("bvh_max_leaf_size");
+    props.mark_queried("bvh_packet");
+
+    Timer timer;
     m_accel.init(this, props);
+    m_accel_build_time = (float) timer.value();
     clear_shapes_dirty();
 
     if (!m_emitters.empty()) {
@@ -113,6 +187,11 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     update_emitter_sampling_distribution();
     update_silhouette_sampling_distribution();
 
+    UVPartialsCallback<Texture> cb;
+    for (auto &child : m_children)
+        cb.visit(child.get());
+    m_needs_uv_partials = cb.found;
+
     m_shapes_grad_enabled = false;
 }
 
@@ -138,6 +217,13 @@ void Scene<Float, Spectrum>::update_emitter_sampling_distribution() {
         m_emitter_pmf = m_emitters.empty() ? 0.f : (1.f / n_emitters);
         m_emitter_distr = nullptr;
     }
+
+    // The light tree is only useful when there is a choice to be made
+    if (m_use_light_tree && n_emitters > 1)
+        m_light_tree = std::make_unique<LightTree<Float, Spectrum>>(m_emitters);
+    else
+        m_light_tree = nullptr;
+
     // Clear emitter's dirty flag
     for (auto &e : m_emitters)
         e->set_dirty(false);
@@ -326,15 +412,30 @@ Scene<Float, Spectrum>::sample_emitter_direction(const Interaction3f &ref, const
     size_t emitter_count = m_emitters.size();
     if (emitter_count > 1 || (emitter_count == 1 && drjit::is_jit_v<Float>)) {
         // Randomly pick an emitter
-        auto [index, emitter_weight, sample_x_re] = sample_emitter(sample.x(), active);
-        sample.x() = sample_x_re;
+        UInt32 index;
+        Float emitter_weight, emitter_pmf;
+        if (m_light_tree) {
+            std::tie(index, emitter_weight, sample.x()) =
+                m_light_tree->sample(ref, sample.x(), active);
+            emitter_pmf = dr::select(emitter_weight > 0.f,
+                                     dr::rcp(emitter_weight), 0.f);
+            active &= emitter_weight > 0.f;
+
+            // No emitter can contribute to the reference location
+            if (dr::none_or<false>(active))
+                return { dr::zeros<DirectionSample3f>(), dr::zeros<Spectrum>() };
+        } else {
+            std::tie(index, emitter_weight, sample.x()) =
+                sample_emitter(sample.x(), active);
+            emitter_pmf = pdf_emitter(index, active);
+        }
 
         // Sample a direction towards the emitter
         EmitterPtr emitter = dr::gather<EmitterPtr>(m_emitters_dr, index, active);
         std::tie(ds, spec) = emitter->sample_direction(ref, sample, active);
 
         // Account for the discrete probability of sampling this emitter
-        ds.pdf *= pdf_emitter(index, active);
+        ds.pdf *= emitter_pmf;
         spec *= emitter_weight;
 
         active &= (ds.pdf != 0.f);
@@ -375,13 +476,26 @@ MI_VARIANT uint32_t Scene<Float, Spectrum>::shape_types() const {
     return result;
 }
 
+MI_VARIANT const KDTreeBuildReport *
+Scene<Float, Spectrum>::kdtree_build_report() const {
+#if !defined(MI_ENABLE_EMBREE)
+    if constexpr (!dr::is_cuda_v<Float> && !dr::is_metal_v<Float>) {
+        if (m_accel.accel)
+            return &m_accel.accel->build_report();
+    }
+#endif
+    return nullptr;
+}
+
 MI_VARIANT Float
 Scene<Float, Spectrum>::pdf_emitter_direction(const Interaction3f &ref,
                                               const DirectionSample3f &ds,
                                               Mask active) const {
     MI_MASK_ARGUMENT(active);
     Float emitter_pmf;
-    if (m_emitter_distr == nullptr)
+    if (m_light_tree)
+        emitter_pmf = m_light_tree->pmf(ref, ds.emitter, active);
+    else if (m_emitter_distr == nullptr)
         emitter_pmf = m_emitter_pmf;
     else
         emitter_pmf = ds.emitter->sampling_weight() * m_emitter_distr->normalization();
@@ -516,22 +630,30 @@ MI_VARIANT void Scene<Float, Spectrum>::traverse(TraversalCallback *cb) {
 
 MI_VARIANT void Scene<Float, Spectrum>::parameters_changed(const std::vector<std::string> &/*keys*/) {
     bool accel_is_dirty = false;
+    uint32_t dirty_flags = 0;
     for (auto &s : m_shapes) {
         if (s->dirty()) {
             accel_is_dirty = true;
-            break;
+            dirty_flags |= s->dirty_flags();
         }
     }
 
     for (auto &s : m_shapegroups) {
         if (s->dirty()) {
             accel_is_dirty = true;
-            break;
+            dirty_flags |= s->dirty_flags();
         }
     }
 
     if (accel_is_dirty) {
-        m_accel.rebuild(this);
+        /* Moved vertices and instances don't require rebuilding the
+           acceleration data structure from scratch */
+        Timer timer;
+        if (has_flag(dirty_flags, ShapeDirtyFlags::Topology))
+            m_accel.rebuild(this);
+        else
+            m_accel.update(this);
+        m_accel_build_time = (float) timer.value();
         clear_shapes_dirty();
 
         m_bbox = {};
@@ -553,13 +675,13 @@ MI_VARIANT void Scene<Float, Spectrum>::parameters_changed(const std::vector<std
     }
 
     // Check if emitters were modified and we potentially need to update
-    // the emitter sampling distribution.
-    for (auto &e : m_emitters) {
-        if (e->dirty()) {
-            update_emitter_sampling_distribution();
-            break;
-        }
-    }
+    // the emitter sampling distribution. The light tree also depends on the
+    // placement of the emitters' shapes.
+    bool emitters_dirty = accel_is_dirty && m_light_tree;
+    for (auto &e : m_emitters)
+        emitters_dirty |= e->dirty();
+    if (emitters_dirty)
+        update_emitter_sampling_distribution();
 }
 
 MI_VARIANT std::string Scene<Float, Spectrum>::to_string() const {
@@ -586,14 +708,19 @@ MI_VARIANT void Scene<Float, Spectrum>::static_accel_shutdown() {
 }
 
 MI_VARIANT void Scene<Float, Spectrum>::clear_shapes_dirty() {
-    for (auto &s : m_shapes)
+    auto clear = [](Shape *s) {
         s->m_dirty = false;
+        s->m_dirty_flags = (uint32_t) ShapeDirtyFlags::Clean;
+    };
+
+    for (auto &s : m_shapes)
+        clear(s.get());
     for (auto &s : m_shapegroups) {
-        s->m_dirty = false;
+        clear(s.get());
         // Clear the group's children too (consumed into its accel by the same
         // build); a backend's per-group dirty check relies on this.
         for (auto &c : s->shapes())
-            const_cast<Shape *>(c.get())->m_dirty = false;
+            clear(const_cast<Shape *>(c.get()));
     }
 }
 
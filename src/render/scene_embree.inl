@@ -5,6 +5,7 @@
 #include <mitsuba/render/scene_ir.h>
 #include "accel_cpu_common.h"
 #include "embree.h"
+#include <algorithm>
 #include <thread>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -115,12 +116,138 @@ static void embree_backface_cull(const RTCFilterFunctionNArguments *args) {
     }
 }
 
+/**
+ * \brief Compute the time range shared by all motion-blurred instances
+ *
+ * Embree does not intersect motion-blurred geometry at ray times outside of
+ * its time range, whereas the other backends keep an instance in place before
+ * its first and after its last keyframe. All instances therefore use the union
+ * of their ranges (see \ref embree_set_transform()), and ray times are clamped
+ * to it. Returns \c false if no instance is motion-blurred.
+ */
+template <typename Shape>
+static bool embree_motion_range(const std::vector<ref<Shape>> &shapes,
+                                float range[2]) {
+    bool has_motion = false;
+    range[0] = dr::Infinity<float>;
+    range[1] = -dr::Infinity<float>;
+    for (const ref<Shape> &shape : shapes) {
+        if (shape->shape_type() != +ShapeType::Instance)
+            continue;
+        ShapeIR g;
+        shape->describe(g);
+        if (g.motion.empty())
+            continue;
+        range[0] = std::min(range[0], g.motion_time[0]);
+        range[1] = std::max(range[1], g.motion_time[1]);
+        has_motion = true;
+    }
+    if (!has_motion) {
+        range[0] = 0.f;
+        range[1] = 1.f;
+    }
+    return has_motion;
+}
+
+/**
+ * \brief Resample the keyframes of an instance uniformly over \c range
+ *
+ * Times outside of the instance's own range see its first or last keyframe.
+ * The spacing of the new keyframes does not exceed that of the original ones,
+ * and both coincide where the segments line up. Keyframes are interpolated
+ * like \ref AnimatedTransform::eval().
+ */
+static std::vector<ShapeIR::MotionKey>
+embree_resample_motion(const ShapeIR &g, const float range[2]) {
+    using Quat = dr::Quaternion<float>;
+    size_t segments = g.motion.size() - 1;
+    float step = (g.motion_time[1] - g.motion_time[0]) / (float) segments;
+    size_t count = (size_t) std::ceil((range[1] - range[0]) / step - 1e-4f) + 1;
+    count = std::clamp(count, (size_t) 2, (size_t) 1024);
+
+    std::vector<ShapeIR::MotionKey> result(count);
+    for (size_t i = 0; i < count; ++i) {
+        float t = dr::lerp(range[0], range[1], (float) i / (float) (count - 1)),
+              x = dr::clip((t - g.motion_time[0]) / step, 0.f, (float) segments);
+        size_t k = std::min((size_t) x, segments - 1);
+        float alpha = x - (float) k;
+
+        const ShapeIR::MotionKey &k0 = g.motion[k], &k1 = g.motion[k + 1];
+        ShapeIR::MotionKey &key = result[i];
+        for (size_t j = 0; j < 6; ++j)
+            key.scale[j] = dr::lerp(k0.scale[j], k1.scale[j], alpha);
+        for (size_t j = 0; j < 3; ++j)
+            key.trans[j] = dr::lerp(k0.trans[j], k1.trans[j], alpha);
+        Quat q = dr::slerp(Quat(k0.quat[1], k0.quat[2], k0.quat[3], k0.quat[0]),
+                           Quat(k1.quat[1], k1.quat[2], k1.quat[3], k1.quat[0]),
+                           alpha);
+        key.quat[0] = q.w();
+        key.quat[1] = q.x();
+        key.quat[2] = q.y();
+        key.quat[3] = q.z();
+    }
+    return result;
+}
+
+/**
+ * \brief Set the (possibly keyframed) transformation of an Embree instance
+ *
+ * \c range is the time range shared by all motion-blurred instances, see
+ * \ref embree_motion_range().
+ */
+static void embree_set_transform(RTCGeometry inst, const ShapeIR &g,
+                                 const float range[2]) {
+    if (!g.motion.empty()) {
+        std::vector<ShapeIR::MotionKey> resampled;
+        const std::vector<ShapeIR::MotionKey> *motion = &g.motion;
+        if (g.motion_time[0] != range[0] || g.motion_time[1] != range[1]) {
+            resampled = embree_resample_motion(g, range);
+            motion = &resampled;
+        }
+
+        // Keyframes interpolated like AnimatedTransform::eval()
+        rtcSetGeometryTimeStepCount(inst, (unsigned int) motion->size());
+        rtcSetGeometryTimeRange(inst, range[0], range[1]);
+        for (size_t i = 0; i < motion->size(); ++i) {
+            const ShapeIR::MotionKey &key = (*motion)[i];
+            RTCQuaternionDecomposition qd;
+            rtcInitQuaternionDecomposition(&qd);
+            qd.scale_x = key.scale[0];
+            qd.skew_xy = key.scale[1];
+            qd.skew_xz = key.scale[2];
+            qd.scale_y = key.scale[3];
+            qd.skew_yz = key.scale[4];
+            qd.scale_z = key.scale[5];
+            qd.quaternion_r = key.quat[0];
+            qd.quaternion_i = key.quat[1];
+            qd.quaternion_j = key.quat[2];
+            qd.quaternion_k = key.quat[3];
+            qd.translation_x = key.trans[0];
+            qd.translation_y = key.trans[1];
+            qd.translation_z = key.trans[2];
+            rtcSetGeometryTransformQuaternion(inst, (unsigned int) i, &qd);
+        }
+        return;
+    }
+
+    rtcSetGeometryTimeStepCount(inst, 1);
+    // Column-major 3x4 (g.to_world[col*3+row]) -> column-major 4x4.
+    float M[16];
+    for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 3; ++row)
+            M[col * 4 + row] = g.to_world[col * 3 + row];
+        M[col * 4 + 3] = (col == 3) ? 1.f : 0.f;
+    }
+    rtcSetGeometryTransform(inst, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, M);
+}
+
 /// Build one Embree geometry from a \ref ShapeIR.
 template <typename Float, typename Spectrum>
 static RTCGeometry
 embree_make_geometry(RTCDevice device, const Shape<Float, Spectrum> *shape,
                      const tsl::robin_map<const void *, RTCSceneTy *,
-                                          PointerHasher> &group_scenes) {
+                                          PointerHasher> &group_scenes,
+                     const float motion_range[2]) {
     ShapeIR g;
     shape->describe(g);
 
@@ -174,15 +301,7 @@ embree_make_geometry(RTCDevice device, const Shape<Float, Spectrum> *shape,
 
             RTCGeometry inst = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
             rtcSetGeometryInstancedScene(inst, nested);
-            rtcSetGeometryTimeStepCount(inst, 1);
-            // Column-major 3x4 (g.to_world[col*3+row]) -> column-major 4x4.
-            float M[16];
-            for (int col = 0; col < 4; ++col) {
-                for (int row = 0; row < 3; ++row)
-                    M[col * 4 + row] = g.to_world[col * 3 + row];
-                M[col * 4 + 3] = (col == 3) ? 1.f : 0.f;
-            }
-            rtcSetGeometryTransform(inst, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, M);
+            embree_set_transform(inst, g, motion_range);
             rtcCommitGeometry(inst);
             return inst;
         }
@@ -190,6 +309,87 @@ embree_make_geometry(RTCDevice device, const Shape<Float, Spectrum> *shape,
     return nullptr; // unreachable
 }
 
+/**
+ * \brief Update an Embree geometry whose shape moved without changing its
+ * primitives (see \ref ShapeDirtyFlags).
+ *
+ * Mesh and curve buffers are re-shared, since packing may have reallocated
+ * them, and their BVH is refit. User geometries re-query their bounds.
+ */
+template <typename Float, typename Spectrum>
+static void embree_update_geometry(RTCGeometry geom,
+                                   const Shape<Float, Spectrum> *shape,
+                                   const float motion_range[2]) {
+    ShapeIR g;
+    shape->describe(g);
+
+    auto reshare = [&](RTCBufferType type, RTCFormat format, const void *ptr,
+                       size_t stride, size_t count) {
+        if (rtcGetGeometryBufferData(geom, type, 0) != ptr)
+            rtcSetSharedGeometryBuffer(geom, type, 0, format, ptr, 0, stride,
+                                       count);
+        else
+            rtcUpdateGeometryBuffer(geom, type, 0);
+    };
+
+    switch (g.kind) {
+        case ShapeIR::Kind::Custom:
+            break;
+
+        case ShapeIR::Kind::Triangles:
+        case ShapeIR::Kind::TrianglesCulled:
+            reshare(RTC_BUFFER_TYPE_VERTEX, RTC_FORMAT_FLOAT3, g.vertex_ptr,
+                    g.vertex_stride, g.vertex_count);
+            reshare(RTC_BUFFER_TYPE_INDEX, RTC_FORMAT_UINT3, g.index_ptr,
+                    g.index_stride, g.face_count);
+            rtcSetGeometryBuildQuality(geom, RTC_BUILD_QUALITY_REFIT);
+            break;
+
+        case ShapeIR::Kind::BSplineCurve:
+        case ShapeIR::Kind::LinearCurve:
+            reshare(RTC_BUFFER_TYPE_VERTEX, RTC_FORMAT_FLOAT4, g.cp_ptr,
+                    4 * sizeof(float), g.cp_count);
+            reshare(RTC_BUFFER_TYPE_INDEX, RTC_FORMAT_UINT, g.seg_ptr,
+                    sizeof(uint32_t), g.seg_count);
+            rtcSetGeometryBuildQuality(geom, RTC_BUILD_QUALITY_REFIT);
+            break;
+
+        case ShapeIR::Kind::Instance:
+            embree_set_transform(geom, g, motion_range);
+            break;
+    }
+
+    rtcCommitGeometry(geom);
+}
+
+/**
+ * \brief Switch a scene to Embree's two-level mode
+ *
+ * Embree only honors per-geometry build qualities (and hence refitting) in
+ * this mode, which builds a separate BVH per geometry and a cheap top-level
+ * BVH over them, at a slightly higher tracing cost.
+ */
+static void embree_make_dynamic(RTCScene scene) {
+    rtcSetSceneBuildQuality(scene, RTC_BUILD_QUALITY_LOW);
+    rtcSetSceneFlags(scene, (RTCSceneFlags) (rtcGetSceneFlags(scene) |
+                                              RTC_SCENE_FLAG_DYNAMIC));
+}
+
+/// Commit a top-level scene, letting all Embree threads join the build
+static void embree_commit_scene(RTCScene scene, bool is_nested_scene) {
+    // Avoid getting in a deadlock when building a nested scene while rendering
+    if (is_nested_scene) {
+        rtcCommitScene(scene);
+    } else {
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, embree_threads, 1),
+            [&](const dr::blocked_range<size_t> &) {
+                rtcJoinCommitScene(scene);
+            }
+        );
+    }
+}
+
 // -----------------------------------------------------------------------
 //  EmbreeAccel<Float, Spectrum> -- lifecycle
 // -----------------------------------------------------------------------
@@ -222,9 +422,27 @@ void EmbreeAccel<Float, Spectrum>::init(Scene<Float, Spectrum> *scene,
     }
 
     accel = rtcNewScene(embree_device);
-    rtcSetSceneBuildQuality(accel, RTC_BUILD_QUALITY_HIGH);
-    bool use_robust = props.get<bool>("embree_use_robust_intersections", false);
-    rtcSetSceneFlags(accel, use_robust ? RTC_SCENE_FLAG_ROBUST : RTC_SCENE_FLAG_NONE);
+
+    int flags = RTC_SCENE_FLAG_NONE;
+    if (props.get<bool>("embree_use_robust_intersections", false))
+        flags |= RTC_SCENE_FLAG_ROBUST;
+    if (scene->m_compact_accel)
+        flags |= RTC_SCENE_FLAG_COMPACT;
+    rtcSetSceneFlags(accel, (RTCSceneFlags) flags);
+
+    switch (scene->m_accel_quality) {
+        case AccelQuality::Low:
+            // Two-level mode, which is also what incremental updates use
+            embree_make_dynamic(accel);
+            is_dynamic = true;
+            break;
+        case AccelQuality::Medium:
+            rtcSetSceneBuildQuality(accel, RTC_BUILD_QUALITY_MEDIUM);
+            break;
+        case AccelQuality::High:
+            rtcSetSceneBuildQuality(accel, RTC_BUILD_QUALITY_HIGH);
+            break;
+    }
 
     ScopedPhase phase(ProfilerPhase::InitAccel);
     rebuild(scene);
@@ -252,13 +470,17 @@ void EmbreeAccel<Float, Spectrum>::rebuild(
         rtcReleaseScene(kv.second);
     group_scenes.clear();
 
+    has_motion = embree_motion_range(scene->m_shapes, motion_range);
+
     std::vector<RTCScene> nested_scenes;
     nested_scenes.reserve(scene->m_shapegroups.size());
     for (auto &group : scene->m_shapegroups) {
         RTCScene nested = rtcNewScene(embree_device);
+        if (is_dynamic)
+            embree_make_dynamic(nested);
         for (const ref<Shape> &child : group->shapes()) {
             RTCGeometry cg = embree_make_geometry<Float, Spectrum>(
-                embree_device, child.get(), group_scenes);
+                embree_device, child.get(), group_scenes, motion_range);
             rtcAttachGeometry(nested, cg);
             rtcReleaseGeometry(cg);
         }
@@ -269,7 +491,7 @@ void EmbreeAccel<Float, Spectrum>::rebuild(
 
     for (Shape *shape : scene->m_shapes) {
         RTCGeometry geom = embree_make_geometry<Float, Spectrum>(
-            embree_device, shape, group_scenes);
+            embree_device, shape, group_scenes, motion_range);
         geometries.push_back(rtcAttachGeometry(accel, geom));
         rtcReleaseGeometry(geom);
     }
@@ -284,17 +506,7 @@ void EmbreeAccel<Float, Spectrum>::rebuild(
     for (RTCScene nested : nested_scenes)
         rtcCommitScene(nested);
 
-    // Avoid getting in a deadlock when building a nested scene while rendering
-    if (is_nested_scene) {
-        rtcCommitScene(accel);
-    } else {
-        dr::parallel_for(
-            dr::blocked_range<size_t>(0, embree_threads, 1),
-            [&](const dr::blocked_range<size_t> &) {
-                rtcJoinCommitScene(accel);
-            }
-        );
-    }
+    embree_commit_scene(accel, is_nested_scene);
 
     // The RTCScene pointer and entry points stay stable across rebuilds, so
     // initialize the handles only once. The cleanup callback keeps the native
@@ -332,6 +544,73 @@ void EmbreeAccel<Float, Spectrum>::rebuild(
     }
 }
 
+template <typename Float, typename Spectrum>
+void EmbreeAccel<Float, Spectrum>::update(
+    Scene<Float, Spectrum> *scene) {
+    if constexpr (dr::is_llvm_v<Float>)
+        dr::sync_thread();
+
+    /* Switch to the two-level mode on the first update, since scenes that
+       were updated once are likely to be updated again */
+    if (!is_dynamic) {
+        embree_make_dynamic(accel);
+        for (auto &kv : group_scenes)
+            embree_make_dynamic(kv.second);
+        is_dynamic = true;
+    }
+
+    // Instances that did not move are re-placed if the shared range changed
+    float range[2];
+    has_motion = embree_motion_range(scene->m_shapes, range);
+    bool range_changed =
+        range[0] != motion_range[0] || range[1] != motion_range[1];
+    motion_range[0] = range[0];
+    motion_range[1] = range[1];
+
+    // Nested scenes: children were attached in order, so their ID is their index
+    std::vector<RTCScene> nested_scenes;
+    for (auto &group : scene->m_shapegroups) {
+        if (!group->dirty())
+            continue;
+        RTCScene nested = group_scenes.at((const void *) group.get());
+        const auto &children = group->shapes();
+        for (size_t i = 0; i < children.size(); ++i) {
+            if (children[i]->dirty())
+                embree_update_geometry<Float, Spectrum>(
+                    rtcGetGeometry(nested, (unsigned int) i), children[i].get(),
+                    motion_range);
+        }
+        nested_scenes.push_back(nested);
+    }
+
+    for (size_t i = 0; i < scene->m_shapes.size(); ++i) {
+        Shape *shape = scene->m_shapes[i];
+        RTCGeometry geom = rtcGetGeometry(accel, (unsigned int) geometries[i]);
+
+        if (shape->dirty() ||
+            (range_changed && shape->shape_type() == +ShapeType::Instance)) {
+            embree_update_geometry<Float, Spectrum>(geom, shape, motion_range);
+        } else if (!nested_scenes.empty() &&
+                   shape->shape_type() == +ShapeType::Instance) {
+            // Instances of a modified group must update their bounds
+            ShapeIR g;
+            shape->describe(g);
+            RTCScene nested = group_scenes.at(g.group_id);
+            if (std::find(nested_scenes.begin(), nested_scenes.end(), nested) !=
+                nested_scenes.end())
+                rtcCommitGeometry(geom);
+        }
+    }
+
+    if constexpr (dr::is_llvm_v<Float>)
+        dr::sync_thread();
+
+    for (RTCScene nested : nested_scenes)
+        rtcCommitScene(nested);
+
+    embree_commit_scene(accel, is_nested_scene);
+}
+
 template <typename Float, typename Spectrum>
 void EmbreeAccel<Float, Spectrum>::release() {
     if (!accel)
@@ -377,6 +656,11 @@ EmbreeAccel<Float, Spectrum>::ray_intersect_preliminary(
     if constexpr (!std::is_same_v<Single, Float>)
         ray_maxt = dr::minimum(ray_maxt, dr::Largest<Single>);
 
+    // Keep motion-blurred instances in place outside of their time range
+    Single ray_time(ray.time);
+    if (has_motion)
+        ray_time = dr::clip(ray_time, motion_range[0], motion_range[1]);
+
     if constexpr (!dr::is_jit_v<Float>) {
         DRJIT_MARK_USED(active);
         DRJIT_MARK_USED(coherent);
@@ -390,7 +674,7 @@ EmbreeAccel<Float, Spectrum>::ray_intersect_preliminary(
 
         RTCRayHit rh;
         dr::store(&rh.ray.org_x, dr::concat(Vector3s(ray.o), float(0.f)));
-        dr::store(&rh.ray.dir_x, dr::concat(Vector3s(ray.d), float(ray.time)));
+        dr::store(&rh.ray.dir_x, dr::concat(Vector3s(ray.d), float(ray_time)));
         rh.ray.tfar = ray_maxt;
         rh.ray.mask = 0;
         rh.ray.id = 0;
@@ -427,7 +711,6 @@ EmbreeAccel<Float, Spectrum>::ray_intersect_preliminary(
         return pi;
     } else if constexpr (dr::is_llvm_v<Float>) {
         dr::Array<Single, 3> ray_o(ray.o), ray_d(ray.d);
-        Single ray_time(ray.time);
 
         uint32_t out[8] { };
         cpu_llvm_ray_trace<Float>((void *) func_ptr, func_handle.index(),
@@ -458,6 +741,11 @@ EmbreeAccel<Float, Spectrum>::ray_test(const Scene<Float, Spectrum> * /*scene*/,
     if constexpr (!std::is_same_v<Single, Float>)
         ray_maxt = dr::minimum(ray_maxt, dr::Largest<Single>);
 
+    // Keep motion-blurred instances in place outside of their time range
+    Single ray_time(ray.time);
+    if (has_motion)
+        ray_time = dr::clip(ray_time, motion_range[0], motion_range[1]);
+
     if constexpr (!dr::is_jit_v<Float>) {
         DRJIT_MARK_USED(active);
         DRJIT_MARK_USED(coherent);
@@ -469,7 +757,7 @@ EmbreeAccel<Float, Spectrum>::ray_test(const Scene<Float, Spectrum> * /*scene*/,
 
         RTCRay ray2;
         dr::store(&ray2.org_x, dr::concat(Vector3s(ray.o), float(0.f)));
-        dr::store(&ray2.dir_x, dr::concat(Vector3s(ray.d), float(ray.time)));
+        dr::store(&ray2.dir_x, dr::concat(Vector3s(ray.d), float(ray_time)));
         ray2.tfar = (float) ray_maxt;
         ray2.mask = 0;
         ray2.id = 0;
@@ -481,7 +769,6 @@ EmbreeAccel<Float, Spectrum>::ray_test(const Scene<Float, Spectrum> * /*scene*/,
     } else if constexpr (dr::is_llvm_v<Float>) {
         // Conversion, in case this is a double precision build
         dr::Array<Single, 3> ray_o(ray.o), ray_d(ray.d);
-        Single ray_time(ray.time);
 
         // Shadow ray: trace against rtcOccludedN, which accepts any hit and
         // terminates traversal early.
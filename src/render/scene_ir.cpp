@@ -77,6 +77,10 @@ SceneIR SceneIRBuilder<Float, Spectrum>::build(Scene<Float, Spectrum> *scene) {
     }
     // ...then, per Instance shape, one instance per BLAS of its ShapeGroup.
     for (const ShapeIR &inst : inst_shapes) {
+        if (!inst.motion.empty())
+            Throw("Motion-blurred instances are only supported by the CPU "
+                  "acceleration data structures (Embree and the builtin "
+                  "kd-tree/BVH).");
         uint32_t owner = jit_registry_id(inst.ctx);
         for (uint32_t bi : sd.group_blases[group_index.at(inst.group_id)]) {
             InstanceEntry e;
@@ -3,8 +3,9 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
-template <typename Float, typename Spectrum, bool ShadowRay, size_t Width>
-void kdtree_trace_func_wrapper(const int *valid, void *ptr,
+template <typename Tree, typename Float, typename Spectrum, bool ShadowRay,
+          size_t Width>
+void native_trace_func_wrapper(const int *valid, void *ptr,
                                void* /* context */, uint8_t *args);
 
 // -----------------------------------------------------------------------
@@ -14,8 +15,17 @@ void kdtree_trace_func_wrapper(const int *valid, void *ptr,
 template <typename Float, typename Spectrum>
 void NativeAccel<Float, Spectrum>::init(Scene<Float, Spectrum> *scene,
                                         const Properties &props) {
-    accel = new ShapeKDTree<Float, Spectrum>(props);
-    accel->inc_ref();
+    std::string_view type = props.get<std::string_view>("accel", "kdtree");
+    if (type == "kdtree") {
+        accel = new ShapeKDTree<Float, Spectrum>(props, scene->m_accel_quality);
+        accel->inc_ref();
+    } else if (type == "bvh") {
+        bvh = new ShapeBVH<Float, Spectrum>(props, scene->m_accel_quality);
+        bvh->inc_ref();
+    } else {
+        Throw("Scene: unsupported acceleration data structure \"%s\" "
+              "(must be \"kdtree\" or \"bvh\")", std::string(type));
+    }
 
     if constexpr (dr::is_llvm_v<Float>)
         shapes_registry_ids = build_registry_ids<Float, Spectrum>(scene->m_shapes);
@@ -30,66 +40,90 @@ void NativeAccel<Float, Spectrum>::rebuild(
     if constexpr (dr::is_llvm_v<Float>)
         dr::sync_thread();
 
-    accel->clear();
-    for (Shape *shape : scene->m_shapes)
-        accel->add_shape(shape);
-    ScopedPhase phase(ProfilerPhase::InitAccel);
-    accel->build();
-
-    // The kd-tree is rebuilt in place, so initialize the handles only once.
-    // The cleanup callback keeps it alive until pending ray-tracing kernels
-    // finish.
-    if constexpr (dr::is_llvm_v<Float>) {
-        if (!accel_handle.index()) {
-            init_mapped_handle(
-                accel_handle, (void *) accel,
-                [](uint32_t /* index */, int free, void *payload) {
-                    if (free)
-                        jit_enqueue_host_func(
-                            JitBackend::LLVM,
-                            [](void *p) {
-                                auto *kdtree = (ShapeKDTree<Float, Spectrum> *) p;
-                                kdtree->clear();
-                                kdtree->dec_ref();
-                            },
-                            payload);
-                },
-                (void *) accel);
-
-            // The LLVM vector width is fixed over the scene's lifetime.
-            int jit_width  = jit_llvm_vector_width();
-            switch (jit_width) {
-                case 1:  func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 1>;  occlude_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 1>;  break;
-                case 4:  func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 4>;  occlude_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 4>;  break;
-                case 8:  func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 8>;  occlude_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 8>;  break;
-                case 16: func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, false, 16>; occlude_func_ptr = (void *) kdtree_trace_func_wrapper<Float, Spectrum, true, 16>; break;
-                default:
-                    Throw("NativeAccel::rebuild(): Dr.Jit is configured for "
-                          "vectors of width %u, which is not supported by the "
-                          "kd-tree ray tracing backend!", jit_width);
+    visit_tree([&](auto *tree) {
+        using Tree = std::remove_pointer_t<decltype(tree)>;
+
+        tree->clear();
+        for (Shape *shape : scene->m_shapes)
+            tree->add_shape(shape);
+        ScopedPhase phase(ProfilerPhase::InitAccel);
+        tree->build();
+
+        // The tree is rebuilt in place, so initialize the handles only once.
+        // The cleanup callback keeps it alive until pending ray-tracing
+        // kernels finish.
+        if constexpr (dr::is_llvm_v<Float>) {
+            if (!accel_handle.index()) {
+                init_mapped_handle(
+                    accel_handle, (void *) tree,
+                    [](uint32_t /* index */, int free, void *payload) {
+                        if (free)
+                            jit_enqueue_host_func(
+                                JitBackend::LLVM,
+                                [](void *p) {
+                                    Tree *tree = (Tree *) p;
+                                    tree->clear();
+                                    tree->dec_ref();
+                                },
+                                payload);
+                    },
+                    (void *) tree);
+
+                // The LLVM vector width is fixed over the scene's lifetime.
+                int jit_width  = jit_llvm_vector_width();
+                switch (jit_width) {
+                    case 1:  func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, false, 1>;  occlude_func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, true, 1>;  break;
+                    case 4:  func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, false, 4>;  occlude_func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, true, 4>;  break;
+                    case 8:  func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, false, 8>;  occlude_func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, true, 8>;  break;
+                    case 16: func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, false, 16>; occlude_func_ptr = (void *) native_trace_func_wrapper<Tree, Float, Spectrum, true, 16>; break;
+                    default:
+                        Throw("NativeAccel::rebuild(): Dr.Jit is configured for "
+                              "vectors of width %u, which is not supported by the "
+                              "native ray tracing backend!", jit_width);
+                }
+
+                map_func_handles(func_handle, occlude_handle, func_ptr,
+                                 occlude_func_ptr);
             }
-
-            map_func_handles(func_handle, occlude_handle, func_ptr,
-                             occlude_func_ptr);
         }
+    });
+}
+
+template <typename Float, typename Spectrum>
+void NativeAccel<Float, Spectrum>::update(
+    Scene<Float, Spectrum> *scene) {
+    /* The split planes of the kd-tree are tailored to the primitive bounds,
+       hence only the BVH can be refit. Instances are primitives of the
+       scene-level tree, so this also covers transformation changes. */
+    if (!bvh) {
+        rebuild(scene);
+        return;
     }
+
+    // Ensure all ray tracing kernels are terminated before refitting
+    if constexpr (dr::is_llvm_v<Float>)
+        dr::sync_thread();
+
+    ScopedPhase phase(ProfilerPhase::InitAccel);
+    bvh->refit();
 }
 
 template <typename Float, typename Spectrum>
 void NativeAccel<Float, Spectrum>::release() {
-    if (!accel)
+    if (!accel && !bvh)
         return;
     if constexpr (dr::is_llvm_v<Float>) {
         // Ensure all ray tracing kernels are terminated before releasing
         dr::sync_thread();
 
-        // Drop the handle reference. Its callback releases the kd-tree once no
+        // Drop the handle reference. Its callback releases the tree once no
         // ray tracing calls remain.
         accel_handle = 0;
     } else {
-        accel->dec_ref();
+        visit_tree([](auto *tree) { tree->dec_ref(); });
     }
     accel = nullptr;
+    bvh = nullptr;
 }
 
 #if defined(_MSC_VER)
@@ -109,16 +143,84 @@ template <typename ScalarFloat> struct RayHitT {
 #  pragma pack(pop)
 #endif
 
-template <typename Float, typename Spectrum, bool ShadowRay, size_t Width>
-void kdtree_trace_func_wrapper(const int *valid, void *ptr,
+/**
+ * \brief Trace the lanes of an LLVM ray tracing call as one packet through
+ * the native kd-tree or BVH
+ *
+ * Returns \c false without touching \c args when the active lanes are not
+ * coherent enough for packet traversal, in which case the caller traces them
+ * one at a time.
+ */
+template <typename Tree, typename Float, typename Spectrum, bool ShadowRay,
+          size_t Width>
+bool native_trace_packet(const int *valid, const Tree *tree, uint8_t *args) {
+    MI_IMPORT_TYPES()
+    using FloatP    = dr::Packet<ScalarFloat, Width>;
+    using UInt32P   = dr::Packet<uint32_t, Width>;
+    using MaskP     = dr::mask_t<FloatP>;
+    using Point3fP  = Point<FloatP, 3>;
+    using Vector3fP = Vector<FloatP, 3>;
+    using Ray3fP    = Ray<Point3fP, Spectrum>;
+    using RayHit    = RayHitT<ScalarFloat>;
+
+    auto field = [&](size_t offset) { return &args[offset * Width]; };
+
+    MaskP active = dr::load<dr::Packet<int, Width>>(valid) != 0;
+
+    Vector3fP ray_d(dr::load<FloatP>(field(offsetof(RayHit, d_x))),
+                    dr::load<FloatP>(field(offsetof(RayHit, d_y))),
+                    dr::load<FloatP>(field(offsetof(RayHit, d_z))));
+
+    if (!tree->is_coherent(ray_d, active))
+        return false;
+
+    Ray3fP ray;
+    ray.o    = Point3fP(dr::load<FloatP>(field(offsetof(RayHit, o_x))),
+                        dr::load<FloatP>(field(offsetof(RayHit, o_y))),
+                        dr::load<FloatP>(field(offsetof(RayHit, o_z))));
+    ray.d    = ray_d;
+    ray.maxt = dr::load<FloatP>(field(offsetof(RayHit, tfar)));
+    ray.time = dr::load<FloatP>(field(offsetof(RayHit, time)));
+
+    auto pi = tree->template ray_intersect_packet<ShadowRay>(ray, active);
+
+    uint8_t *tfar = field(offsetof(RayHit, tfar));
+    if constexpr (ShadowRay) {
+        dr::store(tfar, dr::select(pi.valid, -dr::Infinity<FloatP>, ray.maxt));
+    } else {
+        auto update = [&](size_t offset, const auto &value) {
+            using T = std::decay_t<decltype(value)>;
+            uint8_t *ptr = field(offset);
+            dr::store(ptr, dr::select(pi.valid, value, dr::load<T>(ptr)));
+        };
+        update(offsetof(RayHit, tfar),    pi.t);
+        update(offsetof(RayHit, u),       pi.prim_uv.x());
+        update(offsetof(RayHit, v),       pi.prim_uv.y());
+        update(offsetof(RayHit, prim_id), UInt32P(pi.prim_index));
+        update(offsetof(RayHit, geom_id), UInt32P(pi.shape_index));
+        update(offsetof(RayHit, inst_id), UInt32P(pi.instance_index));
+    }
+
+    return true;
+}
+
+template <typename Tree, typename Float, typename Spectrum, bool ShadowRay,
+          size_t Width>
+void native_trace_func_wrapper(const int *valid, void *ptr,
                                void* /* context */, uint8_t *args) {
     MI_IMPORT_TYPES()
     using ScalarRay3f = Ray<ScalarPoint3f, Spectrum>;
-    using ShapeKDTree = ShapeKDTree<Float, Spectrum>;
 
-    const ShapeKDTree *kdtree = (const ShapeKDTree *) ptr;
+    const Tree *tree = (const Tree *) ptr;
     using RayHit = RayHitT<ScalarFloat>;
 
+    if constexpr (Width > 1) {
+        if (tree->packet_traversal() &&
+            native_trace_packet<Tree, Float, Spectrum, ShadowRay, Width>(
+                valid, tree, args))
+            return;
+    }
+
     for (size_t i = 0; i < Width; i++) {
         if (valid[i] == 0)
             continue;
@@ -139,11 +241,11 @@ void kdtree_trace_func_wrapper(const int *valid, void *ptr,
         ScalarRay3f ray = ScalarRay3f(ray_o, ray_d, ray_maxt, ray_time, wavelength_t<Spectrum>());
 
         if constexpr (ShadowRay) {
-            bool hit = kdtree->template ray_intersect_scalar<true>(ray).is_valid();
+            bool hit = tree->template ray_intersect_scalar<true>(ray).is_valid();
             if (hit)
                 ray_maxt = -dr::Infinity<ScalarFloat>;
         } else {
-            auto pi = kdtree->template ray_intersect_scalar<false>(ray);
+            auto pi = tree->template ray_intersect_scalar<false>(ray);
             if (pi.is_valid()) {
                 ScalarFloat& prim_u = ((ScalarFloat*) &args[offsetof(RayHit, u) * Width])[i];
                 ScalarFloat& prim_v = ((ScalarFloat*) &args[offsetof(RayHit, v) * Width])[i];
@@ -175,17 +277,19 @@ NativeAccel<Float, Spectrum>::ray_intersect_preliminary(
     Mask active) const {
     if constexpr (!dr::is_array_v<Float>) {
         DRJIT_MARK_USED(coherent);
-        return accel->template ray_intersect_preliminary<false>(ray, active);
+        return visit_tree([&](auto *tree) {
+            return tree->template ray_intersect_preliminary<false>(ray, active);
+        });
     } else {
         dr::Array<Float, 3> ray_o(ray.o), ray_d(ray.d);
 
         uint32_t out[8] { };
         cpu_llvm_ray_trace<Float>((void *) func_ptr, func_handle.index(),
-                                  (void *) accel, accel_handle.index(), ray_o,
-                                  ray_d, ray.time, ray.maxt, coherent, active,
-                                  0, out);
+                                  visit_tree([](auto *tree) { return (void *) tree; }),
+                                  accel_handle.index(), ray_o, ray_d, ray.time,
+                                  ray.maxt, coherent, active, 0, out);
 
-        // The kd-tree traces in ``Float`` precision, so the hit fields are
+        // The native trees trace in ``Float`` precision, so the hit fields are
         // stolen at that width.
         return decode_cpu_llvm_pi<Float, Spectrum, Float>(out,
                                                           shapes_registry_ids);
@@ -199,7 +303,9 @@ NativeAccel<Float, Spectrum>::ray_test(const Scene<Float, Spectrum> * /*scene*/,
                                        Mask active) const {
     if constexpr (!dr::is_jit_v<Float>) {
         DRJIT_MARK_USED(coherent);
-        return accel->template ray_intersect_preliminary<true>(ray, active).is_valid();
+        return visit_tree([&](auto *tree) {
+            return tree->template ray_intersect_preliminary<true>(ray, active);
+        }).is_valid();
     } else {
         dr::Array<Float, 3> ray_o(ray.o), ray_d(ray.d);
 
@@ -207,7 +313,8 @@ NativeAccel<Float, Spectrum>::ray_test(const Scene<Float, Spectrum> * /*scene*/,
         // first hit and returns a boolean hit mask.
         uint32_t out[1] { };
         cpu_llvm_ray_trace<Float>((void *) occlude_func_ptr,
-                                  occlude_handle.index(), (void *) accel,
+                                  occlude_handle.index(),
+                                  visit_tree([](auto *tree) { return (void *) tree; }),
                                   accel_handle.index(), ray_o, ray_d, ray.time,
                                   ray.maxt, coherent, active, 1, out);
 
@@ -220,8 +327,9 @@ typename NativeAccel<Float, Spectrum>::SurfaceInteraction3f
 NativeAccel<Float, Spectrum>::ray_intersect_naive(
     const Scene<Float, Spectrum> * /*scene*/, const Ray3f &ray,
     Mask active) const {
-    PreliminaryIntersection3f pi =
-        accel->template ray_intersect_naive<false>(ray, active);
+    PreliminaryIntersection3f pi = visit_tree([&](auto *tree) {
+        return tree->template ray_intersect_naive<false>(ray, active);
+    });
 
     return pi.compute_surface_interaction(ray, +RayFlags::Default, active);
 }
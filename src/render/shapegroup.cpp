@@ -87,10 +87,11 @@ MI_VARIANT void ShapeGroup<Float, Spectrum>::traverse(TraversalCallback *cb) {
 }
 
 MI_VARIANT void ShapeGroup<Float, Spectrum>::parameters_changed(const std::vector<std::string> &/*keys*/) {
+    // The group changed in the same way as its children
     for (auto &s : m_shapes) {
         if (s->dirty()) {
             m_dirty = true;
-            break;
+            m_dirty_flags |= s->dirty_flags();
         }
     }
 
@@ -153,13 +154,15 @@ std::tuple<bool,
            typename ShapeGroup<Float, Spectrum>::ScalarPoint2f,
            typename ShapeGroup<Float, Spectrum>::ScalarUInt32,
            typename ShapeGroup<Float, Spectrum>::ScalarUInt32>
-ShapeGroup<Float, Spectrum>::ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const {
+ShapeGroup<Float, Spectrum>::ray_intersect_preliminary_scalar(const ScalarRay3f &ray,
+                                                              ScalarIndex /*prim_index*/) const {
     auto pi = m_kdtree->template ray_intersect_scalar<false>(ray);
     return { pi.valid, pi.t, pi.prim_uv, pi.shape_index, pi.prim_index };
 }
 
 MI_VARIANT
-bool ShapeGroup<Float, Spectrum>::ray_test_scalar(const ScalarRay3f &ray) const {
+bool ShapeGroup<Float, Spectrum>::ray_test_scalar(const ScalarRay3f &ray,
+                                                  ScalarIndex /*prim_index*/) const {
     return m_kdtree->template ray_intersect_scalar<true>(ray).is_valid();
 }
 #endif
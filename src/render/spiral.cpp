@@ -5,9 +5,9 @@
 NAMESPACE_BEGIN(mitsuba)
 
 Spiral::Spiral(const Vector2u &size, const Vector2u &offset,
-               uint32_t block_size, uint32_t passes)
+               uint32_t block_size, uint32_t passes, bool scanline)
     : m_size(size), m_offset(offset), m_passes_left(passes),
-      m_block_size(block_size) {
+      m_block_size(block_size), m_scanline(scanline) {
 
     m_blocks = (size + (block_size - 1)) / block_size;
     m_block_count = dr::prod(m_blocks);
@@ -18,7 +18,7 @@ Spiral::Spiral(const Vector2u &size, const Vector2u &offset,
 void Spiral::reset() {
     m_block_counter = 0;
     direction = Direction::Right;
-    m_position = Vector2u(m_blocks / 2);
+    m_position = m_scanline ? Vector2u(0) : Vector2u(m_blocks / 2);
     m_steps_left = 1;
     m_spiral_size = 1;
 }
@@ -47,7 +47,13 @@ std::tuple<Spiral::Vector2i, Spiral::Vector2u, uint32_t> Spiral::next_block() {
 
     ++m_block_counter;
 
-    if (m_block_counter != m_block_count) {
+    if (m_scanline) {
+        // Advance to the next block in scanline order
+        if (++m_position.x() == (int32_t) m_blocks.x()) {
+            m_position.x() = 0;
+            ++m_position.y();
+        }
+    } else if (m_block_counter != m_block_count) {
         // Prepare the next block's position along the spiral.
         do {
             switch (direction) {
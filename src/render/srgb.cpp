@@ -4,32 +4,38 @@
 #include <mitsuba/render/texture.h>
 #include <mitsuba/render/srgb.h>
 #include <rgb2spec.h>
+#include <atomic>
 #include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
 
-static RGB2Spec *model = nullptr;
+/* Loaded on first use. Textures that are instantiated in parallel may race to
+   do so, hence the atomic pointer for the double-checked lock. */
+static std::atomic<RGB2Spec *> model { nullptr };
 static std::mutex model_mutex;
 
 dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
     using Array3f = dr::Array<float, 3>;
 
-    if (unlikely(model == nullptr)) {
+    RGB2Spec *m = model.load(std::memory_order_acquire);
+    if (unlikely(m == nullptr)) {
         std::lock_guard<std::mutex> lock(model_mutex);
-        if (model == nullptr) {
+        m = model.load(std::memory_order_relaxed);
+        if (m == nullptr) {
             FileResolver *fr = file_resolver();
             std::string fname = fr->resolve("data/srgb.coeff").string();
             Log(Info, "Loading spectral upsampling model \"data/srgb.coeff\" .. ");
-            model = rgb2spec_load(fname.c_str());
-            if (model == nullptr)
+            m = rgb2spec_load(fname.c_str());
+            if (m == nullptr)
                 Throw("Could not load sRGB-to-spectrum upsampling model ('data/srgb.coeff')");
-            atexit([]{ rgb2spec_free(model); });
+            model.store(m, std::memory_order_release);
+            atexit([]{ rgb2spec_free(model.load()); });
         }
     }
 
     float rgb[3] = { (float) c.r(), (float) c.g(), (float) c.b() };
     float out[3];
-    rgb2spec_fetch(model, rgb, out);
+    rgb2spec_fetch(m, rgb, out);
 
     return Array3f(out[0], out[1], out[2]);
 }
@@ -35,8 +35,9 @@ def create_stairs(num_steps):
         positions=mi.TensorXf(v.numpy().astype(np.float32)))
     return mesh
 
-def make_synthetic_scene(n_steps):
+def make_synthetic_scene(n_steps, accel="kdtree"):
     props = mi.Properties("scene")
+    props["accel"] = accel
     props["_unnamed_0"] = create_stairs(n_steps)
     return mi.Scene(props)
 
@@ -47,12 +48,13 @@ def compare_results(res_a, res_b, atol=0.0):
         assert dr.allclose(res_a.t, res_b.t, atol=atol), "\n%s\n\n%s" % (res_a.t, res_b.t)
 
 
-def test01_depth_scalar_stairs(variant_scalar_rgb):
+@pytest.mark.parametrize("accel", ["kdtree", "bvh"])
+def test01_depth_scalar_stairs(variant_scalar_rgb, accel):
     if mi.MI_ENABLE_EMBREE:
         pytest.skip("EMBREE enabled")
 
     n_steps = 20
-    scene = make_synthetic_scene(n_steps)
+    scene = make_synthetic_scene(n_steps, accel)
 
     n = 128
     inv_n = 1.0 / (n-1)
@@ -111,3 +113,207 @@ def test02_depth_scalar_bunny(variant_scalar_rgb):
             res_shadow = scene.ray_test(r)
             assert dr.all(res_shadow == res_naive.is_valid())
             compare_results(res_naive, res)
+
+
+@fresolver_append_path
+def test03_packet_traversal_llvm(variants_any_llvm):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    def load(kd_packet):
+        return mi.load_dict({
+            'type': 'scene',
+            'kd_packet': kd_packet,
+            'shape': {
+                "type" : "ply",
+                "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+            },
+            'sphere': {
+                'type': 'sphere',
+                'center': [0, 0, 0],
+                'radius': 0.02
+            }
+        })
+
+    scene_packet, scene_lanes = load(True), load(False)
+    b = scene_packet.bbox()
+
+    # Coherent rays: a parallel grid shot along +Z through the bounding box
+    n = 64
+    x, y = dr.meshgrid(dr.linspace(mi.Float, 0, 1, n),
+                       dr.linspace(mi.Float, 0, 1, n))
+    o = mi.Point3f(dr.lerp(b.min[0], b.max[0], x),
+                   dr.lerp(b.min[1], b.max[1], y),
+                   b.min[2] - 1)
+    rays = [mi.Ray3f(o, mi.Vector3f(0, 0, 1))]
+
+    # Incoherent rays: random directions from within the bounding box
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n * n)
+    o = dr.lerp(mi.Point3f(b.min), mi.Point3f(b.max), mi.Point3f(
+        sampler.next_1d(), sampler.next_1d(), sampler.next_1d()))
+    d = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    rays.append(mi.Ray3f(o, d))
+
+    for ray in rays:
+        res_packet = scene_packet.ray_intersect_preliminary(ray)
+        res_lanes  = scene_lanes.ray_intersect_preliminary(ray)
+        compare_results(res_packet, res_lanes, atol=1e-5)
+        assert dr.all((res_packet.prim_index == res_lanes.prim_index) |
+                      ~res_lanes.is_valid())
+
+        assert dr.all(scene_packet.ray_test(ray) == scene_lanes.ray_test(ray))
+
+
+@fresolver_append_path
+def test04_bvh_bunny(variants_any_llvm):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    def load(accel, **kwargs):
+        return mi.load_dict({
+            'type': 'scene',
+            'accel': accel,
+            'shape': {
+                "type" : "ply",
+                "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+            },
+            'sphere': {
+                'type': 'sphere',
+                'center': [0, 0, 0],
+                'radius': 0.02
+            },
+            **kwargs
+        })
+
+    scene_kdtree = load('kdtree')
+    b = scene_kdtree.bbox()
+
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, 64 * 64)
+    o = dr.lerp(mi.Point3f(b.min), mi.Point3f(b.max), mi.Point3f(
+        sampler.next_1d(), sampler.next_1d(), sampler.next_1d()))
+    d = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    ray = mi.Ray3f(o, d)
+
+    res_kdtree = scene_kdtree.ray_intersect_preliminary(ray)
+
+    # Small bins/leaves exercise deeper trees
+    for kwargs in [{}, {'bvh_bins': 2, 'bvh_max_leaf_size': 1}]:
+        scene_bvh = load('bvh', **kwargs)
+        res_bvh = scene_bvh.ray_intersect_preliminary(ray)
+        compare_results(res_bvh, res_kdtree, atol=1e-5)
+        assert dr.all((res_bvh.prim_index == res_kdtree.prim_index) |
+                      ~res_kdtree.is_valid())
+        assert dr.all(scene_bvh.ray_test(ray) == scene_kdtree.ray_test(ray))
+
+
+def test05_bvh_invalid_accel(variant_scalar_rgb):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    with pytest.raises(RuntimeError, match='unsupported acceleration'):
+        mi.load_dict({'type': 'scene', 'accel': 'octree'})
+
+
+def test06_build_report(variant_scalar_rgb):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    import numpy as np
+
+    # Soup of small triangles, large enough to sort events in parallel and to
+    # hand subtrees of the O(N log N) builder to separate tasks
+    n = 50000
+    rng = np.random.default_rng(0)
+    centers = np.repeat(rng.random((n, 3)), 3, axis=0)
+    positions = centers + 0.01 * rng.random((3 * n, 3)) - 0.005
+    faces = np.arange(3 * n, dtype=np.uint32).reshape(n, 3)
+
+    mesh = mi.Mesh("soup")
+    mesh.from_fields(faces=mi.TensorXu(faces),
+                     positions=mi.TensorXf(positions.astype(np.float32)))
+
+    props = mi.Properties("scene")
+    props["kd_exact_primitive_threshold"] = 2 * n
+    props["_unnamed_0"] = mesh
+    scene = mi.Scene(props)
+
+    report = scene.kdtree_build_report()
+    assert report is not None
+    assert report.primitive_count == n
+    assert report.index_count >= n - report.pruned
+    assert dr.allclose(report.duplication_factor, report.index_count / n)
+    assert report.node_count >= 2 * report.leaf_count - 1
+    assert report.nonempty_leaf_count <= report.leaf_count
+    assert sum(report.leaf_histogram) <= report.leaf_count
+    assert report.max_leaf_size > 0 and report.max_depth > 0
+    assert report.cost > 0 and report.expected_primitive_visits > 0
+    assert report.subtree_tasks > 0
+    assert report.total_time >= report.construction_time >= 0
+    assert 'KDTreeBuildReport' in str(report)
+
+    # The tree must agree with a brute force search
+    for i in range(64):
+        o = rng.random(3)
+        d = rng.normal(size=3)
+        d /= np.linalg.norm(d)
+        r = mi.Ray3f(mi.Point3f(*o), mi.Vector3f(*d))
+        res_naive = scene.ray_intersect_naive(r)
+        res = scene.ray_intersect(r)
+        compare_results(res_naive, res, atol=1e-5)
+
+    # Other acceleration data structures don't provide a report
+    assert make_synthetic_scene(4, "bvh").kdtree_build_report() is None
+
+
+@fresolver_append_path
+def test07_accel_cache(variant_scalar_rgb, tmp_path):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    import os
+
+    # Missing parent directories of the cache are created as well
+    cache_dir = tmp_path / 'nested' / 'cache'
+
+    def load(offset=0.0):
+        return mi.load_dict({
+            'type': 'scene',
+            'accel_cache': str(cache_dir),
+            'bunny': {
+                'type': 'ply',
+                'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+                'to_world': mi.ScalarTransform4f().translate([offset, 0, 0])
+            }
+        })
+
+    scene_1 = load()
+    report_1 = scene_1.kdtree_build_report()
+    assert not report_1.cached
+    files = os.listdir(cache_dir)
+    assert len(files) == 1 and files[0].endswith('.bin')
+
+    # The second load must be served from the cache
+    scene_2 = load()
+    report_2 = scene_2.kdtree_build_report()
+    assert report_2.cached
+    assert report_2.primitive_count == report_1.primitive_count
+    assert report_2.node_count == report_1.node_count
+    assert report_2.index_count == report_1.index_count
+
+    rng = mi.PCG32(initstate=7)
+    bbox = scene_1.bbox()
+    for i in range(64):
+        o = bbox.min + (bbox.max - bbox.min) * mi.Point3f(
+            rng.next_float32(), rng.next_float32(), rng.next_float32())
+        d = dr.normalize(mi.Vector3f(rng.next_float32() - .5,
+                                     rng.next_float32() - .5,
+                                     rng.next_float32() - .5))
+        r = mi.Ray3f(o, d)
+        compare_results(scene_1.ray_intersect(r), scene_2.ray_intersect(r))
+
+    # Moving the geometry invalidates the cached tree
+    scene_3 = load(offset=1.0)
+    assert not scene_3.kdtree_build_report().cached
+    assert len(os.listdir(cache_dir)) == 2
@@ -417,3 +417,103 @@ def test11_serialized_legacy_versions(variants_all_rgb, tmp_path, version,
     m = mi.load_dict({'type': 'serialized', 'filename': fname,
                       'face_normals': True})
     assert not m.has_normals()
+
+
+def test12_obj_parallel_chunks(variant_scalar_rgb, tmp_path):
+    """OBJ files larger than the parser's chunk size are parsed in parallel.
+    Faces in later chunks reference values defined in earlier ones, and
+    references past the values defined so far are still rejected."""
+    n = 400
+    x, y = np.meshgrid(np.arange(n), np.arange(n))
+    x, y = x.ravel(), y.ravel()
+    idx = np.arange(n * n).reshape(n, n)[:-1, :-1].ravel() + 1
+
+    lines = [f"v {a} {b} {0.25 * a}" for a, b in zip(x, y)]
+    lines += [f"vt {a / n} {b / n}" for a, b in zip(x, y)]
+    lines += [f"f {i}/{i} {i + 1}/{i + 1} {i + n + 1}/{i + n + 1} {i + n}/{i + n}"
+              for i in idx]
+    obj = "\n".join(lines) + "\n"
+    assert len(obj) > 8 * 1024 * 1024
+
+    path = tmp_path / "grid.obj"
+    path.write_text(obj)
+    m = mi.load_dict({"type": "obj", "filename": str(path)})
+
+    assert m.face_count() == 2 * (n - 1) ** 2
+    assert m.vertex_count() == n * n
+    pos = vertex_positions(m)
+    uv = np.array(m.texcoords())
+    assert np.allclose(uv[:, 0] * n, pos[:, 0])
+    assert np.allclose((1 - uv[:, 1]) * n, pos[:, 1], atol=1e-3)
+    assert np.allclose(m.surface_area(), (n - 1) ** 2 * np.sqrt(1 + 0.25 ** 2),
+                       rtol=1e-3)
+
+    path.write_text(obj + f"f 1 2 {n * n + 1}\n")
+    with pytest.raises(RuntimeError, match=f'invalid vertex {n * n + 1}'):
+        mi.load_dict({"type": "obj", "filename": str(path)})
+
+
+def test13_serialized_legacy_v5(variants_all_rgb, tmp_path):
+    """Version 5 files, which store everything in a single zlib stream,
+    remain readable"""
+    positions = np.float32([[0, 0, 0], [1, 0, 0], [1, 1, 0], [0, 1, 0]])
+    faces = np.uint32([[0, 1, 2, 0], [0, 2, 3, 0]])
+    records = np.zeros((4, 8), dtype=np.float32)
+    records[:, :3] = positions
+
+    name = b'v5'
+    payload = struct.pack('<II', 0x1000, len(name)) + name
+    payload += struct.pack('<QQQQ', 4, 2, 0, 0)
+    payload += records.tobytes() + faces.tobytes()
+    payload += struct.pack('<I', 0)
+
+    fname = str(tmp_path / "v5.serialized")
+    with open(fname, 'wb') as f:
+        f.write(struct.pack('<HH', 0x041C, 5))
+        f.write(zlib.compress(payload))
+
+    m = mi.load_dict({'type': 'serialized', 'filename': fname})
+    assert m.vertex_count() == 4 and m.face_count() == 2
+    assert np.allclose(vertex_positions(m), positions)
+    assert np.array_equal(faces_of(m), faces[:, :3])
+
+
+def test14_serialized_blocks(variant_scalar_rgb, tmp_path):
+    """Arrays larger than the compression block size of the current format
+    span several independently compressed blocks, and shapes behind such a
+    mesh are found directly through the index."""
+    n = 200
+    x, y = np.meshgrid(np.linspace(0, 1, n), np.linspace(0, 1, n))
+    positions = np.stack([x.ravel(), y.ravel(), x.ravel() * y.ravel()],
+                         axis=1).astype(np.float32)
+    idx = np.arange(n * n).reshape(n, n)[:-1, :-1].ravel()
+    quads = np.stack([idx, idx + 1, idx + n + 1, idx + n], axis=1)
+
+    big = mi.Mesh("big")
+    big.from_corners(positions=positions,
+                     corner_vertex=quads.ravel().astype(np.uint32),
+                     face_size=4,
+                     attrs={"vertex_color": positions})
+    positions, corner_vertex, uv = quad_corners()
+    small = mi.Mesh("small")
+    small.from_corners(positions=positions, corner_vertex=corner_vertex,
+                       texcoords=uv)
+
+    fname = str(tmp_path / "blocks.serialized")
+    stream = mi.FileStream(fname, mi.FileStream.EMode.ETruncReadWrite)
+    offsets = []
+    for m in (big, small):
+        offsets.append(stream.tell())
+        m.write_serialized(stream)
+    for o in offsets:
+        stream.write_uint64(o)
+    stream.write_uint32(len(offsets))
+    stream.close()
+
+    for i, m in enumerate((big, small)):
+        m2 = mi.load_dict({'type': 'serialized', 'filename': fname,
+                           'shape_index': i})
+        assert m2.vertex_count() == m.vertex_count()
+        assert np.array_equal(face_records(m2), face_records(m))
+        assert np.array_equal(vertex_positions(m2), vertex_positions(m))
+    assert np.array_equal(np.array(m2.texcoords()), np.array(small.texcoords()))
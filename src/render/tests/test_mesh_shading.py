@@ -535,3 +535,67 @@ def test12_sample_position(variants_vec_rgb, flip_normals):
     cy = (0.5 * (1 / 3) + 2.0 * (2 / 3)) / 2.5
     dr.assert_allclose(dr.mean(ps.p.x), cx, atol=0.02)
     dr.assert_allclose(dr.mean(ps.p.y), cy, atol=0.02)
+
+
+# -------------------------------------------------------------------
+# Quantized storage
+# -------------------------------------------------------------------
+
+@fresolver_append_path
+def test13_quantized_storage(variants_all_rgb):
+    """Meshes loaded with ``quantize`` decode their records during
+    intersection and shading. The results match the full-precision mesh up
+    to the reported position error and half precision texture
+    coordinates."""
+    def load(quantize):
+        return mi.load_dict({
+            'type': 'obj',
+            'filename': 'resources/data/common/meshes/sphere.obj',
+            'quantize': quantize
+        })
+
+    if mi.variant().startswith(('cuda', 'metal')):
+        with pytest.raises(RuntimeError, match='only supported by CPU'):
+            load(True)
+        return
+
+    ref, m = load(False), load(True)
+    assert m.is_quantized() and not ref.is_quantized()
+
+    # The records occupy about half of the full-precision footprint
+    assert m.storage_size() < 0.6 * ref.storage_size()
+
+    # 16-bit positions relative to boxes within the unit sphere
+    err = m.quantization_error()
+    assert 0 < err < 2 * 3**0.5 / 65535
+    assert dr.width(m.packed_vertices()) == 0
+
+    # The decoded fields match the full-precision mesh
+    assert np.array_equal(np.array(m.faces()), np.array(ref.faces()))
+    assert np.allclose(np.array(m.positions()), np.array(ref.positions()),
+                       atol=err)
+    assert np.allclose(np.array(m.texcoords()), np.array(ref.texcoords()),
+                       atol=1e-3)
+    assert np.allclose(np.array(m.normals()), np.array(ref.normals()),
+                       atol=1e-4)
+
+    # Rays towards the center hit both meshes at nearly the same spot
+    n = 256
+    phi = dr.arange(mi.Float, n) * (2 * dr.pi / n) + 0.01
+    d = mi.Vector3f(dr.cos(phi), dr.sin(phi), 0.3)
+    ray = mi.Ray3f(o=mi.Point3f(-3 * d), d=dr.normalize(d))
+
+    si_ref = mi.load_dict({'type': 'scene', 'm': ref}).ray_intersect(ray)
+    si = mi.load_dict({'type': 'scene', 'm': m}).ray_intersect(ray)
+    assert dr.all(si.is_valid() & si_ref.is_valid())
+    dr.assert_allclose(si.p, si_ref.p, atol=1e-4)
+    dr.assert_allclose(si.uv, si_ref.uv, atol=1e-3)
+    dr.assert_allclose(si.sh_frame.n, si_ref.sh_frame.n, atol=1e-3)
+
+    # The decoded records survive a parameter update
+    params = mi.traverse(m)
+    params['positions'] = params['positions'] * 2
+    params.update()
+    assert m.is_quantized()
+    assert np.allclose(np.array(m.positions()),
+                       2 * np.array(ref.positions()), atol=4 * err)
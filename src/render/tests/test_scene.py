@@ -363,3 +363,294 @@ def test12_many_top_level_analytic_shapes(variants_vec_backends_once_rgb):
     for i in range(n):
         got = dr.gather(mi.ShapePtr, si.shape, mi.UInt32(i))
         assert dr.all(got == shapes[i])
+
+
+def light_tree_scene(light_tree):
+    from mitsuba import ScalarTransform4f as T
+    d = {'type': 'scene', 'light_tree': light_tree}
+    for i in range(12):
+        d[f'rect_{i}'] = {
+            'type': 'rectangle',
+            'to_world': T().translate([2.0 * (i % 4) - 3.0,
+                                                          2.0 * (i // 4) - 2.0,
+                                                          4.0 + i % 3])
+                        @ T().scale(0.2 + 0.05 * i),
+            'emitter': {'type': 'area', 'sampling_weight': 1.0 + 0.25 * i},
+        }
+    d['point'] = {'type': 'point', 'position': [0, 3, 1]}
+    d['env'] = {'type': 'constant', 'sampling_weight': 0.5}
+    return mi.load_dict(d)
+
+
+def test13_light_tree_pdf(variants_vec_backends_once_rgb):
+    """The emitter sampling PDF of the light tree is reproduced by
+    pdf_emitter_direction(), as required for MIS."""
+    scene = light_tree_scene(True)
+    n = 256
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    it = dr.zeros(mi.SurfaceInteraction3f, n)
+    it.p = mi.Point3f(4.0 * sampler.next_1d() - 2.0,
+                      4.0 * sampler.next_1d() - 2.0, 0.0)
+    it.n = mi.Normal3f(0, 0, 1)
+    it.wavelengths = dr.zeros(mi.Spectrum)
+
+    ds, weight = scene.sample_emitter_direction(it, sampler.next_2d(), False)
+    pdf = scene.pdf_emitter_direction(it, ds)
+    valid = ds.pdf > 0
+    assert dr.any(valid)
+    dr.assert_allclose(dr.select(valid, pdf, 0), ds.pdf, rtol=1e-3)
+
+
+def test14_light_tree_estimate(variants_vec_rgb):
+    """Direct illumination estimated with the light tree matches the
+    estimate obtained with sampling-weight-based emitter selection."""
+    n = 1 << 18
+    results = []
+    for light_tree in [False, True]:
+        scene = light_tree_scene(light_tree)
+        sampler = mi.load_dict({'type': 'independent'})
+        sampler.seed(0, n)
+
+        it = dr.zeros(mi.SurfaceInteraction3f, n)
+        it.p = mi.Point3f(0.5, -0.5, 0.0)
+        it.n = mi.Normal3f(0, 0, 1)
+        it.wavelengths = dr.zeros(mi.Spectrum)
+
+        ds, weight = scene.sample_emitter_direction(it, sampler.next_2d(), False)
+        value = weight * dr.maximum(dr.dot(ds.d, it.n), 0)
+        results.append(dr.mean(value, axis=None))
+
+    dr.assert_allclose(results[0], results[1], rtol=2e-2)
+
+
+@fresolver_append_path
+@pytest.mark.parametrize("accel", [None, 'bvh'])
+def test15_incremental_accel_update(variants_all_backends_once, accel):
+    """Moving vertices or instances updates the acceleration structure
+    incrementally, and a later change of the topology still rebuilds it."""
+    if accel is not None and (mi.MI_ENABLE_EMBREE or
+                              not mi.variant().startswith(('scalar', 'llvm'))):
+        pytest.skip("Builtin acceleration data structures are not used")
+
+    scene_dict = {
+        'type': 'scene',
+        'rect': {
+            'type': 'ply',
+            'filename': 'resources/data/tests/ply/rectangle_normals_uv.ply'
+        },
+        'group': {
+            'type': 'shapegroup',
+            'sphere': {'type': 'sphere', 'radius': 0.5}
+        },
+        'instance': {
+            'type': 'instance',
+            'shapegroup': {'type': 'ref', 'id': 'group'},
+            'to_world': mi.ScalarTransform4f().translate([5, 0, 0])
+        }
+    }
+    if accel is not None:
+        scene_dict['accel'] = accel
+    scene = mi.load_dict(scene_dict)
+
+    def trace(o):
+        ray = mi.Ray3f(o, [0, 1, 0])
+        return scene.ray_intersect_preliminary(ray).t
+
+    params = mi.traverse(scene)
+    init_pos = mi.Point3f(params['rect.positions'], flip_axes=True)
+    t_rect, t_sphere = trace([0, -5, 0]), trace([5, -5, 0])
+    dr.assert_allclose(t_sphere, 4.5)
+
+    # Vertex-only change (refit)
+    v = mi.Vector3f(0, 0, 10)
+    params['rect.positions'] = mi.TensorXf(init_pos + v, flip_axes=True)
+    params.update()
+    dr.assert_allclose(trace(mi.Point3f(0, -5, 0) + v), t_rect)
+    assert not dr.all(dr.isfinite(trace([0, -5, 0])))
+
+    # Transform-only change (top level)
+    params['instance.to_world'] = mi.Transform4f().translate([-5, 0, 0])
+    params.update()
+    dr.assert_allclose(trace([-5, -5, 0]), 4.5)
+    assert not dr.all(dr.isfinite(trace([5, -5, 0])))
+    dr.assert_allclose(trace(mi.Point3f(0, -5, 0) + v), t_rect)
+
+    # The scene bounds follow
+    assert scene.bbox().min.x <= -5.5 + 1e-4
+    assert scene.bbox().max.z >= 10 - 1e-4
+
+    # Topology change (full rebuild): only keep the first triangle. A refit
+    # tree would still reference the removed one. The probes lie on both
+    # sides of either diagonal of the rectangle.
+    import numpy as np
+    probes = [[0.6, -0.2], [-0.6, 0.2], [0.2, 0.6], [-0.2, -0.6]]
+
+    def hit_prims():
+        prims = []
+        for x, z in probes:
+            pi = scene.ray_intersect_preliminary(
+                mi.Ray3f(mi.Point3f(x, -5, z) + v, [0, 1, 0]))
+            if dr.all(pi.is_valid()):
+                prims.append(dr.all(pi.prim_index == 0))
+        return prims
+
+    assert len(hit_prims()) == 4
+    params['rect.faces'] = np.array(params['rect.faces'])[:1]
+    params.update()
+
+    prims = hit_prims()
+    assert len(prims) == 2 and all(prims)
+    dr.assert_allclose(trace([-5, -5, 0]), 4.5)
+
+
+@pytest.mark.parametrize("accel", [None, 'bvh'])
+def test16_accel_quality(variants_all_backends_once, accel):
+    """All build qualities produce a valid acceleration structure."""
+    if accel is not None and (mi.MI_ENABLE_EMBREE or
+                              not mi.variant().startswith(('scalar', 'llvm'))):
+        pytest.skip("Builtin acceleration data structures are not used")
+
+    def load(quality, res=16, spp=4):
+        scene_dict = {
+            'type': 'scene',
+            'accel_quality': quality,
+            'cube': {
+                'type': 'cube',
+                'to_world': mi.ScalarTransform4f().scale(0.5)
+            },
+            'rect': {
+                'type': 'rectangle',
+                'to_world': mi.ScalarTransform4f().translate([0.5, 0.5, 1])
+            },
+            'sensor': {
+                'type': 'perspective',
+                'film': {'type': 'hdrfilm', 'width': res, 'height': res},
+                'sampler': {'type': 'independent', 'sample_count': spp}
+            }
+        }
+        if accel is not None:
+            scene_dict['accel'] = accel
+        return mi.load_dict(scene_dict)
+
+    n = 64
+    x = dr.linspace(mi.Float, -1.2, 1.2, n)
+    x, y = dr.meshgrid(x, x)
+    ray = mi.Ray3f(mi.Point3f(x, y, -2), mi.Vector3f(0, 0, 1))
+
+    ref = None
+    for quality, expected in [('high', mi.AccelQuality.High),
+                              ('medium', mi.AccelQuality.Medium),
+                              ('low', mi.AccelQuality.Low)]:
+        scene = load(quality)
+        assert scene.accel_quality() == expected
+        assert scene.accel_build_time() >= 0
+        t = scene.ray_intersect_preliminary(ray).t
+        if ref is None:
+            ref = t
+            assert dr.any(dr.isfinite(t))
+        else:
+            dr.assert_allclose(t, ref)
+
+    # Few samples per primitive favor a fast build, many a good tree
+    assert load('auto', res=1, spp=1).accel_quality() == mi.AccelQuality.Low
+    assert load('auto', spp=4096).accel_quality() == mi.AccelQuality.High
+
+    with pytest.raises(RuntimeError, match='unsupported acceleration data'):
+        load('fastest')
+
+
+def light_tree_mesh_scene(light_tree):
+    from mitsuba import ScalarTransform4f as T
+    d = {'type': 'scene', 'light_tree': light_tree}
+    for i in range(10):
+        # Quads facing the receivers at z=0, tilted sideways, or facing away
+        d[f'quad_{i}'] = {
+            'type': 'obj',
+            'filename': 'resources/data/common/meshes/rectangle.obj',
+            'to_world': T().translate([1.5 * (i % 5) - 3.0,
+                                       2.0 * (i // 5) - 1.0,
+                                       2.0 + 0.5 * (i % 3)])
+                        @ T().rotate([1, 0, 0], 180.0 - 40.0 * (i % 4))
+                        @ T().rotate([0, 1, 0], 25.0 * (i % 3))
+                        @ T().scale(0.3),
+            'emitter': {
+                'type': 'area',
+                'radiance': {'type': 'rgb', 'value': 1.0 + 0.5 * i}
+            },
+        }
+    return mi.load_dict(d)
+
+
+def light_tree_receiver(p, n):
+    it = dr.zeros(mi.SurfaceInteraction3f, n)
+    it.p = p
+    it.n = mi.Normal3f(0, 0, 1)
+    it.sh_frame = mi.Frame3f(it.n)
+    it.wavelengths = dr.zeros(mi.Spectrum)
+    return it
+
+
+@fresolver_append_path
+def test17_light_tree_mesh_pdf(variants_vec_backends_once_rgb):
+    """With oriented triangle mesh emitters, pdf_emitter_direction()
+    reproduces the density of the directions sampled through the light
+    tree."""
+    scene = light_tree_mesh_scene(True)
+    n = 1024
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    it = light_tree_receiver(mi.Point3f(4.0 * sampler.next_1d() - 2.0,
+                                        4.0 * sampler.next_1d() - 2.0, 0.0), n)
+
+    ds, weight = scene.sample_emitter_direction(it, sampler.next_2d(), False)
+    valid = ds.pdf > 0
+    assert dr.any(valid)
+    assert dr.all(valid | (weight[0] == 0))
+
+    pdf = scene.pdf_emitter_direction(it, ds, valid)
+    dr.assert_allclose(dr.select(valid, pdf, 0), ds.pdf, rtol=1e-3)
+
+
+@fresolver_append_path
+def test18_light_tree_mis(variants_vec_rgb):
+    """Direct illumination combining light tree emitter sampling and
+    cosine-weighted direction sampling through MIS matches the estimate
+    obtained with uniform emitter selection."""
+    n = 1 << 18
+    p = mi.Point3f(0.5, -0.5, 0.0)
+
+    def mis(pdf_a, pdf_b):
+        return dr.select(pdf_a > 0, pdf_a / (pdf_a + pdf_b), 0)
+
+    # Reference: uniform emitter selection without MIS (diffuse receiver)
+    scene = light_tree_mesh_scene(False)
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+    it = light_tree_receiver(p, n)
+
+    ds, weight = scene.sample_emitter_direction(it, sampler.next_2d(), True)
+    cos_theta = dr.maximum(dr.dot(ds.d, it.n), 0)
+    ref = dr.mean(weight * cos_theta / dr.pi, axis=None)
+
+    # Emitter sampling through the light tree
+    scene = light_tree_mesh_scene(True)
+    sampler.seed(1, n)
+
+    ds, weight = scene.sample_emitter_direction(it, sampler.next_2d(), True)
+    pdf_bsdf = dr.maximum(dr.dot(ds.d, it.n), 0) / dr.pi
+    result = weight * pdf_bsdf * mis(ds.pdf, pdf_bsdf)
+
+    # Cosine-weighted direction sampling, whose weight is one
+    wo = mi.warp.square_to_cosine_hemisphere(sampler.next_2d())
+    si = scene.ray_intersect(it.spawn_ray(wo))
+    hit = si.is_valid()
+    emitted = si.emitter(scene).eval(si, hit)
+
+    ds = mi.DirectionSample3f(scene, si=si, ref=it)
+    pdf_em = scene.pdf_emitter_direction(it, ds, hit)
+    result += dr.select(hit, emitted * mis(wo.z / dr.pi, pdf_em), 0)
+
+    dr.assert_allclose(dr.mean(result, axis=None), ref, rtol=2e-2)
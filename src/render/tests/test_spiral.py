@@ -77,3 +77,17 @@ def test03_normal_film(variant_scalar_rgb):
     # Resetting and re-querying the blocks should yield the exact same results.
     s.reset()
     check_first_blocks(extract_blocks(s), expected, n_total=110)
+
+
+def test04_scanline(variant_scalar_rgb):
+    # Blocks are generated row by row, covering the film exactly once per pass
+    f = make_film(70, 40)
+    s = mi.Spiral(f.size(), f.crop_offset(), block_size=32, passes=2,
+                  scanline=True)
+    expected = [
+        [(0, 0), (32, 32)], [(32, 0), (32, 32)], [(64, 0), (6, 32)],
+        [(0, 32), (32, 8)], [(32, 32), (32, 8)], [(64, 32), (6, 8)]
+    ]
+    blocks = extract_blocks(s)
+    check_first_blocks(blocks, expected + expected)
+    assert [b[2] for b in blocks] == [6, 7, 8, 9, 10, 11, 0, 1, 2, 3, 4, 5]
@@ -3,6 +3,7 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/render/interaction.h>
+#include <algorithm>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -57,6 +58,12 @@ Volume<Float, Spectrum>::max_per_channel(ScalarFloat * /*out*/) const {
     NotImplementedError("max_per_channel");
 }
 
+MI_VARIANT void
+Volume<Float, Spectrum>::max_grid(const ScalarVector3u &res,
+                                  ScalarFloat *out) const {
+    std::fill(out, out + dr::prod(res), max());
+}
+
 MI_VARIANT typename Volume<Float, Spectrum>::ScalarVector3i
 Volume<Float, Spectrum>::resolution() const {
     return ScalarVector3i(1, 1, 1);
@@ -2,6 +2,7 @@
 #include <mitsuba/core/stream.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -122,6 +123,110 @@ void VolumeGrid<Float, Spectrum>::write(Stream *stream) const {
     }
 }
 
+MI_VARIANT
+void VolumeGrid<Float, Spectrum>::write_sparse(const fs::path &path,
+                                               uint32_t brick_size) const {
+    ref<FileStream> fs = new FileStream(path, FileStream::ETruncReadWrite);
+    write_sparse(fs, brick_size);
+}
+
+MI_VARIANT
+void VolumeGrid<Float, Spectrum>::write_sparse(Stream *stream,
+                                               uint32_t brick_size) const {
+    if (brick_size != 8 && brick_size != 16)
+        Throw("write_sparse(): the brick size must be 8 or 16 (got %u)!",
+              brick_size);
+    if (m_channel_count != 1 && m_channel_count != 3)
+        Throw("write_sparse(): only volumes with 1 or 3 channels are "
+              "supported (got %u)!", m_channel_count);
+
+    Timer timer;
+    ScalarVector3u bricks = (m_size + brick_size - 1) / brick_size;
+    size_t brick_count = dr::prod(bricks);
+    std::vector<uint32_t> index(brick_count, SparseVolumeEmptyBrick);
+    std::vector<float> maxima;
+
+    // Copy brick 'b' into 'out' (zero-padded), returning whether it is empty
+    std::vector<float> brick(brick_size * brick_size * brick_size *
+                             m_channel_count);
+    auto fetch_brick = [&](size_t b) {
+        ScalarVector3u offset =
+            ScalarVector3u(b % bricks.x(), (b / bricks.x()) % bricks.y(),
+                           b / (bricks.x() * bricks.y())) * brick_size;
+        bool empty = true;
+        float *out = brick.data();
+        for (uint32_t z = 0; z < brick_size; ++z) {
+            for (uint32_t y = 0; y < brick_size; ++y) {
+                for (uint32_t x = 0; x < brick_size; ++x) {
+                    ScalarVector3u v = offset + ScalarVector3u(x, y, z);
+                    bool inside = dr::all(v < m_size);
+                    size_t i = ((size_t) (v.z() * m_size.y() + v.y()) *
+                                m_size.x() + v.x()) * m_channel_count;
+                    for (uint32_t c = 0; c < m_channel_count; ++c) {
+                        float value = inside ? (float) m_data[i + c] : 0.f;
+                        empty &= value == 0.f;
+                        *out++ = value;
+                    }
+                }
+            }
+        }
+        return empty;
+    };
+
+    // First pass: find the non-empty bricks and their per-channel maxima
+    uint32_t stored = 0;
+    for (size_t b = 0; b < brick_count; ++b) {
+        if (fetch_brick(b))
+            continue;
+        index[b] = stored++;
+        for (uint32_t c = 0; c < m_channel_count; ++c) {
+            float value = -dr::Infinity<float>;
+            for (size_t i = c; i < brick.size(); i += m_channel_count)
+                value = dr::maximum(value, brick[i]);
+            maxima.push_back(value);
+        }
+    }
+
+    stream->set_byte_order(Stream::ELittleEndian);
+    size_t start = stream->tell();
+    stream->write("SVL", 3);
+    stream->write(SparseVolumeVersion);
+    stream->write(brick_size);
+    stream->write(m_size.x());
+    stream->write(m_size.y());
+    stream->write(m_size.z());
+    stream->write(m_channel_count);
+    stream->write(float(m_bbox.min.x()));
+    stream->write(float(m_bbox.min.y()));
+    stream->write(float(m_bbox.min.z()));
+    stream->write(float(m_bbox.max.x()));
+    stream->write(float(m_bbox.max.y()));
+    stream->write(float(m_bbox.max.z()));
+    stream->write(stored);
+    stream->write_array(index.data(), index.size());
+    stream->write_array(maxima.data(), maxima.size());
+
+    // Page-align the brick data
+    size_t padding = (SparseVolumeAlignment -
+                      (stream->tell() - start) % SparseVolumeAlignment) %
+                     SparseVolumeAlignment;
+    std::vector<uint8_t> zeros(padding, 0);
+    stream->write(zeros.data(), padding);
+
+    // Second pass: write the non-empty bricks
+    for (size_t b = 0; b < brick_count; ++b) {
+        if (index[b] == SparseVolumeEmptyBrick)
+            continue;
+        fetch_brick(b);
+        stream->write_array(brick.data(), brick.size());
+    }
+
+    Log(Debug, "Wrote sparse volume: %u of %u bricks stored (%s, in %s)",
+        stored, brick_count,
+        util::mem_string(stored * brick.size() * sizeof(float)),
+        util::time_string((float) timer.value()));
+}
+
 MI_VARIANT
 std::string VolumeGrid<Float, Spectrum>::to_string() const {
     std::ostringstream oss;
@@ -32,9 +32,43 @@ Instance (:monosp:`instance`)
    - Specifies a linear object-to-world transformation. (Default: none (i.e. object space = world space))
    - |exposed|, |differentiable|, |discontinuous|
 
+ * - to_world_0, to_world_1, ...
+   - |transform|
+   - Keyframes of a motion-blurred instance, used instead of :monosp:`to_world` (see below).
+
+ * - time_start, time_end
+   - |float|
+   - Times of the first and last keyframe. (Default: 0 and 1)
+
 This plugin implements a geometry instance used to efficiently replicate geometry many times. For
 details on how to create instances, refer to the :ref:`shape-shapegroup` plugin.
 
+.. rubric:: Motion blur
+
+Instead of a single :monosp:`to_world` transformation, an instance can specify two or more
+keyframes :monosp:`to_world_0`, :monosp:`to_world_1`, etc. They are spaced uniformly over the
+interval between :monosp:`time_start` and :monosp:`time_end`, and each ray sees the instance at the
+interpolated transformation for its time (see the :monosp:`shutter_open` and
+:monosp:`shutter_close` parameters of the sensor). Rotations are interpolated spherically, and
+translations and scales linearly. Before the first and after the last keyframe, the instance
+remains in place. Any shape can be animated in this way by placing it into a shape group.
+
+The CPU acceleration data structures are aware of the motion: Embree uses its builtin motion blur
+support, while the builtin kd-tree and BVH treat each motion segment between two keyframes as a
+separate primitive bounded by the space it sweeps, which a ray only intersects if its time falls
+into that segment. Motion-blurred instances are not supported in CUDA and Metal variants, and
+their keyframes are not exposed as differentiable parameters.
+
+Embree requires all motion-blurred instances of a scene to share a single time range. When their
+ranges differ, the keyframes of each instance are resampled uniformly over the union of all ranges,
+at a spacing no larger than that of the original keyframes (and with at most 1024 keyframes). This
+is an approximation: between the resampled keyframes, Embree interpolates them rather than the
+original ones. Where an original keyframe, or the start or end of an instance's own time range,
+falls between two resampled keyframes, the motion is smoothed over and the instance may start
+moving slightly before :monosp:`time_start` or stop slightly after :monosp:`time_end`. The motion
+is exact when the keyframes of all instances line up, e.g. if the ranges coincide. The builtin
+kd-tree and BVH always evaluate the exact motion.
+
     .. image:: ../../resources/data/docs/images/render/shape_instance_fractal.jpg
         :width: 100%
         :align: center
@@ -61,6 +95,7 @@ public:
     using typename Base::ScalarSize;
     using typename Base::ScalarIndex;
     using ShapeGroup_ = ShapeGroup<Float, Spectrum>;
+    using AnimatedTransform_ = AnimatedTransform<Float>;
 
     Instance(const Properties &props) : Base(props) {
         for (auto &prop : props.objects()) {
@@ -77,17 +112,40 @@ public:
 
         m_shape_type = ShapeType::Instance;
 
+        std::vector<ScalarAffineTransform4f> keyframes;
+        for (size_t i = 0;; ++i) {
+            std::string name = "to_world_" + std::to_string(i);
+            if (!props.has_property(name))
+                break;
+            keyframes.push_back(props.get<ScalarAffineTransform4f>(name));
+        }
+
+        if (!keyframes.empty()) {
+            if (props.has_property("to_world"))
+                Throw("Specify either \"to_world\" or a sequence of "
+                      "keyframes \"to_world_0\", \"to_world_1\", .., but "
+                      "not both!");
+            if (keyframes.size() < 2)
+                Throw("A motion-blurred instance requires at least two "
+                      "keyframes \"to_world_0\" and \"to_world_1\"!");
+            m_motion = AnimatedTransform_(
+                keyframes, props.get<ScalarFloat>("time_start", 0.f),
+                props.get<ScalarFloat>("time_end", 1.f));
+            m_to_world = keyframes[0];
+        }
+
         dr::make_opaque(m_to_world);
     }
 
     void traverse(TraversalCallback *cb) override {
-        cb->put("to_world", m_to_world, ParamFlags::NonDifferentiable);
+        if (!m_motion.is_animated())
+            cb->put("to_world", m_to_world, ParamFlags::NonDifferentiable);
     }
 
     void parameters_changed(const std::vector<std::string> &keys) override {
         if (keys.empty() || string::contains(keys, "to_world")) {
             m_to_world = m_to_world.value().update();
-            mark_dirty();
+            mark_dirty(ShapeDirtyFlags::Transform);
         }
         Base::parameters_changed();
     }
@@ -99,13 +157,29 @@ public:
         if (!bbox.valid())
             return bbox;
 
+        if (m_motion.is_animated())
+            return m_motion.bbox(bbox);
+
         ScalarBoundingBox3f result;
         for (int i = 0; i < 8; ++i)
             result.expand(m_to_world.scalar() * bbox.corner(i));
         return result;
     }
 
-    ScalarSize primitive_count() const override { return 1; }
+    /// Bounds of the space swept by the instance during one motion segment
+    ScalarBoundingBox3f bbox(ScalarIndex index) const override {
+        const ScalarBoundingBox3f &bbox = m_shapegroup->bbox();
+        if (!bbox.valid() || !m_motion.is_animated())
+            return this->bbox();
+        return m_motion.segment_bbox(index, bbox);
+    }
+
+    /* Motion-blurred instances expose one primitive per motion segment, so
+       that the builtin acceleration data structures bound each one
+       separately (see ray_intersect_preliminary_impl()) */
+    ScalarSize primitive_count() const override {
+        return m_motion.is_animated() ? m_motion.segment_count() : 1;
+    }
 
     ScalarSize effective_primitive_count() const override {
         return m_shapegroup->primitive_count();
@@ -118,15 +192,35 @@ public:
     //! @{ \name Ray tracing routines
     // =============================================================
 
+    /**
+     * \brief Return the world-to-object transformation for the given ray
+     *
+     * For motion-blurred instances, this returns \c false if the time of the
+     * ray does not fall into the motion segment \c prim_index, so that only
+     * a single segment is intersected.
+     */
+    std::pair<bool, ScalarAffineTransform4f>
+    to_object_scalar(ScalarFloat time, ScalarIndex prim_index) const {
+        if (!m_motion.is_animated())
+            return { true, m_to_world.scalar().inverse() };
+        if (m_motion.segment(time).first != prim_index)
+            return { false, ScalarAffineTransform4f() };
+        return { true, m_motion.eval(time).inverse() };
+    }
+
     template <typename FloatP, typename Ray3fP>
     std::tuple<dr::mask_t<FloatP>, FloatP, Point<FloatP, 2>,
                dr::uint32_array_t<FloatP>, dr::uint32_array_t<FloatP>>
     ray_intersect_preliminary_impl(const Ray3fP &ray,
-                                   ScalarIndex /*prim_index*/,
+                                   ScalarIndex prim_index,
                                    dr::mask_t<FloatP> active) const {
         MI_MASK_ARGUMENT(active);
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_intersect_preliminary_scalar(m_to_world.scalar().inverse() * ray);
+            auto [valid, to_object] = to_object_scalar(ray.time, prim_index);
+            if (!valid)
+                return { false, dr::Infinity<FloatP>, Point<FloatP, 2>(0.f),
+                         (uint32_t) -1, (uint32_t) -1 };
+            return m_shapegroup->ray_intersect_preliminary_scalar(to_object * ray);
         } else {
             Throw("Instance::ray_intersect_preliminary() should only be called with scalar types.");
         }
@@ -134,12 +228,13 @@ public:
 
     template <typename FloatP, typename Ray3fP>
     dr::mask_t<FloatP> ray_test_impl(const Ray3fP &ray,
-                                     ScalarIndex /*prim_index*/,
+                                     ScalarIndex prim_index,
                                      dr::mask_t<FloatP> active) const {
         MI_MASK_ARGUMENT(active);
 
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_test_scalar(m_to_world.scalar().inverse() * ray);
+            auto [valid, to_object] = to_object_scalar(ray.time, prim_index);
+            return valid && m_shapegroup->ray_test_scalar(to_object * ray);
         } else {
             Throw("Instance::ray_test_impl() should only be called with scalar types.");
         }
@@ -154,7 +249,9 @@ public:
                                                      Mask active) const override {
         MI_MASK_ARGUMENT(active);
 
-        const AffineTransform4f& to_world  = m_to_world.value();
+        AffineTransform4f to_world = m_motion.is_animated()
+                                         ? m_motion.eval(ray.time)
+                                         : m_to_world.value();
         AffineTransform4f to_object = to_world.inverse();
 
         constexpr bool IsDiff = dr::is_diff_v<Float>;
@@ -257,8 +354,10 @@ public:
         std::ostringstream oss;
             oss << "Instance[" << std::endl
                 << "  shapegroup = " << string::indent(m_shapegroup) << std::endl
-                << "  to_world = " << string::indent(m_to_world, 13) << "," << std::endl
-                << "]";
+                << "  to_world = " << string::indent(m_to_world, 13) << "," << std::endl;
+            if (m_motion.is_animated())
+                oss << "  motion = " << string::indent(m_motion) << "," << std::endl;
+            oss << "]";
         return oss.str();
     }
 
@@ -278,11 +377,31 @@ public:
                 g.to_world[col * 3 + row] = (float) M(row, col);
         // Stable id for caching one BLAS set per ShapeGroup across Instances
         g.group_id = (const void *) m_shapegroup.get();
+
+        if (m_motion.is_animated()) {
+            g.motion.resize(m_motion.size());
+            for (size_t i = 0; i < m_motion.size(); ++i) {
+                const auto &key = m_motion.keyframe(i);
+                ShapeIR::MotionKey &mk = g.motion[i];
+                const size_t rows[6] = { 0, 0, 0, 1, 1, 2 },
+                             cols[6] = { 0, 1, 2, 1, 2, 2 };
+                for (size_t j = 0; j < 6; ++j)
+                    mk.scale[j] = (float) key.scale(rows[j], cols[j]);
+                mk.quat[0] = (float) key.quat.w();
+                for (size_t j = 0; j < 3; ++j) {
+                    mk.quat[j + 1] = (float) key.quat[j];
+                    mk.trans[j] = (float) key.trans[j];
+                }
+            }
+            g.motion_time[0] = (float) m_motion.time_start();
+            g.motion_time[1] = (float) m_motion.time_end();
+        }
     }
 
     MI_DECLARE_CLASS(Instance)
 private:
    ref<ShapeGroup_> m_shapegroup;
+   AnimatedTransform_ m_motion;
 
    MI_TRAVERSE_CB(Base, m_shapegroup)
 };
@@ -7,9 +7,13 @@
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/profiler.h>
+#include <nanothread/nanothread.h>
 
 #include <array>
 
+/// OBJ files are split into chunks of about this many bytes, which are parsed
+/// in parallel
+#define MI_OBJ_CHUNK_SIZE (8u * 1024u * 1024u)
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -41,6 +45,11 @@ Wavefront OBJ mesh loader (:monosp:`obj`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - quantize
+   - |bool|
+   - Store the mesh in a compact quantized format, see
+     :ref:`sec-shape-mesh-quantization`. (Default: |false|)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -121,8 +130,6 @@ public:
 
         ScopedPhase phase(ProfilerPhase::LoadGeometry);
 
-        constexpr uint32_t MissingIndex = (uint32_t) -1;
-
         /* Value pools (flat float arrays) and per-corner indices into them.
            The heavy lifting -- corner deduplication, triangulation, normal
            generation -- happens in from_corners(). */
@@ -143,22 +150,170 @@ public:
         const char *ptr = tmp.get();
 #endif
 
-        size_t vertex_guess = file_size / 100;
-        const char *eof     = ptr + file_size;
-        char buf[1025];
+        const char *eof = ptr + file_size;
 
-        vertices.reserve(vertex_guess * 3);
-        normals.reserve(vertex_guess * 3);
-        texcoords.reserve(vertex_guess * 2);
-        corner_vertex.reserve(vertex_guess * 6);
-        corner_uv.reserve(vertex_guess * 6);
-        corner_normal.reserve(vertex_guess * 6);
-        face_offsets.reserve(vertex_guess * 2);
-        face_offsets.push_back(0);
+        Timer timer;
+
+        /* Split the file into chunks at line boundaries and parse them in
+           parallel. OBJ indices are global, hence the chunks only need to be
+           concatenated afterwards. */
+        std::vector<std::pair<const char *, const char *>> ranges;
+        while (ptr < eof) {
+            const char *next = ptr + std::min(file_size, (size_t) MI_OBJ_CHUNK_SIZE);
+            if (next < eof) {
+                advance<false>(&next, eof, "\n");
+                if (next < eof)
+                    ++next;
+            }
+            ranges.emplace_back(ptr, next);
+            file_size -= next - ptr;
+            ptr = next;
+        }
 
+        std::vector<Chunk> chunks(ranges.size());
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, ranges.size(), 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i)
+                    parse_chunk(ranges[i].first, ranges[i].second,
+                                flip_tex_coords, chunks[i]);
+            }
+        );
+
+        /* Determine where each chunk goes, and report the first error in the
+           file. References must point to values defined on earlier lines,
+           which is only known now that the preceding chunks are parsed. */
+        struct ChunkOffsets { size_t vertex, normal, texcoord, corner, face; };
+        std::vector<ChunkOffsets> offsets(chunks.size() + 1);
         bool has_uv_indices = false, has_normal_indices = false;
 
-        Timer timer;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const Chunk &c = chunks[i];
+            ChunkOffsets o = offsets[i];
+
+            if (unlikely(c.excess[0] > (int64_t) (o.vertex / 3)))
+                fail("reference to invalid vertex %i!", c.excess_key[0]);
+            if (unlikely(c.excess[1] > (int64_t) (o.texcoord / 2)))
+                fail("reference to invalid texture coordinate %i!", c.excess_key[1]);
+            if (unlikely(c.excess[2] > (int64_t) (o.normal / 3)))
+                fail("reference to invalid normal %i!", c.excess_key[2]);
+            if (unlikely(!c.error.empty()))
+                fail("%s", c.error);
+
+            has_uv_indices |= c.has_uv_indices;
+            has_normal_indices |= c.has_normal_indices;
+
+            offsets[i + 1] = { o.vertex + c.vertices.size(),
+                               o.normal + c.normals.size(),
+                               o.texcoord + c.texcoords.size(),
+                               o.corner + c.corner_vertex.size(),
+                               o.face + c.face_ends.size() };
+        }
+
+        const ChunkOffsets &total = offsets.back();
+        vertices.resize(total.vertex);
+        normals.resize(total.normal);
+        texcoords.resize(total.texcoord);
+        corner_vertex.resize(total.corner);
+        corner_uv.resize(total.corner);
+        corner_normal.resize(total.corner);
+        face_offsets.resize(total.face + 1);
+        face_offsets[0] = 0;
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, chunks.size(), 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    Chunk &c = chunks[i];
+                    const ChunkOffsets &o = offsets[i];
+                    std::copy(c.vertices.begin(), c.vertices.end(), vertices.begin() + o.vertex);
+                    std::copy(c.normals.begin(), c.normals.end(), normals.begin() + o.normal);
+                    std::copy(c.texcoords.begin(), c.texcoords.end(), texcoords.begin() + o.texcoord);
+                    std::copy(c.corner_vertex.begin(), c.corner_vertex.end(), corner_vertex.begin() + o.corner);
+                    std::copy(c.corner_uv.begin(), c.corner_uv.end(), corner_uv.begin() + o.corner);
+                    std::copy(c.corner_normal.begin(), c.corner_normal.end(), corner_normal.begin() + o.corner);
+                    for (size_t j = 0; j < c.face_ends.size(); ++j)
+                        face_offsets[o.face + j + 1] = (uint32_t) (o.corner + c.face_ends[j]);
+                    c = Chunk();
+                }
+            }
+        );
+
+        CornerMesh desc;
+        desc.vertex_count = vertices.size() / 3;
+        desc.positions = vertices.data();
+        desc.corner_count = corner_vertex.size();
+        desc.corner_vertex = corner_vertex.data();
+        desc.face_count = face_offsets.size() - 1;
+        desc.face_offsets = face_offsets.data();
+        if (has_uv_indices)
+            desc.texcoords = { "texcoords", 2, texcoords.data(),
+                               texcoords.size() / 2, corner_uv.data() };
+        if (has_normal_indices && !has_face_normals())
+            desc.normals = { "normals", 3, normals.data(),
+                             normals.size() / 3, corner_normal.data() };
+
+        from_corners(desc);
+
+        Log(Debug, "\"%s\": read %i faces, %i vertices (%zu chunks, in %s)",
+            m_filename, m_face_count, m_vertex_count, chunks.size(),
+            util::time_string((float) timer.value()));
+    }
+
+    MI_DECLARE_CLASS(OBJMesh)
+
+protected:
+    /// Values and faces parsed from a contiguous range of lines
+    struct Chunk {
+        std::vector<InputFloat> vertices, normals, texcoords;
+        std::vector<uint32_t> corner_vertex, corner_uv, corner_normal;
+
+        /// Number of corners in this chunk after each of its faces
+        std::vector<uint32_t> face_ends;
+
+        bool has_uv_indices = false, has_normal_indices = false;
+
+        /**
+         * Largest amount by which a referenced vertex, texture coordinate, and
+         * normal index exceeds the number of such values parsed so far within
+         * this chunk, along with the offending index. Whether the reference is
+         * valid depends on the preceding chunks and is checked once they have
+         * all been parsed.
+         */
+        int64_t excess[3] = { 0, 0, 0 };
+        uint32_t excess_key[3] = { 0, 0, 0 };
+
+        /// Description of the first parse error in this chunk, if any
+        std::string error;
+    };
+
+    /// Parse the lines in <tt>[ptr, eof)</tt>, stopping at the first error
+    void parse_chunk(const char *ptr, const char *eof, bool flip_tex_coords,
+                     Chunk &chunk) const {
+        constexpr uint32_t MissingIndex = (uint32_t) -1;
+
+        auto fail = [&](const char *descr, auto... args) {
+            chunk.error = tfm::format(descr, args...);
+        };
+
+        auto check_index = [&](size_t i, uint32_t key, size_t count) {
+            int64_t excess = (int64_t) key - (int64_t) count;
+            if (excess > chunk.excess[i]) {
+                chunk.excess[i] = excess;
+                chunk.excess_key[i] = key;
+            }
+        };
+
+        size_t vertex_guess = (eof - ptr) / 100;
+        char buf[1025];
+
+        chunk.vertices.reserve(vertex_guess * 3);
+        chunk.normals.reserve(vertex_guess * 3);
+        chunk.texcoords.reserve(vertex_guess * 2);
+        chunk.corner_vertex.reserve(vertex_guess * 6);
+        chunk.corner_uv.reserve(vertex_guess * 6);
+        chunk.corner_normal.reserve(vertex_guess * 6);
+        chunk.face_ends.reserve(vertex_guess * 2);
 
         while (ptr < eof) {
             // Determine the offset of the next newline
@@ -168,7 +323,7 @@ public:
             // Copy buf into a 0-terminated buffer
             size_t size = next - ptr;
             if (size >= sizeof(buf) - 1)
-                fail("file contains an excessively long line! (%i characters)", size);
+                return fail("file contains an excessively long line! (%i characters)", size);
             memcpy(buf, ptr, size);
             buf[size] = '\0';
 
@@ -187,9 +342,9 @@ public:
                     parse_error |= cur == orig;
                 }
                 if (unlikely(!all(dr::isfinite(p))))
-                    fail("mesh contains invalid vertex position data");
+                    return fail("mesh contains invalid vertex position data");
                 for (size_t i = 0; i < 3; ++i)
-                    vertices.push_back(p[i]);
+                    chunk.vertices.push_back(p[i]);
             } else if (cur[0] == 'v' && cur[1] == 'n' && (cur[2] == ' ' || cur[2] == '\t')) {
                 if (!has_face_normals()) {
                     cur += 3;
@@ -201,9 +356,9 @@ public:
                         parse_error |= cur == orig;
                     }
                     if (unlikely(!all(dr::isfinite(n))))
-                        fail("mesh contains invalid vertex normal data");
+                        return fail("mesh contains invalid vertex normal data");
                     for (size_t i = 0; i < 3; ++i)
-                        normals.push_back(n[i]);
+                        chunk.normals.push_back(n[i]);
                 }
             } else if (cur[0] == 'v' && cur[1] == 't' && (cur[2] == ' ' || cur[2] == '\t')) {
                 // Texture coordinate
@@ -217,8 +372,8 @@ public:
                 if (flip_tex_coords)
                     uv.y() = 1.f - uv.y();
 
-                texcoords.push_back(uv.x());
-                texcoords.push_back(uv.y());
+                chunk.texcoords.push_back(uv.x());
+                chunk.texcoords.push_back(uv.y());
             } else if (cur[0] == 'f' && (cur[1] == ' ' || cur[1] == '\t')) {
                 // Face specification
                 cur += 2;
@@ -246,19 +401,19 @@ public:
                     if (*next2 == ' ' || *next2 == '\t' || *next2 == '\0' || *next2 == '\r') {
                         type_index = 0;
 
-                        if (unlikely(key[0] == 0 || (key[0] - 1) * 3 >= vertices.size()))
-                            fail("reference to invalid vertex %i!", key[0]);
-                        if (unlikely(key[1] != 0 && (key[1] - 1) * 2 >= texcoords.size()))
-                            fail("reference to invalid texture coordinate %i!", key[1]);
-                        if (unlikely(key[2] != 0 && !has_face_normals() &&
-                                     (key[2] - 1) * 3 >= normals.size()))
-                            fail("reference to invalid normal %i!", key[2]);
+                        if (unlikely(key[0] == 0))
+                            return fail("reference to invalid vertex %i!", key[0]);
+                        check_index(0, key[0], chunk.vertices.size() / 3);
+                        if (key[1] != 0)
+                            check_index(1, key[1], chunk.texcoords.size() / 2);
+                        if (key[2] != 0 && !has_face_normals())
+                            check_index(2, key[2], chunk.normals.size() / 3);
 
-                        corner_vertex.push_back(key[0] - 1);
-                        corner_uv.push_back(key[1] ? key[1] - 1 : MissingIndex);
-                        corner_normal.push_back(key[2] ? key[2] - 1 : MissingIndex);
-                        has_uv_indices |= key[1] != 0;
-                        has_normal_indices |= key[2] != 0;
+                        chunk.corner_vertex.push_back(key[0] - 1);
+                        chunk.corner_uv.push_back(key[1] ? key[1] - 1 : MissingIndex);
+                        chunk.corner_normal.push_back(key[2] ? key[2] - 1 : MissingIndex);
+                        chunk.has_uv_indices |= key[1] != 0;
+                        chunk.has_normal_indices |= key[2] != 0;
 
                         key[1] = key[2] = 0;
                     }
@@ -266,37 +421,15 @@ public:
                     cur = next2;
                 }
 
-                face_offsets.push_back((uint32_t) corner_vertex.size());
+                chunk.face_ends.push_back((uint32_t) chunk.corner_vertex.size());
             }
 
             if (unlikely(parse_error))
-                fail("could not parse line \"%s\"", buf);
+                return fail("could not parse line \"%s\"", buf);
             ptr = next + 1;
         }
-
-        CornerMesh desc;
-        desc.vertex_count = vertices.size() / 3;
-        desc.positions = vertices.data();
-        desc.corner_count = corner_vertex.size();
-        desc.corner_vertex = corner_vertex.data();
-        desc.face_count = face_offsets.size() - 1;
-        desc.face_offsets = face_offsets.data();
-        if (has_uv_indices)
-            desc.texcoords = { "texcoords", 2, texcoords.data(),
-                               texcoords.size() / 2, corner_uv.data() };
-        if (has_normal_indices && !has_face_normals())
-            desc.normals = { "normals", 3, normals.data(),
-                             normals.size() / 3, corner_normal.data() };
-
-        from_corners(desc);
-
-        Log(Debug, "\"%s\": read %i faces, %i vertices (in %s)",
-            m_filename, m_face_count, m_vertex_count,
-            util::time_string((float) timer.value()));
     }
 
-    MI_DECLARE_CLASS(OBJMesh)
-
     MI_TRAVERSE_CB(Base)
 };
 
@@ -43,6 +43,11 @@ PLY (Stanford Triangle Format) mesh loader (:monosp:`ply`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - quantize
+   - |bool|
+   - Store the mesh in a compact quantized format, see
+     :ref:`sec-shape-mesh-quantization`. (Default: |false|)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -38,6 +38,11 @@ Serialized mesh loader (:monosp:`serialized`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - quantize
+   - |bool|
+   - Store the mesh in a compact quantized format, see
+     :ref:`sec-shape-mesh-quantization`. (Default: |false|)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -58,7 +63,7 @@ Format description
 
 The :monosp:`serialized` file format uses the little endian encoding, hence
 all fields below should be interpreted accordingly. The contents of a
-version 5 file are structured as follows:
+version 6 file are structured as follows:
 
 .. figtable::
     :label: table-serialized-format
@@ -72,11 +77,7 @@ version 5 file are structured as follows:
         * - :monosp:`uint16`
           - File format identifier: :code:`0x041C`
         * - :monosp:`uint16`
-          - File version identifier. Currently set to :code:`0x0005`
-        * - :math:`\rightarrow`
-          - From this point on, the stream is compressed by the :monosp:`DEFLATE` algorithm.
-        * - :math:`\rightarrow`
-          - The used encoding is that of the :monosp:`zlib` library.
+          - File version identifier. Currently set to :code:`0x0006`
         * - :monosp:`uint32`
           - An 32-bit integer whose bits can be used to specify the following flags:
 
@@ -91,7 +92,7 @@ version 5 file are structured as follows:
               than generated from the positions (in which case a position edit through the
               parameter interface recomputes them)
             - :code:`0x1000`: The subsequent content is represented in single precision
-              (always set; version 5 files are single precision)
+              (always set; version 5 and 6 files are single precision)
         * - :monosp:`string`
           - The name of the shape: a :monosp:`uint32` length followed by that many
             utf-8 bytes.
@@ -105,6 +106,21 @@ version 5 file are structured as follows:
         * - :monosp:`uint64`
           - Number of normal groups ``N``, or 0 when the vertex-to-normal-group map is
             the identity and not stored
+        * - :monosp:`uint32`
+          - Block size ``B`` in bytes (see below)
+        * - :monosp:`uint32`
+          - Number of custom mesh attributes
+        * - :monosp:`attribute`
+          - Per attribute: a length-prefixed name whose ``vertex_`` or ``face_`` prefix
+            selects the domain, a :monosp:`uint8` flag byte (bit 0: the values are
+            sRGB-to-spectrum upsampling coefficients written by a spectral variant rather
+            than raw values), and a :monosp:`uint32` channel count ``dim`` in [1, 4]
+        * - :monosp:`uint32`
+          - Compressed size of each block of the arrays listed below, in order
+        * - :math:`\rightarrow`
+          - The arrays below follow, each cut into blocks of ``B`` bytes (the last one
+            may be shorter) that are compressed independently using the :monosp:`zlib`
+            library. The blocks are therefore decompressed in parallel.
         * - :monosp:`array`
           - ``8 V`` single precision floats: the packed vertex records (position in lanes
             0-2, the shading normal or, with stored tangents, the encoded shading frame
@@ -118,14 +134,14 @@ version 5 file are structured as follows:
         * - :monosp:`array`
           - ``V`` :monosp:`uint32` vertex-to-normal-group indices in ``[0, N)``. Omitted
             when ``N`` is 0.
-        * - :monosp:`uint32`
-          - Number of custom mesh attributes
-        * - :monosp:`attribute`
-          - Per attribute: a length-prefixed name whose ``vertex_`` or ``face_`` prefix
-            selects the domain, a :monosp:`uint8` flag byte (bit 0: the values are
-            sRGB-to-spectrum upsampling coefficients written by a spectral variant rather
-            than raw values), a :monosp:`uint32` channel count ``dim`` in [1, 4], and
-            ``V dim`` (or ``F dim``) single precision floats of attribute data
+        * - :monosp:`array`
+          - Per attribute: ``V dim`` (or ``F dim``) single precision floats of
+            attribute data
+
+Version 5 files store the same information, but everything following the
+version identifier is a single :monosp:`zlib` stream, there is no block size
+or block table, and each attribute description immediately precedes its data
+at the end of the stream.
 
 Version 3 and 4 files instead store a single-indexed triangle mesh: the flag
 word (with :code:`0x0001` denoting normals, :code:`0x0002` texture
@@ -143,7 +159,8 @@ file. This is done by simply concatenating their data streams,
 where every one is structured according to the above description.
 Hence, after each mesh, the stream briefly reverts back to an
 uncompressed format, followed by an uncompressed header, and so on.
-This is necessary for efficient read access to arbitrary sub-meshes.
+Together with the dictionary below, this allows the loader to seek
+directly to an arbitrary sub-mesh without decoding the preceding ones.
 
 End-of-file dictionary
 **********************
@@ -191,6 +208,7 @@ at the end of the file, which specifies the starting position of each sub-mesh:
 /// Legacy format versions; the current one is \ref SerializedVersion
 #define MI_FILEFORMAT_VERSION_V3 0x0003
 #define MI_FILEFORMAT_VERSION_V4 0x0004
+#define MI_FILEFORMAT_VERSION_V5 0x0005
 
 /// Flag word of the legacy (version 3 and 4) encoding
 enum class TriMeshFlags : uint32_t {
@@ -261,6 +279,7 @@ public:
 
         if (version != MI_FILEFORMAT_VERSION_V3 &&
             version != MI_FILEFORMAT_VERSION_V4 &&
+            version != MI_FILEFORMAT_VERSION_V5 &&
             version != SerializedVersion)
             fail("encountered an incompatible file version!");
 
@@ -299,6 +318,8 @@ public:
         }
 
         if (version == SerializedVersion)
+            load_v6(stream, props);
+        else if (version == MI_FILEFORMAT_VERSION_V5)
             load_v5(stream, props);
         else
             load_legacy(stream, version);
@@ -384,38 +405,72 @@ public:
         from_packed(std::move(pm));
     }
 
+    /**
+     * Load a version 6 mesh. It stores the same packed representation as
+     * version 5, but the header (including the attribute descriptions) is
+     * uncompressed, and the arrays follow as independently compressed blocks
+     * that are decompressed in parallel straight into the staging storage.
+     * \ref Mesh::write_serialized() is the writer.
+     */
+    void load_v6(Stream *stream, const Properties &props) {
+        stream->set_byte_order(Stream::ELittleEndian);
+
+        uint32_t flags;
+        uint64_t vertex_count, face_count, position_count, normal_count;
+        read_packed_header(stream, flags, vertex_count, face_count,
+                           position_count, normal_count);
+        Layout layout =
+            (Layout) (flags & (uint32_t) SerializedFlags::LayoutMask);
+
+        uint32_t block_size = 0;
+        stream->read(block_size);
+
+        PackedMesh pm(dr::backend_v<Float>, vertex_count, face_count,
+                      layout, position_count, normal_count);
+
+        std::vector<SerializedArray> arrays = {
+            { pm.vertices.data(), vertex_count * MeshVertexStride * sizeof(float) },
+            { pm.faces.data(), face_count * MeshFaceStride * sizeof(uint32_t) }
+        };
+        if (position_count)
+            arrays.push_back({ pm.position_index.data(),
+                               vertex_count * sizeof(uint32_t) });
+        if (normal_count)
+            arrays.push_back({ pm.normal_index.data(),
+                               vertex_count * sizeof(uint32_t) });
+
+        uint32_t attr_count = 0;
+        stream->read(attr_count);
+        for (uint32_t i = 0; i < attr_count; ++i) {
+            std::string name;
+            uint32_t dim = 0;
+            float *dst = read_attribute_header(stream, pm, name, dim);
+            arrays.push_back({ dst, (string::starts_with(name, "face_")
+                                         ? face_count : vertex_count) *
+                                        dim * sizeof(float) });
+        }
+
+        read_serialized_blocks(stream, arrays, block_size);
+
+        finish_packed(std::move(pm), flags, props);
+    }
+
     /**
      * Load a version 5 mesh, which stores the packed representation
      * verbatim: vertex and face records, the vertex -> surface point /
      * normal group maps, and custom attributes stream directly into the
-     * staging storage. \ref Mesh::write_serialized() is the writer.
+     * staging storage.
      */
     void load_v5(Stream *stream_, const Properties &props) {
         ref<Stream> stream = new ZStream(stream_);
         stream->set_byte_order(Stream::ELittleEndian);
 
-        uint32_t flags = 0;
-        stream->read(flags);
-        stream->read(m_filename);
-
-        if (!(flags & (uint32_t) SerializedFlags::SinglePrecision))
-            Throw("\"%s\": version 5 serialized meshes are stored in single "
-                  "precision.", m_filename);
-
+        uint32_t flags;
+        uint64_t vertex_count, face_count, position_count, normal_count;
+        read_packed_header(stream, flags, vertex_count, face_count,
+                           position_count, normal_count);
         Layout layout =
             (Layout) (flags & (uint32_t) SerializedFlags::LayoutMask);
-        bool normals = has_flag(layout, Layout::Normals);
-
-        uint64_t vertex_count, face_count, position_count, normal_count;
-        stream->read(vertex_count);
-        stream->read(face_count);
-        stream->read(position_count);
-        stream->read(normal_count);
-
-        if (position_count > vertex_count ||
-            normal_count > vertex_count ||
-            (has_flag(layout, Layout::Tangents) && !normals))
-            Throw("\"%s\": invalid serialized mesh header.", m_filename);
 
         PackedMesh pm(dr::backend_v<Float>, vertex_count, face_count,
                       layout, position_count, normal_count);
@@ -433,22 +488,61 @@ public:
         stream->read(attr_count);
         for (uint32_t i = 0; i < attr_count; ++i) {
             std::string name;
-            stream->read(name);
-            uint8_t aflags = 0;
-            stream->read(aflags);
-            bool coeffs = (aflags & 1) != 0;
             uint32_t dim = 0;
-            stream->read(dim);
-            if (coeffs && !is_spectral_v<Spectrum>)
-                Log(Warn, "\"%s\": attribute \"%s\" stores spectral "
-                    "upsampling coefficients; a non-spectral variant "
-                    "cannot reproduce the original colors.",
-                    m_filename, name);
-            float *dst = pm.add_attribute(name, dim, /* upsample_srgb */ !coeffs);
+            float *dst = read_attribute_header(stream, pm, name, dim);
             stream->read_array(dst, (string::starts_with(name, "face_")
                                          ? face_count : vertex_count) * dim);
         }
 
+        finish_packed(std::move(pm), flags, props);
+    }
+
+    /// Read and validate the flags, name, and counts of a version 5 or 6 mesh
+    void read_packed_header(Stream *stream, uint32_t &flags,
+                            uint64_t &vertex_count, uint64_t &face_count,
+                            uint64_t &position_count, uint64_t &normal_count) {
+        flags = 0;
+        stream->read(flags);
+        stream->read(m_filename);
+
+        if (!(flags & (uint32_t) SerializedFlags::SinglePrecision))
+            Throw("\"%s\": version 5 and 6 serialized meshes are stored in "
+                  "single precision.", m_filename);
+
+        Layout layout =
+            (Layout) (flags & (uint32_t) SerializedFlags::LayoutMask);
+        bool normals = has_flag(layout, Layout::Normals);
+
+        stream->read(vertex_count);
+        stream->read(face_count);
+        stream->read(position_count);
+        stream->read(normal_count);
+
+        if (position_count > vertex_count ||
+            normal_count > vertex_count ||
+            (has_flag(layout, Layout::Tangents) && !normals))
+            Throw("\"%s\": invalid serialized mesh header.", m_filename);
+    }
+
+    /// Read the description of a custom attribute and allocate its storage
+    float *read_attribute_header(Stream *stream, PackedMesh &pm,
+                                 std::string &name, uint32_t &dim) {
+        stream->read(name);
+        uint8_t aflags = 0;
+        stream->read(aflags);
+        bool coeffs = (aflags & 1) != 0;
+        stream->read(dim);
+        if (coeffs && !is_spectral_v<Spectrum>)
+            Log(Warn, "\"%s\": attribute \"%s\" stores spectral "
+                "upsampling coefficients; a non-spectral variant "
+                "cannot reproduce the original colors.",
+                m_filename, name);
+        return pm.add_attribute(name, dim, /* upsample_srgb */ !coeffs);
+    }
+
+    /// Apply the transform and flags of a version 5 or 6 mesh
+    void finish_packed(PackedMesh &&pm, uint32_t flags,
+                       const Properties &props) {
         // The records arrived in bulk, so they are transformed after the fact
         pm.set_transform(m_to_world.scalar(), m_flip_normals);
         m_flip_normals = false;
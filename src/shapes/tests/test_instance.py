@@ -298,3 +298,154 @@ def test05_normal_partials_non_similarity(variant_scalar_rgb):
                                   to_world)
 
     assert hits > 5, hits
+
+
+def motion_scene(keyframes, accel=None):
+    scene = {
+        'type' : 'scene',
+        'group_0' : {
+            'type' : 'shapegroup',
+            'shape' : { 'type' : 'sphere', 'radius' : 0.5 }
+        },
+        'instance' : {
+            'type' : 'instance',
+            'group' : { 'type' : 'ref', 'id' : 'group_0' },
+            'time_start' : 0.0,
+            'time_end' : 1.0
+        }
+    }
+    if accel is not None:
+        scene['accel'] = accel
+    for i, k in enumerate(keyframes):
+        scene['instance'][f'to_world_{i}'] = k
+    return mi.load_dict(scene)
+
+
+@pytest.mark.parametrize("accel", [None, 'kdtree', 'bvh'])
+def test06_motion_blur(variant_scalar_rgb, accel):
+    from mitsuba import ScalarTransform4f as T
+
+    if accel is not None and mi.MI_ENABLE_EMBREE:
+        pytest.skip("Builtin acceleration data structures are not used")
+
+    s = motion_scene([T().translate([-2, 0, 0]),
+                      T().translate([0, 0, 0]),
+                      T().translate([2, 0, 0])], accel)
+
+    # The bounds cover the swept volume
+    assert dr.allclose(s.bbox().min, [-2.5, -0.5, -0.5])
+    assert dr.allclose(s.bbox().max, [2.5, 0.5, 0.5])
+
+    for time, x in [(0.0, -2), (0.25, -1), (0.5, 0), (0.75, 1), (1.0, 2)]:
+        for dx, hit in [(0.0, True), (1.0, False), (-1.0, False)]:
+            ray = mi.Ray3f(o=[x + dx, 0, -8], d=[0, 0, 1], time=time,
+                           wavelengths=[])
+            assert s.ray_test(ray) == hit
+            si = s.ray_intersect(ray)
+            assert si.is_valid() == hit
+            if hit:
+                assert dr.allclose(si.t, 7.5, atol=1e-4)
+                assert dr.allclose(si.p, [x, 0, -0.5], atol=1e-4)
+                assert dr.allclose(si.n, [0, 0, -1], atol=1e-4)
+
+    # Times outside of the keyframe range clamp to the first/last keyframe
+    ray = mi.Ray3f(o=[2, 0, -8], d=[0, 0, 1], time=3.0, wavelengths=[])
+    assert s.ray_test(ray)
+
+
+def test07_motion_blur_rotation(variant_scalar_rgb):
+    from mitsuba import ScalarTransform4f as T
+
+    # Rotate a sphere offset from the origin by 90 degrees around the z-axis
+    s = motion_scene([T().translate([2, 0, 0]),
+                      T().rotate([0, 0, 1], 90) @ T().translate([2, 0, 0])])
+
+    # The rotation is interpolated spherically: at time 0.5, the sphere is
+    # still at distance 2 from the origin (rather than sqrt(2))
+    c = 2 ** 0.5
+    ray = mi.Ray3f(o=[c, c, -8], d=[0, 0, 1], time=0.5, wavelengths=[])
+    si = s.ray_intersect(ray)
+    assert si.is_valid()
+    assert dr.allclose(si.t, 7.5, atol=1e-3)
+
+    ray = mi.Ray3f(o=[c / 2, c / 2, -8], d=[0, 0, 1], time=0.5, wavelengths=[])
+    assert not s.ray_test(ray)
+
+    # The bounds include the arc traced by the sphere
+    bbox = s.bbox()
+    for i in range(9):
+        angle = dr.pi / 2 * i / 8
+        p = mi.ScalarPoint3f(dr.cos(angle), dr.sin(angle), 0) * 2.5
+        assert bbox.contains(p)
+
+
+def test08_motion_blur_invalid(variant_scalar_rgb):
+    from mitsuba import ScalarTransform4f as T
+
+    with pytest.raises(RuntimeError, match='at least two'):
+        motion_scene([T().translate([1, 0, 0])])
+
+    with pytest.raises(RuntimeError, match='not both'):
+        mi.load_dict({
+            'type' : 'instance',
+            'group' : {
+                'type' : 'shapegroup',
+                'shape' : { 'type' : 'sphere' }
+            },
+            'to_world' : T().translate([1, 0, 0]),
+            'to_world_0' : T(),
+            'to_world_1' : T().translate([1, 0, 0])
+        })
+
+
+@pytest.mark.parametrize("accel", [None, 'kdtree', 'bvh'])
+def test09_motion_blur_time_ranges(variant_scalar_rgb, accel):
+    from mitsuba import ScalarTransform4f as T
+
+    if accel is not None and mi.MI_ENABLE_EMBREE:
+        pytest.skip("Builtin acceleration data structures are not used")
+
+    # Instances whose keyframes span different time ranges. Those of 'c' don't
+    # line up with the ones of the other instances.
+    scene = {
+        'type' : 'scene',
+        'group_0' : {
+            'type' : 'shapegroup',
+            'shape' : { 'type' : 'sphere', 'radius' : 0.5 }
+        }
+    }
+    for name, y, t0, t1 in [('a', 0, 0.0, 1.0), ('b', 3, 2.0, 4.0),
+                            ('c', 6, 0.25, 1.25)]:
+        scene[name] = {
+            'type' : 'instance',
+            'group' : { 'type' : 'ref', 'id' : 'group_0' },
+            'time_start' : t0,
+            'time_end' : t1,
+            'to_world_0' : T().translate([-2, y, 0]),
+            'to_world_1' : T().translate([2, y, 0])
+        }
+    if accel is not None:
+        scene['accel'] = accel
+    s = mi.load_dict(scene)
+
+    def check(time, y, x):
+        for dx, hit in [(0.0, True), (1.0, False)]:
+            ray = mi.Ray3f(o=[x + dx, y, -8], d=[0, 0, 1], time=time,
+                           wavelengths=[])
+            assert s.ray_test(ray) == hit
+
+    # Each instance remains in place outside of its own time range
+    for time, xa, xb in [(-1.0, -2, -2), (0.5, 0, -2), (1.5, 2, -2),
+                         (3.0, 2, 0), (5.0, 2, 2)]:
+        check(time, 0, xa)
+        check(time, 3, xb)
+
+    # Embree resamples the keyframes of 'c' at the integer times of the
+    # shared range [0, 4], where its motion is exact. In between, only the
+    # builtin data structures match the original keyframes.
+    exact = accel is not None or not mi.MI_ENABLE_EMBREE
+    for time, xc, resampled in [(0.0, -2, True), (1.0, 1, True),
+                                (2.0, 2, True), (0.25, -2, False),
+                                (0.75, 0, False)]:
+        if resampled or exact:
+            check(time, 6, xc)
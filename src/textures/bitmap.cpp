@@ -2,7 +2,9 @@
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/rfilter.h>
 #include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/texcache.h>
 #include <mitsuba/core/distr_2d.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/texture.h>
@@ -49,6 +51,25 @@ Bitmap texture (:monosp:`bitmap`)
      - ``nearest``: disable filtering and interpolation. In this mode, the plugin
        performs nearest neighbor lookups of texture values.
 
+     - ``trilinear``: build a MIP map pyramid and blend bilinear lookups from
+       the two levels that best match the pixel footprint, which is derived from
+       the UV partials of the surface interaction.
+
+     - ``ewa``: like ``trilinear``, but accounts for anisotropic footprints by
+       averaging several lookups along the major axis of the footprint ellipse
+       with Gaussian weights. This approximates elliptically weighted average
+       filtering.
+
+     When no UV partials are available (e.g. after the first bounce, or when
+     rendering without ray differentials), the MIP map modes fall back to a
+     bilinear lookup of the full-resolution image.
+
+ * - max_anisotropy
+   - |float|
+   - Largest ratio between the major and minor axis of the footprint ellipse
+     that the ``ewa`` mode resolves. More elongated footprints are blurred
+     along their minor axis instead. (Default: 16)
+
  * - wrap_mode
    - |string|
    - Controls the behavior of texture evaluations that fall outside of the
@@ -102,9 +123,42 @@ Bitmap texture (:monosp:`bitmap`)
      cause small differences as hardware interpolation methods typically have a
      loss of precision (not exactly 32-bit arithmetic). (Default: true)
 
+ * - cache
+   - |bool|
+   - Page the texels of an OpenEXR :paramtype:`filename` in on demand through
+     the process-wide texture cache instead of loading the whole image at
+     construction. Only available in scalar and LLVM variants. (Default: false)
+
 This plugin provides a bitmap texture that performs interpolated lookups given
 a JPEG, PNG, OpenEXR, RGBE, TGA, or BMP input file.
 
+The coarser levels of the MIP map used by the ``trilinear`` and ``ewa`` filter
+types are computed at load time by repeatedly halving the resolution with a box
+filter in linear space. They are rebuilt when the :paramtype:`data` parameter
+changes, but gradients only propagate to the full-resolution level. In spectral
+variants, the coarser levels average the spectral upsampling coefficients, which
+approximates the average spectrum.
+
+With :paramtype:`cache` set to :monosp:`true`, the texture only keeps a handle
+to the file and reads tiles of 32-bit float texels as lookups touch them. All
+cached textures share one least-recently-used pool of tiles whose memory budget
+defaults to 2 GiB; it can be changed with the :monosp:`-T` flag of the
+:monosp:`mitsuba` executable or with :monosp:`mi.TextureCache.set_budget()`,
+which also reports hit and miss counts through
+:monosp:`mi.TextureCache.statistics()`. Tiled OpenEXR files (e.g. converted with
+:monosp:`exrmaketiled -m`) work best: their tiles are read individually, and the
+``trilinear`` filter type uses the MIP map levels stored in the file (``ewa``
+falls back to ``trilinear``). Scanline files are read in strips of 64 rows and
+only support ``nearest`` and ``bilinear`` lookups. A cached texture does not
+support position sampling or differentiation, and in spectral variants the
+filtered color (rather than each texel) is spectrally upsampled. In LLVM
+variants, lookups read texels on the host and therefore require rendering in
+wavefront mode (:monosp:`mitsuba -W -W`, or disabling
+:monosp:`dr.JitFlag.SymbolicLoops` and :monosp:`dr.JitFlag.SymbolicCalls`).
+The tiles of a file are released once the last texture referencing it is
+destroyed, and a file that changed on disk (as determined by its modification
+time and size) is opened again.
+
 When loading the plugin, the data is first converted into a usable color representation
 for the renderer:
 
@@ -139,7 +193,18 @@ at all.
 template <typename Float, typename Spectrum, typename StoredType>
 class BitmapTextureImpl;
 
+// Forward declaration of the bitmap texture backed by the texture cache
+template <typename Float, typename Spectrum>
+class CachedBitmapTexture;
+
 NAMESPACE_BEGIN(detail)
+/// Filtering across the levels of a MIP map pyramid
+enum class MIPFilter {
+    None,      ///< Only use the full-resolution image
+    Trilinear, ///< Blend isotropic lookups from two adjacent levels
+    EWA        ///< Gaussian-weighted trilinear probes along the major axis
+};
+
 /// Class name tagged with the storage precision (for diagnostics / RTTI), since
 /// it depends on a template parameter that MI_DECLARE_CLASS() cannot capture.
 template <typename StoredType>
@@ -182,13 +247,21 @@ public:
         // Filter mode
         {
             std::string_view filter_mode_str = props.get<std::string_view>("filter_type", "bilinear");
+            m_filter_mode = dr::FilterMode::Linear;
+            m_mip_filter = detail::MIPFilter::None;
             if (filter_mode_str == "nearest")
                 m_filter_mode = dr::FilterMode::Nearest;
-            else if (filter_mode_str == "bilinear")
-                m_filter_mode = dr::FilterMode::Linear;
-            else
-                Throw("Invalid filter type \"%s\", must be one of: \"nearest\", or "
-                      "\"bilinear\"!", filter_mode_str);
+            else if (filter_mode_str == "trilinear")
+                m_mip_filter = detail::MIPFilter::Trilinear;
+            else if (filter_mode_str == "ewa")
+                m_mip_filter = detail::MIPFilter::EWA;
+            else if (filter_mode_str != "bilinear")
+                Throw("Invalid filter type \"%s\", must be one of: \"nearest\", "
+                      "\"bilinear\", \"trilinear\", or \"ewa\"!", filter_mode_str);
+
+            m_max_anisotropy = props.get<ScalarFloat>("max_anisotropy", 16.f);
+            if (!(m_max_anisotropy >= 1.f))
+                Throw("The \"max_anisotropy\" parameter must be >= 1!");
         }
 
         // Wrap mode
@@ -229,6 +302,16 @@ public:
 
         // Store
         {
+            m_cache = props.get<bool>("cache", false);
+            if (m_cache) {
+                if constexpr (dr::is_cuda_v<Float> || dr::is_metal_v<Float>)
+                    Throw("The texture cache (cache=true) is only available "
+                          "in scalar and LLVM variants!");
+                if (!props.has_property("filename"))
+                    Throw("The texture cache (cache=true) requires the "
+                          "\"filename\" parameter!");
+            }
+
             if (props.has_property("bitmap")) {
                 // Creates a Bitmap texture directly from an existing Bitmap
                 if (props.has_property("filename"))
@@ -245,8 +328,14 @@ public:
                 FileResolver* fs = file_resolver();
                 fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
                 m_name = file_path.filename().string();
-                Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
-                m_bitmap = new Bitmap(file_path);
+                if (m_cache) {
+                    // Only read the header, texels are paged in by lookups
+                    Log(Debug, "Opening cached bitmap texture \"%s\" ..", m_name);
+                    m_image = TextureCache::open(file_path);
+                } else {
+                    Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
+                    m_bitmap = new Bitmap(file_path);
+                }
             } else if (props.has_property("data")) {
                 m_tensor = std::move(const_cast<TensorXf&>(props.get_any<TensorXf>("data")));
                 if (m_tensor.ndim() != 3)
@@ -261,6 +350,8 @@ public:
         }
     }
 
+    ~BitmapTexture() { TextureCache::close(m_image.get()); }
+
     std::vector<ref<Object>> expand() const override {
         return { ref<Object>(expand_impl()) };
     }
@@ -269,6 +360,14 @@ public:
 
 protected:
     Object *expand_impl() const {
+        if (m_image) {
+            // The expanded texture holds its own handle on the cache entry
+            Properties props;
+            return new CachedBitmapTexture<Float, Spectrum>(
+                props, m_name, m_transform, m_filter_mode, m_wrap_mode,
+                m_mip_filter, m_raw, TextureCache::open(m_image->filename()));
+        }
+
         // The `data` tensor path: native float storage, already linear
         if (!m_bitmap)
             return instantiate<Float>(std::move(m_tensor), /* srgb = */ false);
@@ -394,8 +493,9 @@ protected:
     Object *instantiate(Tensor &&tensor, bool srgb) const {
         Properties props;
         return new BitmapTextureImpl<Float, Spectrum, StoredType>(
-            props, m_name, m_transform, m_filter_mode, m_wrap_mode, m_raw,
-            m_accel, srgb, std::forward<Tensor>(tensor));
+            props, m_name, m_transform, m_filter_mode, m_wrap_mode,
+            m_mip_filter, m_max_anisotropy, m_raw, m_accel, srgb,
+            std::forward<Tensor>(tensor));
     }
 
 private:
@@ -417,12 +517,16 @@ private:
     Format m_format;
 
     bool m_accel;
+    bool m_cache;
     bool m_raw;
     ScalarAffineTransform3f m_transform;
     std::string m_name;
     dr::FilterMode m_filter_mode;
     dr::WrapMode m_wrap_mode;
+    detail::MIPFilter m_mip_filter;
+    ScalarFloat m_max_anisotropy;
     mutable ref<Bitmap> m_bitmap;
+    ref<TiledImage> m_image;
     TensorXf m_tensor;
 
     MI_TRAVERSE_CB(Texture, m_bitmap, m_tensor)
@@ -445,6 +549,8 @@ public:
                       const ScalarAffineTransform3f& transform,
                       dr::FilterMode filter_mode,
                       dr::WrapMode wrap_mode,
+                      detail::MIPFilter mip_filter,
+                      ScalarFloat max_anisotropy,
                       bool raw,
                       bool accel,
                       bool srgb,
@@ -453,12 +559,15 @@ public:
         m_name(name),
         m_transform(transform),
         m_raw(raw),
-        m_srgb(srgb) {
+        m_srgb(srgb),
+        m_mip_filter(mip_filter),
+        m_max_anisotropy(max_anisotropy) {
 
         /* Compute the mean without migrating texture data, i.e. avoid the
            m_texture.tensor() call that would trigger a migration. On CUDA we
            ideally keep the data solely as a GPU texture. */
         rebuild_internals(tensor, true, false);
+        build_mipmap(tensor, wrap_mode);
 
         m_texture = StoredTexture2f(std::forward<Tensor>(tensor), accel, accel,
                                     filter_mode, wrap_mode, srgb);
@@ -487,6 +596,7 @@ public:
 
             m_texture.update_inplace();
             rebuild_internals(m_texture.tensor(), true, m_distr2d != nullptr);
+            build_mipmap(m_texture.tensor(), m_texture.wrap_mode());
         }
 
         if ((keys.empty() || string::contains(keys, "to_uv")) && m_distr2d)
@@ -731,12 +841,17 @@ public:
 
     bool is_spatially_varying() const override { return true; }
 
+    bool needs_uv_partials() const override {
+        return m_mip_filter != detail::MIPFilter::None;
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "BitmapTexture[" << std::endl
             << "  name = \"" << m_name << "\"," << std::endl
             << "  resolution = \"" << resolution() << "\"," << std::endl
             << "  raw = " << (int) m_raw << "," << std::endl
+            << "  mip_levels = " << m_mip_levels + 1 << "," << std::endl
             << "  mean = " << m_mean << "," << std::endl
             << "  transform = " << string::indent(m_transform) << std::endl
             << "]";
@@ -791,7 +906,11 @@ protected:
 
         Point2f uv = m_transform * si.uv;
 
-        if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+        if (use_mipmap(si)) {
+            // Upsample the filtered coefficients (see the plugin documentation)
+            Color3f out = lookup_mipmap<Color3f>(si, uv, active);
+            return srgb_model_eval<UnpolarizedSpectrum>(out, si.wavelengths);
+        } else if (m_texture.filter_mode() == dr::FilterMode::Linear) {
             // Fetch the four enclosing texels and spectrally upsample each
             // *before* interpolating. Upsampling is nonlinear, so blending the
             // RGB values first (e.g. via m_texture.eval()) would be incorrect.
@@ -831,6 +950,8 @@ protected:
         Point2f uv = m_transform * si.uv;
 
         using Data1 = dr::Array<Float, 1>;
+        if (use_mipmap(si))
+            return lookup_mipmap<Data1>(si, uv, active).x();
         return m_texture.template eval<Data1>(uv, active).x();
     }
 
@@ -846,9 +967,156 @@ protected:
 
         Point2f uv = m_transform * si.uv;
 
+        if (use_mipmap(si))
+            return lookup_mipmap<Color3f>(si, uv, active);
         return m_texture.template eval<Color3f>(uv, active);
     }
 
+    /// Should a lookup at the given surface interaction use the MIP map?
+    MI_INLINE bool use_mipmap(const SurfaceInteraction3f &si) const {
+        return m_mip_levels > 0 && si.has_uv_partials();
+    }
+
+    /**
+     * \brief Filtered lookup at the footprint described by the UV partials of
+     * \c si
+     *
+     * The partials are mapped through \c to_uv and scaled to texels of the
+     * full-resolution level, whose base-2 logarithm then selects the level.
+     */
+    template <typename Value>
+    Value lookup_mipmap(const SurfaceInteraction3f &si, const Point2f &uv,
+                        Mask active) const {
+        Vector2f duv_dx = m_transform * si.duv_dx,
+                 duv_dy = m_transform * si.duv_dy;
+        ScalarVector2f res(resolution());
+        Float len_x = dr::norm(duv_dx * res),
+              len_y = dr::norm(duv_dy * res);
+
+        if (m_mip_filter == detail::MIPFilter::Trilinear)
+            return lookup_trilinear<Value>(
+                uv, dr::log2(dr::maximum(len_x, len_y)), active);
+
+        /* Clamp the eccentricity of the footprint ellipse, then cover its
+           major axis with trilinear probes sized to the minor axis */
+        Mask swap = len_x < len_y;
+        Vector2f major = dr::select(swap, duv_dy, duv_dx);
+        Float len_major = dr::maximum(len_x, len_y),
+              len_minor = dr::maximum(dr::minimum(len_x, len_y),
+                                      len_major / m_max_anisotropy),
+              ratio = dr::select(len_minor > 0.f, len_major / len_minor, 1.f),
+              lod = dr::log2(len_minor);
+
+        UInt32 probes = dr::clip(dr::ceil2int<UInt32>(ratio), 1u,
+                                 (uint32_t) dr::ceil(m_max_anisotropy));
+
+        UInt32 i = 0u;
+        Value result = dr::zeros<Value>();
+        Float weight_sum = 0.f;
+        Mask active_loop = Mask(active);
+
+        std::tie(i, result, weight_sum, active_loop) = dr::while_loop(
+            std::make_tuple(i, result, weight_sum, active_loop),
+            [](const UInt32 &, const Value &, const Float &,
+               const Mask &active_loop) { return active_loop; },
+            [this, uv, major, lod, probes](UInt32 &i, Value &result,
+                                           Float &weight_sum,
+                                           Mask &active_loop) {
+                // Gaussian falloff across the ellipse (alpha = 2)
+                Float s = dr::fmadd(2.f, (Float(i) + .5f) / Float(probes), -1.f),
+                      w = dr::exp(-2.f * dr::square(s));
+
+                Value v = lookup_trilinear<Value>(uv + major * s, lod, active_loop);
+                dr::masked(result, active_loop) += w * v;
+                dr::masked(weight_sum, active_loop) += w;
+
+                i += 1u;
+                active_loop &= i < probes;
+            },
+            "Bitmap texture EWA lookup");
+
+        return result * dr::select(weight_sum > 0.f, dr::rcp(weight_sum), 0.f);
+    }
+
+    /**
+     * \brief Blend bilinear lookups from the two levels around \c lod
+     *
+     * Each lane only gathers from its two levels, regardless of the depth of
+     * the pyramid: the full-resolution level is looked up through the
+     * texture, and the coarser ones through the packed \ref m_mip_data.
+     */
+    template <typename Value>
+    Value lookup_trilinear(const Point2f &uv, const Float &lod_,
+                           Mask active) const {
+        Float lod = dr::clip(dr::select(dr::isnan(lod_), 0.f, lod_), 0.f,
+                             (ScalarFloat) m_mip_levels);
+        UInt32 lower = dr::floor2int<UInt32>(lod);
+        Float t = lod - Float(lower);
+
+        Mask base = active && lower == 0u;
+        Value result = dr::zeros<Value>();
+        if (dr::any_or<true>(base))
+            dr::masked(result, base) =
+                (1.f - t) * m_texture.template eval<Value>(uv, base);
+
+        result += lookup_level<Value>(uv, lower, 1.f - t, active && !base);
+        result += lookup_level<Value>(uv, lower + 1u, t, active && t > 0.f);
+
+        return result;
+    }
+
+    /// Weighted bilinear lookup of a coarser level (>= 1) of the MIP map
+    template <typename Value>
+    Value lookup_level(const Point2f &uv, const UInt32 &level,
+                       const Float &weight, Mask active) const {
+        using StoredValue = dr::replace_scalar_t<Value, StoredScalar>;
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<Value>();
+
+        UInt32 info = (level - 1u) * 3u;
+        Int32 w = Int32(dr::gather<UInt32>(m_mip_info, info, active)),
+              h = Int32(dr::gather<UInt32>(m_mip_info, info + 1u, active));
+        UInt32 offset = dr::gather<UInt32>(m_mip_info, info + 2u, active);
+
+        Point2f p = dr::fmadd(uv, Point2f(Float(w), Float(h)), -.5f);
+        Point2i p_i = dr::floor2int<Point2i>(p);
+        Vector2f w1 = p - Point2f(p_i), w0 = 1.f - w1;
+
+        Int32 x0 = wrap(p_i.x(), w), x1 = wrap(p_i.x() + 1, w),
+              y0 = wrap(p_i.y(), h), y1 = wrap(p_i.y() + 1, h);
+
+        auto fetch = [&](const Int32 &x, const Int32 &y) {
+            UInt32 index = offset + UInt32(y * w + x);
+            return Value(decode(
+                dr::gather<StoredValue>(m_mip_data, index, active)));
+        };
+
+        Value v0 = w0.x() * fetch(x0, y0) + w1.x() * fetch(x1, y0),
+              v1 = w0.x() * fetch(x0, y1) + w1.x() * fetch(x1, y1);
+
+        return weight * (w0.y() * v0 + w1.y() * v1);
+    }
+
+    /// Map integer texel coordinates into [0, n) following the wrap mode
+    Int32 wrap(const Int32 &x, const Int32 &n) const {
+        switch (m_texture.wrap_mode()) {
+            case dr::WrapMode::Repeat: {
+                    Int32 r = x % n;
+                    return dr::select(r < 0, r + n, r);
+                }
+
+            case dr::WrapMode::Mirror: {
+                    Int32 r = x % (2 * n);
+                    r = dr::select(r < 0, r + 2 * n, r);
+                    return dr::select(r >= n, 2 * n - 1 - r, r);
+                }
+
+            default:
+                return dr::clip(x, 0, n - 1);
+        }
+    }
+
     /**
      * \brief Decode a raw stored value to linear, mirroring the texture's own
      * sampling-time conversion
@@ -869,6 +1137,85 @@ protected:
         }
     }
 
+    /// Inverse of \ref decode(), rounding to the nearest stored value
+    MI_INLINE StoredScalar encode(float v) const {
+        if constexpr (IsUInt8) {
+            if (m_srgb)
+                v = dr::linear_to_srgb(v);
+            return (StoredScalar) dr::clip(dr::round(v * 255.f), 0.f, 255.f);
+        } else {
+            return (StoredScalar) v;
+        }
+    }
+
+    /**
+     * \brief (Re)build the coarser levels of the MIP map pyramid
+     *
+     * Starting from the full-resolution texels, the resolution is repeatedly
+     * halved with a box filter (see \ref Bitmap::resample()) until it reaches a
+     * single texel. Filtering happens in linear space, and the boundary
+     * condition follows the wrap mode of the texture. The levels are stored
+     * back to back in the texture's storage precision.
+     */
+    void build_mipmap(const StoredTensorXf &tensor, dr::WrapMode wrap_mode) {
+        m_mip_levels = 0;
+        m_mip_data = DynamicBuffer<StoredType>();
+        m_mip_info = DynamicBuffer<UInt32>();
+        if (m_mip_filter == detail::MIPFilter::None)
+            return;
+
+        const dr::vector<size_t> &shape = tensor.shape();
+        size_t channels = shape[2];
+        ScalarVector2u res((uint32_t) shape[1], (uint32_t) shape[0]);
+
+        auto&& data = dr::migrate(tensor.array(), JitBackend::None);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        ref<Bitmap> bitmap = new Bitmap(
+            channels == 1 ? Bitmap::PixelFormat::Y : Bitmap::PixelFormat::RGB,
+            struct_type_v<float>, res);
+        const StoredScalar *in = (const StoredScalar *) data.data();
+        float *out = (float *) bitmap->data();
+        for (size_t i = 0, n = bitmap->pixel_count() * channels; i < n; ++i)
+            out[i] = (float) decode(in[i]);
+
+        FilterBoundaryCondition bc;
+        switch (wrap_mode) {
+            case dr::WrapMode::Repeat: bc = FilterBoundaryCondition::Repeat; break;
+            case dr::WrapMode::Mirror: bc = FilterBoundaryCondition::Mirror; break;
+            default: bc = FilterBoundaryCondition::Clamp; break;
+        }
+
+        ref<Bitmap::ReconstructionFilter> rfilter =
+            PluginManager::instance()->create_object<Bitmap::ReconstructionFilter>(
+                Properties("box"));
+
+        // Width, height, and offset (in texels) of each level
+        std::vector<uint32_t> info;
+        std::vector<StoredScalar> buf;
+        while (dr::any(res > 1u)) {
+            res = dr::maximum(res / 2u, 1u);
+            bitmap = bitmap->resample(res, rfilter.get(), { bc, bc });
+
+            info.push_back(res.x());
+            info.push_back(res.y());
+            info.push_back((uint32_t) (buf.size() / channels));
+
+            size_t n = bitmap->pixel_count() * channels;
+            const float *level = (const float *) bitmap->data();
+            for (size_t i = 0; i < n; ++i)
+                buf.push_back(encode(level[i]));
+        }
+
+        m_mip_levels = (uint32_t) (info.size() / 3);
+        m_mip_data = dr::load<DynamicBuffer<StoredType>>(buf.data(), buf.size());
+        m_mip_info = dr::load<DynamicBuffer<UInt32>>(info.data(), info.size());
+
+        Log(Debug, "BitmapTexture: built %u MIP map levels for \"%s\".",
+            m_mip_levels, m_name);
+    }
+
     /**
      * \brief Recompute mean and 2D sampling distribution (if requested)
      * following an update
@@ -998,11 +1345,397 @@ protected:
     Float m_mean;
     StoredTexture2f m_texture;
 
+    // Optional: coarser levels of the MIP map pyramid, stored back to back
+    detail::MIPFilter m_mip_filter;
+    ScalarFloat m_max_anisotropy;
+    uint32_t m_mip_levels = 0;
+    DynamicBuffer<StoredType> m_mip_data;
+    /// Width, height, and offset into \ref m_mip_data of each coarser level
+    DynamicBuffer<UInt32> m_mip_info;
+
     // Optional: distribution for importance sampling
     mutable std::mutex m_mutex;
     std::unique_ptr<DiscreteDistribution2D<Float>> m_distr2d;
 
-    MI_TRAVERSE_CB(Texture, m_mean, m_texture, m_distr2d)
+    MI_TRAVERSE_CB(Texture, m_mean, m_texture, m_mip_data, m_mip_info,
+                   m_distr2d)
+};
+
+/**
+ * \brief Bitmap texture whose texels are paged in on demand through the
+ * process-wide \ref TextureCache
+ *
+ * Lookups are performed on the host: scalar variants query the cache directly,
+ * while LLVM variants evaluate the lookup coordinates and process them in
+ * parallel before uploading the result.
+ */
+template <typename Float, typename Spectrum>
+class CachedBitmapTexture final : public Texture<Float, Spectrum> {
+public:
+    MI_IMPORT_TYPES(Texture)
+
+    CachedBitmapTexture(const Properties &props,
+                        const std::string &name,
+                        const ScalarAffineTransform3f &transform,
+                        dr::FilterMode filter_mode,
+                        dr::WrapMode wrap_mode,
+                        detail::MIPFilter mip_filter,
+                        bool raw,
+                        ref<TiledImage> image) :
+        Texture(props),
+        m_name(name),
+        m_transform(transform),
+        m_filter_mode(filter_mode),
+        m_wrap_mode(wrap_mode),
+        m_raw(raw),
+        m_image(image) {
+
+        m_channels = m_image->channel_count();
+        m_mipmapped = mip_filter != detail::MIPFilter::None &&
+                      m_image->level_count() > 1;
+
+        if (mip_filter != detail::MIPFilter::None && !m_mipmapped)
+            Log(Warn, "BitmapTexture: \"%s\" does not store MIP map levels, "
+                      "cached lookups will not be filtered. Convert it into a "
+                      "tiled MIP map (e.g. using 'exrmaketiled -m') to enable "
+                      "this.", m_name);
+        else if (mip_filter == detail::MIPFilter::EWA)
+            Log(Debug, "BitmapTexture: cached lookups of \"%s\" use trilinear "
+                       "instead of EWA filtering.", m_name);
+    }
+
+    ~CachedBitmapTexture() { TextureCache::close(m_image.get()); }
+
+    void traverse(TraversalCallback *cb) override {
+        cb->put("to_uv", m_transform, ParamFlags::NonDifferentiable);
+    }
+
+    UnpolarizedSpectrum eval(const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channels == 3 && is_spectral_v<Spectrum> && m_raw)
+            Throw("eval(): The bitmap texture %s was queried for a spectrum, "
+                  "but texture conversion into spectra was explicitly "
+                  "disabled! (raw=true)",
+                  to_string());
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<UnpolarizedSpectrum>();
+
+        Color3f value = lookup(si, active);
+        if constexpr (is_monochromatic_v<Spectrum>) {
+            return m_channels == 1 ? value.x() : luminance(value);
+        } else {
+            if (m_channels == 1)
+                return value.x();
+            else if constexpr (is_spectral_v<Spectrum>)
+                return srgb_model_eval<UnpolarizedSpectrum>(value, si.wavelengths);
+            else
+                return value;
+        }
+    }
+
+    Float eval_1(const SurfaceInteraction3f &si,
+                 Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (stores_spectral_coeffs())
+            Throw("eval_1(): The bitmap texture %s was queried for a "
+                  "monochromatic value, but texture conversion to color "
+                  "spectra had previously been requested! (raw=false)",
+                  to_string());
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<Float>();
+
+        Color3f value = lookup(si, active);
+        return m_channels == 1 ? value.x() : luminance(value);
+    }
+
+    Color3f eval_3(const SurfaceInteraction3f &si,
+                   Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channels != 3)
+            Throw("eval_3(): The bitmap texture %s was queried for a RGB "
+                  "value, but it is monochromatic!",
+                  to_string());
+        if (stores_spectral_coeffs())
+            Throw("eval_3(): The bitmap texture %s was queried for a RGB "
+                  "value, but texture conversion to color spectra had "
+                  "previously been requested! (raw=false)",
+                  to_string());
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<Color3f>();
+
+        return lookup(si, active);
+    }
+
+    ScalarVector2i resolution() const override {
+        return ScalarVector2i(m_image->size());
+    }
+
+    /// Computed on first use from the coarsest level stored in the file
+    Float mean() const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_mean_valid) {
+            m_mean = compute_mean();
+            m_mean_valid = true;
+        }
+        return m_mean;
+    }
+
+    bool is_spatially_varying() const override { return true; }
+
+    bool needs_uv_partials() const override { return m_mipmapped; }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "CachedBitmapTexture[" << std::endl
+            << "  name = \"" << m_name << "\"," << std::endl
+            << "  resolution = \"" << resolution() << "\"," << std::endl
+            << "  raw = " << (int) m_raw << "," << std::endl
+            << "  mip_levels = " << (m_mipmapped ? m_image->level_count() : 1)
+            << "," << std::endl
+            << "  image = " << string::indent(m_image.get()) << "," << std::endl
+            << "  transform = " << string::indent(m_transform) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS(CachedBitmapTexture)
+
+protected:
+    /// Most recently used tile of a host lookup, to skip redundant cache queries
+    struct TileCursor {
+        uint32_t level = (uint32_t) -1, x = 0, y = 0;
+        std::shared_ptr<const TextureTile> tile;
+    };
+
+    /// See \ref BitmapTextureImpl::stores_spectral_coeffs()
+    bool stores_spectral_coeffs() const {
+        return is_spectral_v<Spectrum> && !m_raw && m_channels == 3;
+    }
+
+    /**
+     * \brief Filtered lookup at the given surface interaction
+     *
+     * Returns linear RGB values, spectral upsampling coefficients (see \ref
+     * stores_spectral_coeffs()), or a luminance value in the first component.
+     */
+    Color3f lookup(const SurfaceInteraction3f &si, Mask active) const {
+        Point2f uv = m_transform * si.uv;
+
+        // Footprint in texels of the full-resolution level (as in the MIP map)
+        Float lod = 0.f;
+        if (m_mipmapped && si.has_uv_partials()) {
+            ScalarVector2f res(resolution());
+            lod = dr::log2(dr::maximum(dr::norm(m_transform * si.duv_dx * res),
+                                       dr::norm(m_transform * si.duv_dy * res)));
+        }
+
+        if constexpr (!dr::is_jit_v<Float>) {
+            Color3f result(0.f);
+            if (active)
+                lookup_host(uv.x(), uv.y(), lod, result.data());
+            return result;
+        } else {
+            if (jit_flag(JitFlag::SymbolicScope))
+                Throw("BitmapTexture: the cached texture \"%s\" reads texels on "
+                      "the host and cannot be evaluated within a symbolic loop "
+                      "or call. Render in wavefront mode instead ('mitsuba -W "
+                      "-W', or disable dr.JitFlag.SymbolicLoops and "
+                      "dr.JitFlag.SymbolicCalls).", m_name);
+
+            using FloatStorage = DynamicBuffer<Float>;
+            using MaskStorage  = DynamicBuffer<Mask>;
+
+            size_t n = std::max({ dr::width(uv), dr::width(lod),
+                                  dr::width(active) });
+            FloatStorage u = uv.x() + dr::zeros<FloatStorage>(n),
+                         v = uv.y() + dr::zeros<FloatStorage>(n),
+                         l = lod + dr::zeros<FloatStorage>(n);
+            MaskStorage a = active || dr::zeros<MaskStorage>(n);
+            dr::eval(u, v, l, a);
+
+            auto &&u_host = dr::migrate(u, JitBackend::None);
+            auto &&v_host = dr::migrate(v, JitBackend::None);
+            auto &&l_host = dr::migrate(l, JitBackend::None);
+            auto &&a_host = dr::migrate(a, JitBackend::None);
+            dr::sync_thread();
+
+            const ScalarFloat *u_p = u_host.data(), *v_p = v_host.data(),
+                              *l_p = l_host.data();
+            const bool *a_p = a_host.data();
+
+            // Planar output: one block of 'n' values per channel
+            std::unique_ptr<ScalarFloat[]> out(new ScalarFloat[3 * n]());
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, n, 4096),
+                [&](const dr::blocked_range<size_t> &range) {
+                    ScalarFloat value[3];
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        if (!a_p[i])
+                            continue;
+                        lookup_host(u_p[i], v_p[i], l_p[i], value);
+                        for (size_t c = 0; c < 3; ++c)
+                            out[c * n + i] = value[c];
+                    }
+                }
+            );
+
+            return Color3f(dr::load<Float>(out.get(), n),
+                           dr::load<Float>(out.get() + n, n),
+                           dr::load<Float>(out.get() + 2 * n, n));
+        }
+    }
+
+    /// Host lookup of a single texture coordinate at the given level of detail
+    void lookup_host(ScalarFloat u, ScalarFloat v, ScalarFloat lod,
+                     ScalarFloat *out) const {
+        TileCursor cursor;
+        ScalarFloat value[3] = { 0.f, 0.f, 0.f };
+
+        if (!m_mipmapped || !(lod > 0.f)) {
+            lookup_level(cursor, 0, u, v, 1.f, value);
+        } else {
+            lod = dr::minimum(lod, (ScalarFloat) (m_image->level_count() - 1));
+            uint32_t lower = (uint32_t) lod;
+            ScalarFloat t = lod - (ScalarFloat) lower;
+            lookup_level(cursor, lower, u, v, 1.f - t, value);
+            if (t > 0.f)
+                lookup_level(cursor, lower + 1, u, v, t, value);
+        }
+
+        if (m_channels == 1) {
+            value[1] = value[2] = value[0];
+        } else if (stores_spectral_coeffs()) {
+            dr::Array<float, 3> coeff = srgb_model_fetch(
+                Color<float, 3>(value[0], value[1], value[2]));
+            for (size_t c = 0; c < 3; ++c)
+                value[c] = (ScalarFloat) coeff[c];
+        }
+
+        for (size_t c = 0; c < 3; ++c)
+            out[c] = value[c];
+    }
+
+    /// Accumulate a weighted nearest/bilinear lookup of one level into \c out
+    void lookup_level(TileCursor &cursor, uint32_t level, ScalarFloat u,
+                      ScalarFloat v, ScalarFloat weight, ScalarFloat *out) const {
+        ScalarVector2u res = m_image->size(level);
+
+        if (m_filter_mode == dr::FilterMode::Nearest) {
+            int x = (int) dr::floor(u * res.x()),
+                y = (int) dr::floor(v * res.y());
+            fetch(cursor, level, res, x, y, weight, out);
+            return;
+        }
+
+        ScalarFloat px = dr::fmadd(u, (ScalarFloat) res.x(), -.5f),
+                    py = dr::fmadd(v, (ScalarFloat) res.y(), -.5f),
+                    fx = dr::floor(px), fy = dr::floor(py),
+                    w1x = px - fx, w1y = py - fy;
+        int x = (int) fx, y = (int) fy;
+
+        fetch(cursor, level, res, x,     y,     weight * (1.f - w1x) * (1.f - w1y), out);
+        fetch(cursor, level, res, x + 1, y,     weight * w1x * (1.f - w1y), out);
+        fetch(cursor, level, res, x,     y + 1, weight * (1.f - w1x) * w1y, out);
+        fetch(cursor, level, res, x + 1, y + 1, weight * w1x * w1y, out);
+    }
+
+    /// Accumulate a weighted texel, applying the wrap mode to its coordinates
+    void fetch(TileCursor &cursor, uint32_t level, const ScalarVector2u &res,
+               int x, int y, ScalarFloat weight, ScalarFloat *out) const {
+        if (weight == 0.f)
+            return;
+
+        uint32_t xw = wrap(x, res.x()), yw = wrap(y, res.y());
+        ScalarVector2u tile_size = m_image->tile_size();
+        uint32_t tx = xw / tile_size.x(), ty = yw / tile_size.y();
+
+        if (cursor.level != level || cursor.x != tx || cursor.y != ty) {
+            cursor.tile  = m_image->tile(level, tx, ty);
+            cursor.level = level;
+            cursor.x     = tx;
+            cursor.y     = ty;
+        }
+
+        const TextureTile &tile = *cursor.tile;
+        const float *texel =
+            tile.data.get() + ((size_t) (yw - ty * tile_size.y()) * tile.size.x() +
+                               (xw - tx * tile_size.x())) * m_channels;
+        for (uint32_t c = 0; c < m_channels; ++c)
+            out[c] += weight * texel[c];
+    }
+
+    /// Map an integer texel coordinate into [0, n) following the wrap mode
+    uint32_t wrap(int x, uint32_t n_) const {
+        int n = (int) n_;
+        switch (m_wrap_mode) {
+            case dr::WrapMode::Repeat:
+                x %= n;
+                return (uint32_t) (x < 0 ? x + n : x);
+
+            case dr::WrapMode::Mirror:
+                x %= 2 * n;
+                if (x < 0)
+                    x += 2 * n;
+                return (uint32_t) (x >= n ? 2 * n - 1 - x : x);
+
+            default:
+                return (uint32_t) dr::clip(x, 0, n - 1);
+        }
+    }
+
+    /**
+     * \brief Average the texels of the coarsest level (luminance or spectral
+     * mean), streaming its tiles past the cache
+     */
+    ScalarFloat compute_mean() const {
+        uint32_t level = m_mipmapped ? m_image->level_count() - 1 : 0;
+        ScalarVector2u count = m_image->tile_count(level);
+
+        double sum = 0.0;
+        for (uint32_t ty = 0; ty < count.y(); ++ty) {
+            for (uint32_t tx = 0; tx < count.x(); ++tx) {
+                std::shared_ptr<TextureTile> tile = m_image->read_tile(level, tx, ty);
+                const float *texel = tile->data.get();
+                for (size_t i = 0, n = (size_t) tile->size.x() * tile->size.y();
+                     i < n; ++i, texel += m_channels) {
+                    if (m_channels == 1) {
+                        sum += texel[0];
+                        continue;
+                    }
+
+                    Color<float, 3> c(texel[0], texel[1], texel[2]);
+                    if (stores_spectral_coeffs())
+                        sum += srgb_model_mean(srgb_model_fetch(c));
+                    else
+                        sum += luminance(c);
+                }
+            }
+        }
+
+        return (ScalarFloat) (sum / dr::prod(ScalarVector2f(m_image->size(level))));
+    }
+
+    std::string m_name;
+    ScalarAffineTransform3f m_transform;
+    dr::FilterMode m_filter_mode;
+    dr::WrapMode m_wrap_mode;
+    bool m_raw;
+    bool m_mipmapped;
+    uint32_t m_channels;
+    ref<TiledImage> m_image;
+
+    mutable std::mutex m_mutex;
+    mutable ScalarFloat m_mean = 0.f;
+    mutable bool m_mean_valid = false;
+
+    MI_TRAVERSE_CB(Texture)
 };
 
 MI_EXPORT_PLUGIN(BitmapTexture)
@@ -338,3 +338,151 @@ def test11_u8_small_bitmap_upsample(variants_vec_backends_once_rgb, tmpdir):
     si.uv = [0.5, 0.5]
     val = tex.eval_3(si)
     assert dr.all(val > 0)
+
+
+@fresolver_append_path
+@pytest.mark.parametrize('filter_type', ['trilinear', 'ewa'])
+@pytest.mark.parametrize('format', ['variant', 'uint8'])
+def test12_mipmap(variants_vec_backends_once_rgb, filter_type, format):
+    # Without a footprint, MIP mapped lookups match bilinear interpolation of
+    # the full-resolution image. A footprint that covers the whole texture
+    # returns its average.
+    def load(filter_type):
+        return mi.load_dict({
+            'type'        : 'bitmap',
+            'filename'    : 'resources/data/common/textures/carrot.png',
+            'filter_type' : filter_type,
+            'format'      : format,
+        })
+
+    bilinear, mipmap = load('bilinear'), load(filter_type)
+
+    si = dr.zeros(mi.SurfaceInteraction3f, 64)
+    si.uv = mi.Point2f(dr.linspace(mi.Float, 0.05, 0.95, 64),
+                       dr.linspace(mi.Float, 0.9, 0.1, 64))
+    dr.assert_allclose(mipmap.eval_3(si), bilinear.eval_3(si), atol=1e-3)
+
+    si.duv_dx = mi.Vector2f(2, 0)
+    si.duv_dy = mi.Vector2f(0, 2)
+    dr.assert_allclose(mipmap.eval_1(si), bilinear.mean(), rtol=2e-2)
+
+    # Integrators only compute UV partials for scenes that need them
+    assert mipmap.needs_uv_partials() and not bilinear.needs_uv_partials()
+    for tex, expected in [(bilinear, False), (mipmap, True)]:
+        scene = mi.load_dict({
+            'type'  : 'scene',
+            'shape' : { 'type' : 'rectangle',
+                        'bsdf' : { 'type' : 'diffuse', 'reflectance' : tex } }
+        })
+        assert scene.needs_uv_partials() == expected
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'bilinear'])
+@pytest.mark.parametrize('wrap_mode', ['repeat', 'clamp', 'mirror'])
+def test13_cache(variant_scalar_rgb, tmpdir, filter_type, wrap_mode):
+    # Lookups through the texture cache match a texture that is fully loaded
+    import numpy as np
+    import os
+
+    rng = np.random.default_rng(seed=0)
+    filename = os.path.join(str(tmpdir), 'cached.exr')
+    mi.Bitmap(rng.random((150, 100, 3), dtype=np.float32)).write(filename)
+
+    def load(cache):
+        return mi.load_dict({
+            'type'        : 'bitmap',
+            'filename'    : filename,
+            'filter_type' : filter_type,
+            'wrap_mode'   : wrap_mode,
+            'format'      : 'variant',
+            'cache'       : cache,
+        })
+
+    loaded, cached = load(False), load(True)
+    mi.TextureCache.reset_statistics()
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    for uv in rng.uniform(-0.5, 1.5, size=(64, 2)):
+        si.uv = mi.Point2f(uv)
+        dr.assert_allclose(cached.eval_3(si), loaded.eval_3(si), atol=1e-5)
+        dr.assert_allclose(cached.eval_1(si), loaded.eval_1(si), atol=1e-5)
+
+    assert dr.allclose(cached.mean(), loaded.mean())
+
+    # The image is split into 3 strips of 64 rows that are read once
+    stats = mi.TextureCache.statistics()
+    assert stats.misses == 3 and stats.hits > 0
+
+    # Destroying the last texture that references the file drops its tiles
+    del cached
+    assert mi.TextureCache.statistics().tile_count == stats.tile_count - 3
+
+
+def test14_cache_llvm(variant_llvm_ad_rgb, tmpdir):
+    import numpy as np
+    import os
+
+    rng = np.random.default_rng(seed=0)
+    filename = os.path.join(str(tmpdir), 'cached.exr')
+    mi.Bitmap(rng.random((80, 120, 1), dtype=np.float32)).write(filename)
+
+    def load(cache):
+        return mi.load_dict({
+            'type'     : 'bitmap',
+            'filename' : filename,
+            'format'   : 'variant',
+            'raw'      : True,
+            'cache'    : cache,
+        })
+
+    loaded, cached = load(False), load(True)
+
+    si = dr.zeros(mi.SurfaceInteraction3f, 1024)
+    si.uv = mi.Point2f(rng.random((2, 1024)))
+    dr.assert_allclose(cached.eval_1(si), loaded.eval_1(si), atol=1e-5)
+
+    mi.TextureCache.clear()
+    assert mi.TextureCache.statistics().tile_count == 0
+
+
+@pytest.mark.parametrize('wrap_mode', ['repeat', 'clamp', 'mirror'])
+def test15_mipmap_level(variants_vec_backends_once_rgb, wrap_mode):
+    # A footprint of two texels selects the second level of the pyramid,
+    # whose texels average 2x2 blocks of the image. Compare to a bilinear
+    # lookup of this level with the same wrap mode.
+    import numpy as np
+
+    rng = np.random.default_rng(seed=0)
+    data = rng.random((8, 8, 1)).astype(np.float32)
+    level = data[:, :, 0].reshape(4, 2, 4, 2).mean(axis=(1, 3))
+
+    def wrap(x, n):
+        if wrap_mode == 'repeat':
+            return x % n
+        elif wrap_mode == 'clamp':
+            return np.clip(x, 0, n - 1)
+        x = x % (2 * n)
+        return np.where(x >= n, 2 * n - 1 - x, x)
+
+    u, v = rng.uniform(-0.5, 1.5, size=(2, 256))
+    px, py = u * 4 - .5, v * 4 - .5
+    x, y = np.floor(px).astype(int), np.floor(py).astype(int)
+    wx, wy = px - x, py - y
+    ref = sum(level[wrap(y + j, 4), wrap(x + i, 4)] *
+              (wx if i else 1 - wx) * (wy if j else 1 - wy)
+              for i in range(2) for j in range(2))
+
+    texture = mi.load_dict({
+        'type'        : 'bitmap',
+        'data'        : mi.TensorXf(data),
+        'raw'         : True,
+        'filter_type' : 'trilinear',
+        'wrap_mode'   : wrap_mode,
+    })
+
+    si = dr.zeros(mi.SurfaceInteraction3f, 256)
+    si.uv = mi.Point2f(u, v)
+    si.duv_dx = mi.Vector2f(2 / 8, 0)
+    si.duv_dy = mi.Vector2f(0, 2 / 8)
+    dr.assert_allclose(texture.eval_1(si), ref, atol=1e-5)
+
@@ -8,6 +8,7 @@
 #include <mitsuba/render/volumegrid.h>
 #include <drjit/dynamic.h>
 #include <drjit/texture.h>
+#include <algorithm>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -427,6 +428,77 @@ public:
             out[i] = m_max_per_channel[i];
     }
 
+    void max_grid(const ScalarVector3u &res, ScalarFloat *out) const override {
+        if (m_fixed_max) {
+            std::fill(out, out + dr::prod(res), m_max);
+            return;
+        }
+
+        auto&& data = dr::migrate(m_texture.tensor().array(), JitBackend::None);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        const ScalarFloat *ptr = (const ScalarFloat *) data.data();
+
+        const ScalarVector3i vres = resolution();
+        const size_t channels = m_texture.channel_count();
+
+        /* With spectral upsampling, the spectrum is bounded by the scale
+           factor stored in the last channel. Otherwise, all evaluation
+           modes are bounded by the largest channel. */
+        const bool upsampled = channels != nchannels();
+
+        // Range of voxels that influence cell 'c' along the given axis
+        auto voxel_range = [&](uint32_t axis, uint32_t c) {
+            /* Trilinear interpolation at a local position 'p' reads voxels
+               floor(p * res - 0.5) and the next one; nearest neighbor
+               lookups only read a subset of these. */
+            ScalarFloat scale = (ScalarFloat) vres[axis] / res[axis];
+            int32_t lo = (int32_t) dr::floor(c * scale - .5f),
+                    hi = (int32_t) dr::floor((c + 1) * scale - .5f) + 1;
+            return std::make_pair(lo, hi);
+        };
+
+        // Map a voxel index that may lie one voxel outside of the grid
+        dr::WrapMode wrap_mode = m_texture.wrap_mode();
+        auto wrap = [&](int32_t i, int32_t n) {
+            if (i < 0)
+                return wrap_mode == dr::WrapMode::Repeat ? n - 1 : 0;
+            else if (i >= n)
+                return wrap_mode == dr::WrapMode::Repeat ? 0 : n - 1;
+            return i;
+        };
+
+        for (uint32_t z = 0; z < res.z(); ++z) {
+            auto [z0, z1] = voxel_range(2, z);
+            for (uint32_t y = 0; y < res.y(); ++y) {
+                auto [y0, y1] = voxel_range(1, y);
+                for (uint32_t x = 0; x < res.x(); ++x) {
+                    auto [x0, x1] = voxel_range(0, x);
+
+                    ScalarFloat value = 0.f;
+                    for (int32_t vz = z0; vz <= z1; ++vz) {
+                        for (int32_t vy = y0; vy <= y1; ++vy) {
+                            for (int32_t vx = x0; vx <= x1; ++vx) {
+                                size_t index =
+                                    ((size_t) (wrap(vz, vres.z()) * vres.y() +
+                                               wrap(vy, vres.y())) * vres.x() +
+                                     wrap(vx, vres.x())) * channels;
+                                if (upsampled) {
+                                    value = dr::maximum(value, ptr[index + 3]);
+                                } else {
+                                    for (size_t ch = 0; ch < channels; ++ch)
+                                        value = dr::maximum(value, ptr[index + ch]);
+                                }
+                            }
+                        }
+                    }
+
+                    *out++ = value;
+                }
+            }
+        }
+    }
+
     ScalarVector3i resolution() const override {
         const size_t *shape = m_texture.shape();
         return { (int) shape[2], (int) shape[1], (int) shape[0] };
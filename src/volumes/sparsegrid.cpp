@@ -0,0 +1,517 @@
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/mmap.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/volume.h>
+#include <mitsuba/render/volumegrid.h>
+#include <drjit/texture.h>
+#include <algorithm>
+#include <cstring>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _volume-sparsegridvolume:
+
+Sparse grid-based volume data source (:monosp:`sparsegridvolume`)
+-----------------------------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of the bricked sparse volume to be loaded
+
+ * - use_grid_bbox
+   - |bool|
+   - When set to ``true``, the bounding box stored in the file will be used.
+     By default, it is assumed that the grid is defined in the unit cube
+     spanning (0, 0, 0) x (1, 1, 1). (Default: false)
+
+ * - filter_type
+   - |string|
+   - Specifies how voxel values are interpolated. The following options are
+     currently available:
+
+     - ``trilinear`` (default): perform trilinear interpolation.
+
+     - ``nearest``: disable interpolation. In this mode, the plugin
+       performs nearest neighbor lookups of volume values.
+
+ * - wrap_mode
+   - |string|
+   - Controls the behavior of volume evaluations that fall outside of the
+     :math:`[0, 1]` range. The following options are currently available:
+
+     - ``clamp`` (default): clamp coordinates to the edge of the volume.
+
+     - ``repeat``: tile the volume infinitely.
+
+     - ``mirror``: mirror the volume along its boundaries.
+
+ * - to_world
+   - |transform|
+   - Specifies an optional 4x4 transformation matrix that will be applied to volume coordinates.
+
+This plugin is a variant of :ref:`gridvolume <volume-gridvolume>` for very
+large and mostly empty single- or three-channel volumes, such as the
+density fields of smoke and cloud simulations. The voxels are grouped into
+dense bricks of :math:`8^3` or :math:`16^3` voxels, and bricks whose voxels
+are all zero are not stored. A top-level index maps every brick to its
+storage slot.
+
+Rather than loading the data, the plugin maps the file into memory, and the
+operating system pages in the bricks as they are accessed (CUDA variants
+instead copy the stored bricks to the GPU). Lookups within empty bricks
+return zero without accessing any brick data, and the per-brick maxima stored
+in the file provide the majorants of a :ref:`heterogeneous medium
+<medium-heterogeneous>` without reading any voxel data. The data are not
+exposed as a differentiable parameter.
+
+Such files are created from a ``VolumeGrid`` using its ``write_sparse()``
+method. The format uses a little endian encoding and is specified as follows:
+
+.. list-table:: Sparse volume file format
+   :widths: 8 30
+   :header-rows: 1
+
+   * - Type
+     - Content
+   * - :monosp:`char[3]`
+     - ASCII Bytes ’S’, ’V’, and ’L’
+   * - :monosp:`uint8`
+     - File format version number (currently 1)
+   * - :monosp:`uint32`
+     - Brick size ``B`` (8 or 16)
+   * - :monosp:`uint32[3]`
+     - Number of voxels along the X, Y, and Z axes
+   * - :monosp:`uint32`
+     - Number of channels ``C`` (1 or 3)
+   * - :monosp:`float32[6]`
+     - Axis-aligned bounding box of the data (order: xmin, ymin, zmin, xmax,
+       ymax, zmax)
+   * - :monosp:`uint32`
+     - Number of stored bricks ``K``
+   * - :monosp:`uint32[]`
+     - Brick index with one entry per brick, ordered so that
+       :code:`index[(bz*by_count + by)*bx_count + bx]` refers to the brick
+       with the given coordinates. Each entry is the storage slot of the brick
+       in ``[0, K)``, or :code:`0xFFFFFFFF` for empty bricks.
+   * - :monosp:`float32[K][C]`
+     - Maximum value of each channel per stored brick
+   * - :math:`\rightarrow`
+     - Zero padding up to the next multiple of 4096 bytes (relative to the
+       beginning of the file)
+   * - :monosp:`float32[K][B][B][B][C]`
+     - Voxel data of the stored bricks in the order of their slots, indexed as
+       :code:`data[slot][z][y][x][chan]`. Voxels outside of the volume are
+       zero.
+
+.. tabs::
+    .. code-tab:: python
+
+        # Convert a dense grid into a sparse volume file
+        mi.VolumeGrid(data).write_sparse('smoke.svol', brick_size=16)
+
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'sparsegridvolume',
+            'filename': 'smoke.svol'
+        }
+
+    .. code-tab:: xml
+
+        <medium type="heterogeneous">
+            <volume type="sparsegridvolume" name="sigma_t">
+                <string name="filename" value="smoke.svol"/>
+            </volume>
+        </medium>
+*/
+
+template <typename Float, typename Spectrum>
+class SparseGridVolume final : public Volume<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Volume, update_bbox, m_to_local, m_bbox, m_channel_count)
+    MI_IMPORT_TYPES()
+
+    using FloatStorage  = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    SparseGridVolume(const Properties &props) : Base(props) {
+        std::string_view filter_type_str = props.get<std::string_view>("filter_type", "trilinear");
+        if (filter_type_str == "nearest")
+            m_filter_mode = dr::FilterMode::Nearest;
+        else if (filter_type_str == "trilinear")
+            m_filter_mode = dr::FilterMode::Linear;
+        else
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\" or "
+                  "\"trilinear\"!", filter_type_str);
+
+        std::string_view wrap_mode_st = props.get<std::string_view>("wrap_mode", "clamp");
+        if (wrap_mode_st == "repeat")
+            m_wrap_mode = dr::WrapMode::Repeat;
+        else if (wrap_mode_st == "mirror")
+            m_wrap_mode = dr::WrapMode::Mirror;
+        else if (wrap_mode_st == "clamp")
+            m_wrap_mode = dr::WrapMode::Clamp;
+        else
+            Throw("Invalid wrap mode \"%s\", must be one of: \"repeat\", "
+                  "\"mirror\", or \"clamp\"!",
+                  wrap_mode_st);
+
+        FileResolver *fs = file_resolver();
+        fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
+        if (!fs::exists(file_path))
+            Throw("\"%s\": file does not exist!", file_path);
+
+        ScalarBoundingBox3f bbox = load(file_path);
+
+        if (props.get<bool>("use_grid_bbox", false)) {
+            m_to_local = ScalarAffineTransform4f::scale(dr::rcp(bbox.extents())) *
+                         ScalarAffineTransform4f::translate(-bbox.min) *
+                         m_to_local;
+            update_bbox();
+        }
+    }
+
+    UnpolarizedSpectrum eval(const Interaction3f &it,
+                             Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channel_count == 1)
+            return interpolate<1>(it, active).x();
+
+        if constexpr (is_spectral_v<Spectrum>) {
+            Throw("The SparseGridVolume texture %s was queried for a spectrum, "
+                  "but spectral upsampling of 3-channel data is not supported",
+                  to_string());
+        } else if constexpr (is_monochromatic_v<Spectrum>) {
+            return luminance(Color3f(interpolate<3>(it, active)));
+        } else {
+            return Color3f(interpolate<3>(it, active));
+        }
+    }
+
+    Float eval_1(const Interaction3f &it, Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channel_count == 1)
+            return interpolate<1>(it, active).x();
+        else
+            return luminance(Color3f(interpolate<3>(it, active)));
+    }
+
+    Vector3f eval_3(const Interaction3f &it,
+                    Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channel_count != 3)
+            Throw("eval_3(): The SparseGridVolume texture %s was queried for "
+                  "a 3D vector, but it has %s channel(s)", to_string(),
+                  m_channel_count);
+        return Vector3f(interpolate<3>(it, active));
+    }
+
+    ScalarFloat max() const override { return m_max; }
+
+    void max_per_channel(ScalarFloat *out) const override {
+        for (size_t i = 0; i < m_max_per_channel.size(); ++i)
+            out[i] = m_max_per_channel[i];
+    }
+
+    void max_grid(const ScalarVector3u &res, ScalarFloat *out) const override {
+        /* Bound every cell by the maxima of the bricks holding the voxels
+           that influence it (see GridVolume::max_grid()), which only
+           requires the brick index. First, list these bricks per axis. */
+        std::vector<std::vector<uint32_t>> bricks[3];
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            int32_t n = (int32_t) m_res[axis];
+            ScalarFloat scale = (ScalarFloat) n / res[axis];
+            bricks[axis].resize(res[axis]);
+            for (uint32_t c = 0; c < res[axis]; ++c) {
+                int32_t lo = (int32_t) dr::floor(c * scale - .5f),
+                        hi = (int32_t) dr::floor((c + 1) * scale - .5f) + 1;
+                std::vector<uint32_t> &list = bricks[axis][c];
+                for (int32_t b = dr::maximum(lo, 0) >> m_brick_shift;
+                     b <= (dr::minimum(hi, n - 1) >> m_brick_shift); ++b)
+                    list.push_back((uint32_t) b);
+
+                // Voxels past the edges wrap around with the repeat mode
+                if (m_wrap_mode == dr::WrapMode::Repeat) {
+                    if (lo < 0)
+                        list.push_back((uint32_t) (n - 1) >> m_brick_shift);
+                    if (hi >= n)
+                        list.push_back(0);
+                }
+            }
+        }
+
+        for (uint32_t z = 0; z < res.z(); ++z) {
+            for (uint32_t y = 0; y < res.y(); ++y) {
+                for (uint32_t x = 0; x < res.x(); ++x) {
+                    ScalarFloat value = 0.f;
+                    for (uint32_t bz : bricks[2][z]) {
+                        for (uint32_t by : bricks[1][y]) {
+                            for (uint32_t bx : bricks[0][x]) {
+                                uint32_t slot = m_index_host[
+                                    ((size_t) bz * m_brick_res.y() + by) *
+                                    m_brick_res.x() + bx];
+                                if (slot != SparseVolumeEmptyBrick)
+                                    value = dr::maximum(value, m_brick_max[slot]);
+                            }
+                        }
+                    }
+                    *out++ = value;
+                }
+            }
+        }
+    }
+
+    ScalarVector3i resolution() const override {
+        return ScalarVector3i(m_res);
+    };
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SparseGridVolume[" << std::endl
+            << "  to_local = " << string::indent(m_to_local, 13) << "," << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  dimensions = " << m_res << "," << std::endl
+            << "  brick_size = " << (1u << m_brick_shift) << "," << std::endl
+            << "  bricks = " << m_brick_max.size() << " of "
+                             << dr::prod(m_brick_res) << "," << std::endl
+            << "  max = " << m_max << "," << std::endl
+            << "  channels = " << m_channel_count << "," << std::endl
+            << "  filename = \"" << m_mmap->filename().string() << "\"" << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS(SparseGridVolume)
+
+protected:
+    /// Map the sparse volume file and return the bounding box it specifies
+    ScalarBoundingBox3f load(const fs::path &path) {
+        if (Stream::host_byte_order() != Stream::ELittleEndian)
+            Throw("\"%s\": sparse volumes can only be mapped on little endian "
+                  "hosts!", path);
+
+        m_mmap = new MemoryMappedFile(path);
+        const uint8_t *base = (const uint8_t *) m_mmap->data(),
+                      *ptr  = base,
+                      *end  = base + m_mmap->size();
+
+        auto read = [&](void *out, size_t size) {
+            if ((size_t) (end - ptr) < size)
+                Throw("\"%s\": sparse volume file is truncated!", path);
+            memcpy(out, ptr, size);
+            ptr += size;
+        };
+
+        char header[3];
+        uint8_t version;
+        read(header, 3);
+        read(&version, 1);
+        if (header[0] != 'S' || header[1] != 'V' || header[2] != 'L')
+            Throw("\"%s\": invalid sparse volume file!", path);
+        if (version != SparseVolumeVersion)
+            Throw("\"%s\": unsupported sparse volume version %i (expected %i)!",
+                  path, (int) version, (int) SparseVolumeVersion);
+
+        uint32_t brick_size, channels, brick_count;
+        uint32_t res[3];
+        float bbox[6];
+        read(&brick_size, sizeof(uint32_t));
+        read(res, sizeof(res));
+        read(&channels, sizeof(uint32_t));
+        read(bbox, sizeof(bbox));
+        read(&brick_count, sizeof(uint32_t));
+
+        if (brick_size != 8 && brick_size != 16)
+            Throw("\"%s\": invalid brick size %u!", path, brick_size);
+        if (channels != 1 && channels != 3)
+            Throw("\"%s\": only volumes with 1 or 3 channels are supported "
+                  "(found %u)!", path, channels);
+        if (res[0] == 0 || res[1] == 0 || res[2] == 0)
+            Throw("\"%s\": invalid volume resolution!", path);
+
+        m_res = ScalarVector3u(res[0], res[1], res[2]);
+        m_brick_shift = brick_size == 8 ? 3 : 4;
+        m_brick_res = (m_res + brick_size - 1) >> m_brick_shift;
+        m_channel_count = channels;
+
+        // Brick index, which is read in place
+        size_t index_count = dr::prod(m_brick_res);
+        if ((size_t) (end - ptr) < index_count * sizeof(uint32_t))
+            Throw("\"%s\": sparse volume file is truncated!", path);
+        m_index_host = (const uint32_t *) ptr;
+        ptr += index_count * sizeof(uint32_t);
+        for (size_t i = 0; i < index_count; ++i) {
+            if (m_index_host[i] != SparseVolumeEmptyBrick &&
+                m_index_host[i] >= brick_count)
+                Throw("\"%s\": invalid brick index!", path);
+        }
+
+        // Per-brick maxima
+        std::vector<float> maxima((size_t) brick_count * channels);
+        read(maxima.data(), maxima.size() * sizeof(float));
+        m_brick_max.assign(brick_count, 0.f);
+        m_max_per_channel.assign(channels, 0.f);
+        for (size_t i = 0; i < maxima.size(); ++i) {
+            ScalarFloat value = maxima[i];
+            m_brick_max[i / channels] = dr::maximum(m_brick_max[i / channels], value);
+            m_max_per_channel[i % channels] =
+                dr::maximum(m_max_per_channel[i % channels], value);
+        }
+        m_max = 0.f;
+        for (ScalarFloat value : m_max_per_channel)
+            m_max = dr::maximum(m_max, value);
+
+        // Brick data, which is mapped rather than read where possible
+        size_t offset = (size_t) (ptr - base);
+        offset = (offset + SparseVolumeAlignment - 1) /
+                 SparseVolumeAlignment * SparseVolumeAlignment;
+        size_t value_count = (size_t) brick_count * channels
+                             << (3 * m_brick_shift);
+        if (value_count > 0xFFFFFFFFull)
+            Throw("\"%s\": too many non-empty bricks (%u) for 32-bit indexing!",
+                  path, brick_count);
+        if (offset + value_count * sizeof(float) > m_mmap->size())
+            Throw("\"%s\": sparse volume file is truncated!", path);
+        const float *values = (const float *) (base + offset);
+
+        m_index = dr::load<UInt32Storage>(m_index_host, index_count);
+
+        if (value_count == 0) {
+            // Keep the storage non-empty, no lookup reaches it
+            m_values = dr::zeros<FloatStorage>(1);
+            if constexpr (!dr::is_jit_v<Float>)
+                m_values_ptr = m_values.data();
+        } else if constexpr (!std::is_same_v<ScalarFloat, float>) {
+            // Double precision variants need a converted copy
+            std::unique_ptr<ScalarFloat[]> converted(new ScalarFloat[value_count]);
+            for (size_t i = 0; i < value_count; ++i)
+                converted[i] = (ScalarFloat) values[i];
+            m_values = dr::load<FloatStorage>(converted.get(), value_count);
+            if constexpr (!dr::is_jit_v<Float>)
+                m_values_ptr = m_values.data();
+        } else if constexpr (dr::is_llvm_v<Float>) {
+            m_values = dr::map<FloatStorage>((void *) values, value_count, false);
+        } else if constexpr (dr::is_jit_v<Float>) {
+            m_values = dr::load<FloatStorage>(values, value_count);
+        } else {
+            m_values_ptr = values;
+        }
+
+        Log(Debug, "Mapped sparse volume \"%s\": dimensions %s, %u of %u "
+            "bricks stored (%s), max value %f", path.filename(), m_res,
+            brick_count, index_count,
+            util::mem_string(value_count * sizeof(float)), m_max);
+
+        return ScalarBoundingBox3f(ScalarPoint3f(bbox[0], bbox[1], bbox[2]),
+                                   ScalarPoint3f(bbox[3], bbox[4], bbox[5]));
+    }
+
+    /// Apply the wrap mode to voxel coordinates
+    MI_INLINE Vector3i wrap(const Vector3i &v) const {
+        ScalarVector3i res(m_res);
+        if (m_wrap_mode == dr::WrapMode::Repeat) {
+            Vector3i r = v % res;
+            return dr::select(r < 0, r + res, r);
+        } else if (m_wrap_mode == dr::WrapMode::Mirror) {
+            Vector3i r = v % (2 * res);
+            r = dr::select(r < 0, r + 2 * res, r);
+            return dr::select(r >= res, 2 * res - 1 - r, r);
+        } else {
+            return dr::clip(v, 0, res - 1);
+        }
+    }
+
+    /// Fetch the value at voxel \c v, skipping the data of empty bricks
+    template <size_t Channels>
+    MI_INLINE dr::Array<Float, Channels> fetch(const Vector3i &v,
+                                               Mask active) const {
+        uint32_t shift = m_brick_shift;
+        Vector3u vu(v),
+                 brick = vu >> m_brick_shift,
+                 local = vu & ((1u << m_brick_shift) - 1u);
+
+        UInt32 slot = dr::gather<UInt32>(
+            m_index, (brick.z() * m_brick_res.y() + brick.y()) *
+                     m_brick_res.x() + brick.x(), active);
+        active &= slot != SparseVolumeEmptyBrick;
+
+        UInt32 index = ((((slot << shift) + local.z()) << shift) + local.y())
+                           << shift;
+        index = (index + local.x()) * (uint32_t) Channels;
+
+        dr::Array<Float, Channels> result;
+        for (size_t c = 0; c < Channels; ++c) {
+            if constexpr (dr::is_jit_v<Float>)
+                result[c] = dr::gather<Float>(m_values, index + (uint32_t) c,
+                                              active);
+            else
+                result[c] = active ? m_values_ptr[index + c] : 0.f;
+        }
+        return result;
+    }
+
+    /// Evaluate the volume with the configured filter and wrap mode
+    template <size_t Channels>
+    MI_INLINE dr::Array<Float, Channels> interpolate(const Interaction3f &it,
+                                                     Mask active) const {
+        ScalarVector3f res(m_res);
+        Point3f p = m_to_local * it.p;
+
+        if (m_filter_mode == dr::FilterMode::Nearest)
+            return fetch<Channels>(wrap(dr::floor2int<Vector3i>(p * res)),
+                                   active);
+
+        p = dr::fmadd(p, res, -.5f);
+        Vector3i v0 = dr::floor2int<Vector3i>(p);
+        Vector3f w1 = p - Point3f(v0),
+                 w0 = 1.f - w1;
+        Vector3i a = wrap(v0), b = wrap(v0 + 1);
+
+        dr::Array<Float, Channels> result = 0.f;
+        for (uint32_t i = 0; i < 8; ++i) {
+            Vector3i v((i & 1) ? b.x() : a.x(),
+                       (i & 2) ? b.y() : a.y(),
+                       (i & 4) ? b.z() : a.z());
+            Float w = ((i & 1) ? w1.x() : w0.x()) *
+                      ((i & 2) ? w1.y() : w0.y()) *
+                      ((i & 4) ? w1.z() : w0.z());
+            result = dr::fmadd(fetch<Channels>(v, active), w, result);
+        }
+        return result;
+    }
+
+protected:
+    ref<MemoryMappedFile> m_mmap;
+    /// Brick index (points into the mapped file)
+    const uint32_t *m_index_host = nullptr;
+    /// Brick data for scalar variants (points into the mapped file or \c m_values)
+    const ScalarFloat *m_values_ptr = nullptr;
+
+    UInt32Storage m_index;
+    FloatStorage m_values;
+
+    ScalarVector3u m_res;
+    ScalarVector3u m_brick_res;
+    uint32_t m_brick_shift;
+    dr::FilterMode m_filter_mode;
+    dr::WrapMode m_wrap_mode;
+
+    std::vector<ScalarFloat> m_brick_max;
+    std::vector<ScalarFloat> m_max_per_channel;
+    ScalarFloat m_max;
+
+    MI_TRAVERSE_CB(Base, m_index, m_values)
+};
+
+MI_EXPORT_PLUGIN(SparseGridVolume)
+NAMESPACE_END(mitsuba)
@@ -2,6 +2,7 @@ import pytest
 import drjit as dr
 import mitsuba as mi
 import os
+import numpy as np
 
 
 def test01_grid_construct(variant_scalar_rgb, tmpdir):
@@ -114,3 +115,29 @@ def test06_eval_per_channel(variants_all_rgb, tmpdir):
     it.p = mi.Point3f(1.0)
     print(vol.eval_n(it))
     assert dr.allclose(vol.eval_n(it), [1.0, 2.0, 3.0, 4.0, 5.0, 6.0])
+
+
+@pytest.mark.parametrize('wrap_mode', ['clamp', 'repeat', 'mirror'])
+def test07_max_grid(variants_vec_backends_once_rgb, np_rng, wrap_mode):
+    """The coarse max grid bounds the interpolated values within each cell"""
+    data = (np_rng.random((12, 10, 9, 1)) ** 8).astype(np.float32)
+    vol = mi.load_dict({
+        'type' : 'gridvolume',
+        'grid' : mi.VolumeGrid(mi.TensorXf(data)),
+        'wrap_mode' : wrap_mode
+    })
+
+    res = np.array([3, 4, 2])
+    bounds = np.array(vol.max_grid(mi.ScalarVector3u(res))).reshape(res[::-1])
+    assert np.all(bounds <= data.max())
+
+    p = np_rng.random((100000, 3))
+    it = dr.zeros(mi.Interaction3f, len(p))
+    it.p = mi.Point3f(p[:, 0], p[:, 1], p[:, 2])
+    values = np.array(vol.eval_1(it))
+    cell = np.minimum((p * res).astype(int), res - 1)
+    assert np.all(values <= bounds[cell[:, 2], cell[:, 1], cell[:, 0]] + 1e-6)
+
+    # The default implementation is the global maximum
+    const = mi.load_dict({'type': 'constvolume', 'value': 0.5})
+    assert np.allclose(const.max_grid(mi.ScalarVector3u(2, 2, 2)), 0.5)
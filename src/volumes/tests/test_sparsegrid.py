@@ -0,0 +1,87 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import os
+import numpy as np
+
+
+def sparse_data(np_rng, channels):
+    """A mostly empty grid, with a few small blobs like a smoke plume"""
+    data = np.zeros((40, 35, 50, channels), dtype=np.float32)
+    data[2:9, 20:30, 3:12] = np_rng.random((7, 10, 9, channels))
+    data[30:40, 0:4, 40:50] = np_rng.random((10, 4, 10, channels))
+    data[39, 34, 49] = 2.0
+    return data
+
+
+@pytest.mark.parametrize('brick_size', [8, 16])
+def test01_write_sparse(variant_scalar_rgb, tmpdir, np_rng, brick_size):
+    """Only non-empty bricks are stored"""
+    dense_file = os.path.join(str(tmpdir), "dense.vol")
+    sparse_file = os.path.join(str(tmpdir), "sparse.svol")
+    grid = mi.VolumeGrid(mi.TensorXf(sparse_data(np_rng, 1)))
+    grid.write(dense_file)
+    grid.write_sparse(sparse_file, brick_size=brick_size)
+    assert os.path.getsize(sparse_file) < os.path.getsize(dense_file) / 2
+
+    with open(sparse_file, 'rb') as f:
+        header = f.read(48)
+    assert header[:4] == b'SVL\x01'
+    assert np.frombuffer(header, np.uint32, 5, 4)[0] == brick_size
+
+    with pytest.raises(RuntimeError, match='brick size'):
+        grid.write_sparse(sparse_file, brick_size=4)
+
+
+@pytest.mark.parametrize('channels', [1, 3])
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+@pytest.mark.parametrize('wrap_mode', ['clamp', 'repeat', 'mirror'])
+def test02_eval(variants_all_rgb, tmpdir, np_rng, channels, filter_type,
+                wrap_mode):
+    """Lookups match the dense grid volume"""
+    tmp_file = os.path.join(str(tmpdir), "sparse.svol")
+    grid = mi.VolumeGrid(mi.TensorXf(sparse_data(np_rng, channels)))
+    grid.write_sparse(tmp_file, brick_size=8)
+
+    params = {
+        'filter_type': filter_type,
+        'wrap_mode': wrap_mode,
+        'to_world': mi.ScalarTransform4f().scale(2.0)
+    }
+    dense = mi.load_dict({'type': 'gridvolume', 'grid': grid,
+                          'raw': True, **params})
+    sparse = mi.load_dict({'type': 'sparsegridvolume',
+                           'filename': tmp_file, **params})
+
+    assert sparse.resolution() == dense.resolution()
+    assert dr.allclose(sparse.max(), 2.0)
+
+    n = 10000
+    p = np_rng.random((n, 3)) * 2.4 - 0.2
+    it = dr.zeros(mi.Interaction3f, n)
+    it.p = mi.Point3f(p[:, 0], p[:, 1], p[:, 2])
+    if channels == 1:
+        assert dr.allclose(sparse.eval_1(it), dense.eval_1(it), atol=1e-5)
+    else:
+        assert dr.allclose(sparse.eval_3(it), dense.eval_3(it), atol=1e-5)
+
+
+def test03_max_grid(variants_vec_backends_once_rgb, tmpdir, np_rng):
+    """Per-brick maxima bound the interpolated values within each cell"""
+    tmp_file = os.path.join(str(tmpdir), "sparse.svol")
+    data = sparse_data(np_rng, 1)
+    mi.VolumeGrid(mi.TensorXf(data)).write_sparse(tmp_file, brick_size=8)
+    vol = mi.load_dict({'type': 'sparsegridvolume', 'filename': tmp_file})
+
+    res = np.array([5, 4, 3])
+    bounds = np.array(vol.max_grid(mi.ScalarVector3u(res))).reshape(res[::-1])
+    assert np.all(bounds <= data.max())
+    # Cells far from the blobs are empty
+    assert np.count_nonzero(bounds == 0) > bounds.size // 3
+
+    p = np_rng.random((100000, 3))
+    it = dr.zeros(mi.Interaction3f, len(p))
+    it.p = mi.Point3f(p[:, 0], p[:, 1], p[:, 2])
+    values = np.array(vol.eval_1(it))
+    cell = np.minimum((p * res).astype(int), res - 1)
+    assert np.all(values <= bounds[cell[:, 2], cell[:, 1], cell[:, 0]] + 1e-6)